@@ -12,7 +12,7 @@ import esphome.codegen as cg
 import esphome.config_validation as cv
 from esphome import automation
 from esphome.const import CONF_ID, CONF_TRIGGER_ID
-from esphome.components import esp32_ble
+from esphome.components import esp32_ble, lvgl_game_runner
 from esphome.components.esp32 import add_idf_sdkconfig_option
 import esphome.final_validate as fv
 
@@ -32,16 +32,17 @@ BLEGamepad = ble_gamepad_ns.class_(
 
 # Triggers
 BLEGamepadConnectTrigger = ble_gamepad_ns.class_(
-    "BLEGamepadConnectTrigger", automation.Trigger.template()
+    "BLEGamepadConnectTrigger", automation.Trigger.template(cg.uint8)
 )
 BLEGamepadDisconnectTrigger = ble_gamepad_ns.class_(
-    "BLEGamepadDisconnectTrigger", automation.Trigger.template()
+    "BLEGamepadDisconnectTrigger", automation.Trigger.template(cg.uint8)
 )
 BLEGamepadButtonTrigger = ble_gamepad_ns.class_(
-    "BLEGamepadButtonTrigger", automation.Trigger.template()
+    "BLEGamepadButtonTrigger",
+    automation.Trigger.template(cg.std_string, cg.bool_, cg.uint8),
 )
 BLEGamepadStickTrigger = ble_gamepad_ns.class_(
-    "BLEGamepadStickTrigger", automation.Trigger.template()
+    "BLEGamepadStickTrigger", automation.Trigger.template(cg.uint8)
 )
 
 # Config keys
@@ -49,36 +50,106 @@ CONF_ON_CONNECT = "on_connect"
 CONF_ON_DISCONNECT = "on_disconnect"
 CONF_ON_BUTTON = "on_button"
 CONF_ON_STICK = "on_stick"
+CONF_RUNNER = "runner"
+CONF_PLAYER = "player"
+CONF_CONNECTION_PARAMETERS = "connection_parameters"
+CONF_INTERVAL = "interval"
+CONF_LATENCY = "latency"
+CONF_TIMEOUT = "timeout"
+CONF_FAST_RECONNECT = "fast_reconnect"
+CONF_MAX_CONTROLLERS = "max_controllers"
 
-# Configuration schema
-CONFIG_SCHEMA = cv.Schema(
-    {
-        cv.GenerateID(): cv.declare_id(BLEGamepad),
-        cv.GenerateID(esp32_ble.CONF_BLE_ID): cv.use_id(esp32_ble.ESP32BLE),
-        cv.Optional(CONF_ON_CONNECT): automation.validate_automation(
-            {
-                cv.GenerateID(CONF_TRIGGER_ID): cv.declare_id(BLEGamepadConnectTrigger),
-            }
-        ),
-        cv.Optional(CONF_ON_DISCONNECT): automation.validate_automation(
-            {
-                cv.GenerateID(CONF_TRIGGER_ID): cv.declare_id(
-                    BLEGamepadDisconnectTrigger
+
+def _validate_connection_parameters(config):
+    # Bluetooth Core spec: the supervision timeout must cover (1 + latency) * interval twice
+    interval_ms = config[CONF_INTERVAL].total_microseconds / 1000
+    timeout_ms = config[CONF_TIMEOUT].total_milliseconds
+    if timeout_ms <= (1 + config[CONF_LATENCY]) * interval_ms * 2:
+        raise cv.Invalid(
+            f"{CONF_TIMEOUT} must be longer than (1 + {CONF_LATENCY}) * {CONF_INTERVAL} * 2"
+        )
+    return config
+
+
+CONNECTION_PARAMETERS_SCHEMA = cv.All(
+    cv.Schema(
+        {
+            cv.Optional(CONF_INTERVAL, default="7.5ms"): cv.All(
+                cv.positive_time_period_microseconds,
+                cv.Range(
+                    min=cv.TimePeriod(microseconds=7500), max=cv.TimePeriod(seconds=4)
                 ),
-            }
-        ),
-        cv.Optional(CONF_ON_BUTTON): automation.validate_automation(
-            {
-                cv.GenerateID(CONF_TRIGGER_ID): cv.declare_id(BLEGamepadButtonTrigger),
-            }
-        ),
-        cv.Optional(CONF_ON_STICK): automation.validate_automation(
-            {
-                cv.GenerateID(CONF_TRIGGER_ID): cv.declare_id(BLEGamepadStickTrigger),
-            }
-        ),
-    }
-).extend(cv.COMPONENT_SCHEMA)
+            ),
+            cv.Optional(CONF_LATENCY, default=0): cv.int_range(min=0, max=499),
+            cv.Optional(CONF_TIMEOUT, default="2s"): cv.All(
+                cv.positive_time_period_milliseconds,
+                cv.Range(
+                    min=cv.TimePeriod(milliseconds=100), max=cv.TimePeriod(seconds=32)
+                ),
+            ),
+        }
+    ),
+    _validate_connection_parameters,
+)
+
+
+def _validate_players(config):
+    # Controller slot N feeds runner player `player` + N - 1
+    last = config[CONF_PLAYER] + config[CONF_MAX_CONTROLLERS] - 1
+    if CONF_RUNNER in config and last > 4:
+        raise cv.Invalid(
+            f"{CONF_PLAYER} + {CONF_MAX_CONTROLLERS} - 1 must not exceed 4 (got {last})"
+        )
+    return config
+
+
+# Configuration schema
+CONFIG_SCHEMA = cv.All(
+    cv.Schema(
+        {
+            cv.GenerateID(): cv.declare_id(BLEGamepad),
+            cv.GenerateID(esp32_ble.CONF_BLE_ID): cv.use_id(esp32_ble.ESP32BLE),
+            cv.Optional(CONF_RUNNER): cv.use_id(lvgl_game_runner.LvglGameRunner),
+            cv.Optional(CONF_PLAYER, default=1): cv.int_range(min=1, max=4),
+            cv.Optional(
+                CONF_CONNECTION_PARAMETERS, default={}
+            ): CONNECTION_PARAMETERS_SCHEMA,
+            cv.Optional(CONF_FAST_RECONNECT, default=True): cv.boolean,
+            cv.Optional(CONF_MAX_CONTROLLERS, default=1): cv.int_range(
+                min=1, max=4
+            ),
+            cv.Optional(CONF_ON_CONNECT): automation.validate_automation(
+                {
+                    cv.GenerateID(CONF_TRIGGER_ID): cv.declare_id(
+                        BLEGamepadConnectTrigger
+                    ),
+                }
+            ),
+            cv.Optional(CONF_ON_DISCONNECT): automation.validate_automation(
+                {
+                    cv.GenerateID(CONF_TRIGGER_ID): cv.declare_id(
+                        BLEGamepadDisconnectTrigger
+                    ),
+                }
+            ),
+            cv.Optional(CONF_ON_BUTTON): automation.validate_automation(
+                {
+                    cv.GenerateID(CONF_TRIGGER_ID): cv.declare_id(
+                        BLEGamepadButtonTrigger
+                    ),
+                }
+            ),
+            cv.Optional(CONF_ON_STICK): automation.validate_automation(
+                {
+                    cv.GenerateID(CONF_TRIGGER_ID): cv.declare_id(
+                        BLEGamepadStickTrigger
+                    ),
+                }
+            ),
+        }
+    ).extend(cv.COMPONENT_SCHEMA),
+    _validate_players,
+)
 
 
 def _validate_psram(config):
@@ -156,21 +227,47 @@ async def to_code(config):
     # This moves BLE stack allocations out of precious internal RAM
     add_idf_sdkconfig_option("CONFIG_BT_ALLOCATION_FROM_SPIRAM_FIRST", True)
 
+    # Requested after HOGP setup (in BLE units: 1.25ms interval, 10ms timeout)
+    conn = config[CONF_CONNECTION_PARAMETERS]
+    cg.add(
+        var.set_conn_params(
+            round(conn[CONF_INTERVAL].total_microseconds / 1250),
+            conn[CONF_LATENCY],
+            conn[CONF_TIMEOUT].total_milliseconds // 10,
+        )
+    )
+
+    # Persist discovered GATT handles per bonded controller and reconnect without scanning
+    cg.add(var.set_fast_reconnect(config[CONF_FAST_RECONNECT]))
+
+    # Controllers are set up one at a time and keep their player slot across reconnects
+    cg.add(var.set_max_controllers(config[CONF_MAX_CONTROLLERS]))
+
+    # Direct link to a game runner: input events are pushed from the BLE context, so the
+    # runner needs its multi-producer input queue
+    if CONF_RUNNER in config:
+        runner = await cg.get_variable(config[CONF_RUNNER])
+        cg.add_define("USE_BLE_GAMEPAD_RUNNER")
+        cg.add_build_flag("-DLVGL_GAME_RUNNER_INPUT_MPSC=1")
+        cg.add(var.set_runner(runner, config[CONF_PLAYER]))
+
     # Register automation triggers
     for conf in config.get(CONF_ON_CONNECT, []):
         trigger = cg.new_Pvariable(conf[CONF_TRIGGER_ID], var)
-        await automation.build_automation(trigger, [], conf)
+        await automation.build_automation(trigger, [(cg.uint8, "player")], conf)
 
     for conf in config.get(CONF_ON_DISCONNECT, []):
         trigger = cg.new_Pvariable(conf[CONF_TRIGGER_ID], var)
-        await automation.build_automation(trigger, [], conf)
+        await automation.build_automation(trigger, [(cg.uint8, "player")], conf)
 
     for conf in config.get(CONF_ON_BUTTON, []):
         trigger = cg.new_Pvariable(conf[CONF_TRIGGER_ID], var)
         await automation.build_automation(
-            trigger, [(cg.std_string, "input"), (cg.bool_, "pressed")], conf
+            trigger,
+            [(cg.std_string, "input"), (cg.bool_, "pressed"), (cg.uint8, "player")],
+            conf,
         )
 
     for conf in config.get(CONF_ON_STICK, []):
         trigger = cg.new_Pvariable(conf[CONF_TRIGGER_ID], var)
-        await automation.build_automation(trigger, [], conf)
+        await automation.build_automation(trigger, [(cg.uint8, "player")], conf)
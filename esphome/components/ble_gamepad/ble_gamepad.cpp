@@ -2,9 +2,14 @@
 // SPDX-License-Identifier: MIT
 
 #include "ble_gamepad.h"
+#include "generic_controller.h"
 #include "xbox_controller.h"
+#include "esphome/core/helpers.h"
 #include "esphome/core/log.h"
 #include "esphome/components/esp32_ble/ble.h"
+#include "esp_timer.h"
+#include <algorithm>
+#include <cstdlib>
 #include <inttypes.h>  // For PRIu32 format specifier
 
 #ifdef USE_ESP_IDF
@@ -15,11 +20,42 @@ static const char *const TAG = "ble_gamepad";
 
 // Known Xbox controller identifiers
 static constexpr uint16_t BLE_APPEARANCE_GAMEPAD = 0x03C4;  // Generic Gamepad
+static constexpr uint16_t MICROSOFT_VENDOR_ID = 0x045e;
 
 // GATT app ID for registration (arbitrary value, must be unique within application)
 // This ID is used to identify this component's GATT client instance
 static constexpr uint16_t GATTC_APP_ID = 0x1234;
 
+#ifdef USE_BLE_GAMEPAD_RUNNER
+using lvgl_game_runner::InputEvent;
+using lvgl_game_runner::InputType;
+
+// runner: mapping, matching the names on_button reports for the same buttons
+struct RunnerButton {
+  ButtonBit bit;
+  InputType type;
+};
+static constexpr RunnerButton RUNNER_BUTTONS[] = {
+    {BUTTON_SOUTH, InputType::A},
+    {BUTTON_EAST, InputType::B},
+    {BUTTON_SELECT, InputType::SELECT},
+    {BUTTON_START, InputType::START},
+};
+
+// Directions come from the d-pad or the left stick, in this order
+static constexpr RunnerButton RUNNER_DIRECTIONS[] = {
+    {BUTTON_DPAD_UP, InputType::UP},
+    {BUTTON_DPAD_DOWN, InputType::DOWN},
+    {BUTTON_DPAD_LEFT, InputType::LEFT},
+    {BUTTON_DPAD_RIGHT, InputType::RIGHT},
+};
+
+static constexpr int STICK_PRESS_THRESHOLD = 64;    // Deflection (of 127) that presses a direction
+static constexpr int STICK_RELEASE_THRESHOLD = 48;  // ...and releases it again (hysteresis)
+static constexpr int TRIGGER_PRESS_THRESHOLD = 32;  // Trigger travel (of 255) reported as pressed
+static constexpr int TRIGGER_STEP = 16;             // Smaller trigger movements send no event
+#endif
+
 void BLEGamepad::setup() {
   ESP_LOGI(TAG, "Setting up BLE gamepad component");
 
@@ -45,99 +81,142 @@ void BLEGamepad::loop() {
     ESP_LOGI(TAG, "GATT client app registration initiated");
   }
 
-  // Main loop - check for state changes and fire triggers
-  if (active_controller_ == nullptr) {
-    return;
+  // Main loop - check each controller for state changes and fire triggers
+  this->reports_last_poll_ = 0;
+  for (auto &session : this->sessions_) {
+    this->poll_session_(session);
+  }
+}
+
+void BLEGamepad::poll_session_(Session &session) {
+  const uint32_t seq = session.state_slot.read(session.current_state);
+  const uint32_t reports = seq - session.last_report_seq;
+  if (reports == 0) {
+    return;  // No reports since the last poll
   }
+  session.last_report_seq = seq;
+  this->reports_last_poll_ += reports;
+  const uint8_t player = this->player_of_(session);
 
-  const ControllerState &current = active_controller_->get_state();
+  const ControllerState &current = session.current_state;
+  const ControllerState &prev = session.prev_state;
+
+  // Buttons that went down and back up (or the reverse) in reports between two polls
+  uint32_t pressed_edges;
+  uint32_t released_edges;
+  session.state_slot.take_button_edges(pressed_edges, released_edges);
+  const uint32_t round_trips = pressed_edges & released_edges;
 
   // Check for button changes
-  bool button_changed = false;
-  if (memcmp(&current.buttons, &prev_state_.buttons, sizeof(current.buttons)) != 0) {
+  bool button_changed = round_trips != 0;
+  if (memcmp(&current.buttons, &prev.buttons, sizeof(current.buttons)) != 0) {
     button_changed = true;
   }
 
   // Check for analog stick changes (with small deadzone to avoid noise)
   bool stick_changed = false;
   constexpr int8_t STICK_DEADZONE = 5;
-  if (abs(current.left_stick_x - prev_state_.left_stick_x) > STICK_DEADZONE ||
-      abs(current.left_stick_y - prev_state_.left_stick_y) > STICK_DEADZONE ||
-      abs(current.right_stick_x - prev_state_.right_stick_x) > STICK_DEADZONE ||
-      abs(current.right_stick_y - prev_state_.right_stick_y) > STICK_DEADZONE) {
+  if (abs(current.left_stick_x - prev.left_stick_x) > STICK_DEADZONE ||
+      abs(current.left_stick_y - prev.left_stick_y) > STICK_DEADZONE ||
+      abs(current.right_stick_x - prev.right_stick_x) > STICK_DEADZONE ||
+      abs(current.right_stick_y - prev.right_stick_y) > STICK_DEADZONE) {
     stick_changed = true;
   }
 
   // Fire triggers and log changes
   if (button_changed) {
-    ESP_LOGD(TAG, "Button state changed:");
+    ESP_LOGD(TAG, "Player %u button state changed:", player);
 
-    // Macro to check a button change, log it, and fire callback
-#define CHECK_BUTTON(field, name, log_name) \
-  if (current.buttons.field != prev_state_.buttons.field) { \
+    // Macro to check a button change, log it, and fire callback. A button that ends where it
+    // started but went both ways in between gets both callbacks, so short taps aren't lost.
+#define CHECK_BUTTON(field, bit, name, log_name) \
+  if (current.buttons.field != prev.buttons.field) { \
     ESP_LOGD(TAG, "  %s: %s", log_name, current.buttons.field ? "PRESSED" : "released"); \
-    on_button_callbacks_.call(name, current.buttons.field); \
+    on_button_callbacks_.call(name, current.buttons.field, player); \
+  } else if (round_trips & (1u << (bit))) { \
+    ESP_LOGD(TAG, "  %s: %s", log_name, current.buttons.field ? "released+PRESSED" : "PRESSED+released"); \
+    on_button_callbacks_.call(name, !current.buttons.field, player); \
+    on_button_callbacks_.call(name, current.buttons.field, player); \
   }
 
     // D-pad (map to UP/DOWN/LEFT/RIGHT for game runner compatibility)
-    CHECK_BUTTON(dpad_up, "UP", "D-Up")
-    CHECK_BUTTON(dpad_down, "DOWN", "D-Down")
-    CHECK_BUTTON(dpad_left, "LEFT", "D-Left")
-    CHECK_BUTTON(dpad_right, "RIGHT", "D-Right")
+    CHECK_BUTTON(dpad_up, BUTTON_DPAD_UP, "UP", "D-Up")
+    CHECK_BUTTON(dpad_down, BUTTON_DPAD_DOWN, "DOWN", "D-Down")
+    CHECK_BUTTON(dpad_left, BUTTON_DPAD_LEFT, "LEFT", "D-Left")
+    CHECK_BUTTON(dpad_right, BUTTON_DPAD_RIGHT, "RIGHT", "D-Right")
 
     // Face buttons
-    CHECK_BUTTON(button_south, "A", "A")  // Xbox A / PS Cross
-    CHECK_BUTTON(button_east, "B", "B")   // Xbox B / PS Circle
+    CHECK_BUTTON(button_south, BUTTON_SOUTH, "A", "A")  // Xbox A / PS Cross
+    CHECK_BUTTON(button_east, BUTTON_EAST, "B", "B")    // Xbox B / PS Circle
 
     // System buttons
-    CHECK_BUTTON(button_select, "SELECT", "View")  // Xbox View / PS Share
-    CHECK_BUTTON(button_start, "START", "Menu")    // Xbox Menu / PS Options
+    CHECK_BUTTON(button_select, BUTTON_SELECT, "SELECT", "View")  // Xbox View / PS Share
+    CHECK_BUTTON(button_start, BUTTON_START, "START", "Menu")     // Xbox Menu / PS Options
 
     // Additional buttons (for logging, games can choose to use or ignore)
-    CHECK_BUTTON(button_west, "X", "X")         // Xbox X / PS Square
-    CHECK_BUTTON(button_north, "Y", "Y")        // Xbox Y / PS Triangle
-    CHECK_BUTTON(button_l1, "L1", "LB")         // Xbox LB / PS L1
-    CHECK_BUTTON(button_r1, "R1", "RB")         // Xbox RB / PS R1
-    CHECK_BUTTON(button_l3, "L3", "L3")         // Left stick press
-    CHECK_BUTTON(button_r3, "R3", "R3")         // Right stick press
-    CHECK_BUTTON(button_home, "HOME", "Xbox")   // Xbox button / PS button
-    CHECK_BUTTON(button_misc, "MISC", "Share")  // Xbox Share button
+    CHECK_BUTTON(button_west, BUTTON_WEST, "X", "X")          // Xbox X / PS Square
+    CHECK_BUTTON(button_north, BUTTON_NORTH, "Y", "Y")        // Xbox Y / PS Triangle
+    CHECK_BUTTON(button_l1, BUTTON_L1, "L1", "LB")            // Xbox LB / PS L1
+    CHECK_BUTTON(button_r1, BUTTON_R1, "R1", "RB")            // Xbox RB / PS R1
+    CHECK_BUTTON(button_l3, BUTTON_L3, "L3", "L3")            // Left stick press
+    CHECK_BUTTON(button_r3, BUTTON_R3, "R3", "R3")            // Right stick press
+    CHECK_BUTTON(button_home, BUTTON_HOME, "HOME", "Xbox")    // Xbox button / PS button
+    CHECK_BUTTON(button_misc, BUTTON_MISC, "MISC", "Share")   // Xbox Share button
 
 #undef CHECK_BUTTON
   }
   if (stick_changed) {
-    ESP_LOGD(TAG, "Stick changed: LX=%d LY=%d RX=%d RY=%d", current.left_stick_x, current.left_stick_y,
-             current.right_stick_x, current.right_stick_y);
-    on_stick_callbacks_.call();
+    ESP_LOGD(TAG, "Player %u stick changed: LX=%d LY=%d RX=%d RY=%d", player, current.left_stick_x,
+             current.left_stick_y, current.right_stick_x, current.right_stick_y);
+    on_stick_callbacks_.call(player);
   }
 
   // Log trigger changes (with threshold to avoid noise)
   constexpr uint8_t TRIGGER_THRESHOLD = 10;
-  if (abs(static_cast<int>(current.left_trigger) - static_cast<int>(prev_state_.left_trigger)) > TRIGGER_THRESHOLD ||
-      abs(static_cast<int>(current.right_trigger) - static_cast<int>(prev_state_.right_trigger)) > TRIGGER_THRESHOLD) {
-    ESP_LOGD(TAG, "Triggers: LT=%d RT=%d", current.left_trigger, current.right_trigger);
+  if (abs(static_cast<int>(current.left_trigger) - static_cast<int>(prev.left_trigger)) > TRIGGER_THRESHOLD ||
+      abs(static_cast<int>(current.right_trigger) - static_cast<int>(prev.right_trigger)) > TRIGGER_THRESHOLD) {
+    ESP_LOGD(TAG, "Player %u triggers: LT=%d RT=%d", player, current.left_trigger, current.right_trigger);
   }
 
   // Update previous state
-  prev_state_ = current;
+  session.prev_state = current;
 }
 
 void BLEGamepad::dump_config() {
   ESP_LOGCONFIG(TAG, "BLE Gamepad:");
-  if (active_controller_) {
-    ESP_LOGCONFIG(TAG, "  Controller: %s", active_controller_->get_controller_type());
-    ESP_LOGCONFIG(TAG, "  Connected: Yes");
-  } else {
-    ESP_LOGCONFIG(TAG, "  Connected: No");
-    ESP_LOGCONFIG(TAG, "  Scanning: %s", scanning_ ? "Yes" : "No");
+  ESP_LOGCONFIG(TAG, "  Max controllers: %u", max_controllers_);
+  for (size_t i = 0; i < max_controllers_; i++) {
+    const Session &session = sessions_[i];
+    if (session.controller) {
+      ESP_LOGCONFIG(TAG, "  Player %zu: %s", i + 1, session.controller->get_controller_type());
+      if (session.conn_interval != 0) {
+        ESP_LOGCONFIG(TAG, "    Connection interval: %.2fms", session.conn_interval * 1.25f);
+      }
+    } else {
+      ESP_LOGCONFIG(TAG, "  Player %zu: Not connected", i + 1);
+    }
   }
+  ESP_LOGCONFIG(TAG, "  Scanning: %s", scanning_ ? "Yes" : "No");
+  ESP_LOGCONFIG(TAG, "  Fast reconnect: %s", fast_reconnect_ ? "Yes" : "No");
 }
 
-const ControllerState *BLEGamepad::get_state() const {
-  if (active_controller_ == nullptr) {
+const ControllerState *BLEGamepad::get_state(uint8_t player) const {
+  if (player < 1 || player > MAX_SESSIONS || !sessions_[player - 1].current_state.connected) {
     return nullptr;
   }
-  return &active_controller_->get_state();
+  return &sessions_[player - 1].current_state;
+}
+
+bool BLEGamepad::is_connected() const {
+  if (gattc_if_ == ESP_GATT_IF_NONE) {
+    return false;
+  }
+  for (const auto &session : sessions_) {
+    if (session.controller != nullptr) {
+      return true;
+    }
+  }
+  return false;
 }
 
 void BLEGamepad::start_scan_() {
@@ -207,6 +286,12 @@ void BLEGamepad::gap_event_handler(esp_gap_ble_cb_event_t event, esp_ble_gap_cb_
       break;
 
     case ESP_GAP_BLE_AUTH_CMPL_EVT: {
+      Session *found = this->find_session_(param->ble_security.auth_cmpl.bd_addr);
+      if (found == nullptr) {
+        break;  // Not one of our controllers
+      }
+      Session &session = *found;
+
       // Authentication/pairing complete - now safe to do GATT operations
       if (param->ble_security.auth_cmpl.success) {
         ESP_LOGI(TAG, "Authentication success with " ESP_BD_ADDR_STR,
@@ -217,19 +302,21 @@ void BLEGamepad::gap_event_handler(esp_gap_ble_cb_event_t event, esp_ble_gap_cb_
 
         // Following bluepad32's sequence: Query Device Information Service FIRST
         // This reads PnP ID (VID/PID) which may be required for controller to activate
-        if (this->connected_ && this->gattc_if_ != ESP_GATT_IF_NONE) {
+        if (session.connected && this->gattc_if_ != ESP_GATT_IF_NONE && session.using_cache) {
+          this->start_cached_init_(session, this->gattc_if_);
+        } else if (session.connected && this->gattc_if_ != ESP_GATT_IF_NONE) {
           ESP_LOGI(TAG, "Searching for Device Information Service (DIS)");
           // Search for DIS service (0x180A) specifically
           esp_bt_uuid_t dis_uuid;
           dis_uuid.len = ESP_UUID_LEN_16;
           dis_uuid.uuid.uuid16 = DIS_SERVICE_UUID;
-          esp_ble_gattc_search_service(this->gattc_if_, this->conn_id_, &dis_uuid);
+          esp_ble_gattc_search_service(this->gattc_if_, session.conn_id, &dis_uuid);
         }
       } else {
         ESP_LOGE(TAG, "Authentication failed with " ESP_BD_ADDR_STR " (reason: %d)",
                  ESP_BD_ADDR_HEX(param->ble_security.auth_cmpl.bd_addr), param->ble_security.auth_cmpl.fail_reason);
         // Disconnect and retry
-        this->disconnect_();
+        this->disconnect_(session);
       }
       break;
     }
@@ -243,6 +330,22 @@ void BLEGamepad::gap_event_handler(esp_gap_ble_cb_event_t event, esp_ble_gap_cb_
       ESP_LOGI(TAG, "Bond device removed, status: %d", param->remove_bond_dev_cmpl.status);
       break;
 
+    case ESP_GAP_BLE_UPDATE_CONN_PARAMS_EVT: {
+      const auto &p = param->update_conn_params;
+      Session *session = this->find_session_(p.bda);
+      if (session == nullptr || !session->connected) {
+        break;  // Another connection's parameters
+      }
+      if (p.status != ESP_BT_STATUS_SUCCESS) {
+        ESP_LOGW(TAG, "Connection parameter update failed, status: %d", p.status);
+        break;
+      }
+      session->conn_interval = p.conn_int;
+      ESP_LOGI(TAG, "Player %u connection parameters: interval=%.2fms latency=%u timeout=%ums",
+               this->player_of_(*session), p.conn_int * 1.25f, p.latency, p.timeout * 10u);
+      break;
+    }
+
     default:
       ESP_LOGD(TAG, "Unhandled GAP event: %d", event);
       break;
@@ -250,8 +353,8 @@ void BLEGamepad::gap_event_handler(esp_gap_ble_cb_event_t event, esp_ble_gap_cb_
 }
 
 void BLEGamepad::gap_scan_event_handler(const esp32_ble::BLEScanResult &scan_result) {
-  // Only process inquiry results when not connected
-  if (this->connected_)
+  // Only process inquiry results while looking for a controller
+  if (!this->scanning_)
     return;
 
   // Check if device has HID service UUID or gamepad indicators
@@ -313,19 +416,21 @@ void BLEGamepad::gap_scan_event_handler(const esp32_ble::BLEScanResult &scan_res
 
   if (is_hid_device) {
     // Check if already connecting (prevents multiple connection attempts from repeated advertising packets)
-    if (!this->scanning_) {
-      return;  // Already initiated connection
+    if (!this->scanning_ || this->find_session_(scan_result.bda) != nullptr) {
+      return;  // Already initiated connection, or already connected
+    }
+    Session *session = this->acquire_session_(scan_result.bda);
+    if (session == nullptr) {
+      return;  // All player slots taken
     }
 
-    ESP_LOGI(TAG, "Found HID/gamepad device: " ESP_BD_ADDR_STR, ESP_BD_ADDR_HEX(scan_result.bda));
+    ESP_LOGI(TAG, "Found HID/gamepad device: " ESP_BD_ADDR_STR " (player %u)", ESP_BD_ADDR_HEX(scan_result.bda),
+             this->player_of_(*session));
 
     // Stop scanning and connect
     esp_ble_gap_stop_scanning();
     this->scanning_ = false;
-
-    // Save address and connect
-    memcpy(this->remote_bda_, scan_result.bda, sizeof(esp_bd_addr_t));
-    this->connect_to_device_(this->remote_bda_);
+    this->connect_to_device_(*session);
   }
 }
 
@@ -341,6 +446,45 @@ void BLEGamepad::gattc_event_handler(esp_gattc_cb_event_t event, esp_gatt_if_t g
     return;
   }
 
+  // Route everything but registration to the controller's session
+  Session *found = nullptr;
+  switch (event) {
+    case ESP_GATTC_REG_EVT:
+      break;
+    case ESP_GATTC_OPEN_EVT:
+      found = this->find_session_(param->open.remote_bda);
+      break;
+    case ESP_GATTC_CLOSE_EVT:
+      found = this->find_session_(param->close.remote_bda);
+      break;
+    case ESP_GATTC_SEARCH_RES_EVT:
+      found = this->find_session_(param->search_res.conn_id);
+      break;
+    case ESP_GATTC_SEARCH_CMPL_EVT:
+      found = this->find_session_(param->search_cmpl.conn_id);
+      break;
+    case ESP_GATTC_READ_CHAR_EVT:
+      found = this->find_session_(param->read.conn_id);
+      break;
+    case ESP_GATTC_WRITE_CHAR_EVT:
+    case ESP_GATTC_WRITE_DESCR_EVT:
+      found = this->find_session_(param->write.conn_id);
+      break;
+    case ESP_GATTC_REG_FOR_NOTIFY_EVT:
+      found = this->setup_session_();  // Carries no conn_id; only the session being set up registers
+      break;
+    case ESP_GATTC_NOTIFY_EVT:
+      found = this->find_session_(param->notify.conn_id);
+      break;
+    default:
+      ESP_LOGD(TAG, "Unhandled GATT event: %d", event);
+      return;
+  }
+  if (event != ESP_GATTC_REG_EVT && found == nullptr) {
+    ESP_LOGD(TAG, "GATT event %d for a connection we don't track, ignoring", event);
+    return;
+  }
+
   switch (event) {
     case ESP_GATTC_REG_EVT: {
       if (param->reg.status == ESP_GATT_OK) {
@@ -366,8 +510,8 @@ void BLEGamepad::gattc_event_handler(esp_gattc_cb_event_t event, esp_gatt_if_t g
 
         ESP_LOGI(TAG, "BLE security configured (bonding enabled, IO cap: none)");
 
-        // Start scanning for HID devices now that GATT client is registered
-        this->start_scan_();
+        // Connect to a known controller, or scan for HID devices now that GATT client is registered
+        this->reconnect_();
       } else {
         ESP_LOGE(TAG, "GATT client registration failed, status: %d", param->reg.status);
       }
@@ -375,13 +519,17 @@ void BLEGamepad::gattc_event_handler(esp_gattc_cb_event_t event, esp_gatt_if_t g
     }
 
     case ESP_GATTC_OPEN_EVT: {
+      Session &session = *found;
       if (param->open.status == ESP_GATT_OK) {
-        this->conn_id_ = param->open.conn_id;
-        this->connected_ = true;
-        ESP_LOGI(TAG, "Connected to device: " ESP_BD_ADDR_STR, ESP_BD_ADDR_HEX(param->open.remote_bda));
+        session.conn_id = param->open.conn_id;
+        session.connected = true;
+        session.conn_interval = 0;
+        this->direct_connecting_ = false;
+        ESP_LOGI(TAG, "Connected to device: " ESP_BD_ADDR_STR " (player %u)", ESP_BD_ADDR_HEX(param->open.remote_bda),
+                 this->player_of_(session));
 
-        // Save the remote address for pairing
-        memcpy(this->remote_bda_, param->open.remote_bda, sizeof(esp_bd_addr_t));
+        // The cache is only trusted after encryption, once the PnP ID confirms it
+        session.using_cache = this->fast_reconnect_ && this->load_handle_cache_(session.remote_bda);
 
         // Update MTU
         esp_ble_gattc_send_mtu_req(gattc_if, param->open.conn_id);
@@ -392,11 +540,16 @@ void BLEGamepad::gattc_event_handler(esp_gattc_cb_event_t event, esp_gatt_if_t g
         esp_err_t ret = esp_ble_set_encryption(param->open.remote_bda, ESP_BLE_SEC_ENCRYPT);
         if (ret != ESP_OK) {
           ESP_LOGE(TAG, "Failed to initiate encryption: %s", esp_err_to_name(ret));
-          this->disconnect_();
+          this->disconnect_(session);
         }
       } else {
-        ESP_LOGE(TAG, "Connection failed, status: %d", param->open.status);
-        this->connected_ = false;
+        if (this->direct_connecting_) {
+          ESP_LOGI(TAG, "Bonded controller not reachable (status: %d), scanning instead", param->open.status);
+        } else {
+          ESP_LOGE(TAG, "Connection failed, status: %d", param->open.status);
+        }
+        this->direct_connecting_ = false;
+        this->release_session_(session);
         // Restart scanning
         this->start_scan_();
       }
@@ -404,22 +557,18 @@ void BLEGamepad::gattc_event_handler(esp_gattc_cb_event_t event, esp_gatt_if_t g
     }
 
     case ESP_GATTC_CLOSE_EVT: {
-      ESP_LOGI(TAG, "Disconnected from device");
-      this->connected_ = false;
+      Session &session = *found;
+      ESP_LOGI(TAG, "Player %u disconnected", this->player_of_(session));
       // Note: gattc_if_ remains valid for the app ID registration, don't reset
+      this->release_session_(session);
 
-      if (this->active_controller_) {
-        this->active_controller_->on_disconnect();
-        this->active_controller_.reset();
-        this->on_disconnect_callbacks_.call();
-      }
-
-      // Restart scanning
-      this->start_scan_();
+      // A sleeping controller comes back to the same address, so try that before scanning
+      this->reconnect_();
       break;
     }
 
     case ESP_GATTC_SEARCH_RES_EVT: {
+      Session &session = *found;
       // Service discovered
       esp_gatt_id_t *srvc_id = &param->search_res.srvc_id;
       if (srvc_id->uuid.len == ESP_UUID_LEN_16) {
@@ -428,23 +577,24 @@ void BLEGamepad::gattc_event_handler(esp_gattc_cb_event_t event, esp_gatt_if_t g
         // Check for Device Information Service (0x180A)
         if (uuid == DIS_SERVICE_UUID) {
           ESP_LOGI(TAG, "Found Device Information Service");
-          this->dis_service_start_handle_ = param->search_res.start_handle;
-          this->dis_service_end_handle_ = param->search_res.end_handle;
+          session.dis_service_start_handle = param->search_res.start_handle;
+          session.dis_service_end_handle = param->search_res.end_handle;
         }
         // Check for HID Service (0x1812)
         else if (uuid == HID_SERVICE_UUID) {
           ESP_LOGI(TAG, "Found HID service");
-          this->hid_service_start_handle_ = param->search_res.start_handle;
-          this->hid_service_end_handle_ = param->search_res.end_handle;
+          session.hid_service_start_handle = param->search_res.start_handle;
+          session.hid_service_end_handle = param->search_res.end_handle;
         }
       }
       break;
     }
 
     case ESP_GATTC_SEARCH_CMPL_EVT: {
+      Session &session = *found;
       if (param->search_cmpl.status != ESP_GATT_OK) {
         ESP_LOGE(TAG, "Service discovery failed");
-        this->disconnect_();
+        this->disconnect_(session);
         break;
       }
 
@@ -452,32 +602,32 @@ void BLEGamepad::gattc_event_handler(esp_gattc_cb_event_t event, esp_gatt_if_t g
 
       // Check if DIS was searched for but not found (both handles still 0)
       // This happens when Xbox controller doesn't have DIS service
-      if (this->dis_service_start_handle_ == 0 && this->hid_service_start_handle_ == 0) {
-        if (this->service_discovery_retries_ >= MAX_DISCOVERY_RETRIES) {
+      if (session.dis_service_start_handle == 0 && session.hid_service_start_handle == 0) {
+        if (session.service_discovery_retries >= MAX_DISCOVERY_RETRIES) {
           ESP_LOGE(TAG, "Service discovery failed after %d retries - no DIS or HID services found",
                    MAX_DISCOVERY_RETRIES);
-          this->disconnect_();
+          this->disconnect_(session);
           break;
         }
-        this->service_discovery_retries_++;
+        session.service_discovery_retries++;
         ESP_LOGI(TAG, "DIS service not found, searching for HID service (attempt %d/%d)",
-                 this->service_discovery_retries_, MAX_DISCOVERY_RETRIES);
+                 session.service_discovery_retries, MAX_DISCOVERY_RETRIES);
         esp_bt_uuid_t hid_uuid;
         hid_uuid.len = ESP_UUID_LEN_16;
         hid_uuid.uuid.uuid16 = HID_SERVICE_UUID;
-        esp_ble_gattc_search_service(this->gattc_if_, this->conn_id_, &hid_uuid);
+        esp_ble_gattc_search_service(this->gattc_if_, session.conn_id, &hid_uuid);
         break;
       }
 
       // Check if we just discovered DIS service
-      if (this->dis_service_start_handle_ != 0 && this->hid_service_start_handle_ == 0) {
+      if (session.dis_service_start_handle != 0 && session.hid_service_start_handle == 0) {
         // DIS service discovery complete - now read PnP ID
         ESP_LOGI(TAG, "DIS service discovered, searching for PnP ID characteristic");
 
         uint16_t char_count = 0;
         esp_gatt_status_t status = esp_ble_gattc_get_attr_count(
-            gattc_if, this->conn_id_, ESP_GATT_DB_CHARACTERISTIC, this->dis_service_start_handle_,
-            this->dis_service_end_handle_, ESP_GATT_INVALID_HANDLE, &char_count);
+            gattc_if, session.conn_id, ESP_GATT_DB_CHARACTERISTIC, session.dis_service_start_handle,
+            session.dis_service_end_handle, ESP_GATT_INVALID_HANDLE, &char_count);
 
         if (status != ESP_GATT_OK || char_count == 0) {
           ESP_LOGW(TAG, "No characteristics found in DIS service, proceeding to HID discovery");
@@ -485,7 +635,7 @@ void BLEGamepad::gattc_event_handler(esp_gattc_cb_event_t event, esp_gatt_if_t g
           esp_bt_uuid_t hid_uuid;
           hid_uuid.len = ESP_UUID_LEN_16;
           hid_uuid.uuid.uuid16 = HID_SERVICE_UUID;
-          esp_ble_gattc_search_service(this->gattc_if_, this->conn_id_, &hid_uuid);
+          esp_ble_gattc_search_service(this->gattc_if_, session.conn_id, &hid_uuid);
           break;
         }
 
@@ -493,8 +643,8 @@ void BLEGamepad::gattc_event_handler(esp_gattc_cb_event_t event, esp_gatt_if_t g
         auto char_elems = std::make_unique<esp_gattc_char_elem_t[]>(char_count);
         uint16_t actual_count = char_count;
 
-        status = esp_ble_gattc_get_all_char(gattc_if, this->conn_id_, this->dis_service_start_handle_,
-                                            this->dis_service_end_handle_, char_elems.get(), &actual_count, 0);
+        status = esp_ble_gattc_get_all_char(gattc_if, session.conn_id, session.dis_service_start_handle,
+                                            session.dis_service_end_handle, char_elems.get(), &actual_count, 0);
 
         if (status != ESP_GATT_OK) {
           ESP_LOGW(TAG, "Failed to get DIS characteristics, proceeding to HID discovery");
@@ -503,7 +653,7 @@ void BLEGamepad::gattc_event_handler(esp_gattc_cb_event_t event, esp_gatt_if_t g
           esp_bt_uuid_t hid_uuid;
           hid_uuid.len = ESP_UUID_LEN_16;
           hid_uuid.uuid.uuid16 = HID_SERVICE_UUID;
-          esp_ble_gattc_search_service(this->gattc_if_, this->conn_id_, &hid_uuid);
+          esp_ble_gattc_search_service(this->gattc_if_, session.conn_id, &hid_uuid);
           break;
         }
 
@@ -511,44 +661,44 @@ void BLEGamepad::gattc_event_handler(esp_gattc_cb_event_t event, esp_gatt_if_t g
         for (uint16_t i = 0; i < actual_count; i++) {
           if (char_elems[i].uuid.len == ESP_UUID_LEN_16 && char_elems[i].uuid.uuid.uuid16 == DIS_PNP_ID_UUID) {
             ESP_LOGI(TAG, "Found PnP ID characteristic, handle: %04x", char_elems[i].char_handle);
-            this->dis_pnp_id_handle_ = char_elems[i].char_handle;
+            session.dis_pnp_id_handle = char_elems[i].char_handle;
             break;
           }
         }
         // char_elems automatically cleaned up by unique_ptr at end of scope
 
-        if (this->dis_pnp_id_handle_ != 0) {
+        if (session.dis_pnp_id_handle != 0) {
           // Read PnP ID to get VID/PID
-          this->init_state_ = InitState::READING_DIS_PNPID;
+          session.init_state = InitState::READING_DIS_PNPID;
           ESP_LOGI(TAG, "Reading PnP ID");
-          esp_ble_gattc_read_char(gattc_if, this->conn_id_, this->dis_pnp_id_handle_, ESP_GATT_AUTH_REQ_NONE);
+          esp_ble_gattc_read_char(gattc_if, session.conn_id, session.dis_pnp_id_handle, ESP_GATT_AUTH_REQ_NONE);
         } else {
           ESP_LOGW(TAG, "PnP ID characteristic not found, proceeding to HID discovery");
           // Proceed to HID service discovery
           esp_bt_uuid_t hid_uuid;
           hid_uuid.len = ESP_UUID_LEN_16;
           hid_uuid.uuid.uuid16 = HID_SERVICE_UUID;
-          esp_ble_gattc_search_service(this->gattc_if_, this->conn_id_, &hid_uuid);
+          esp_ble_gattc_search_service(this->gattc_if_, session.conn_id, &hid_uuid);
         }
         break;
       }
 
       // HID service discovery complete
-      if (this->hid_service_start_handle_ == 0) {
+      if (session.hid_service_start_handle == 0) {
         ESP_LOGW(TAG, "HID service not found");
-        this->disconnect_();
+        this->disconnect_(session);
         break;
       }
 
       // Get all characteristics in HID service (synchronous call)
       uint16_t char_count = 0;
       esp_gatt_status_t status = esp_ble_gattc_get_attr_count(
-          gattc_if, this->conn_id_, ESP_GATT_DB_CHARACTERISTIC, this->hid_service_start_handle_,
-          this->hid_service_end_handle_, ESP_GATT_INVALID_HANDLE, &char_count);
+          gattc_if, session.conn_id, ESP_GATT_DB_CHARACTERISTIC, session.hid_service_start_handle,
+          session.hid_service_end_handle, ESP_GATT_INVALID_HANDLE, &char_count);
 
       if (status != ESP_GATT_OK || char_count == 0) {
         ESP_LOGE(TAG, "Failed to get characteristic count");
-        this->disconnect_();
+        this->disconnect_(session);
         break;
       }
 
@@ -558,13 +708,13 @@ void BLEGamepad::gattc_event_handler(esp_gattc_cb_event_t event, esp_gatt_if_t g
       auto char_elems = std::make_unique<esp_gattc_char_elem_t[]>(char_count);
       uint16_t actual_count = char_count;
 
-      status = esp_ble_gattc_get_all_char(gattc_if, this->conn_id_, this->hid_service_start_handle_,
-                                          this->hid_service_end_handle_, char_elems.get(), &actual_count, 0);
+      status = esp_ble_gattc_get_all_char(gattc_if, session.conn_id, session.hid_service_start_handle,
+                                          session.hid_service_end_handle, char_elems.get(), &actual_count, 0);
 
       if (status != ESP_GATT_OK) {
         ESP_LOGE(TAG, "Failed to get characteristics");
         // char_elems automatically cleaned up by unique_ptr
-        this->disconnect_();
+        this->disconnect_(session);
         break;
       }
 
@@ -577,17 +727,17 @@ void BLEGamepad::gattc_event_handler(esp_gattc_cb_event_t event, esp_gatt_if_t g
           // Find HID Information (0x2A4A) - required for HOGP
           if (uuid == HID_INFO_UUID) {
             ESP_LOGI(TAG, "Found HID Information characteristic, handle: %04x", char_elems[i].char_handle);
-            this->hid_info_handle_ = char_elems[i].char_handle;
+            session.hid_info_handle = char_elems[i].char_handle;
           }
           // Find HID Report Map (0x2A4B) - CRITICAL for Xbox pairing
           else if (uuid == HID_REPORT_MAP_UUID) {
             ESP_LOGI(TAG, "Found HID Report Map characteristic, handle: %04x", char_elems[i].char_handle);
-            this->hid_report_map_handle_ = char_elems[i].char_handle;
+            session.hid_report_map_handle = char_elems[i].char_handle;
           }
           // Find Protocol Mode (0x2A4E) - optional for Report-only devices
           else if (uuid == PROTOCOL_MODE_UUID) {
             ESP_LOGI(TAG, "Found Protocol Mode characteristic, handle: %04x", char_elems[i].char_handle);
-            this->protocol_mode_handle_ = char_elems[i].char_handle;
+            session.protocol_mode_handle = char_elems[i].char_handle;
           }
           // Find HID Report (0x2A4D) - input/output/feature reports
           else if (uuid == HID_REPORT_UUID) {
@@ -598,15 +748,15 @@ void BLEGamepad::gattc_event_handler(esp_gattc_cb_event_t event, esp_gatt_if_t g
 
             // Get descriptors for this characteristic (CCC for notifications)
             uint16_t descr_count = 0;
-            status = esp_ble_gattc_get_attr_count(gattc_if, this->conn_id_, ESP_GATT_DB_DESCRIPTOR,
-                                                  this->hid_service_start_handle_, this->hid_service_end_handle_,
+            status = esp_ble_gattc_get_attr_count(gattc_if, session.conn_id, ESP_GATT_DB_DESCRIPTOR,
+                                                  session.hid_service_start_handle, session.hid_service_end_handle,
                                                   char_elems[i].char_handle, &descr_count);
 
             if (status == ESP_GATT_OK && descr_count > 0) {
               auto descr_elems = std::make_unique<esp_gattc_descr_elem_t[]>(descr_count);
               uint16_t actual_descr_count = descr_count;
 
-              status = esp_ble_gattc_get_all_descr(gattc_if, this->conn_id_, char_elems[i].char_handle,
+              status = esp_ble_gattc_get_all_descr(gattc_if, session.conn_id, char_elems[i].char_handle,
                                                    descr_elems.get(), &actual_descr_count, 0);
 
               if (status == ESP_GATT_OK) {
@@ -624,7 +774,7 @@ void BLEGamepad::gattc_event_handler(esp_gattc_cb_event_t event, esp_gatt_if_t g
             }
 
             // Store this HID Report characteristic
-            this->hid_report_chars_.push_back(report_char);
+            session.hid_report_chars.push_back(report_char);
             ESP_LOGI(TAG, "Stored HID Report char_handle=%04x, ccc_handle=%04x", report_char.char_handle,
                      report_char.ccc_handle);
           }
@@ -633,16 +783,16 @@ void BLEGamepad::gattc_event_handler(esp_gattc_cb_event_t event, esp_gatt_if_t g
       // char_elems automatically cleaned up by unique_ptr at end of scope
 
       // Validate required characteristics were found
-      if (this->hid_report_chars_.empty()) {
+      if (session.hid_report_chars.empty()) {
         ESP_LOGE(TAG, "No HID Report characteristics found");
-        this->disconnect_();
+        this->disconnect_(session);
         break;
       }
-      ESP_LOGI(TAG, "Found %zu HID Report characteristic(s)", this->hid_report_chars_.size());
+      ESP_LOGI(TAG, "Found %zu HID Report characteristic(s)", session.hid_report_chars.size());
 
       // Check if at least one has CCC descriptor
       bool has_ccc = false;
-      for (const auto &report : this->hid_report_chars_) {
+      for (const auto &report : session.hid_report_chars) {
         if (report.ccc_handle != 0) {
           has_ccc = true;
           break;
@@ -656,62 +806,65 @@ void BLEGamepad::gattc_event_handler(esp_gattc_cb_event_t event, esp_gatt_if_t g
       // Order: HID Info → Report Map → Protocol Mode → Enable Notifications
       ESP_LOGI(TAG, "Starting HOGP initialization sequence");
 
-      if (this->hid_info_handle_ != 0) {
+      if (session.hid_info_handle != 0) {
         // Step 1: Read HID Information
-        this->init_state_ = InitState::READING_HID_INFO;
+        session.init_state = InitState::READING_HID_INFO;
         ESP_LOGI(TAG, "Reading HID Information");
-        esp_ble_gattc_read_char(gattc_if, this->conn_id_, this->hid_info_handle_, ESP_GATT_AUTH_REQ_NONE);
-      } else if (this->hid_report_map_handle_ != 0) {
+        esp_ble_gattc_read_char(gattc_if, session.conn_id, session.hid_info_handle, ESP_GATT_AUTH_REQ_NONE);
+      } else if (session.hid_report_map_handle != 0) {
         // Step 2: Skip to Report Map if HID Info not found
-        this->init_state_ = InitState::READING_REPORT_MAP;
+        session.init_state = InitState::READING_REPORT_MAP;
         ESP_LOGI(TAG, "Reading HID Report Map (HID Info not found, skipping)");
-        esp_ble_gattc_read_char(gattc_if, this->conn_id_, this->hid_report_map_handle_, ESP_GATT_AUTH_REQ_NONE);
+        esp_ble_gattc_read_char(gattc_if, session.conn_id, session.hid_report_map_handle, ESP_GATT_AUTH_REQ_NONE);
       } else {
         // Both missing - log warning and try to continue
         ESP_LOGW(TAG, "HID Info and Report Map characteristics not found - controller may not pair properly");
-        this->init_state_ = InitState::SETTING_PROTOCOL_MODE;
+        session.init_state = InitState::SETTING_PROTOCOL_MODE;
         // Try setting protocol mode or enabling notifications
-        if (this->protocol_mode_handle_ != 0) {
+        if (session.protocol_mode_handle != 0) {
           ESP_LOGI(TAG, "Setting Protocol Mode to Report Mode");
           uint8_t report_mode = 0x01;
-          esp_ble_gattc_write_char(gattc_if, this->conn_id_, this->protocol_mode_handle_, sizeof(report_mode),
+          esp_ble_gattc_write_char(gattc_if, session.conn_id, session.protocol_mode_handle, sizeof(report_mode),
                                    &report_mode, ESP_GATT_WRITE_TYPE_RSP, ESP_GATT_AUTH_REQ_NONE);
         } else {
           // Enable notifications on all HID Report characteristics
-          this->enable_all_notifications_(gattc_if);
+          this->enable_all_notifications_(session, gattc_if);
         }
       }
       break;
     }
 
     case ESP_GATTC_READ_CHAR_EVT: {
+      Session &session = *found;
       // Handle characteristic read completion (DIS and HOGP initialization)
       if (param->read.status != ESP_GATT_OK) {
         ESP_LOGE(TAG, "Read characteristic failed, handle: %04x, status: %d", param->read.handle, param->read.status);
-        this->disconnect_();
+        if (!this->retry_without_cache_(session, "read failed")) {
+          this->disconnect_(session);
+        }
         break;
       }
 
       // PnP ID read complete (from Device Information Service)
-      if (param->read.handle == this->dis_pnp_id_handle_) {
+      if (param->read.handle == session.dis_pnp_id_handle) {
         ESP_LOGI(TAG, "PnP ID read complete, length: %d", param->read.value_len);
 
         // PnP ID structure: Vendor ID Source (1 byte), Vendor ID (2 bytes LE), Product ID (2 bytes LE), Product Version
         // (2 bytes LE)
         if (param->read.value_len >= 7) {
           uint8_t vendor_id_source = param->read.value[0];
-          this->vendor_id_ = (param->read.value[2] << 8) | param->read.value[1];
-          this->product_id_ = (param->read.value[4] << 8) | param->read.value[3];
+          session.vendor_id = (param->read.value[2] << 8) | param->read.value[1];
+          session.product_id = (param->read.value[4] << 8) | param->read.value[3];
           uint16_t product_version = (param->read.value[6] << 8) | param->read.value[5];
 
-          ESP_LOGI(TAG, "  Vendor ID: 0x%04x, Product ID: 0x%04x, Version: 0x%04x", this->vendor_id_, this->product_id_,
-                   product_version);
+          ESP_LOGI(TAG, "  Vendor ID: 0x%04x, Product ID: 0x%04x, Version: 0x%04x", session.vendor_id,
+                   session.product_id, product_version);
 
           // Identify controller type
-          if (this->vendor_id_ == 0x045e) {  // Microsoft
-            if (this->product_id_ == 0x02e0) {
+          if (session.vendor_id == MICROSOFT_VENDOR_ID) {
+            if (session.product_id == 0x02e0) {
               ESP_LOGI(TAG, "  Detected: Xbox One BLE controller");
-            } else if (this->product_id_ == 0x0b20) {
+            } else if (session.product_id == 0x0b20) {
               ESP_LOGI(TAG, "  Detected: Xbox Series X/S controller");
             } else {
               ESP_LOGI(TAG, "  Detected: Microsoft controller (unknown model)");
@@ -719,17 +872,27 @@ void BLEGamepad::gattc_event_handler(esp_gattc_cb_event_t event, esp_gatt_if_t g
           }
         }
 
+        if (session.using_cache) {
+          // Same controller as when the handles were cached: skip straight past discovery
+          if (session.vendor_id != this->cache_.vendor_id || session.product_id != this->cache_.product_id) {
+            this->retry_without_cache_(session, "PnP ID changed");
+          } else {
+            this->finish_cached_init_(session, gattc_if);
+          }
+          break;
+        }
+
         // After reading PnP ID, proceed to HID service discovery
         ESP_LOGI(TAG, "DIS query complete, searching for HID service");
         esp_bt_uuid_t hid_uuid;
         hid_uuid.len = ESP_UUID_LEN_16;
         hid_uuid.uuid.uuid16 = HID_SERVICE_UUID;
-        esp_ble_gattc_search_service(this->gattc_if_, this->conn_id_, &hid_uuid);
+        esp_ble_gattc_search_service(this->gattc_if_, session.conn_id, &hid_uuid);
         break;
       }
 
       // HID Information read complete
-      if (param->read.handle == this->hid_info_handle_) {
+      if (param->read.handle == session.hid_info_handle) {
         ESP_LOGI(TAG, "HID Information read complete, length: %d", param->read.value_len);
         if (param->read.value_len >= 4) {
           uint16_t bcd_hid = (param->read.value[1] << 8) | param->read.value[0];
@@ -739,47 +902,47 @@ void BLEGamepad::gattc_event_handler(esp_gattc_cb_event_t event, esp_gatt_if_t g
         }
 
         // Step 2: Read HID Report Map
-        if (this->hid_report_map_handle_ != 0) {
-          this->init_state_ = InitState::READING_REPORT_MAP;
+        if (session.hid_report_map_handle != 0) {
+          session.init_state = InitState::READING_REPORT_MAP;
           ESP_LOGI(TAG, "Reading HID Report Map");
-          esp_ble_gattc_read_char(gattc_if, this->conn_id_, this->hid_report_map_handle_, ESP_GATT_AUTH_REQ_NONE);
+          esp_ble_gattc_read_char(gattc_if, session.conn_id, session.hid_report_map_handle, ESP_GATT_AUTH_REQ_NONE);
         } else {
           // Skip to Protocol Mode if Report Map not found
-          this->init_state_ = InitState::SETTING_PROTOCOL_MODE;
+          session.init_state = InitState::SETTING_PROTOCOL_MODE;
           ESP_LOGW(TAG, "HID Report Map not found - skipping to Protocol Mode");
-          if (this->protocol_mode_handle_ != 0) {
+          if (session.protocol_mode_handle != 0) {
             ESP_LOGI(TAG, "Setting Protocol Mode to Report Mode");
             uint8_t report_mode = 0x01;
-            esp_ble_gattc_write_char(gattc_if, this->conn_id_, this->protocol_mode_handle_, sizeof(report_mode),
+            esp_ble_gattc_write_char(gattc_if, session.conn_id, session.protocol_mode_handle, sizeof(report_mode),
                                      &report_mode, ESP_GATT_WRITE_TYPE_RSP, ESP_GATT_AUTH_REQ_NONE);
           } else {
             // Skip to enabling notifications
-            this->enable_all_notifications_(gattc_if);
+            this->enable_all_notifications_(session, gattc_if);
           }
         }
       }
       // HID Report Map read complete (CRITICAL for Xbox pairing)
-      else if (param->read.handle == this->hid_report_map_handle_) {
+      else if (param->read.handle == session.hid_report_map_handle) {
         ESP_LOGI(TAG, "HID Report Map read complete, length: %d bytes", param->read.value_len);
 
         // Store report map for future parsing (Xbox requires this read to complete pairing)
-        this->hid_report_map_.assign(param->read.value, param->read.value + param->read.value_len);
-        ESP_LOGI(TAG, "Stored HID Report Map (%zu bytes)", this->hid_report_map_.size());
+        session.hid_report_map.assign(param->read.value, param->read.value + param->read.value_len);
+        ESP_LOGI(TAG, "Stored HID Report Map (%zu bytes)", session.hid_report_map.size());
 
         // Step 3: Set Protocol Mode (if available)
-        if (this->protocol_mode_handle_ != 0) {
-          this->init_state_ = InitState::SETTING_PROTOCOL_MODE;
+        if (session.protocol_mode_handle != 0) {
+          session.init_state = InitState::SETTING_PROTOCOL_MODE;
           ESP_LOGI(TAG, "Setting Protocol Mode to Report Mode");
           uint8_t report_mode = 0x01;  // Report Protocol Mode
-          esp_ble_gattc_write_char(gattc_if, this->conn_id_, this->protocol_mode_handle_, sizeof(report_mode),
+          esp_ble_gattc_write_char(gattc_if, session.conn_id, session.protocol_mode_handle, sizeof(report_mode),
                                    &report_mode, ESP_GATT_WRITE_TYPE_RSP, ESP_GATT_AUTH_REQ_NONE);
         } else {
           // Step 4: Enable notifications (Protocol Mode not present)
-          this->enable_all_notifications_(gattc_if);
+          this->enable_all_notifications_(session, gattc_if);
         }
       }
       // Initial HID Report read complete (to "prime" controller)
-      else if (this->init_state_ == InitState::READING_INITIAL_REPORT) {
+      else if (session.init_state == InitState::READING_INITIAL_REPORT) {
         ESP_LOGI(TAG, "Initial HID Report read complete, length: %d bytes", param->read.value_len);
 
         // Log the report data for debugging
@@ -791,32 +954,39 @@ void BLEGamepad::gattc_event_handler(esp_gattc_cb_event_t event, esp_gatt_if_t g
         }
 
         // HOGP initialization complete - create controller instance
-        this->init_state_ = InitState::COMPLETE;
-        this->service_discovery_retries_ = 0;  // Reset retry counter on successful connection
-
-        // Xbox-only limitation: Among common console controllers, only Xbox supports standard BLE HID
-        // - Xbox One S/X/Series (Model 1708+, revision 1914) use BLE HID Profile
-        // - PlayStation controllers use proprietary Bluetooth protocols (not standard HID)
-        // - Switch Pro controllers require reverse-engineered HID report descriptors
-        // Future: Could detect controller type via VID/PID from DIS PnP ID characteristic
-        this->active_controller_ = std::make_unique<XboxController>();
-        if (this->active_controller_) {
-          this->active_controller_->on_connect();
-          this->on_connect_callbacks_.call();
-          ESP_LOGI(TAG, "HOGP initialization complete - Controller ready: %s",
-                   this->active_controller_->get_controller_type());
+        session.init_state = InitState::COMPLETE;
+        session.service_discovery_retries = 0;  // Reset retry counter on successful connection
+        if (!session.using_cache) {
+          this->save_handle_cache_(session);
         }
+
+        // Controllers default to a slow 30-50ms interval; ask for ours now that pairing and
+        // setup traffic is done (every reconnect passes through here again)
+        this->request_conn_params_(session);
+
+        session.controller = this->create_controller_(session);
+        if (session.controller) {
+          session.controller->on_connect();
+          this->publish_state_(session, session.controller->get_state());
+          this->on_connect_callbacks_.call(this->player_of_(session));
+          ESP_LOGI(TAG, "HOGP initialization complete - Player %u ready: %s", this->player_of_(session),
+                   session.controller->get_controller_type());
+        }
+
+        // Look for the next controller if there are player slots left
+        this->reconnect_();
       }
       break;
     }
 
     case ESP_GATTC_WRITE_CHAR_EVT: {
+      Session &session = *found;
       // Protocol Mode write complete
-      if (param->write.status == ESP_GATT_OK && param->write.handle == this->protocol_mode_handle_) {
+      if (param->write.status == ESP_GATT_OK && param->write.handle == session.protocol_mode_handle) {
         ESP_LOGI(TAG, "Protocol Mode set successfully");
 
         // Step 4: Enable notifications on all HID Report characteristics
-        this->enable_all_notifications_(gattc_if);
+        this->enable_all_notifications_(session, gattc_if);
       } else if (param->write.status != ESP_GATT_OK) {
         ESP_LOGE(TAG, "Failed to set Protocol Mode, status: %d", param->write.status);
       }
@@ -824,40 +994,44 @@ void BLEGamepad::gattc_event_handler(esp_gattc_cb_event_t event, esp_gatt_if_t g
     }
 
     case ESP_GATTC_REG_FOR_NOTIFY_EVT: {
+      Session &session = *found;
       // Notification registration complete (Bluedroid requirement)
       if (param->reg_for_notify.status == ESP_GATT_OK) {
         // Verify this is for our current characteristic
-        if (this->current_notify_index_ < this->hid_report_chars_.size() &&
-            param->reg_for_notify.handle == this->hid_report_chars_[this->current_notify_index_].char_handle) {
+        if (session.current_notify_index < session.hid_report_chars.size() &&
+            param->reg_for_notify.handle == session.hid_report_chars[session.current_notify_index].char_handle) {
           ESP_LOGI(TAG, "Notification registration successful for handle=%04x",
-                   this->hid_report_chars_[this->current_notify_index_].char_handle);
+                   session.hid_report_chars[session.current_notify_index].char_handle);
 
           // Now write CCC descriptor to enable notifications for this characteristic
-          this->init_state_ = InitState::ENABLING_NOTIFICATIONS;
+          session.init_state = InitState::ENABLING_NOTIFICATIONS;
           uint16_t notify_enable = 1;
-          uint16_t ccc_handle = this->hid_report_chars_[this->current_notify_index_].ccc_handle;
+          uint16_t ccc_handle = session.hid_report_chars[session.current_notify_index].ccc_handle;
 
           ESP_LOGI(TAG, "Writing CCC descriptor (handle=%04x) to enable notifications", ccc_handle);
-          esp_ble_gattc_write_char_descr(gattc_if, this->conn_id_, ccc_handle, sizeof(notify_enable),
+          esp_ble_gattc_write_char_descr(gattc_if, session.conn_id, ccc_handle, sizeof(notify_enable),
                                          (uint8_t *) &notify_enable, ESP_GATT_WRITE_TYPE_RSP, ESP_GATT_AUTH_REQ_NONE);
         } else {
           ESP_LOGW(TAG, "REG_FOR_NOTIFY event for unexpected handle=%04x (current index=%zu)",
-                   param->reg_for_notify.handle, this->current_notify_index_);
+                   param->reg_for_notify.handle, session.current_notify_index);
         }
       } else {
         ESP_LOGE(TAG, "Failed to register for notifications on handle=%04x, status: %d", param->reg_for_notify.handle,
                  param->reg_for_notify.status);
-        this->disconnect_();
+        if (!this->retry_without_cache_(session, "notification registration failed")) {
+          this->disconnect_(session);
+        }
       }
       break;
     }
 
     case ESP_GATTC_WRITE_DESCR_EVT: {
+      Session &session = *found;
       // CCC descriptor write complete for one characteristic
       if (param->write.status == ESP_GATT_OK) {
         // Check if this is one of our HID Report CCC descriptors
         bool is_hid_report_ccc = false;
-        for (const auto &report : this->hid_report_chars_) {
+        for (const auto &report : session.hid_report_chars) {
           if (report.ccc_handle == param->write.handle) {
             is_hid_report_ccc = true;
             ESP_LOGI(TAG, "CCC write complete for HID Report handle=%04x (CCC=%04x)", report.char_handle,
@@ -866,24 +1040,24 @@ void BLEGamepad::gattc_event_handler(esp_gattc_cb_event_t event, esp_gatt_if_t g
           }
         }
 
-        if (is_hid_report_ccc && this->init_state_ == InitState::ENABLING_NOTIFICATIONS) {
+        if (is_hid_report_ccc && session.init_state == InitState::ENABLING_NOTIFICATIONS) {
           // Move to next characteristic with CCC descriptor
           bool found_next = false;
-          for (size_t i = this->current_notify_index_ + 1; i < this->hid_report_chars_.size(); i++) {
-            if (this->hid_report_chars_[i].ccc_handle != 0) {
+          for (size_t i = session.current_notify_index + 1; i < session.hid_report_chars.size(); i++) {
+            if (session.hid_report_chars[i].ccc_handle != 0) {
               // Found next characteristic with CCC - register for notifications
-              this->current_notify_index_ = i;
-              this->init_state_ = InitState::REGISTERING_NOTIFICATIONS;
+              session.current_notify_index = i;
+              session.init_state = InitState::REGISTERING_NOTIFICATIONS;
               found_next = true;
 
               ESP_LOGI(TAG, "Registering for notifications: HID Report handle=%04x (next characteristic)",
-                       this->hid_report_chars_[i].char_handle);
+                       session.hid_report_chars[i].char_handle);
 
-              esp_err_t err = esp_ble_gattc_register_for_notify(gattc_if, this->remote_bda_,
-                                                                this->hid_report_chars_[i].char_handle);
+              esp_err_t err = esp_ble_gattc_register_for_notify(gattc_if, session.remote_bda,
+                                                                session.hid_report_chars[i].char_handle);
               if (err != ESP_OK) {
                 ESP_LOGE(TAG, "Failed to register for notify: %s", esp_err_to_name(err));
-                this->disconnect_();
+                this->disconnect_(session);
               }
               break;
             }
@@ -892,15 +1066,15 @@ void BLEGamepad::gattc_event_handler(esp_gattc_cb_event_t event, esp_gatt_if_t g
           if (!found_next) {
             // All CCC descriptors have been enabled - proceed to reading initial report
             ESP_LOGI(TAG, "All notifications enabled on %zu HID Report characteristic(s)",
-                     this->hid_report_chars_.size());
+                     session.hid_report_chars.size());
 
             // Xbox controllers may need an initial read to "prime" them before they start sending notifications
             // Read the first input HID Report characteristic (the one with CCC descriptor)
-            for (const auto &report : this->hid_report_chars_) {
+            for (const auto &report : session.hid_report_chars) {
               if (report.ccc_handle != 0) {
-                this->init_state_ = InitState::READING_INITIAL_REPORT;
+                session.init_state = InitState::READING_INITIAL_REPORT;
                 ESP_LOGI(TAG, "Reading initial HID Report to activate controller");
-                esp_ble_gattc_read_char(gattc_if, this->conn_id_, report.char_handle, ESP_GATT_AUTH_REQ_NONE);
+                esp_ble_gattc_read_char(gattc_if, session.conn_id, report.char_handle, ESP_GATT_AUTH_REQ_NONE);
                 break;  // Only read the first input report
               }
             }
@@ -909,16 +1083,19 @@ void BLEGamepad::gattc_event_handler(esp_gattc_cb_event_t event, esp_gatt_if_t g
       } else {
         ESP_LOGE(TAG, "Failed to write CCC descriptor handle=%04x, status: %d", param->write.handle,
                  param->write.status);
-        this->disconnect_();
+        if (!this->retry_without_cache_(session, "CCC write failed")) {
+          this->disconnect_(session);
+        }
       }
       break;
     }
 
     case ESP_GATTC_NOTIFY_EVT: {
+      Session &session = *found;
       // Verify this notification is for our connection
-      if (param->notify.conn_id != this->conn_id_) {
+      if (param->notify.conn_id != session.conn_id) {
         ESP_LOGD(TAG, "Notification from different connection (conn_id: %d, ours: %d), ignoring", param->notify.conn_id,
-                 this->conn_id_);
+                 session.conn_id);
         break;
       }
 
@@ -927,12 +1104,12 @@ void BLEGamepad::gattc_event_handler(esp_gattc_cb_event_t event, esp_gatt_if_t g
 
       // Check if this is from any of our HID Report characteristics
       bool is_hid_report = false;
-      for (const auto &report : this->hid_report_chars_) {
+      for (const auto &report : session.hid_report_chars) {
         if (param->notify.handle == report.char_handle) {
           is_hid_report = true;
           ESP_LOGV(TAG, "HID Report notification (input report): handle=%04x, len=%d", report.char_handle,
                    param->notify.value_len);
-          this->handle_notification_(param->notify.value, param->notify.value_len);
+          this->handle_notification_(session, param->notify.value, param->notify.value_len);
           break;
         }
       }
@@ -944,61 +1121,415 @@ void BLEGamepad::gattc_event_handler(esp_gattc_cb_event_t event, esp_gatt_if_t g
     }
 
     default:
-      ESP_LOGD(TAG, "Unhandled GATT event: %d", event);
       break;
   }
 }
 
-void BLEGamepad::handle_notification_(uint8_t *value, uint16_t value_len) {
-  if (active_controller_ == nullptr) {
+void BLEGamepad::handle_notification_(Session &session, uint8_t *value, uint16_t value_len) {
+  if (session.controller == nullptr) {
     return;
   }
+  const uint32_t received_us = (uint32_t) esp_timer_get_time();
 
-  // Delegate parsing to controller-specific implementation
-  if (!active_controller_->parse_input_report(value, value_len)) {
+  // Delegate parsing to controller-specific implementation. Only this context touches the
+  // controller's state; everyone else reads the published snapshot.
+  if (!session.controller->parse_input_report(value, value_len)) {
     ESP_LOGW(TAG, "Failed to parse input report (length: %d)", value_len);
+    return;
+  }
+  this->publish_state_(session, session.controller->get_state(), received_us);
+}
+
+std::unique_ptr<ControllerBase> BLEGamepad::create_controller_(const Session &session) {
+  // Xbox keeps its verified hand-written parser; everything else is driven by its Report Map.
+  // PlayStation and Switch Pro controllers don't speak HOGP at all, so they never get here.
+  if (session.vendor_id != MICROSOFT_VENDOR_ID) {
+    auto generic = std::make_unique<GenericController>();
+    if (generic->init(session.hid_report_map.data(), session.hid_report_map.size())) {
+      return generic;
+    }
+    ESP_LOGW(TAG, "Report Map has no gamepad input we can map, assuming the Xbox report layout");
+  }
+  return std::make_unique<XboxController>();
+}
+
+void BLEGamepad::request_conn_params_(const Session &session) {
+  esp_ble_conn_update_params_t params{};
+  memcpy(params.bda, session.remote_bda, sizeof(esp_bd_addr_t));
+  params.min_int = this->conn_params_.interval;
+  params.max_int = this->conn_params_.interval;
+  params.latency = this->conn_params_.latency;
+  params.timeout = this->conn_params_.timeout;
+  ESP_LOGI(TAG, "Requesting connection interval %.2fms, latency %u, timeout %ums", params.min_int * 1.25f,
+           params.latency, params.timeout * 10u);
+  esp_err_t ret = esp_ble_gap_update_conn_params(&params);
+  if (ret != ESP_OK) {
+    ESP_LOGW(TAG, "Connection parameter request failed: %s", esp_err_to_name(ret));
   }
 }
 
-void BLEGamepad::connect_to_device_(esp_bd_addr_t bda) {
-  ESP_LOGI(TAG, "Connecting to device: " ESP_BD_ADDR_STR, ESP_BD_ADDR_HEX(bda));
-  esp_ble_gattc_open(gattc_if_, bda, BLE_ADDR_TYPE_PUBLIC, true);
+void BLEGamepad::publish_state_(Session &session, const ControllerState &state, uint32_t received_us) {
+  session.state_slot.publish(state);
+#ifdef USE_BLE_GAMEPAD_RUNNER
+  this->forward_to_runner_(session, state, received_us);
+#endif
+}
+
+#ifdef USE_BLE_GAMEPAD_RUNNER
+void BLEGamepad::forward_to_runner_(Session &session, const ControllerState &state, uint32_t received_us) {
+  if (this->runner_ == nullptr) {
+    return;
+  }
+  const uint8_t player = this->runner_player_ + this->player_of_(session) - 1;
+  const uint32_t mask = state.button_mask();
+  // Stamped with the notification time, so the runner can measure controller-to-game latency
+  auto send = [&](InputType type, bool pressed, int16_t value) {
+    InputEvent event(type, player, pressed, value);
+    event.timestamp_us = received_us;
+    this->runner_->send_input_event(event);
+  };
+
+  for (const auto &button : RUNNER_BUTTONS) {
+    const bool pressed = (mask >> button.bit) & 1;
+    if (pressed != (bool) ((session.runner_buttons >> button.bit) & 1)) {
+      send(button.type, pressed, 0);
+    }
+  }
+  session.runner_buttons = mask;
+
+  // Stick deflection toward up, down, left, right (positive Y is up)
+  const int x = state.left_stick_x;
+  const int y = state.left_stick_y;
+  const int deflection[4] = {std::max(y, 0), std::max(-y, 0), std::max(-x, 0), std::max(x, 0)};
+  for (int i = 0; i < 4; i++) {
+    const uint8_t bit = 1 << i;
+    const bool was_pressed = session.runner_directions & bit;
+    const bool dpad = (mask >> RUNNER_DIRECTIONS[i].bit) & 1;
+    const bool pressed =
+        dpad || deflection[i] >= (was_pressed ? STICK_RELEASE_THRESHOLD : STICK_PRESS_THRESHOLD);
+    if (pressed != was_pressed) {
+      session.runner_directions ^= bit;
+      // value: how far the stick is pushed (0-127, 127 for the d-pad)
+      send(RUNNER_DIRECTIONS[i].type, pressed, (int16_t) (dpad ? 127 : deflection[i]));
+    }
+  }
+
+  const uint8_t triggers[2] = {state.left_trigger, state.right_trigger};
+  const InputType trigger_types[2] = {InputType::L_TRIGGER, InputType::R_TRIGGER};
+  for (int i = 0; i < 2; i++) {
+    const int last = session.runner_triggers[i];
+    const int now = triggers[i];
+    // Always report reaching either end so games see a clean 0 / 255
+    if (std::abs(now - last) >= TRIGGER_STEP || (now != last && (now == 0 || now == 255))) {
+      session.runner_triggers[i] = now;
+      send(trigger_types[i], now >= TRIGGER_PRESS_THRESHOLD, (int16_t) now);
+    }
+  }
 }
+#endif
 
-void BLEGamepad::disconnect_() {
-  if (connected_) {
-    esp_err_t ret = esp_ble_gattc_close(gattc_if_, conn_id_);
+void BLEGamepad::connect_to_device_(Session &session) {
+  ESP_LOGI(TAG, "Player %u: connecting to device " ESP_BD_ADDR_STR, this->player_of_(session),
+           ESP_BD_ADDR_HEX(session.remote_bda));
+  esp_err_t ret = esp_ble_gattc_open(gattc_if_, session.remote_bda, BLE_ADDR_TYPE_PUBLIC, true);
+  if (ret != ESP_OK) {
+    // No ESP_GATTC_OPEN_EVT will follow
+    ESP_LOGE(TAG, "Failed to open connection: %s", esp_err_to_name(ret));
+    this->direct_connecting_ = false;
+    this->release_session_(session);
+    this->start_scan_();
+  }
+}
+
+void BLEGamepad::reconnect_() {
+  // Controllers are set up one at a time; the next free slot is filled once this one completes
+  if (this->scanning_ || this->direct_connecting_ || this->setup_session_() != nullptr) {
+    return;
+  }
+  bool slot_free = false;
+  for (uint8_t i = 0; i < this->max_controllers_; i++) {
+    slot_free |= !this->sessions_[i].in_use;
+  }
+  if (!slot_free) {
+    return;
+  }
+
+  esp_bd_addr_t bda;
+  if (this->fast_reconnect_ && this->find_cached_bond_(bda)) {
+    Session *session = this->acquire_session_(bda);
+    if (session != nullptr) {
+      // Pending until the controller advertises or the stack's connection timeout fails it
+      ESP_LOGI(TAG, "Reconnecting directly to bonded controller " ESP_BD_ADDR_STR, ESP_BD_ADDR_HEX(bda));
+      this->direct_connecting_ = true;
+      this->connect_to_device_(*session);
+      return;
+    }
+  }
+  this->start_scan_();
+}
+
+BLEGamepad::Session *BLEGamepad::find_session_(const esp_bd_addr_t bda) {
+  for (auto &session : this->sessions_) {
+    if (session.in_use && memcmp(session.remote_bda, bda, sizeof(esp_bd_addr_t)) == 0) {
+      return &session;
+    }
+  }
+  return nullptr;
+}
+
+BLEGamepad::Session *BLEGamepad::find_session_(uint16_t conn_id) {
+  for (auto &session : this->sessions_) {
+    if (session.connected && session.conn_id == conn_id) {
+      return &session;
+    }
+  }
+  return nullptr;
+}
+
+BLEGamepad::Session *BLEGamepad::setup_session_() {
+  // In use but no controller yet: connecting or still running discovery
+  for (auto &session : this->sessions_) {
+    if (session.in_use && !session.controller) {
+      return &session;
+    }
+  }
+  return nullptr;
+}
+
+BLEGamepad::Session *BLEGamepad::acquire_session_(const esp_bd_addr_t bda) {
+  int slot = -1;
+  // A controller that comes back gets its old player number if nobody took it meanwhile
+  for (uint8_t i = 0; i < this->max_controllers_ && slot < 0; i++) {
+    if (!this->sessions_[i].in_use && this->slot_assigned_[i] &&
+        memcmp(this->slot_bda_[i], bda, sizeof(esp_bd_addr_t)) == 0) {
+      slot = i;
+    }
+  }
+  // Then a slot no controller has used yet, then the first free one
+  for (uint8_t i = 0; i < this->max_controllers_ && slot < 0; i++) {
+    if (!this->sessions_[i].in_use && !this->slot_assigned_[i]) {
+      slot = i;
+    }
+  }
+  for (uint8_t i = 0; i < this->max_controllers_ && slot < 0; i++) {
+    if (!this->sessions_[i].in_use) {
+      slot = i;
+    }
+  }
+  if (slot < 0) {
+    return nullptr;
+  }
+
+  Session &session = this->sessions_[slot];
+  session.in_use = true;
+  session.connected = false;
+  session.using_cache = false;
+  session.conn_interval = 0;
+  session.service_discovery_retries = 0;
+  memcpy(session.remote_bda, bda, sizeof(esp_bd_addr_t));
+  memcpy(this->slot_bda_[slot], bda, sizeof(esp_bd_addr_t));
+  this->slot_assigned_[slot] = true;
+#ifdef USE_BLE_GAMEPAD_RUNNER
+  session.runner_buttons = 0;
+  session.runner_directions = 0;
+  session.runner_triggers[0] = session.runner_triggers[1] = 0;
+#endif
+  this->reset_discovery_(session);
+  return &session;
+}
+
+void BLEGamepad::release_session_(Session &session) {
+  if (session.controller) {
+    session.controller->on_disconnect();
+    this->publish_state_(session, session.controller->get_state());
+    session.controller.reset();
+    this->on_disconnect_callbacks_.call(this->player_of_(session));
+  }
+  session.in_use = false;
+  session.connected = false;
+}
+
+void BLEGamepad::reset_discovery_(Session &session) {
+  session.dis_service_start_handle = 0;
+  session.dis_service_end_handle = 0;
+  session.dis_pnp_id_handle = 0;
+  session.vendor_id = 0;
+  session.product_id = 0;
+  session.hid_service_start_handle = 0;
+  session.hid_service_end_handle = 0;
+  session.hid_info_handle = 0;
+  session.hid_report_map_handle = 0;
+  session.protocol_mode_handle = 0;
+  session.hid_report_chars.clear();
+  session.hid_report_map.clear();
+  session.current_notify_index = 0;
+  session.init_state = InitState::IDLE;
+}
+
+void BLEGamepad::start_cached_init_(Session &session, esp_gatt_if_t gattc_if) {
+  const HandleCache &cache = this->cache_;
+  ESP_LOGI(TAG, "Using cached GATT handles (%u HID Report(s)), skipping service discovery", cache.report_count);
+  session.dis_pnp_id_handle = cache.dis_pnp_id_handle;
+  session.hid_service_start_handle = cache.hid_service_start_handle;
+  session.hid_service_end_handle = cache.hid_service_end_handle;
+  session.hid_info_handle = cache.hid_info_handle;
+  session.hid_report_map_handle = cache.hid_report_map_handle;
+  session.protocol_mode_handle = cache.protocol_mode_handle;
+  session.hid_report_chars.assign(cache.reports, cache.reports + cache.report_count);
+  session.hid_report_map.assign(cache.report_map, cache.report_map + cache.report_map_len);
+
+  if (session.dis_pnp_id_handle != 0) {
+    // One read confirms it's still the controller (and firmware) the handles came from
+    session.init_state = InitState::READING_DIS_PNPID;
+    ESP_LOGI(TAG, "Reading PnP ID to validate cached handles");
+    esp_ble_gattc_read_char(gattc_if, session.conn_id, session.dis_pnp_id_handle, ESP_GATT_AUTH_REQ_NONE);
+  } else {
+    this->finish_cached_init_(session, gattc_if);
+  }
+}
+
+void BLEGamepad::finish_cached_init_(Session &session, esp_gatt_if_t gattc_if) {
+  if (session.protocol_mode_handle != 0) {
+    session.init_state = InitState::SETTING_PROTOCOL_MODE;
+    ESP_LOGI(TAG, "Setting Protocol Mode to Report Mode");
+    uint8_t report_mode = 0x01;
+    esp_ble_gattc_write_char(gattc_if, session.conn_id, session.protocol_mode_handle, sizeof(report_mode),
+                             &report_mode, ESP_GATT_WRITE_TYPE_RSP, ESP_GATT_AUTH_REQ_NONE);
+  } else {
+    this->enable_all_notifications_(session, gattc_if);
+  }
+}
+
+bool BLEGamepad::retry_without_cache_(Session &session, const char *reason) {
+  if (!session.using_cache || !session.connected) {
+    return false;
+  }
+  ESP_LOGW(TAG, "Cached GATT handles rejected (%s), running full service discovery", reason);
+  session.using_cache = false;
+  this->cache_valid_ = false;  // Overwritten once discovery completes
+  this->reset_discovery_(session);
+
+  esp_bt_uuid_t dis_uuid;
+  dis_uuid.len = ESP_UUID_LEN_16;
+  dis_uuid.uuid.uuid16 = DIS_SERVICE_UUID;
+  esp_ble_gattc_search_service(this->gattc_if_, session.conn_id, &dis_uuid);
+  return true;
+}
+
+// One preference per controller address
+static uint32_t handle_cache_key(const esp_bd_addr_t bda) {
+  char key[32];
+  snprintf(key, sizeof(key), "ble_gamepad_" ESP_BD_ADDR_STR, ESP_BD_ADDR_HEX(bda));
+  return fnv1_hash(key);
+}
+
+bool BLEGamepad::load_handle_cache_(const esp_bd_addr_t bda) {
+  if (this->cache_valid_ && memcmp(this->cache_.bda, bda, sizeof(esp_bd_addr_t)) == 0) {
+    return true;
+  }
+  ESPPreferenceObject pref = global_preferences->make_preference<HandleCache>(handle_cache_key(bda));
+  this->cache_valid_ = pref.load(&this->cache_) && memcmp(this->cache_.bda, bda, sizeof(esp_bd_addr_t)) == 0 &&
+                       this->cache_.report_count > 0 && this->cache_.report_count <= CACHE_MAX_REPORTS &&
+                       this->cache_.report_map_len <= CACHE_MAX_REPORT_MAP;
+  return this->cache_valid_;
+}
+
+void BLEGamepad::save_handle_cache_(const Session &session) {
+  if (!this->fast_reconnect_) {
+    return;
+  }
+  if (session.hid_report_chars.size() > CACHE_MAX_REPORTS || session.hid_report_map.size() > CACHE_MAX_REPORT_MAP) {
+    ESP_LOGW(TAG, "Not caching GATT handles: %zu HID Reports / %zu byte Report Map exceed the cache",
+             session.hid_report_chars.size(), session.hid_report_map.size());
+    return;
+  }
+
+  HandleCache &cache = this->cache_;
+  cache = {};
+  memcpy(cache.bda, session.remote_bda, sizeof(esp_bd_addr_t));
+  cache.vendor_id = session.vendor_id;
+  cache.product_id = session.product_id;
+  cache.dis_pnp_id_handle = session.dis_pnp_id_handle;
+  cache.hid_service_start_handle = session.hid_service_start_handle;
+  cache.hid_service_end_handle = session.hid_service_end_handle;
+  cache.hid_info_handle = session.hid_info_handle;
+  cache.hid_report_map_handle = session.hid_report_map_handle;
+  cache.protocol_mode_handle = session.protocol_mode_handle;
+  cache.report_count = session.hid_report_chars.size();
+  std::copy(session.hid_report_chars.begin(), session.hid_report_chars.end(), cache.reports);
+  cache.report_map_len = session.hid_report_map.size();
+  std::copy(session.hid_report_map.begin(), session.hid_report_map.end(), cache.report_map);
+
+  ESPPreferenceObject pref = global_preferences->make_preference<HandleCache>(handle_cache_key(cache.bda));
+  this->cache_valid_ = pref.save(&cache);
+  if (this->cache_valid_) {
+    ESP_LOGI(TAG, "Cached GATT handles for " ESP_BD_ADDR_STR, ESP_BD_ADDR_HEX(cache.bda));
+  } else {
+    ESP_LOGW(TAG, "Failed to save GATT handle cache");
+  }
+}
+
+bool BLEGamepad::find_cached_bond_(esp_bd_addr_t bda) {
+  int count = esp_ble_get_bond_device_num();
+  if (count <= 0) {
+    return false;
+  }
+  auto bonds = std::make_unique<esp_ble_bond_dev_t[]>(count);
+  if (esp_ble_get_bond_device_list(&count, bonds.get()) != ESP_OK) {
+    return false;
+  }
+
+  // The last controller seen is already in cache_ and the most likely to come back
+  const esp_ble_bond_dev_t *found = nullptr;
+  // Controllers already in a slot are skipped
+  for (int i = 0; i < count && found == nullptr; i++) {
+    if (this->cache_valid_ && memcmp(bonds[i].bd_addr, this->cache_.bda, sizeof(esp_bd_addr_t)) == 0 &&
+        this->find_session_(bonds[i].bd_addr) == nullptr) {
+      found = &bonds[i];
+    }
+  }
+  for (int i = 0; i < count && found == nullptr; i++) {
+    if (this->find_session_(bonds[i].bd_addr) == nullptr && this->load_handle_cache_(bonds[i].bd_addr)) {
+      found = &bonds[i];
+    }
+  }
+  if (found == nullptr) {
+    return false;
+  }
+  memcpy(bda, found->bd_addr, sizeof(esp_bd_addr_t));
+  return true;
+}
+
+void BLEGamepad::disconnect_(Session &session) {
+  if (session.connected) {
+    esp_err_t ret = esp_ble_gattc_close(gattc_if_, session.conn_id);
     if (ret != ESP_OK) {
       ESP_LOGE(TAG, "Failed to close GATT connection: %s", esp_err_to_name(ret));
       // Force cleanup even if close fails to prevent stuck state
-      this->connected_ = false;
-      if (this->active_controller_) {
-        this->active_controller_->on_disconnect();
-        this->active_controller_.reset();
-        this->on_disconnect_callbacks_.call();
-      }
+      this->release_session_(session);
+      this->reconnect_();
     }
   }
 }
 
-void BLEGamepad::enable_all_notifications_(esp_gatt_if_t gattc_if) {
+void BLEGamepad::enable_all_notifications_(Session &session, esp_gatt_if_t gattc_if) {
   // Bluedroid requires calling esp_ble_gattc_register_for_notify() BEFORE writing CCC
   // Without this, Bluedroid won't dispatch notification events to our handler
-  this->init_state_ = InitState::REGISTERING_NOTIFICATIONS;
-  this->current_notify_index_ = 0;
-  ESP_LOGI(TAG, "Registering for notifications on %zu HID Report characteristic(s)", this->hid_report_chars_.size());
+  session.init_state = InitState::REGISTERING_NOTIFICATIONS;
+  session.current_notify_index = 0;
+  ESP_LOGI(TAG, "Registering for notifications on %zu HID Report characteristic(s)", session.hid_report_chars.size());
 
   // Find first characteristic with CCC descriptor and register for notifications
-  for (size_t i = 0; i < this->hid_report_chars_.size(); i++) {
-    if (this->hid_report_chars_[i].ccc_handle != 0) {
-      this->current_notify_index_ = i;
-      ESP_LOGI(TAG, "Registering for notifications: HID Report handle=%04x", this->hid_report_chars_[i].char_handle);
+  for (size_t i = 0; i < session.hid_report_chars.size(); i++) {
+    if (session.hid_report_chars[i].ccc_handle != 0) {
+      session.current_notify_index = i;
+      ESP_LOGI(TAG, "Registering for notifications: HID Report handle=%04x", session.hid_report_chars[i].char_handle);
 
       esp_err_t err =
-          esp_ble_gattc_register_for_notify(gattc_if, this->remote_bda_, this->hid_report_chars_[i].char_handle);
+          esp_ble_gattc_register_for_notify(gattc_if, session.remote_bda, session.hid_report_chars[i].char_handle);
       if (err != ESP_OK) {
         ESP_LOGE(TAG, "Failed to register for notify: %s", esp_err_to_name(err));
-        this->disconnect_();
+        this->disconnect_(session);
       }
       return;  // Wait for ESP_GATTC_REG_FOR_NOTIFY_EVT before proceeding
     }
@@ -1006,7 +1537,7 @@ void BLEGamepad::enable_all_notifications_(esp_gatt_if_t gattc_if) {
 
   // No characteristics with CCC found
   ESP_LOGE(TAG, "No HID Report characteristics with CCC descriptors found");
-  this->disconnect_();
+  this->disconnect_(session);
 }
 
 }  // namespace esphome::ble_gamepad
@@ -4,10 +4,20 @@
 #pragma once
 
 #include "controller_base.h"
+#include "controller_state_slot.h"
 #include "esphome/core/component.h"
 #include "esphome/core/automation.h"
+#include "esphome/core/preferences.h"
 #include "esphome/components/esp32_ble/ble.h"
+#ifdef USE_BLE_GAMEPAD_RUNNER
+#include "esphome/components/lvgl_game_runner/lvgl_game_runner.h"
+// Reports are pushed from the BLE context, alongside the runner's other producers
+#if !LVGL_GAME_RUNNER_INPUT_MPSC
+#error "ble_gamepad runner: requires LVGL_GAME_RUNNER_INPUT_MPSC=1"
+#endif
+#endif
 
+#include <algorithm>
 #include <memory>
 #include <vector>
 #include <map>
@@ -65,31 +75,165 @@ class BLEGamepad : public Component,
   /**
    * @brief Get current controller state (if connected).
    *
-   * @return Pointer to state, or nullptr if no controller connected
+   * This is the consistent snapshot taken at the last loop(), not the state the BLE
+   * callbacks are writing.
+   *
+   * @param player Player slot (1 to max_controllers)
+   * @return Pointer to state, or nullptr if no controller connected in that slot
+   */
+  const ControllerState *get_state(uint8_t player = 1) const;
+
+  /**
+   * @brief Number of input reports (from all controllers) that arrived between the last two loop() polls.
    */
-  const ControllerState *get_state() const;
+  uint32_t get_reports_last_poll() const { return reports_last_poll_; }
+
+#ifdef USE_BLE_GAMEPAD_RUNNER
+  /**
+   * @brief Send input straight to a game runner as reports arrive.
+   *
+   * Buttons, d-pad and left stick become InputEvents without going through on_button or the
+   * main loop. The controller in player slot 1 is `player`, slot 2 is `player` + 1, etc.
+   */
+  void set_runner(lvgl_game_runner::LvglGameRunner *runner, uint8_t player) {
+    runner_ = runner;
+    runner_player_ = player;
+  }
+#endif
 
   /**
    * @brief Check if any controller is currently connected.
    *
    * @return true if connected
    */
-  bool is_connected() const { return active_controller_ != nullptr && gattc_if_ != ESP_GATT_IF_NONE; }
+  bool is_connected() const;
 
   /**
-   * @brief Register automation triggers.
+   * @brief How many controllers may be connected at once, each in its own player slot (1-4).
    */
-  void add_on_connect_callback(std::function<void()> &&callback) { on_connect_callbacks_.add(std::move(callback)); }
-  void add_on_disconnect_callback(std::function<void()> &&callback) {
+  void set_max_controllers(uint8_t max_controllers) {
+    max_controllers_ = std::min<uint8_t>(std::max<uint8_t>(max_controllers, 1), MAX_SESSIONS);
+  }
+
+  /**
+   * @brief Register automation triggers. Each gets the player slot (1-4) of the controller.
+   */
+  void add_on_connect_callback(std::function<void(uint8_t)> &&callback) {
+    on_connect_callbacks_.add(std::move(callback));
+  }
+  void add_on_disconnect_callback(std::function<void(uint8_t)> &&callback) {
     on_disconnect_callbacks_.add(std::move(callback));
   }
-  void add_on_button_callback(std::function<void(std::string, bool)> &&callback) {
+  void add_on_button_callback(std::function<void(std::string, bool, uint8_t)> &&callback) {
     on_button_callbacks_.add(std::move(callback));
   }
-  void add_on_stick_callback(std::function<void()> &&callback) { on_stick_callbacks_.add(std::move(callback)); }
+  void add_on_stick_callback(std::function<void(uint8_t)> &&callback) {
+    on_stick_callbacks_.add(std::move(callback));
+  }
+
+  /**
+   * @brief Connection parameters to request once a controller is set up.
+   *
+   * @param interval Connection interval in 1.25ms units (6-3200)
+   * @param latency Slave latency in connection events (0-499)
+   * @param timeout Supervision timeout in 10ms units (10-3200)
+   */
+  void set_conn_params(uint16_t interval, uint16_t latency, uint16_t timeout) {
+    conn_params_ = {interval, latency, timeout};
+  }
+
+  /**
+   * @brief Remember each bonded controller's GATT handles and reconnect to it directly.
+   *
+   * When enabled, a known controller is connected to without scanning, and service discovery
+   * is skipped as long as its PnP ID still matches what was cached.
+   */
+  void set_fast_reconnect(bool fast_reconnect) { fast_reconnect_ = fast_reconnect; }
 
  protected:
 #ifdef USE_ESP_IDF
+  // HID Report characteristics (multiple reports: input, output, feature)
+  struct HIDReportCharacteristic {
+    uint16_t char_handle;
+    uint16_t ccc_handle;  // Client Characteristic Configuration descriptor
+  };
+
+  // HOGP initialization state tracking
+  enum class InitState {
+    IDLE,
+    READING_DIS_PNPID,  // Reading Device Information Service PnP ID
+    READING_HID_INFO,
+    READING_REPORT_MAP,
+    SETTING_PROTOCOL_MODE,
+    REGISTERING_NOTIFICATIONS,  // Calling esp_ble_gattc_register_for_notify() for each HID Report
+    ENABLING_NOTIFICATIONS,     // Writing CCC descriptors to enable notifications
+    READING_INITIAL_REPORT,     // Reading first input report to "prime" the controller
+    COMPLETE
+  };
+
+  /**
+   * @brief One controller link: its GATT handles, HOGP setup progress and parsed state.
+   *
+   * sessions_[i] is always player i + 1, so a controller keeps its player number for as
+   * long as it stays connected.
+   */
+  struct Session {
+    bool in_use{false};  // Connecting or connected
+    bool connected{false};
+    uint16_t conn_id{0};
+    esp_bd_addr_t remote_bda{};
+    uint16_t conn_interval{0};  // Negotiated interval (1.25ms units), 0 = not reported yet
+
+    // Device Information Service handles
+    uint16_t dis_service_start_handle{0};
+    uint16_t dis_service_end_handle{0};
+    uint16_t dis_pnp_id_handle{0};  // PnP ID characteristic (0x2A50) - contains VID/PID
+
+    // Controller identification (from PnP ID)
+    uint16_t vendor_id{0};   // e.g., 0x045e for Microsoft
+    uint16_t product_id{0};  // e.g., 0x02e0 for Xbox One BLE
+
+    // GATT service/characteristic handles
+    uint16_t hid_service_start_handle{0};
+    uint16_t hid_service_end_handle{0};
+    uint16_t hid_info_handle{0};        // HID Information (0x2A4A) - required for HOGP
+    uint16_t hid_report_map_handle{0};  // HID Report Map (0x2A4B) - CRITICAL for Xbox pairing
+    uint16_t protocol_mode_handle{0};   // Protocol Mode (0x2A4E) - optional for Report-only devices
+
+    std::vector<HIDReportCharacteristic> hid_report_chars;  // All HID Report characteristics
+
+    // HID Report Map storage (required for Xbox controllers)
+    std::vector<uint8_t> hid_report_map;
+
+    InitState init_state{InitState::IDLE};
+
+    // Service discovery retry counter (prevents infinite loops if services missing)
+    uint8_t service_discovery_retries{0};
+
+    // Index for sequential notification registration (Bluedroid requirement)
+    size_t current_notify_index{0};
+
+    bool using_cache{false};  // This connection is being set up from cache_
+
+    // Active controller (nullptr until HOGP setup completes)
+    std::unique_ptr<ControllerBase> controller{nullptr};
+
+    // Parsed reports, published by the BLE context and read by loop()
+    ControllerStateSlot state_slot;
+    ControllerState current_state{};  // Snapshot from the latest loop()
+    uint32_t last_report_seq{0};
+
+    // Previous state for change detection (triggers)
+    ControllerState prev_state{};
+
+#ifdef USE_BLE_GAMEPAD_RUNNER
+    // What the runner was last sent (BLE context only)
+    uint32_t runner_buttons{0};
+    uint8_t runner_directions{0};  // Bit per RUNNER_DIRECTIONS entry
+    uint8_t runner_triggers[2]{};
+#endif
+  };
+
   /**
    * @brief Start BLE scanning for HID devices.
    */
@@ -125,93 +269,187 @@ class BLEGamepad : public Component,
    * @param value Report data
    * @param value_len Report length
    */
-  void handle_notification_(uint8_t *value, uint16_t value_len);
+  void handle_notification_(Session &session, uint8_t *value, uint16_t value_len);
+
+  /**
+   * @brief Publish a new controller state to loop() (and the runner, if linked).
+   *
+   * Only called from the BLE event context.
+   */
+  void publish_state_(Session &session, const ControllerState &state, uint32_t received_us = 0);
+
+  /**
+   * @brief Parser for the controller just set up, chosen by PnP vendor and Report Map.
+   */
+  std::unique_ptr<ControllerBase> create_controller_(const Session &session);
+
+  /**
+   * @brief Ask for the configured connection parameters on the current connection.
+   */
+  void request_conn_params_(const Session &session);
 
   /**
    * @brief Connect to discovered HID device.
    *
-   * @param bda Device Bluetooth address
+   * @param session Acquired session holding the device address
    */
-  void connect_to_device_(esp_bd_addr_t bda);
+  void connect_to_device_(Session &session);
 
   /**
-   * @brief Disconnect from current device.
+   * @brief Disconnect a session's device.
    */
-  void disconnect_();
+  void disconnect_(Session &session);
 
   /**
    * @brief Enable notifications on all HID Report characteristics.
    *
    * @param gattc_if GATT client interface
    */
-  void enable_all_notifications_(esp_gatt_if_t gattc_if);
+  void enable_all_notifications_(Session &session, esp_gatt_if_t gattc_if);
 
-  // BLE connection state
-  esp_gatt_if_t gattc_if_{ESP_GATT_IF_NONE};
-  uint16_t conn_id_{0};
-  esp_bd_addr_t remote_bda_{};
-  bool connected_{false};
-  bool scanning_{false};
-  bool gatt_registered_{false};
+  /**
+   * @brief Fill a free player slot: connect directly to a bonded controller with cached handles,
+   * or start scanning. Does nothing while a controller is being set up or all slots are taken.
+   */
+  void reconnect_();
 
-  // Device Information Service handles
-  uint16_t dis_service_start_handle_{0};
-  uint16_t dis_service_end_handle_{0};
-  uint16_t dis_pnp_id_handle_{0};  // PnP ID characteristic (0x2A50) - contains VID/PID
+  /**
+   * @brief Forget the handles discovered on the previous connection.
+   */
+  void reset_discovery_(Session &session);
 
-  // Controller identification (from PnP ID)
-  uint16_t vendor_id_{0};   // e.g., 0x045e for Microsoft
-  uint16_t product_id_{0};  // e.g., 0x02e0 for Xbox One BLE
+  /**
+   * @brief Start HOGP setup from the cached handles (after encryption).
+   */
+  void start_cached_init_(Session &session, esp_gatt_if_t gattc_if);
 
-  // GATT service/characteristic handles
-  uint16_t hid_service_start_handle_{0};
-  uint16_t hid_service_end_handle_{0};
-  uint16_t hid_info_handle_{0};        // HID Information (0x2A4A) - required for HOGP
-  uint16_t hid_report_map_handle_{0};  // HID Report Map (0x2A4B) - CRITICAL for Xbox pairing
-  uint16_t protocol_mode_handle_{0};   // Protocol Mode (0x2A4E) - optional for Report-only devices
+  /**
+   * @brief Fall back to full service discovery if setup was running from cached handles.
+   *
+   * @return true if discovery was restarted, false if the caller should give up
+   */
+  bool retry_without_cache_(Session &session, const char *reason);
 
-  // HID Report characteristics (multiple reports: input, output, feature)
-  struct HIDReportCharacteristic {
-    uint16_t char_handle;
-    uint16_t ccc_handle;  // Client Characteristic Configuration descriptor
-  };
-  std::vector<HIDReportCharacteristic> hid_report_chars_;  // All HID Report characteristics
+  /**
+   * @brief Continue cached setup once the controller is confirmed: Protocol Mode, then notifications.
+   */
+  void finish_cached_init_(Session &session, esp_gatt_if_t gattc_if);
 
-  // HID Report Map storage (required for Xbox controllers)
-  std::vector<uint8_t> hid_report_map_;
+  /**
+   * @brief Load the cache entry for `bda` into cache_ (if it isn't there already).
+   */
+  bool load_handle_cache_(const esp_bd_addr_t bda);
 
-  // HOGP initialization state tracking
-  enum class InitState {
-    IDLE,
-    READING_DIS_PNPID,  // Reading Device Information Service PnP ID
-    READING_HID_INFO,
-    READING_REPORT_MAP,
-    SETTING_PROTOCOL_MODE,
-    REGISTERING_NOTIFICATIONS,  // Calling esp_ble_gattc_register_for_notify() for each HID Report
-    ENABLING_NOTIFICATIONS,     // Writing CCC descriptors to enable notifications
-    READING_INITIAL_REPORT,     // Reading first input report to "prime" the controller
-    COMPLETE
-  };
-  InitState init_state_{InitState::IDLE};
+  /**
+   * @brief Save the handles of a completed setup for the next connection.
+   */
+  void save_handle_cache_(const Session &session);
+
+  /**
+   * @brief Find a bonded controller (not already connected) with a cache entry, preferring the
+   * last one cached.
+   */
+  bool find_cached_bond_(esp_bd_addr_t bda);
+
+  uint8_t player_of_(const Session &session) const { return &session - this->sessions_ + 1; }
+
+  /**
+   * @brief Session connecting or connected to `bda`, or nullptr.
+   */
+  Session *find_session_(const esp_bd_addr_t bda);
+
+  /**
+   * @brief Connected session with this GATT connection ID, or nullptr.
+   */
+  Session *find_session_(uint16_t conn_id);
+
+  /**
+   * @brief The session being set up (connecting or in HOGP init), or nullptr.
+   *
+   * Only one controller is set up at a time, which keeps scanning, pending opens and cache_
+   * simple.
+   */
+  Session *setup_session_();
+
+  /**
+   * @brief Claim a free player slot for `bda`: its previous slot if free, else the first one
+   * not remembered for another controller.
+   *
+   * @return nullptr if max_controllers are already in use
+   */
+  Session *acquire_session_(const esp_bd_addr_t bda);
+
+  /**
+   * @brief Tear down a session whose link is gone and fire on_disconnect if it was ready.
+   */
+  void release_session_(Session &session);
+
+  /**
+   * @brief Fire triggers for one session's reports since the last loop().
+   */
+  void poll_session_(Session &session);
+
+  // BLE connection state
+  esp_gatt_if_t gattc_if_{ESP_GATT_IF_NONE};
+  bool scanning_{false};
+  bool gatt_registered_{false};
 
-  // Service discovery retry counter (prevents infinite loops if services missing)
+  static constexpr size_t MAX_SESSIONS = 4;  // Players 1-4 (InputEvent::player)
+  Session sessions_[MAX_SESSIONS];
+  uint8_t max_controllers_{1};
+  // Who had each player slot last, so a controller that drops out gets its slot back
+  esp_bd_addr_t slot_bda_[MAX_SESSIONS]{};
+  bool slot_assigned_[MAX_SESSIONS]{};
+
+  // Requested connection parameters (BLE units, see set_conn_params()); default 7.5ms / 0 / 2s
+  struct {
+    uint16_t interval{6};
+    uint16_t latency{0};
+    uint16_t timeout{200};
+  } conn_params_;
+
+  // Service discovery retry limit (prevents infinite loops if services missing)
   static constexpr uint8_t MAX_DISCOVERY_RETRIES = 3;
-  uint8_t service_discovery_retries_{0};
 
-  // Index for sequential notification registration (Bluedroid requirement)
-  size_t current_notify_index_{0};
+  // Persisted handles of one bonded controller (one preference per address). Plain data, so
+  // it can be stored as a single blob; setups that don't fit just aren't cached.
+  static constexpr size_t CACHE_MAX_REPORTS = 8;
+  static constexpr size_t CACHE_MAX_REPORT_MAP = 512;
+  struct HandleCache {
+    esp_bd_addr_t bda;
+    uint16_t vendor_id;
+    uint16_t product_id;
+    uint16_t dis_pnp_id_handle;
+    uint16_t hid_service_start_handle;
+    uint16_t hid_service_end_handle;
+    uint16_t hid_info_handle;
+    uint16_t hid_report_map_handle;
+    uint16_t protocol_mode_handle;
+    uint8_t report_count;
+    HIDReportCharacteristic reports[CACHE_MAX_REPORTS];
+    uint16_t report_map_len;
+    uint8_t report_map[CACHE_MAX_REPORT_MAP];
+  };
+  bool fast_reconnect_{true};
+  HandleCache cache_{};
+  bool cache_valid_{false};        // cache_ holds a loaded or saved entry
+  bool direct_connecting_{false};  // Connecting to a cached bond without having scanned
 
-  // Active controller (nullptr if disconnected)
-  std::unique_ptr<ControllerBase> active_controller_{nullptr};
+  uint32_t reports_last_poll_{0};
 
-  // Previous state for change detection (triggers)
-  ControllerState prev_state_{};
+#ifdef USE_BLE_GAMEPAD_RUNNER
+  void forward_to_runner_(Session &session, const ControllerState &state, uint32_t received_us);
+
+  // Linked runner; player slot i feeds runner player runner_player_ + i
+  lvgl_game_runner::LvglGameRunner *runner_{nullptr};
+  uint8_t runner_player_{1};
+#endif
 
   // Automation trigger callbacks
-  CallbackManager<void()> on_connect_callbacks_;
-  CallbackManager<void()> on_disconnect_callbacks_;
-  CallbackManager<void(std::string, bool)> on_button_callbacks_;
-  CallbackManager<void()> on_stick_callbacks_;
+  CallbackManager<void(uint8_t)> on_connect_callbacks_;
+  CallbackManager<void(uint8_t)> on_disconnect_callbacks_;
+  CallbackManager<void(std::string, bool, uint8_t)> on_button_callbacks_;
+  CallbackManager<void(uint8_t)> on_stick_callbacks_;
 #endif
 };
 
@@ -219,43 +457,50 @@ class BLEGamepad : public Component,
 
 /**
  * @brief Trigger fired when controller connects.
+ *
+ * Passes the controller's player slot.
  */
-class BLEGamepadConnectTrigger : public Trigger<> {
+class BLEGamepadConnectTrigger : public Trigger<uint8_t> {
  public:
   explicit BLEGamepadConnectTrigger(BLEGamepad *parent) {
-    parent->add_on_connect_callback([this]() { this->trigger(); });
+    parent->add_on_connect_callback([this](uint8_t player) { this->trigger(player); });
   }
 };
 
 /**
  * @brief Trigger fired when controller disconnects.
+ *
+ * Passes the controller's player slot.
  */
-class BLEGamepadDisconnectTrigger : public Trigger<> {
+class BLEGamepadDisconnectTrigger : public Trigger<uint8_t> {
  public:
   explicit BLEGamepadDisconnectTrigger(BLEGamepad *parent) {
-    parent->add_on_disconnect_callback([this]() { this->trigger(); });
+    parent->add_on_disconnect_callback([this](uint8_t player) { this->trigger(player); });
   }
 };
 
 /**
  * @brief Trigger fired when any button state changes.
  *
- * Passes the button name (e.g., "UP", "A") and pressed state (true/false).
+ * Passes the button name (e.g., "UP", "A"), pressed state (true/false) and player slot.
  */
-class BLEGamepadButtonTrigger : public Trigger<std::string, bool> {
+class BLEGamepadButtonTrigger : public Trigger<std::string, bool, uint8_t> {
  public:
   explicit BLEGamepadButtonTrigger(BLEGamepad *parent) {
-    parent->add_on_button_callback([this](std::string input, bool pressed) { this->trigger(input, pressed); });
+    parent->add_on_button_callback(
+        [this](std::string input, bool pressed, uint8_t player) { this->trigger(input, pressed, player); });
   }
 };
 
 /**
  * @brief Trigger fired when analog stick values change.
+ *
+ * Passes the controller's player slot.
  */
-class BLEGamepadStickTrigger : public Trigger<> {
+class BLEGamepadStickTrigger : public Trigger<uint8_t> {
  public:
   explicit BLEGamepadStickTrigger(BLEGamepad *parent) {
-    parent->add_on_stick_callback([this]() { this->trigger(); });
+    parent->add_on_stick_callback([this](uint8_t player) { this->trigger(player); });
   }
 };
 
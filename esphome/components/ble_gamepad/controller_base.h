@@ -8,6 +8,30 @@
 
 namespace esphome::ble_gamepad {
 
+/**
+ * @brief Bit of each button in ControllerState::button_mask().
+ */
+enum ButtonBit : uint8_t {
+  BUTTON_DPAD_UP,
+  BUTTON_DPAD_DOWN,
+  BUTTON_DPAD_LEFT,
+  BUTTON_DPAD_RIGHT,
+  BUTTON_SOUTH,
+  BUTTON_EAST,
+  BUTTON_WEST,
+  BUTTON_NORTH,
+  BUTTON_L1,
+  BUTTON_R1,
+  BUTTON_L2,
+  BUTTON_R2,
+  BUTTON_L3,
+  BUTTON_R3,
+  BUTTON_SELECT,
+  BUTTON_START,
+  BUTTON_HOME,
+  BUTTON_MISC,
+};
+
 /**
  * @brief Unified controller state structure.
  *
@@ -16,7 +40,7 @@ namespace esphome::ble_gamepad {
  */
 struct ControllerState {
   // Buttons (bitfield for efficiency)
-  struct {
+  struct Buttons {
     bool dpad_up : 1;
     bool dpad_down : 1;
     bool dpad_left : 1;
@@ -57,6 +81,47 @@ struct ControllerState {
   // Connection status
   bool connected{false};
 
+  /**
+   * @brief Buttons as a bitmask, one bit per ButtonBit.
+   */
+  uint32_t button_mask() const {
+    const Buttons &b = this->buttons;
+    return (uint32_t) b.dpad_up << BUTTON_DPAD_UP | (uint32_t) b.dpad_down << BUTTON_DPAD_DOWN |
+           (uint32_t) b.dpad_left << BUTTON_DPAD_LEFT | (uint32_t) b.dpad_right << BUTTON_DPAD_RIGHT |
+           (uint32_t) b.button_south << BUTTON_SOUTH | (uint32_t) b.button_east << BUTTON_EAST |
+           (uint32_t) b.button_west << BUTTON_WEST | (uint32_t) b.button_north << BUTTON_NORTH |
+           (uint32_t) b.button_l1 << BUTTON_L1 | (uint32_t) b.button_r1 << BUTTON_R1 |
+           (uint32_t) b.button_l2 << BUTTON_L2 | (uint32_t) b.button_r2 << BUTTON_R2 |
+           (uint32_t) b.button_l3 << BUTTON_L3 | (uint32_t) b.button_r3 << BUTTON_R3 |
+           (uint32_t) b.button_select << BUTTON_SELECT | (uint32_t) b.button_start << BUTTON_START |
+           (uint32_t) b.button_home << BUTTON_HOME | (uint32_t) b.button_misc << BUTTON_MISC;
+  }
+
+  /**
+   * @brief Set every button from a button_mask() value.
+   */
+  void set_button_mask(uint32_t mask) {
+    Buttons &b = this->buttons;
+    b.dpad_up = (mask >> BUTTON_DPAD_UP) & 1;
+    b.dpad_down = (mask >> BUTTON_DPAD_DOWN) & 1;
+    b.dpad_left = (mask >> BUTTON_DPAD_LEFT) & 1;
+    b.dpad_right = (mask >> BUTTON_DPAD_RIGHT) & 1;
+    b.button_south = (mask >> BUTTON_SOUTH) & 1;
+    b.button_east = (mask >> BUTTON_EAST) & 1;
+    b.button_west = (mask >> BUTTON_WEST) & 1;
+    b.button_north = (mask >> BUTTON_NORTH) & 1;
+    b.button_l1 = (mask >> BUTTON_L1) & 1;
+    b.button_r1 = (mask >> BUTTON_R1) & 1;
+    b.button_l2 = (mask >> BUTTON_L2) & 1;
+    b.button_r2 = (mask >> BUTTON_R2) & 1;
+    b.button_l3 = (mask >> BUTTON_L3) & 1;
+    b.button_r3 = (mask >> BUTTON_R3) & 1;
+    b.button_select = (mask >> BUTTON_SELECT) & 1;
+    b.button_start = (mask >> BUTTON_START) & 1;
+    b.button_home = (mask >> BUTTON_HOME) & 1;
+    b.button_misc = (mask >> BUTTON_MISC) & 1;
+  }
+
   /**
    * @brief Reset all state to defaults.
    */
@@ -0,0 +1,89 @@
+// © Copyright 2025 Stuart Parmenter
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include "controller_base.h"
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+namespace esphome::ble_gamepad {
+
+/**
+ * @brief Lock-free single-writer snapshot of a ControllerState.
+ *
+ * The BLE side publish()es every parsed report; readers on any other task read() a
+ * consistent copy without ever blocking the writer (a seqlock: the sequence is odd while a
+ * write is in progress and readers retry if it moved under them).
+ *
+ * The sequence advances by 2 per report, so readers can tell how many reports arrived
+ * between two polls. Buttons that went down or up in reports the reader never saw are
+ * latched until take_button_edges(), so a tap shorter than one poll isn't lost.
+ */
+class ControllerStateSlot {
+ public:
+  /**
+   * @brief Publish a new state. Writer side only; never blocks.
+   */
+  void publish(const ControllerState &state) {
+    uint32_t words[WORDS] = {};
+    std::memcpy(words, &state, sizeof(ControllerState));
+
+    const uint32_t mask = state.button_mask();
+    const uint32_t changed = mask ^ this->last_mask_;
+    this->pressed_.fetch_or(changed & mask, std::memory_order_relaxed);
+    this->released_.fetch_or(changed & ~mask, std::memory_order_relaxed);
+    this->last_mask_ = mask;
+
+    const uint32_t seq = this->seq_.load(std::memory_order_relaxed);
+    this->seq_.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    for (size_t i = 0; i < WORDS; i++)
+      this->words_[i].store(words[i], std::memory_order_relaxed);
+    this->seq_.store(seq + 2, std::memory_order_release);
+  }
+
+  /**
+   * @brief Copy the latest state into `out`.
+   *
+   * @return Number of reports published so far (compare with the previous read)
+   */
+  uint32_t read(ControllerState &out) const {
+    uint32_t words[WORDS];
+    uint32_t before;
+    uint32_t after;
+    do {
+      before = this->seq_.load(std::memory_order_acquire);
+      for (size_t i = 0; i < WORDS; i++)
+        words[i] = this->words_[i].load(std::memory_order_relaxed);
+      std::atomic_thread_fence(std::memory_order_acquire);
+      after = this->seq_.load(std::memory_order_relaxed);
+    } while ((before & 1) || before != after);
+    std::memcpy(&out, words, sizeof(ControllerState));
+    return before / 2;
+  }
+
+  /**
+   * @brief Button bits (see ControllerState::button_mask()) that went down / up since the
+   * last call. Single reader.
+   */
+  void take_button_edges(uint32_t &pressed, uint32_t &released) {
+    pressed = this->pressed_.exchange(0, std::memory_order_relaxed);
+    released = this->released_.exchange(0, std::memory_order_relaxed);
+  }
+
+ private:
+  static_assert(std::is_trivially_copyable_v<ControllerState>, "ControllerState is copied as raw words");
+  static constexpr size_t WORDS = (sizeof(ControllerState) + 3) / 4;
+
+  std::atomic<uint32_t> seq_{0};
+  std::atomic<uint32_t> words_[WORDS]{};
+  std::atomic<uint32_t> pressed_{0};
+  std::atomic<uint32_t> released_{0};
+  uint32_t last_mask_{0};  // Writer only
+};
+
+}  // namespace esphome::ble_gamepad
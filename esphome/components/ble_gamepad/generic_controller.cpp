@@ -0,0 +1,51 @@
+// © Copyright 2025 Stuart Parmenter
+// SPDX-License-Identifier: MIT
+
+#include "generic_controller.h"
+#include "esphome/core/log.h"
+
+namespace esphome::ble_gamepad {
+
+static const char *const TAG = "generic_controller";
+
+GenericController::GenericController() {
+  state_.reset();
+  ESP_LOGD(TAG, "Generic HID controller created");
+}
+
+bool GenericController::init(const uint8_t *report_map, size_t len) {
+  if (!report_map_.compile(report_map, len)) {
+    return false;
+  }
+  ESP_LOGI(TAG, "Compiled Report Map: %zu field(s) in %zu input report(s)", report_map_.field_count(),
+           report_map_.report_count());
+  report_map_.dump();
+  return true;
+}
+
+void GenericController::on_connect() {
+  ESP_LOGI(TAG, "Generic HID controller connected");
+  state_.connected = true;
+}
+
+void GenericController::on_disconnect() {
+  ESP_LOGI(TAG, "Generic HID controller disconnected");
+  state_.reset();
+}
+
+bool GenericController::parse_input_report(const uint8_t *report, uint16_t len) {
+  if (report == nullptr) {
+    return false;
+  }
+
+  // Notifications carry no report ID, so the length says which input report this is
+  const HidReportLayout *layout = report_map_.find_report(len);
+  if (layout == nullptr) {
+    ESP_LOGV(TAG, "No mapped input report of %d bytes", len);
+    return false;
+  }
+  report_map_.extract(*layout, report, state_);
+  return true;
+}
+
+}  // namespace esphome::ble_gamepad
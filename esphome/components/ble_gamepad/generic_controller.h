@@ -0,0 +1,40 @@
+// © Copyright 2025 Stuart Parmenter
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include "controller_base.h"
+#include "hid_report_map.h"
+
+namespace esphome::ble_gamepad {
+
+/**
+ * @brief Controller parser driven by the device's own HID Report Map.
+ *
+ * The Report Map read during HOGP setup is compiled once by init(); each report is then
+ * decoded by running the compiled field table, so any standard HID gamepad works without
+ * a dedicated ControllerBase subclass.
+ */
+class GenericController : public ControllerBase {
+ public:
+  GenericController();
+  ~GenericController() override = default;
+
+  /**
+   * @brief Compile the controller's Report Map.
+   *
+   * @return false if it describes no input this parser can map
+   */
+  bool init(const uint8_t *report_map, size_t len);
+
+  // ControllerBase interface
+  bool parse_input_report(const uint8_t *report, uint16_t len) override;
+  void on_connect() override;
+  void on_disconnect() override;
+  const char *get_controller_type() const override { return "Generic HID Gamepad"; }
+
+ private:
+  HidReportMap report_map_;
+};
+
+}  // namespace esphome::ble_gamepad
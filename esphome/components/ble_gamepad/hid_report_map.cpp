@@ -0,0 +1,482 @@
+// © Copyright 2025 Stuart Parmenter
+// SPDX-License-Identifier: MIT
+
+#include "hid_report_map.h"
+#include "esphome/core/log.h"
+
+#include <algorithm>
+#include <cinttypes>
+
+namespace esphome::ble_gamepad {
+
+static const char *const TAG = "hid_report_map";
+
+// Short item types and tags (HID 1.11, section 6.2.2)
+static constexpr uint8_t ITEM_MAIN = 0;
+static constexpr uint8_t ITEM_GLOBAL = 1;
+static constexpr uint8_t ITEM_LOCAL = 2;
+static constexpr uint8_t ITEM_LONG_PREFIX = 0xFE;
+
+static constexpr uint8_t MAIN_INPUT = 0x8;
+static constexpr uint8_t MAIN_OUTPUT = 0x9;
+static constexpr uint8_t MAIN_COLLECTION = 0xA;
+static constexpr uint8_t MAIN_FEATURE = 0xB;
+static constexpr uint8_t MAIN_END_COLLECTION = 0xC;
+
+static constexpr uint8_t GLOBAL_USAGE_PAGE = 0x0;
+static constexpr uint8_t GLOBAL_LOGICAL_MIN = 0x1;
+static constexpr uint8_t GLOBAL_LOGICAL_MAX = 0x2;
+static constexpr uint8_t GLOBAL_REPORT_SIZE = 0x7;
+static constexpr uint8_t GLOBAL_REPORT_ID = 0x8;
+static constexpr uint8_t GLOBAL_REPORT_COUNT = 0x9;
+static constexpr uint8_t GLOBAL_PUSH = 0xA;
+static constexpr uint8_t GLOBAL_POP = 0xB;
+
+static constexpr uint8_t LOCAL_USAGE = 0x0;
+static constexpr uint8_t LOCAL_USAGE_MIN = 0x1;
+static constexpr uint8_t LOCAL_USAGE_MAX = 0x2;
+
+static constexpr uint32_t INPUT_CONSTANT = 0x01;
+static constexpr uint32_t INPUT_VARIABLE = 0x02;
+
+// Usages as (page << 16) | id
+static constexpr uint32_t usage(uint16_t page, uint16_t id) { return (uint32_t) page << 16 | id; }
+static constexpr uint16_t PAGE_GENERIC_DESKTOP = 0x01;
+static constexpr uint16_t PAGE_SIMULATION = 0x02;
+static constexpr uint16_t PAGE_BUTTON = 0x09;
+static constexpr uint16_t PAGE_CONSUMER = 0x0C;
+
+static constexpr uint8_t NO_BUTTON = 0xFF;
+
+// Button page usages 1-15 in the Android gamepad order, which Xbox BLE and most HOGP pads use:
+// A B C X Y Z L1 R1 L2 R2 Select Start Mode L3 R3
+static constexpr uint8_t BUTTON_USAGES[] = {
+    BUTTON_SOUTH,  BUTTON_EAST,  NO_BUTTON, BUTTON_WEST, BUTTON_NORTH, NO_BUTTON, BUTTON_L1, BUTTON_R1,
+    BUTTON_L2,     BUTTON_R2,    BUTTON_SELECT, BUTTON_START, BUTTON_HOME, BUTTON_L3, BUTTON_R3,
+};
+
+// d-pad bits for hat directions N, NE, E, SE, S, SW, W, NW
+static constexpr uint8_t HAT_DPAD[8] = {
+    1 << BUTTON_DPAD_UP,
+    1 << BUTTON_DPAD_UP | 1 << BUTTON_DPAD_RIGHT,
+    1 << BUTTON_DPAD_RIGHT,
+    1 << BUTTON_DPAD_DOWN | 1 << BUTTON_DPAD_RIGHT,
+    1 << BUTTON_DPAD_DOWN,
+    1 << BUTTON_DPAD_DOWN | 1 << BUTTON_DPAD_LEFT,
+    1 << BUTTON_DPAD_LEFT,
+    1 << BUTTON_DPAD_UP | 1 << BUTTON_DPAD_LEFT,
+};
+
+static const char *target_name(HidTarget target) {
+  switch (target) {
+    case HidTarget::BUTTON:
+      return "button";
+    case HidTarget::HAT:
+      return "hat";
+    case HidTarget::LEFT_STICK_X:
+      return "left_x";
+    case HidTarget::LEFT_STICK_Y:
+      return "left_y";
+    case HidTarget::RIGHT_STICK_X:
+      return "right_x";
+    case HidTarget::RIGHT_STICK_Y:
+      return "right_y";
+    case HidTarget::LEFT_TRIGGER:
+      return "left_trigger";
+    case HidTarget::RIGHT_TRIGGER:
+      return "right_trigger";
+  }
+  return "?";
+}
+
+/**
+ * ControllerState target of a usage, if it has one. Right stick is Z/Rz and the triggers
+ * Rx/Ry or Brake/Accelerator, as on Xbox, DualShock-style and 8BitDo descriptors.
+ */
+static bool map_usage(uint32_t u, HidTarget &target, uint8_t &arg) {
+  arg = 0;
+  switch (u) {
+    case usage(PAGE_GENERIC_DESKTOP, 0x30):  // X
+      target = HidTarget::LEFT_STICK_X;
+      return true;
+    case usage(PAGE_GENERIC_DESKTOP, 0x31):  // Y
+      target = HidTarget::LEFT_STICK_Y;
+      arg = 1;
+      return true;
+    case usage(PAGE_GENERIC_DESKTOP, 0x32):  // Z
+      target = HidTarget::RIGHT_STICK_X;
+      return true;
+    case usage(PAGE_GENERIC_DESKTOP, 0x35):  // Rz
+      target = HidTarget::RIGHT_STICK_Y;
+      arg = 1;
+      return true;
+    case usage(PAGE_GENERIC_DESKTOP, 0x33):  // Rx
+    case usage(PAGE_SIMULATION, 0xC5):       // Brake
+      target = HidTarget::LEFT_TRIGGER;
+      return true;
+    case usage(PAGE_GENERIC_DESKTOP, 0x34):  // Ry
+    case usage(PAGE_SIMULATION, 0xC4):       // Accelerator
+      target = HidTarget::RIGHT_TRIGGER;
+      return true;
+    case usage(PAGE_GENERIC_DESKTOP, 0x39):  // Hat switch
+      target = HidTarget::HAT;
+      return true;
+    case usage(PAGE_CONSUMER, 0x223):  // AC Home
+      target = HidTarget::BUTTON;
+      arg = BUTTON_HOME;
+      return true;
+    case usage(PAGE_CONSUMER, 0x224):  // AC Back
+      target = HidTarget::BUTTON;
+      arg = BUTTON_SELECT;
+      return true;
+    case usage(PAGE_CONSUMER, 0xB2):  // Record (Xbox Share)
+      target = HidTarget::BUTTON;
+      arg = BUTTON_MISC;
+      return true;
+    default:
+      break;
+  }
+  const uint16_t id = u & 0xFFFF;
+  if ((u >> 16) == PAGE_BUTTON && id >= 1 && id <= sizeof(BUTTON_USAGES) && BUTTON_USAGES[id - 1] != NO_BUTTON) {
+    target = HidTarget::BUTTON;
+    arg = BUTTON_USAGES[id - 1];
+    return true;
+  }
+  return false;
+}
+
+/**
+ * Fill in a field's scaling for its logical range. false if the range is unusable.
+ */
+static bool set_scale(HidField &field, int32_t logical_min, int32_t logical_max) {
+  const int64_t range = (int64_t) logical_max - logical_min;
+  if (range <= 0) {
+    return false;
+  }
+  field.logical_min = logical_min;
+  field.is_signed = logical_min < 0;
+  switch (field.target) {
+    case HidTarget::BUTTON:
+      field.scale = 0;
+      return true;
+    case HidTarget::HAT:
+      // 4- or 8-way; anything outside the range is centered
+      if (range != 3 && range != 7) {
+        return false;
+      }
+      field.scale = 8 / (range + 1);
+      return true;
+    // Rounded up, so the logical maximum reaches the end of the target's range
+    case HidTarget::LEFT_TRIGGER:
+    case HidTarget::RIGHT_TRIGGER:
+      field.scale = (int32_t) (((255ll << 16) + range - 1) / range);
+      return true;
+    default:
+      field.scale = (int32_t) (((254ll << 16) + range - 1) / range);  // Then offset by -127
+      return true;
+  }
+}
+
+bool HidReportMap::compile(const uint8_t *descriptor, size_t len) {
+  this->report_count_ = 0;
+  this->field_count_ = 0;
+
+  struct Globals {
+    uint16_t usage_page;
+    int32_t logical_min;
+    int32_t logical_max;      // As signed...
+    uint32_t logical_max_u;   // ...and unsigned: many descriptors encode 0-255 as a 1-byte 0xFF
+    uint32_t report_size;
+    uint32_t report_count;
+    uint8_t report_id;
+  };
+  Globals globals{};
+  Globals stack[4];
+  size_t depth = 0;
+
+  static constexpr size_t MAX_USAGES = 16;
+  uint32_t usages[MAX_USAGES];
+  size_t usage_count = 0;
+  uint32_t usage_min = 0;
+  uint32_t usage_max = 0;
+  bool have_usage_range = false;
+
+  uint32_t report_bits[MAX_REPORTS] = {};
+  uint8_t field_report[MAX_FIELDS];  // Index into reports_ of each field, for grouping
+  size_t dropped = 0;
+
+  for (size_t i = 0; i < len;) {
+    const uint8_t prefix = descriptor[i++];
+    if (prefix == ITEM_LONG_PREFIX) {
+      if (i + 2 > len) {
+        break;
+      }
+      i += 2 + descriptor[i];  // bDataSize, bLongItemTag, data: nothing we use
+      continue;
+    }
+
+    const size_t size = (prefix & 0x03) == 3 ? 4 : prefix & 0x03;
+    if (i + size > len) {
+      ESP_LOGW(TAG, "Report Map truncated at offset %zu", i - 1);
+      break;
+    }
+    uint32_t data = 0;
+    for (size_t b = 0; b < size; b++) {
+      data |= (uint32_t) descriptor[i + b] << (8 * b);
+    }
+    const int32_t sdata = size == 0 ? 0 : (int32_t) (data << (32 - 8 * size)) >> (32 - 8 * size);
+    i += size;
+
+    const uint8_t type = (prefix >> 2) & 0x03;
+    const uint8_t tag = prefix >> 4;
+
+    if (type == ITEM_GLOBAL) {
+      switch (tag) {
+        case GLOBAL_USAGE_PAGE:
+          globals.usage_page = data;
+          break;
+        case GLOBAL_LOGICAL_MIN:
+          globals.logical_min = sdata;
+          break;
+        case GLOBAL_LOGICAL_MAX:
+          globals.logical_max = sdata;
+          globals.logical_max_u = data;
+          break;
+        case GLOBAL_REPORT_SIZE:
+          globals.report_size = data;
+          break;
+        case GLOBAL_REPORT_ID:
+          globals.report_id = data;
+          break;
+        case GLOBAL_REPORT_COUNT:
+          globals.report_count = data;
+          break;
+        case GLOBAL_PUSH:
+          if (depth < sizeof(stack) / sizeof(stack[0])) {
+            stack[depth++] = globals;
+          }
+          break;
+        case GLOBAL_POP:
+          if (depth > 0) {
+            globals = stack[--depth];
+          }
+          break;
+        default:
+          break;
+      }
+      continue;
+    }
+
+    if (type == ITEM_LOCAL) {
+      // 4-byte usages carry their own page
+      const uint32_t u = size == 4 ? data : usage(globals.usage_page, data);
+      switch (tag) {
+        case LOCAL_USAGE:
+          if (usage_count < MAX_USAGES) {
+            usages[usage_count++] = u;
+          }
+          break;
+        case LOCAL_USAGE_MIN:
+          usage_min = u;
+          have_usage_range = true;
+          break;
+        case LOCAL_USAGE_MAX:
+          usage_max = u;
+          have_usage_range = true;
+          break;
+        default:
+          break;
+      }
+      continue;
+    }
+
+    if (type != ITEM_MAIN) {
+      continue;
+    }
+
+    if (tag == MAIN_INPUT) {
+      // Find or add this report's layout
+      size_t report = 0;
+      while (report < this->report_count_ && this->reports_[report].report_id != globals.report_id) {
+        report++;
+      }
+      if (report == this->report_count_ && this->report_count_ < MAX_REPORTS) {
+        this->reports_[this->report_count_++] = {globals.report_id, 0, 0, 0};
+      }
+
+      if (report < this->report_count_) {
+        const int32_t logical_max =
+            globals.logical_min >= 0 ? (int32_t) globals.logical_max_u : globals.logical_max;
+
+        // Array inputs (keyboard-style) and padding take up space but map to nothing
+        const bool mapped = !(data & INPUT_CONSTANT) && (data & INPUT_VARIABLE) && globals.report_size >= 1 &&
+                            globals.report_size <= 24;
+        for (uint32_t k = 0; mapped && k < globals.report_count; k++) {
+          uint32_t u;
+          if (have_usage_range) {
+            u = usage_min + k;
+            if (u > usage_max) {
+              break;  // Past the range: no usage
+            }
+          } else if (usage_count > 0) {
+            u = usages[std::min<size_t>(k, usage_count - 1)];  // The last usage repeats
+          } else {
+            break;
+          }
+
+          HidField field{};
+          const uint32_t offset = report_bits[report] + k * globals.report_size;
+          if (!map_usage(u, field.target, field.arg) || offset + globals.report_size > UINT16_MAX) {
+            continue;
+          }
+          field.bit_offset = offset;
+          field.bit_size = globals.report_size;
+          if (!set_scale(field, globals.logical_min, logical_max)) {
+            continue;
+          }
+          if (this->field_count_ == MAX_FIELDS) {
+            dropped++;
+            continue;
+          }
+          field_report[this->field_count_] = report;
+          this->fields_[this->field_count_++] = field;
+        }
+        report_bits[report] += globals.report_size * globals.report_count;
+      }
+    }
+
+    // Every main item consumes the local state
+    if (tag == MAIN_INPUT || tag == MAIN_OUTPUT || tag == MAIN_FEATURE || tag == MAIN_COLLECTION ||
+        tag == MAIN_END_COLLECTION) {
+      usage_count = 0;
+      have_usage_range = false;
+      usage_min = 0;
+      usage_max = 0;
+    }
+  }
+
+  if (dropped > 0) {
+    ESP_LOGW(TAG, "Report Map has more than %zu mapped fields, %zu ignored", MAX_FIELDS, dropped);
+  }
+
+  // Group fields by report (stable), so each report is one contiguous run of the table
+  for (size_t a = 1; a < this->field_count_; a++) {
+    const HidField field = this->fields_[a];
+    const uint8_t report = field_report[a];
+    size_t b = a;
+    for (; b > 0 && field_report[b - 1] > report; b--) {
+      this->fields_[b] = this->fields_[b - 1];
+      field_report[b] = field_report[b - 1];
+    }
+    this->fields_[b] = field;
+    field_report[b] = report;
+  }
+
+  bool usable = false;
+  size_t next = 0;
+  for (size_t r = 0; r < this->report_count_; r++) {
+    HidReportLayout &layout = this->reports_[r];
+    layout.size = std::min<uint32_t>((report_bits[r] + 7) / 8, UINT16_MAX);
+    layout.first_field = next;
+    while (next < this->field_count_ && field_report[next] == r) {
+      next++;
+    }
+    layout.field_count = next - layout.first_field;
+    usable |= layout.field_count > 0;
+  }
+  return usable;
+}
+
+const HidReportLayout *HidReportMap::find_report(uint16_t len) const {
+  const HidReportLayout *best = nullptr;
+  for (size_t r = 0; r < this->report_count_; r++) {
+    const HidReportLayout &layout = this->reports_[r];
+    if (layout.size == len && layout.field_count > 0 &&
+        (best == nullptr || layout.field_count > best->field_count)) {
+      best = &layout;
+    }
+  }
+  return best;
+}
+
+// Little-endian bit field of 1-24 bits; touches only the bytes the field covers
+static inline uint32_t read_bits(const uint8_t *data, uint16_t bit_offset, uint8_t bit_size) {
+  const uint8_t *p = data + (bit_offset >> 3);
+  const unsigned shift = bit_offset & 7;
+  const unsigned bytes = (shift + bit_size + 7) >> 3;
+  uint32_t raw = 0;
+  for (unsigned b = 0; b < bytes; b++) {
+    raw |= (uint32_t) p[b] << (8 * b);
+  }
+  return (raw >> shift) & ((1u << bit_size) - 1);
+}
+
+static inline int8_t to_stick(int32_t rel, const HidField &field) {
+  int32_t v = (int32_t) (((int64_t) rel * field.scale) >> 16) - 127;
+  v = std::clamp<int32_t>(v, -127, 127);
+  return (int8_t) (field.arg ? -v : v);
+}
+
+static inline uint8_t to_trigger(int32_t rel, const HidField &field) {
+  return (uint8_t) std::clamp<int32_t>((int32_t) (((int64_t) rel * field.scale) >> 16), 0, 255);
+}
+
+void HidReportMap::extract(const HidReportLayout &layout, const uint8_t *data, ControllerState &state) const {
+  uint32_t buttons = 0;
+  const HidField *end = this->fields_ + layout.first_field + layout.field_count;
+  for (const HidField *field = this->fields_ + layout.first_field; field != end; field++) {
+    int32_t value = (int32_t) read_bits(data, field->bit_offset, field->bit_size);
+    if (field->is_signed) {
+      const unsigned unused = 32 - field->bit_size;
+      value = (int32_t) ((uint32_t) value << unused) >> unused;
+    }
+    const int32_t rel = value - field->logical_min;
+
+    switch (field->target) {
+      case HidTarget::BUTTON:
+        buttons |= (uint32_t) (value != 0) << field->arg;
+        break;
+      case HidTarget::HAT: {
+        const uint32_t direction = (uint32_t) rel * field->scale;  // Negative wraps to "centered"
+        buttons |= direction < 8 ? HAT_DPAD[direction] : 0;
+        break;
+      }
+      case HidTarget::LEFT_STICK_X:
+        state.left_stick_x = to_stick(rel, *field);
+        break;
+      case HidTarget::LEFT_STICK_Y:
+        state.left_stick_y = to_stick(rel, *field);
+        break;
+      case HidTarget::RIGHT_STICK_X:
+        state.right_stick_x = to_stick(rel, *field);
+        break;
+      case HidTarget::RIGHT_STICK_Y:
+        state.right_stick_y = to_stick(rel, *field);
+        break;
+      case HidTarget::LEFT_TRIGGER:
+        state.left_trigger = to_trigger(rel, *field);
+        break;
+      case HidTarget::RIGHT_TRIGGER:
+        state.right_trigger = to_trigger(rel, *field);
+        break;
+    }
+  }
+  state.set_button_mask(buttons);
+}
+
+void HidReportMap::dump() const {
+  for (size_t r = 0; r < this->report_count_; r++) {
+    const HidReportLayout &layout = this->reports_[r];
+    if (layout.field_count == 0) {
+      continue;
+    }
+    ESP_LOGD(TAG, "Input report %u: %u bytes, %u field(s)", layout.report_id, layout.size, layout.field_count);
+    for (size_t f = layout.first_field; f < (size_t) layout.first_field + layout.field_count; f++) {
+      const HidField &field = this->fields_[f];
+      ESP_LOGD(TAG, "  bit %3u size %2u -> %s%s %u (min %" PRId32 ")", field.bit_offset, field.bit_size,
+               target_name(field.target), field.is_signed ? " (signed)" : "", field.arg, field.logical_min);
+    }
+  }
+}
+
+}  // namespace esphome::ble_gamepad
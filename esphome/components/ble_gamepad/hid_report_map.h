@@ -0,0 +1,99 @@
+// © Copyright 2025 Stuart Parmenter
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include "controller_base.h"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace esphome::ble_gamepad {
+
+/**
+ * @brief ControllerState field a HID report field is extracted into.
+ */
+enum class HidTarget : uint8_t {
+  BUTTON,  // HidField::arg holds the ButtonBit
+  HAT,     // Hat switch, becomes the d-pad bits
+  LEFT_STICK_X,
+  LEFT_STICK_Y,
+  RIGHT_STICK_X,
+  RIGHT_STICK_Y,
+  LEFT_TRIGGER,
+  RIGHT_TRIGGER,
+};
+
+/**
+ * @brief One compiled input field: where it is in the report and how to scale it.
+ */
+struct HidField {
+  uint16_t bit_offset;  // From the start of the report, without the report ID byte
+  uint8_t bit_size;     // 1-24
+  HidTarget target;
+  uint8_t arg;  // ButtonBit for BUTTON; 1 for an inverted stick axis (HID Y grows downward)
+  bool is_signed;
+  int32_t logical_min;
+  int32_t scale;  // Q16 factor from the logical range to the target's range (HAT: steps per value)
+};
+
+/**
+ * @brief One input report: its fields are a contiguous run of HidReportMap's table.
+ */
+struct HidReportLayout {
+  uint8_t report_id;  // 0 if the descriptor uses no report IDs
+  uint16_t size;      // Bytes, without the report ID byte
+  uint8_t first_field;
+  uint8_t field_count;
+};
+
+/**
+ * @brief HID Report Map (report descriptor) compiled into a field-extraction table.
+ *
+ * compile() walks the descriptor once at connect and keeps only the input fields that map
+ * onto ControllerState (Generic Desktop axes and hat, Button page, a few Consumer and
+ * Simulation usages), with their scaling precomputed. extract() then runs that table
+ * against each report, so a notification costs a few shifts and multiplies per field.
+ *
+ * HOGP strips the report ID from notifications, so reports are told apart by length:
+ * find_report() picks the input report of exactly that size, preferring the one with the
+ * most mapped fields.
+ */
+class HidReportMap {
+ public:
+  static constexpr size_t MAX_REPORTS = 8;
+  static constexpr size_t MAX_FIELDS = 48;
+
+  /**
+   * @brief Compile a report descriptor, replacing any previous table.
+   *
+   * @return true if at least one input report has mapped fields
+   */
+  bool compile(const uint8_t *descriptor, size_t len);
+
+  /**
+   * @brief The input report a notification of `len` bytes carries, or nullptr.
+   */
+  const HidReportLayout *find_report(uint16_t len) const;
+
+  /**
+   * @brief Update `state` from a report matching `layout` (data must hold layout.size bytes).
+   */
+  void extract(const HidReportLayout &layout, const uint8_t *data, ControllerState &state) const;
+
+  /**
+   * @brief Log the compiled table.
+   */
+  void dump() const;
+
+  size_t report_count() const { return report_count_; }
+  size_t field_count() const { return field_count_; }
+
+ protected:
+  HidReportLayout reports_[MAX_REPORTS]{};
+  HidField fields_[MAX_FIELDS]{};
+  uint8_t report_count_{0};
+  uint8_t field_count_{0};
+};
+
+}  // namespace esphome::ble_gamepad
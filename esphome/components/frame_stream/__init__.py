@@ -0,0 +1,66 @@
+# © Copyright 2025 Stuart Parmenter
+# SPDX-License-Identifier: MIT
+
+"""
+Frame stream component for ESPHome.
+
+Streams the damaged areas of each frame a game runner draws, run-length encoded,
+to a UDP endpoint for spectator screens and remote QA.
+"""
+
+import esphome.codegen as cg
+import esphome.config_validation as cv
+from esphome.const import CONF_HOST, CONF_ID, CONF_PORT
+from esphome.components import lvgl_game_runner
+
+# Only works with ESP-IDF framework
+DEPENDENCIES = ["esp32", "network", "lvgl_game_runner"]
+CODEBASE_COMPONENTS = ["esp32"]
+
+# Component namespace
+frame_stream_ns = cg.esphome_ns.namespace("frame_stream")
+
+FrameStream = frame_stream_ns.class_("FrameStream", cg.Component)
+
+# Config keys
+CONF_RUNNER = "runner"
+CONF_MAX_FPS = "max_fps"
+CONF_MAX_RATE = "max_rate"
+CONF_KEYFRAME_INTERVAL = "keyframe_interval"
+
+CONFIG_SCHEMA = cv.Schema(
+    {
+        cv.GenerateID(): cv.declare_id(FrameStream),
+        cv.Required(CONF_RUNNER): cv.use_id(lvgl_game_runner.LvglGameRunner),
+        cv.Required(CONF_HOST): cv.ipv4address,
+        cv.Optional(CONF_PORT, default=5600): cv.port,
+        cv.Optional(CONF_MAX_FPS, default=30.0): cv.float_range(min=0.0, max=240.0),
+        cv.Optional(CONF_MAX_RATE, default=250000): cv.int_range(min=10000, max=10000000),
+        cv.Optional(CONF_KEYFRAME_INTERVAL, default="5s"): cv.Any(
+            cv.one_of(0),
+            cv.All(
+                cv.positive_time_period_milliseconds,
+                cv.Range(min=cv.TimePeriod(milliseconds=500)),
+            ),
+        ),
+    }
+).extend(cv.COMPONENT_SCHEMA)
+
+
+async def to_code(config):
+    """Generate C++ code for frame stream component."""
+    var = cg.new_Pvariable(config[CONF_ID])
+    await cg.register_component(var, config)
+
+    runner = await cg.get_variable(config[CONF_RUNNER])
+    cg.add(var.set_runner(runner))
+    cg.add(var.set_host(str(config[CONF_HOST])))
+    cg.add(var.set_port(config[CONF_PORT]))
+
+    # 0 = send with every frame the runner draws
+    cg.add(var.set_max_fps(config[CONF_MAX_FPS]))
+    # Bytes per second; damage over the budget waits for a later frame
+    cg.add(var.set_max_rate(config[CONF_MAX_RATE]))
+
+    keyframe = config[CONF_KEYFRAME_INTERVAL]
+    cg.add(var.set_keyframe_interval(0 if keyframe == 0 else keyframe.total_milliseconds))
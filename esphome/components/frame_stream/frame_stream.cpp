@@ -0,0 +1,402 @@
+// © Copyright 2025 Stuart Parmenter
+// SPDX-License-Identifier: MIT
+
+#include "frame_stream.h"
+
+#include "esphome/core/hal.h"
+#include "esphome/core/log.h"
+#include "esphome/components/network/util.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#include "esp_timer.h"
+
+namespace esphome::frame_stream {
+
+static const char *const TAG = "frame_stream";
+
+namespace {
+
+constexpr uint16_t MAGIC = 0x5346;  // "FS"
+constexpr uint8_t VERSION = 1;
+
+enum Flags : uint8_t {
+  FLAG_END = 1 << 0,     // Last packet of a frame (a frame cut short by the budget has none)
+  FLAG_SWAP16 = 1 << 1,  // 16-bit pixels are byte-swapped (LV_COLOR_16_SWAP)
+};
+
+enum RecordType : uint8_t {
+  RECORD_PALETTE = 1,  // count, then `count` 0xAARRGGBB entries
+  RECORD_AREA = 2,     // AreaRecord, then the area's rows run-length encoded
+};
+
+struct __attribute__((packed)) Header {
+  uint16_t magic;
+  uint8_t version;
+  uint8_t flags;
+  uint16_t frame;   // Frame number; a frame may take several packets
+  uint16_t seq;     // Packet number, to spot losses
+  uint16_t width;   // Game area, in game pixels
+  uint16_t height;
+  uint8_t format;   // Bits per pixel: LV_COLOR_DEPTH, or 1/2/4 for palette indices
+  uint8_t reserved;
+};
+
+// On an indexed canvas x and w cover whole bytes, so the last one may reach past the width
+struct __attribute__((packed)) AreaRecord {
+  uint8_t type;
+  uint16_t x;
+  uint16_t y;
+  uint16_t w;
+  uint16_t h;
+};
+
+constexpr size_t PALETTE_RECORD_MAX = 2 + 16 * sizeof(uint32_t);
+
+// An RLE control byte below 128 is followed by that many plus one literal units; from 128
+// up, the unit after it repeats (control - 126) times
+constexpr size_t MAX_LITERAL = 128;
+constexpr size_t MAX_REPEAT = 129;
+
+}  // namespace
+
+void FrameStream::setup() {
+  fd_ = ::socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+  if (fd_ < 0) {
+    ESP_LOGE(TAG, "Can't create socket: errno %d", errno);
+    this->mark_failed();
+    return;
+  }
+  // Never wait for the stack: a packet it has no room for is retried with a later frame
+  fcntl(fd_, F_SETFL, fcntl(fd_, F_GETFL, 0) | O_NONBLOCK);
+  const int broadcast = 1;
+  setsockopt(fd_, SOL_SOCKET, SO_BROADCAST, &broadcast, sizeof(broadcast));
+
+  addr_.sin_family = AF_INET;
+  addr_.sin_port = htons(port_);
+  if (inet_pton(AF_INET, host_.c_str(), &addr_.sin_addr) != 1) {
+    ESP_LOGE(TAG, "Invalid host '%s'", host_.c_str());
+    ::close(fd_);
+    fd_ = -1;
+    this->mark_failed();
+    return;
+  }
+  runner_->set_frame_sink(this);
+}
+
+void FrameStream::loop() {
+  const uint32_t now = millis();
+
+  // An idle game (pause screen) runs no frames; wake it so keyframes still go out
+  const uint32_t last_frame = last_frame_ms_.load(std::memory_order_relaxed);
+  if (keyframe_interval_ms_ != 0 && now - last_frame >= keyframe_interval_ms_ &&
+      now - last_wake_ms_ >= keyframe_interval_ms_) {
+    last_wake_ms_ = now;
+    runner_->wake();
+  }
+
+  if (now - last_stats_ms_ < STATS_INTERVAL_MS)
+    return;
+  const uint32_t window_ms = now - last_stats_ms_;
+  last_stats_ms_ = now;
+  const uint32_t frames = frames_sent_.exchange(0, std::memory_order_relaxed);
+  const uint32_t deferred = frames_deferred_.exchange(0, std::memory_order_relaxed);
+  const uint32_t bytes = bytes_sent_.exchange(0, std::memory_order_relaxed);
+  const uint32_t raw = raw_bytes_.exchange(0, std::memory_order_relaxed);
+  const uint32_t errors = send_errors_.exchange(0, std::memory_order_relaxed);
+  if (frames == 0 && deferred == 0 && errors == 0)
+    return;
+  ESP_LOGD(TAG, "%u frames sent, %u deferred, %.1f KB/s (%u%% of the raw pixels), %u send errors", (unsigned) frames,
+           (unsigned) deferred, bytes / 1.024f / window_ms, raw ? (unsigned) ((uint64_t) bytes * 100 / raw) : 0u,
+           (unsigned) errors);
+}
+
+void FrameStream::dump_config() {
+  ESP_LOGCONFIG(TAG, "Frame Stream:");
+  ESP_LOGCONFIG(TAG, "  Destination: %s:%u (UDP)", host_.c_str(), port_);
+  ESP_LOGCONFIG(TAG, "  Max rate: %u bytes/s", (unsigned) max_rate_);
+  if (min_interval_us_ != 0)
+    ESP_LOGCONFIG(TAG, "  Max FPS: %.1f", 1000000.0f / min_interval_us_);
+  ESP_LOGCONFIG(TAG, "  Keyframe interval: %u ms", (unsigned) keyframe_interval_ms_);
+  if (this->is_failed())
+    ESP_LOGCONFIG(TAG, "  Setup failed");
+}
+
+// ---- Frames ----
+
+void FrameStream::on_frame(const FrameView &frame) {
+  if (fd_ < 0 || !frame.damage)
+    return;
+  const uint32_t now_ms = millis();
+  const uint64_t now_us = esp_timer_get_time();
+  last_frame_ms_.store(now_ms, std::memory_order_relaxed);
+
+  if (!started_ || frame.generation != generation_ || frame.w != w_ || frame.h != h_ || frame.bpp != bpp_) {
+    // New picture: everything goes out again
+    started_ = true;
+    generation_ = frame.generation;
+    w_ = frame.w;
+    h_ = frame.h;
+    bpp_ = frame.bpp;
+    unit_ = bpp_ ? 1 : sizeof(lv_color_t);
+    pending_.set_bounds(w_, h_);
+    pending_.add_full();
+    resume_y_ = 0;
+    palette_sent_ = false;
+    last_key_ms_ = now_ms;
+
+    // Worst case a row of n units takes n * unit_ + ceil(n / 128) bytes
+    const size_t room = MAX_PACKET - sizeof(Header) - PALETTE_RECORD_MAX - sizeof(AreaRecord);
+    const size_t units = room * MAX_LITERAL / (MAX_LITERAL * unit_ + 1) - 1;
+    const int per_unit = bpp_ ? 8 / bpp_ : 1;
+    // An indexed strip is widened to whole bytes at both ends
+    max_cols_ = std::max<int>((int) units * per_unit - 2 * per_unit, per_unit);
+  } else {
+    pending_.merge(*frame.damage);
+  }
+  if (keyframe_interval_ms_ != 0 && now_ms - last_key_ms_ >= keyframe_interval_ms_) {
+    pending_.add_full();
+    palette_sent_ = false;
+    last_key_ms_ = now_ms;
+  }
+
+  const size_t palette_bytes = bpp_ ? ((size_t) 1 << bpp_) * sizeof(uint32_t) : 0;
+  const bool palette_changed = bpp_ && frame.palette && (!palette_sent_ || memcmp(palette_, frame.palette, palette_bytes));
+  if (pending_.empty() && !palette_changed)
+    return;
+
+  // Over the frame rate or byte budget, or nowhere to send: the damage waits for a later frame
+  if (min_interval_us_ != 0 && now_us - last_send_us_ < min_interval_us_)
+    return;
+  this->refill_(now_us);
+  if (tokens_ < (int64_t) MAX_PACKET || !network::is_connected()) {
+    frames_deferred_.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+  last_send_us_ = now_us;
+  frame_seq_++;
+  this->begin_packet_();
+
+  DamageTracker todo = pending_;
+  pending_.clear();
+  bool ok = !palette_changed || this->add_palette_(frame);
+
+  // A full picture starts where the last one that didn't fit stopped
+  lv_area_t areas[DamageTracker::MAX_RECTS];
+  size_t count = 0;
+  const bool full = todo.is_full();
+  if (full) {
+    if (resume_y_ >= h_)
+      resume_y_ = 0;
+    areas[count++] = lv_area_t{0, (lv_coord_t) resume_y_, (lv_coord_t) (w_ - 1), (lv_coord_t) (h_ - 1)};
+    if (resume_y_ > 0)
+      areas[count++] = lv_area_t{0, 0, (lv_coord_t) (w_ - 1), (lv_coord_t) (resume_y_ - 1)};
+  } else {
+    for (size_t i = 0; i < todo.size(); i++)
+      areas[count++] = todo[i];
+  }
+
+  for (size_t i = 0; i < count; i++) {
+    const lv_area_t &a = areas[i];
+    for (int x = a.x1; x <= a.x2; x += max_cols_) {
+      const lv_area_t strip{(lv_coord_t) x, a.y1, (lv_coord_t) std::min<int>(x + max_cols_ - 1, a.x2), a.y2};
+      lv_area_t rest;
+      if (!ok) {
+        this->requeue_(strip);
+      } else if (!this->send_area_(frame, strip, rest)) {
+        ok = false;
+        this->requeue_(rest);
+        if (full && i == 0)
+          resume_y_ = rest.y1;
+      }
+    }
+  }
+  if (ok)
+    ok = this->send_packet_(true);
+  if (ok) {
+    frames_sent_.fetch_add(1, std::memory_order_relaxed);
+    if (full)
+      resume_y_ = 0;
+  } else {
+    frames_deferred_.fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+bool FrameStream::send_area_(const FrameView &frame, const lv_area_t &area, lv_area_t &rest) {
+  int x1 = area.x1;
+  int x2 = area.x2;
+  size_t units;
+  size_t offset;
+  if (bpp_) {
+    const int per_byte = 8 / bpp_;
+    x1 = x1 / per_byte * per_byte;
+    x2 = (x2 / per_byte + 1) * per_byte - 1;
+    units = (x2 - x1 + 1) / per_byte;
+    offset = x1 / per_byte;
+  } else {
+    units = x2 - x1 + 1;
+    offset = (size_t) x1 * unit_;
+  }
+
+  int y = area.y1;
+  while (y <= area.y2) {
+    if (packet_len_ + sizeof(AreaRecord) + 1 + unit_ > MAX_PACKET || num_records_ == MAX_RECORDS) {
+      if (!this->send_packet_(false)) {
+        rest = lv_area_t{area.x1, (lv_coord_t) y, area.x2, area.y2};
+        return false;
+      }
+    }
+
+    // As many rows as fit go into one record
+    const size_t record_at = packet_len_;
+    packet_len_ += sizeof(AreaRecord);
+    int rows = 0;
+    while (y + rows <= area.y2) {
+      const size_t n = this->encode_row_(frame.data + (size_t) (y + rows) * frame.stride + offset, units,
+                                         packet_ + packet_len_, MAX_PACKET - packet_len_);
+      if (n == 0)
+        break;
+      packet_len_ += n;
+      rows++;
+    }
+    if (rows == 0) {
+      packet_len_ = record_at;
+      // max_cols_ keeps a row within an empty packet; don't spin if that ever fails
+      if (num_records_ == 0 || !this->send_packet_(false)) {
+        rest = lv_area_t{area.x1, (lv_coord_t) y, area.x2, area.y2};
+        return false;
+      }
+      continue;
+    }
+
+    const AreaRecord rec{RECORD_AREA, (uint16_t) x1, (uint16_t) y, (uint16_t) (x2 - x1 + 1), (uint16_t) rows};
+    memcpy(packet_ + record_at, &rec, sizeof(rec));
+    records_[num_records_++] = lv_area_t{area.x1, (lv_coord_t) y, area.x2, (lv_coord_t) (y + rows - 1)};
+    raw_bytes_.fetch_add(rows * units * unit_, std::memory_order_relaxed);
+    y += rows;
+  }
+  return true;
+}
+
+bool FrameStream::add_palette_(const FrameView &frame) {
+  const size_t count = (size_t) 1 << bpp_;
+  uint8_t *p = packet_ + packet_len_;
+  p[0] = RECORD_PALETTE;
+  p[1] = (uint8_t) count;
+  for (size_t i = 0; i < count; i++) {
+    palette_[i] = frame.palette[i].full;
+    memcpy(p + 2 + i * sizeof(uint32_t), &palette_[i], sizeof(uint32_t));
+  }
+  packet_len_ += 2 + count * sizeof(uint32_t);
+  palette_in_packet_ = true;
+  palette_sent_ = true;
+  return true;
+}
+
+size_t FrameStream::encode_row_(const uint8_t *src, size_t units, uint8_t *dst, size_t cap) const {
+  const size_t u = unit_;
+  auto same = [&](size_t a, size_t b) { return memcmp(src + a * u, src + b * u, u) == 0; };
+  // A repeat only pays off from two pixels, or three bytes of indices
+  const size_t min_run = u == 1 ? 3 : 2;
+  auto run_starts = [&](size_t i) {
+    if (i + min_run > units)
+      return false;
+    for (size_t k = 1; k < min_run; k++) {
+      if (!same(i + k, i))
+        return false;
+    }
+    return true;
+  };
+
+  size_t out = 0;
+  size_t i = 0;
+  while (i < units) {
+    if (run_starts(i)) {
+      size_t run = min_run;
+      while (i + run < units && run < MAX_REPEAT && same(i + run, i))
+        run++;
+      if (out + 1 + u > cap)
+        return 0;
+      dst[out++] = (uint8_t) (run + 126);
+      memcpy(dst + out, src + i * u, u);
+      out += u;
+      i += run;
+      continue;
+    }
+    size_t end = i + 1;
+    while (end < units && end - i < MAX_LITERAL && !run_starts(end))
+      end++;
+    const size_t n = end - i;
+    if (out + 1 + n * u > cap)
+      return 0;
+    dst[out++] = (uint8_t) (n - 1);
+    memcpy(dst + out, src + i * u, n * u);
+    out += n * u;
+    i = end;
+  }
+  return out;
+}
+
+// ---- Packets ----
+
+void FrameStream::begin_packet_() {
+  packet_len_ = sizeof(Header);
+  num_records_ = 0;
+  palette_in_packet_ = false;
+}
+
+bool FrameStream::send_packet_(bool end) {
+  Header h{};
+  h.magic = MAGIC;
+  h.version = VERSION;
+  h.flags = end ? FLAG_END : 0;
+#if LV_COLOR_DEPTH == 16 && LV_COLOR_16_SWAP
+  h.flags |= FLAG_SWAP16;
+#endif
+  h.frame = frame_seq_;
+  h.seq = packet_seq_;
+  h.width = w_;
+  h.height = h_;
+  h.format = bpp_ ? bpp_ : LV_COLOR_DEPTH;
+  memcpy(packet_, &h, sizeof(h));
+
+  bool sent = false;
+  if (tokens_ >= (int64_t) packet_len_) {
+    const ssize_t n = ::sendto(fd_, packet_, packet_len_, 0, reinterpret_cast<const sockaddr *>(&addr_), sizeof(addr_));
+    if (n == (ssize_t) packet_len_) {
+      sent = true;
+    } else {
+      // Mostly ENOMEM / EAGAIN: the stack is out of buffers
+      send_errors_.fetch_add(1, std::memory_order_relaxed);
+      ESP_LOGV(TAG, "Send failed: errno %d", errno);
+    }
+  }
+  if (sent) {
+    tokens_ -= packet_len_;
+    bytes_sent_.fetch_add(packet_len_, std::memory_order_relaxed);
+    packet_seq_++;
+  } else {
+    // What the packet carried goes out with a later frame instead
+    for (size_t i = 0; i < num_records_; i++)
+      this->requeue_(records_[i]);
+    if (palette_in_packet_)
+      palette_sent_ = false;
+  }
+  this->begin_packet_();
+  return sent;
+}
+
+void FrameStream::refill_(uint64_t now_us) {
+  // Up to 100 ms of budget can build up, so a full picture goes out over a few frames
+  const int64_t burst = std::max<int64_t>(2 * MAX_PACKET, max_rate_ / 10);
+  if (last_refill_us_ == 0) {
+    tokens_ = burst;
+  } else {
+    tokens_ = std::min<int64_t>(tokens_ + (int64_t) ((now_us - last_refill_us_) * max_rate_ / 1000000), burst);
+  }
+  last_refill_us_ = now_us;
+}
+
+}  // namespace esphome::frame_stream
@@ -0,0 +1,111 @@
+// © Copyright 2025 Stuart Parmenter
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include "esphome/core/component.h"
+#include "esphome/components/lvgl_game_runner/lvgl_game_runner.h"
+#include "esphome/components/lvgl_game_runner/damage_tracker.h"
+#include "esphome/components/lvgl_game_runner/frame_sink.h"
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+#include "lwip/sockets.h"
+
+namespace esphome::frame_stream {
+
+using lvgl_game_runner::DamageTracker;
+using lvgl_game_runner::FrameView;
+using lvgl_game_runner::LvglGameRunner;
+
+/**
+ * Streams what a runner draws to a UDP endpoint, for spectator screens and remote QA.
+ *
+ * Only the frame's damaged areas are sent, read from the game-resolution pixels (before
+ * any pixel_scale upscale) and run-length encoded row by row. Sending is bounded by a
+ * byte rate and a frame rate: whatever doesn't fit is carried over and sent with a later
+ * frame, so a slow or missing receiver never holds up the game. A full picture goes out
+ * every `keyframe_interval` so a viewer that just started, or lost packets, catches up.
+ */
+class FrameStream : public Component, public lvgl_game_runner::FrameSink {
+ public:
+  void setup() override;
+  void loop() override;
+  void dump_config() override;
+  float get_setup_priority() const override { return setup_priority::AFTER_WIFI; }
+
+  void set_runner(LvglGameRunner *runner) { runner_ = runner; }
+  void set_host(const std::string &host) { host_ = host; }
+  void set_port(uint16_t port) { port_ = port; }
+  void set_max_fps(float fps) { min_interval_us_ = fps > 0 ? (uint32_t) (1000000.0f / fps) : 0; }
+  void set_max_rate(uint32_t bytes_per_second) { max_rate_ = bytes_per_second; }
+  void set_keyframe_interval(uint32_t ms) { keyframe_interval_ms_ = ms; }
+
+  // FrameSink (frame context)
+  void on_frame(const FrameView &frame) override;
+
+ protected:
+  static constexpr size_t MAX_PACKET = 1400;  // Stays under a typical 1500 byte MTU
+  static constexpr size_t MAX_RECORDS = 16;   // Areas per packet
+  static constexpr uint32_t STATS_INTERVAL_MS = 10000;
+
+  // Encoding
+  void begin_packet_();
+  bool send_packet_(bool end);
+  bool add_palette_(const FrameView &frame);
+  bool send_area_(const FrameView &frame, const lv_area_t &area, lv_area_t &rest);
+  void requeue_(const lv_area_t &a) { pending_.add(a.x1, a.y1, a.x2 - a.x1 + 1, a.y2 - a.y1 + 1); }
+  size_t encode_row_(const uint8_t *src, size_t units, uint8_t *dst, size_t cap) const;
+  void refill_(uint64_t now_us);
+
+  // Configuration
+  LvglGameRunner *runner_{nullptr};
+  std::string host_;
+  uint16_t port_{5600};
+  uint32_t min_interval_us_{0};
+  uint32_t max_rate_{250000};
+  uint32_t keyframe_interval_ms_{5000};
+
+  int fd_{-1};
+  sockaddr_in addr_{};
+
+  // Stream state (frame context)
+  uint32_t generation_{0};  // Of the game being streamed
+  bool started_{false};
+  int w_{0};
+  int h_{0};
+  uint8_t bpp_{0};
+  uint8_t unit_{0};         // Bytes per RLE unit: a pixel, or a byte of packed indices
+  int max_cols_{0};         // Widest strip whose rows always fit in one packet
+  DamageTracker pending_;   // Changed since it was last sent
+  int resume_y_{0};         // Where a full picture that didn't fit continues
+  uint32_t palette_[16]{};  // As last sent
+  bool palette_sent_{false};
+  uint16_t frame_seq_{0};
+  uint16_t packet_seq_{0};
+  uint64_t last_send_us_{0};
+  uint64_t last_refill_us_{0};
+  int64_t tokens_{0};  // Bytes that may be sent now
+  uint32_t last_key_ms_{0};
+
+  // The packet being built and the areas it carries (re-queued if it can't be sent)
+  uint8_t packet_[MAX_PACKET];
+  size_t packet_len_{0};
+  lv_area_t records_[MAX_RECORDS]{};
+  size_t num_records_{0};
+  bool palette_in_packet_{false};
+
+  // Since the last stats log; written in the frame context, read by loop()
+  std::atomic<uint32_t> frames_sent_{0};
+  std::atomic<uint32_t> frames_deferred_{0};
+  std::atomic<uint32_t> bytes_sent_{0};
+  std::atomic<uint32_t> raw_bytes_{0};
+  std::atomic<uint32_t> send_errors_{0};
+  std::atomic<uint32_t> last_frame_ms_{0};
+  uint32_t last_stats_ms_{0};
+  uint32_t last_wake_ms_{0};
+};
+
+}  // namespace esphome::frame_stream
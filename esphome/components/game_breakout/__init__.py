@@ -3,7 +3,6 @@
 
 import esphome.codegen as cg
 import esphome.config_validation as cv
-from esphome.const import CONF_ID
 
 from esphome.components import lvgl_game_runner
 
@@ -14,11 +13,11 @@ GameBreakout = game_breakout_ns.class_("GameBreakout", lvgl_game_runner.GameBase
 
 CONFIG_SCHEMA = cv.Schema(
     {
-        cv.GenerateID(): cv.declare_id(GameBreakout),
+        cv.GenerateID(): cv.declare_id(lvgl_game_runner.GameFactory),
     }
 )
 
 
 async def to_code(config):
     """Breakout game initialization - currently no custom config needed."""
-    cg.new_Pvariable(config[CONF_ID])
+    await lvgl_game_runner.register_game(config, "breakout", GameBreakout)
@@ -0,0 +1,211 @@
+// © Copyright 2025 Stuart Parmenter
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <cstdint>
+
+namespace esphome::game_breakout {
+
+/**
+ * W x H 1-bit bitmap in blit_mono_fast() layout: rows of (W + 7) / 8 bytes, MSB first.
+ *
+ * The drawing methods are constexpr and mirror GameBase's primitives pixel for pixel, so
+ * art can be "drawn" by the compiler into a flash table and shown with a single blit.
+ * Everything is clipped to the bitmap.
+ */
+template<int W, int H> struct MonoBitmap {
+  static constexpr int STRIDE = (W + 7) / 8;
+  uint8_t bits[H * STRIDE]{};
+
+  constexpr void set(int x, int y, bool on = true) {
+    if (x < 0 || x >= W || y < 0 || y >= H)
+      return;
+    uint8_t &b = bits[y * STRIDE + x / 8];
+    const uint8_t mask = 0x80 >> (x & 7);
+    b = on ? (uint8_t) (b | mask) : (uint8_t) (b & ~mask);
+  }
+
+  constexpr void fill(int x, int y, int w, int h, bool on = true) {
+    for (int py = y; py < y + h; py++) {
+      for (int px = x; px < x + w; px++)
+        set(px, py, on);
+    }
+  }
+
+  // Like GameBase::draw_rect()
+  constexpr void outline(int x, int y, int w, int h) {
+    fill(x, y, w, 1);
+    fill(x, y + h - 1, w, 1);
+    fill(x, y, 1, h);
+    fill(x + w - 1, y, 1, h);
+  }
+
+  // Like GameBase::draw_line() (Bresenham, both ends included)
+  constexpr void line(int x1, int y1, int x2, int y2) {
+    const int dx = x2 > x1 ? x2 - x1 : x1 - x2;
+    const int dy = -(y2 > y1 ? y2 - y1 : y1 - y2);
+    const int sx = x1 < x2 ? 1 : -1;
+    const int sy = y1 < y2 ? 1 : -1;
+    int err = dx + dy;
+    for (;;) {
+      set(x1, y1);
+      if (x1 == x2 && y1 == y2)
+        break;
+      const int e2 = 2 * err;
+      if (e2 >= dy) {
+        err += dy;
+        x1 += sx;
+      }
+      if (e2 <= dx) {
+        err += dx;
+        y1 += sy;
+      }
+    }
+  }
+
+  // Set bits of another bitmap at (x, y)
+  template<int BW, int BH> constexpr void blit(int x, int y, const MonoBitmap<BW, BH> &src) {
+    for (int py = 0; py < BH; py++) {
+      for (int px = 0; px < BW; px++) {
+        if (src.bits[py * src.STRIDE + px / 8] & (0x80 >> (px & 7)))
+          set(x + px, y + py);
+      }
+    }
+  }
+};
+
+namespace brick_art {
+
+//  ## ##
+// #######
+// #######
+//  #####
+//   ###
+//    #
+inline constexpr MonoBitmap<7, 6> HEART{{0x6C, 0xFE, 0xFE, 0x7C, 0x38, 0x10}};
+
+/**
+ * Every brick look, drawn at compile time.
+ */
+template<int W, int H> struct BrickAtlas {
+  static constexpr int WONKY_PHASES = 4;   // The diagonal stripes repeat every 4 pixels
+  static constexpr int NOISE_FRAMES = 16;  // STATIC bricks cycle through these
+  static constexpr int NOISE_PIXELS = 35;  // Random pixels per noise frame (some coincide)
+
+  MonoBitmap<W, H> normal[5];  // By hp: 1, 2, 3, 4, more than 4
+  MonoBitmap<W, H> unbreakable;
+  MonoBitmap<W, H> shield;
+  MonoBitmap<W, H> extra_ball;
+  MonoBitmap<W, H> wider_paddle;
+  MonoBitmap<W, H> extra_life;
+  MonoBitmap<W, H> shooter;
+  MonoBitmap<W, H> shuffle;
+  MonoBitmap<W, H> wonky[WONKY_PHASES];
+  MonoBitmap<W, H> noise[NOISE_FRAMES];
+};
+
+// 2x2 L-shaped corners of the special bricks
+template<int W, int H> constexpr void corners(MonoBitmap<W, H> &b) {
+  b.set(0, 0);
+  b.set(1, 0);
+  b.set(0, 1);
+  b.set(W - 2, 0);
+  b.set(W - 1, 0);
+  b.set(W - 1, 1);
+  b.set(0, H - 2);
+  b.set(0, H - 1);
+  b.set(1, H - 1);
+  b.set(W - 2, H - 1);
+  b.set(W - 1, H - 1);
+  b.set(W - 1, H - 2);
+}
+
+template<int W, int H> constexpr BrickAtlas<W, H> make_brick_atlas() {
+  BrickAtlas<W, H> a{};
+
+  // Normal bricks lose detail as they lose hp
+  a.normal[0].outline(0, 0, W, H);
+  a.normal[1].outline(0, 0, W, H);
+  a.normal[1].outline(2, 2, W - 4, H - 4);
+  a.normal[2].outline(0, 0, W, H);
+  a.normal[2].fill(2, 2, 2, H - 4);
+  a.normal[2].line(5, 2, 5, 4);
+  a.normal[2].line(7, 2, 7, 4);
+  a.normal[2].line(9, 2, 9, 4);
+  a.normal[2].fill(11, 2, 2, H - 4);
+  a.normal[3].outline(0, 0, W, H);
+  a.normal[3].fill(2, 2, W - 4, H - 4);
+  a.normal[4].fill(0, 0, W, H);
+
+  // Solid with 2x2 holes inside each corner, keeping the 1px border
+  a.unbreakable.fill(0, 0, W, H);
+  a.unbreakable.fill(1, 1, 2, 2, false);
+  a.unbreakable.fill(W - 3, 1, 2, 2, false);
+  a.unbreakable.fill(1, H - 3, 2, 2, false);
+  a.unbreakable.fill(W - 3, H - 3, 2, 2, false);
+
+  // Underline
+  corners(a.shield);
+  a.shield.line(4, H - 1, W - 5, H - 1);
+
+  // Ball on the left, plus sign on the right
+  corners(a.extra_ball);
+  a.extra_ball.line(3, 1, 5, 1);
+  a.extra_ball.fill(2, 2, 5, 3);
+  a.extra_ball.line(3, 5, 5, 5);
+  a.extra_ball.line(W - 7, H / 2, W - 3, H / 2);
+  a.extra_ball.line(W - 5, H / 2 - 2, W - 5, H / 2 + 2);
+
+  // Arrows pointing outward
+  corners(a.wider_paddle);
+  a.wider_paddle.line(2, H / 2, 5, H / 2 - 2);
+  a.wider_paddle.line(2, H / 2, 5, H / 2 + 2);
+  a.wider_paddle.line(W - 3, H / 2, W - 6, H / 2 - 2);
+  a.wider_paddle.line(W - 3, H / 2, W - 6, H / 2 + 2);
+
+  corners(a.extra_life);
+  a.extra_life.blit(W / 2 - 3, H / 2 - 2, HEART);
+
+  // Cannon: underline and a dotted barrel
+  corners(a.shooter);
+  a.shooter.line(4, H - 1, W - 5, H - 1);
+  a.shooter.set(W / 2, H - 3);
+  a.shooter.set(W / 2, H - 5);
+  a.shooter.set(W / 2, H - 7);
+
+  // Question mark
+  corners(a.shuffle);
+  a.shuffle.line(6, 0, 8, 0);
+  a.shuffle.set(5, 1);
+  a.shuffle.line(9, 1, 9, 2);
+  a.shuffle.set(8, 3);
+  a.shuffle.set(7, 4);
+  a.shuffle.set(7, 6);
+
+  // Diagonal stripes, one bitmap per phase of their scroll
+  for (int p = 0; p < a.WONKY_PHASES; p++) {
+    for (int y = 0; y < H; y++) {
+      for (int x = 0; x < W; x++) {
+        if ((x + y + p) % 4 < 2)
+          a.wonky[p].set(x, y);
+      }
+    }
+  }
+
+  // TV static (xorshift32 with a fixed seed)
+  uint32_t s = 0x2545F491u;
+  for (auto &frame : a.noise) {
+    for (int i = 0; i < a.NOISE_PIXELS; i++) {
+      s ^= s << 13;
+      s ^= s >> 17;
+      s ^= s << 5;
+      frame.set((int) ((s >> 8) % W), (int) ((s >> 20) % H));
+    }
+  }
+  return a;
+}
+
+}  // namespace brick_art
+
+}  // namespace esphome::game_breakout
@@ -0,0 +1,81 @@
+// © Copyright 2025 Stuart Parmenter
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <algorithm>
+#include <climits>
+#include <cstdint>
+
+namespace esphome::game_breakout {
+
+/**
+ * Uniform grid broadphase for up to 64 static boxes.
+ *
+ * Each cell holds a bitmask of the boxes overlapping it, so a query ORs a few cells and
+ * yields candidate indices in ascending order (iterate with __builtin_ctzll), which keeps
+ * collision response order identical to a linear scan. Boxes and queries are closed
+ * rectangles [x1, x2] x [y1, y2]; coordinates outside the grid clamp to its edge cells,
+ * which keeps every query conservative. Rebuild (clear() + insert()) whenever boxes move.
+ */
+template<int CELL_W, int CELL_H, int COLS, int ROWS> class BrickGrid {
+ public:
+  /**
+   * @param origin_x,origin_y Position of the top-left corner of cell (0, 0)
+   */
+  void clear(int origin_x, int origin_y) {
+    std::fill(this->cells_, this->cells_ + COLS * ROWS, 0);
+    this->origin_x_ = origin_x;
+    this->origin_y_ = origin_y;
+    this->min_x_ = this->min_y_ = INT_MAX;
+    this->max_x_ = this->max_y_ = INT_MIN;
+    this->version_++;
+  }
+
+  void insert(int index, int x1, int y1, int x2, int y2) {
+    const uint64_t bit = 1ull << index;
+    for (int row = this->row_(y1); row <= this->row_(y2); row++) {
+      for (int col = this->col_(x1); col <= this->col_(x2); col++)
+        this->cells_[row * COLS + col] |= bit;
+    }
+    this->min_x_ = std::min(this->min_x_, x1);
+    this->min_y_ = std::min(this->min_y_, y1);
+    this->max_x_ = std::max(this->max_x_, x2);
+    this->max_y_ = std::max(this->max_y_, y2);
+  }
+
+  /**
+   * Bitmask of boxes that may overlap [x1, x2] x [y1, y2].
+   */
+  uint64_t query(int x1, int y1, int x2, int y2) const {
+    if (x2 < this->min_x_ || x1 > this->max_x_ || y2 < this->min_y_ || y1 > this->max_y_)
+      return 0;  // Most of the playfield has no bricks at all
+    uint64_t mask = 0;
+    for (int row = this->row_(y1); row <= this->row_(y2); row++) {
+      for (int col = this->col_(x1); col <= this->col_(x2); col++)
+        mask |= this->cells_[row * COLS + col];
+    }
+    return mask;
+  }
+
+  /**
+   * Changes on every rebuild, so callers can notice boxes moving mid-iteration.
+   */
+  uint32_t version() const { return this->version_; }
+
+ private:
+  int col_(int x) const { return std::clamp(floor_div_(x - this->origin_x_, CELL_W), 0, COLS - 1); }
+  int row_(int y) const { return std::clamp(floor_div_(y - this->origin_y_, CELL_H), 0, ROWS - 1); }
+  static int floor_div_(int a, int b) { return a >= 0 ? a / b : -((-a + b - 1) / b); }
+
+  uint64_t cells_[COLS * ROWS]{};
+  int origin_x_{0};
+  int origin_y_{0};
+  int min_x_{INT_MAX};
+  int min_y_{INT_MAX};
+  int max_x_{INT_MIN};
+  int max_y_{INT_MIN};
+  uint32_t version_{0};
+};
+
+}  // namespace esphome::game_breakout
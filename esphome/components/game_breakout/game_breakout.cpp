@@ -2,9 +2,11 @@
 // Ported from: https://github.com/richrd/esphome-clock-os/tree/main/clockos/packages/games/breakout
 
 #include "game_breakout.h"
+#include "brick_art.h"
 #include "esphome/core/log.h"
 #include <algorithm>
 #include <cstdlib>
+#include <cstring>
 #include <cmath>
 
 namespace esphome::game_breakout {
@@ -26,9 +28,7 @@ GameBreakout::GameBreakout()
       paddle_y_(0),
       paddle_hit_(false),
       autoplay_(false),
-      input_position_(25),  // Start in middle
-      left_held_(false),
-      right_held_(false) {
+      input_position_(25) {  // Start in middle
   // Initialize balls
   for (int i = 0; i < MAX_BALLS; i++) {
     balls_[i] = {0, 0, 0, 0, false};
@@ -41,10 +41,22 @@ GameBreakout::GameBreakout()
   // Initialize colors
   color_on_ = lv_color_hex(0xFFFFFF);
   color_off_ = lv_color_hex(0x000000);
+
+  // Moving objects are sprites; balls sit on top
+  paddle_sprite_ = sprites_.add();
+  for (int p = 0; p < MAX_SPRITE_PROJECTILES; p++) {
+    projectile_sprites_[p] = sprites_.add();
+  }
+  for (int b = 0; b < MAX_BALLS; b++) {
+    ball_sprites_[b] = sprites_.add(1);
+  }
+  sprites_.set_background(color_off_);
+  set_sprite_layer(&sprites_);
 }
 
 void GameBreakout::on_bind(lv_obj_t *canvas) {
   GameBase::on_bind(canvas);
+  cache_text(color_on_, color_off_, "0123456789 L", {"LEVEL", "GET READY!", "BALLS: ", "SCORE:"});
   ESP_LOGI(TAG, "Breakout game bound to canvas");
 }
 
@@ -52,42 +64,26 @@ void GameBreakout::on_resize(const Rect &r) {
   GameBase::on_resize(r);
   ESP_LOGI(TAG, "Breakout canvas resized to %dx%d", r.w, r.h);
   paddle_y_ = r.h - PADDLE_H;
+  needs_full_clear_ = true;
 }
 
 void GameBreakout::reset() {
+  needs_full_clear_ = true;
   reset_game_();
   state_.reset();
 }
 
 void GameBreakout::on_input(const InputEvent &event) {
+  // The paddle polls input_ in update(); buttons only toggle autoplay, on press
   switch (event.type) {
-    case InputType::LEFT:
-      // Track held state for continuous movement
-      left_held_ = event.pressed;
-      break;
-    case InputType::RIGHT:
-      // Track held state for continuous movement
-      right_held_ = event.pressed;
-      break;
     case InputType::A:
     case InputType::B:
     case InputType::START:
-      // Toggle autoplay on button press only
       if (event.pressed) {
         autoplay_ = !autoplay_;
         ESP_LOGI(TAG, "Autoplay: %s", autoplay_ ? "ON" : "OFF");
       }
       break;
-    case InputType::ROTATE_CW:
-      // Rotary encoder - treat each click as a single increment
-      if (event.pressed && input_position_ < 50)
-        input_position_++;
-      break;
-    case InputType::ROTATE_CCW:
-      // Rotary encoder - treat each click as a single decrement
-      if (event.pressed && input_position_ > 0)
-        input_position_--;
-      break;
     default:
       break;
   }
@@ -146,7 +142,9 @@ void GameBreakout::setup_next_level_() {
 
   // Increase speed progressively
   if (level_ > 1) {
-    speed_ = SPEED_INITIAL * powf(SPEED_INCREASE_FACTOR, level_ - 1);
+    speed_ = SPEED_INITIAL;
+    for (int i = 1; i < level_ && speed_ < SPEED_MAX; i++)
+      speed_ *= SPEED_INCREASE_FACTOR;
     if (speed_ > SPEED_MAX) {
       speed_ = SPEED_MAX;
     }
@@ -201,11 +199,11 @@ void GameBreakout::setup_next_level_() {
   }
 
   while (assigned < max_assigned) {
-    int idx = 8 + (esp_random() % (end_brick - 8));
+    int idx = 8 + (int) rng_.below(end_brick - 8);
     if (bricks_[idx].hp > 0 && bricks_[idx].type == NORMAL) {
       BrickType rtype_choices[] = {SHIELD,       EXTRA_BALL, WIDER_PADDLE,   EXTRA_LIFE,
                                    WONKY_BRICKS, SHOOTER,    POWERUP_SHUFFLE};
-      int rtype_idx = esp_random() % (sizeof(rtype_choices) / sizeof(rtype_choices[0]));
+      int rtype_idx = rng_.below(sizeof(rtype_choices) / sizeof(rtype_choices[0]));
       bricks_[idx].type = rtype_choices[rtype_idx];
 
       if (bricks_[idx].type == POWERUP_SHUFFLE) {
@@ -239,18 +237,18 @@ void GameBreakout::shoot_projectile_() {
     Projectile p;
     p.x = paddle_x_ + (paddle_w_ / 2);
     p.y = paddle_y_ - 2;
-    projectiles_.push_back(p);
+    projectiles_.add(p);
   } else if (shooter_level_ == 2) {
     // Shoot from alternating sides of the paddle
     Projectile p1;
     p1.x = paddle_x_ + 2;
     p1.y = paddle_y_ - 2;
-    projectiles_.push_back(p1);
+    projectiles_.add(p1);
 
     Projectile p2;
     p2.x = paddle_x_ + paddle_w_ - 3;
     p2.y = paddle_y_ - 2;
-    projectiles_.push_back(p2);
+    projectiles_.add(p2);
   }
 }
 
@@ -315,7 +313,7 @@ void GameBreakout::on_brick_hit_(int brick_id) {
           case SHOOTER:
           case POWERUP_SHUFFLE:
             // Assign a new random powerup type
-            bricks_[i].type = rtype_choices[esp_random() % (sizeof(rtype_choices) / sizeof(rtype_choices[0]))];
+            bricks_[i].type = rtype_choices[rng_.below(sizeof(rtype_choices) / sizeof(rtype_choices[0]))];
             break;
           default:
             break;
@@ -331,20 +329,23 @@ void GameBreakout::on_brick_hit_(int brick_id) {
 }
 
 void GameBreakout::update_projectiles_() {
-  for (int i = 0; i < projectiles_.size();) {
+  for (size_t i = 0; i < projectiles_.size();) {
     projectiles_[i].y -= 2;  // Move projectile upwards
     if (projectiles_[i].y < 0) {
-      // Remove projectile if it goes off-screen
-      projectiles_.erase(projectiles_.begin() + i);
+      // Remove projectile if it goes off-screen (the last one takes its place)
+      projectiles_.remove_at(i);
     } else {
       i++;
     }
   }
 
   // Check for projectile collisions with bricks
-  for (int p = 0; p < projectiles_.size();) {
+  for (size_t p = 0; p < projectiles_.size();) {
     bool hit = false;
-    for (int i = 0; i < BRICK_COUNT; i++) {
+    const int px = scalar_floor(projectiles_[p].x);
+    const int py = scalar_floor(projectiles_[p].y);
+    for (uint64_t candidates = brick_grid_.query(px, py, px, py); candidates; candidates &= candidates - 1) {
+      const int i = __builtin_ctzll(candidates);
       Brick &brick = bricks_[i];
       if (brick.hp == 0)
         continue;
@@ -352,7 +353,7 @@ void GameBreakout::update_projectiles_() {
           projectiles_[p].y < brick.y + BRICK_H) {
         on_brick_hit_(i);
         // Remove projectile
-        projectiles_.erase(projectiles_.begin() + p);
+        projectiles_.remove_at(p);
         hit = true;
         break;
       }
@@ -374,28 +375,38 @@ bool GameBreakout::any_balls_alive_() {
 
 void GameBreakout::align_brick_positions_() {
   for (int i = 0; i < BRICK_COUNT; i++) {
-    bricks_[i].x = (i % 8) * (BRICK_W + 1);
-    bricks_[i].y = (i / 8) * (BRICK_H + 1);
+    bricks_[i].x = (i % BRICK_COLS) * (BRICK_W + 1);
+    bricks_[i].y = (i / BRICK_COLS) * (BRICK_H + 1);
     bricks_[i].hp = 0;
     bricks_[i].type = NORMAL;
   }
+  rebuild_brick_grid_();
 }
 
 void GameBreakout::randomise_brick_positions_() {
   for (int i = 0; i < BRICK_COUNT; i++) {
     // Only apply to about 33% of bricks
-    if ((esp_random() % 3) == 0) {
-      int delta_x = (esp_random() % 3) - 1;  // -1, 0, or +1
-      int delta_y = (esp_random() % 3) - 1;  // -1, 0, or +1
+    if (rng_.below(3) == 0) {
+      int delta_x = (int) rng_.below(3) - 1;  // -1, 0, or +1
+      int delta_y = (int) rng_.below(3) - 1;  // -1, 0, or +1
       bricks_[i].x += delta_x * 1;
       bricks_[i].y += delta_y * 1;
     }
   }
+  rebuild_brick_grid_();
+}
+
+void GameBreakout::rebuild_brick_grid_() {
+  // Dead bricks stay in the grid (hp is checked per hit), so only moves need a rebuild
+  brick_grid_.clear(-(BRICK_W + 1), -(BRICK_H + 1));
+  for (int i = 0; i < BRICK_COUNT; i++) {
+    brick_grid_.insert(i, bricks_[i].x, bricks_[i].y, bricks_[i].x + BRICK_W, bricks_[i].y + BRICK_H);
+  }
 }
 
 // ========== Main Game Loop ==========
 
-void GameBreakout::step(float dt) {
+void GameBreakout::update(Scalar dt) {
   if (!canvas_ || state_.game_over)
     return;
 
@@ -428,17 +439,22 @@ void GameBreakout::step(float dt) {
 
   state_.score = score_ticker_;
 
-  // Apply continuous movement from held directions
-  // Speed: 100 positions/second = full range (0-50) in 0.5 seconds
-  constexpr float PADDLE_SPEED = 100.0f;  // positions per second
-  if (left_held_ && !right_held_) {
-    input_position_ = std::clamp(input_position_ - PADDLE_SPEED * dt, 0.0f, 50.0f);
-  } else if (right_held_ && !left_held_) {
-    input_position_ = std::clamp(input_position_ + PADDLE_SPEED * dt, 0.0f, 50.0f);
+  // Steer from any player: each encoder click is one position, held directions move
+  // continuously at 100 positions/second = full range (0-50) in 0.5 seconds
+  const auto in = input_.combined();
+  constexpr int PADDLE_SPEED = 100;  // positions per second
+  const bool left = in.is_held(InputType::LEFT);
+  const bool right = in.is_held(InputType::RIGHT);
+  Scalar move = Scalar(in.rotate);
+  if (left && !right) {
+    move -= PADDLE_SPEED * dt;
+  } else if (right && !left) {
+    move += PADDLE_SPEED * dt;
   }
+  input_position_ = std::clamp(input_position_ + move, Scalar(0), Scalar(50));
 
   // Calculate paddle position
-  paddle_x_ = input_position_ * ((float) (area_.w - paddle_w_) / 50);
+  paddle_x_ = (int) (input_position_ / 50 * (area_.w - paddle_w_));
   paddle_y_ = area_.h - PADDLE_H;
   paddle_hit_ = false;
 
@@ -448,7 +464,7 @@ void GameBreakout::step(float dt) {
     int ball_direction_x = 0;
     for (int b = 0; b < MAX_BALLS; b++) {
       if (balls_[b].alive) {
-        ball_position_x = balls_[b].x;
+        ball_position_x = (int) balls_[b].x;
         ball_direction_x = balls_[b].direction_x;
         break;
       }
@@ -473,7 +489,8 @@ void GameBreakout::step(float dt) {
       reset_game_();
     }
   } else {
-    // Game loop logic
+    // Game loop logic (projectiles, balls, collisions), timed as its own profiler section
+    auto timer = profile_scope("physics");
     level_started_ = true;
 
     // Shoot
@@ -540,9 +557,17 @@ void GameBreakout::step(float dt) {
         }
       }
 
-      // Brick collisions
-      for (int i = 0; i < BRICK_COUNT; i++) {
+      // Brick collisions, against the bricks near the ball in index order
+      const int bx1 = scalar_floor(ball.x);
+      const int by1 = scalar_floor(ball.y);
+      const int bx2 = scalar_ceil(ball.x + BALL_SIZE);
+      const int by2 = scalar_ceil(ball.y + BALL_SIZE);
+      uint64_t candidates = brick_grid_.query(bx1, by1, bx2, by2);
+      while (candidates) {
+        const int i = __builtin_ctzll(candidates);
+        candidates &= candidates - 1;
         Brick &brick = bricks_[i];
+        const uint32_t grid_version = brick_grid_.version();
 
         if (brick.hp == 0) {
           continue;
@@ -582,11 +607,20 @@ void GameBreakout::step(float dt) {
             }
           }
         }
+
+        // A wonky brick hit moves bricks; look again, for bricks after this one
+        if (brick_grid_.version() != grid_version)
+          candidates = brick_grid_.query(bx1, by1, bx2, by2) & ~((2ull << i) - 1);
       }
     }
   }
+}
 
-  // Render the game
+void GameBreakout::render(Scalar alpha) {
+  (void) alpha;
+  if (!canvas_ || state_.game_over)
+    return;
+  // Rendering diffs against what was last drawn, so several updates per render are fine
   render_();
 }
 
@@ -596,216 +630,214 @@ void GameBreakout::render_() {
   if (!canvas_)
     return;
 
-  // Clear canvas
-  lv_canvas_fill_bg(canvas_, color_off_, LV_OPA_COVER);
-
-  // Draw game elements
-  draw_lives_left_();
-  draw_score_();
-  draw_level_();
-  draw_bricks_();
-  draw_paddle_();
-  draw_projectiles_();
-  draw_shield_();
-  draw_balls_();
-  draw_overlay_text_();
+  if (needs_full_clear_) {
+    // Paint the whole scene once; after that only what changed is repainted
+    redraw_region(0, 0, area_.w, area_.h);
+    sprites_.invalidate();
+    needs_full_clear_ = false;
+    remember_drawn_state_();
+  } else {
+    update_background_();
+  }
 
-  lv_obj_invalidate(canvas_);
+  // Paddle, balls and projectiles: the sprite layer erases and redraws whatever moved
+  update_sprites_();
 }
 
-void GameBreakout::draw_heart_(int x, int y) {
-  //  ## ##
-  // #######
-  // #######
-  //  #####
-  //   ###
-  //    #
-  draw_line(x + 1, y, x + 2, y, color_on_);
-  draw_line(x + 4, y, x + 5, y, color_on_);
-  fill_rect(x, y + 1, 7, 2, color_on_);
-  draw_line(x + 1, y + 3, x + 5, y + 3, color_on_);
-  draw_line(x + 2, y + 4, x + 4, y + 4, color_on_);
-  draw_pixel(x + 3, y + 5, color_on_);
+GameBase::Rect GameBreakout::overlay_rect_() const {
+  const int text_overlay_y = (area_.h / 2 - OVERLAY_H / 2) - OVERLAY_Y_OFFSET;
+  return Rect{OVERLAY_H_PADDING - 2, text_overlay_y - 2, area_.w - OVERLAY_H_PADDING * 2 + 4, OVERLAY_H + 4};
 }
 
-void GameBreakout::draw_lives_left_() {
-  for (int i = 0; i < state_.lives && i < 6; i++) {
-    draw_heart_(1 + i * 8, 1);
+void GameBreakout::overlay_text_(char *text1, char *text2, size_t len) const {
+  text1[0] = '\0';
+  text2[0] = '\0';
+  if (!level_started_) {
+    snprintf(text1, len, "LEVEL %d", level_);
+    snprintf(text2, len, "GET READY!");
+  } else if (state_.lives > 0) {
+    snprintf(text1, len, "BALLS: %d", state_.lives);
+  } else {
+    snprintf(text1, len, "SCORE:");
+    snprintf(text2, len, "%d", score_);
   }
 }
 
-void GameBreakout::draw_score_() {
-  char buf[16];
-  snprintf(buf, sizeof(buf), "%d", score_ticker_);
-  draw_text(area_.w - 2, 0, buf, color_on_, LV_TEXT_ALIGN_RIGHT);
-}
-
-void GameBreakout::draw_level_() {
-  char buf[16];
-  snprintf(buf, sizeof(buf), "L%d", level_);
-  draw_text(0, 0, buf, color_on_, LV_TEXT_ALIGN_CENTER);
+void GameBreakout::remember_drawn_state_() {
+  for (int i = 0; i < BRICK_COUNT; i++) {
+    drawn_bricks_[i] = bricks_[i];
+  }
+  drawn_lives_ = state_.lives;
+  drawn_score_ = score_ticker_;
+  drawn_level_ = level_;
+  drawn_shield_ = shield_amount_;
+  drawn_overlay_ = pause_frames_ > 0;
+  overlay_text_(drawn_overlay_text1_, drawn_overlay_text2_, sizeof(drawn_overlay_text1_));
 }
 
-void GameBreakout::draw_special_brick_corners_(int x, int y) {
-  // Draw 2x2 L-shaped corners
-  // Top-left
-  draw_pixel(x, y, color_on_);
-  draw_pixel(x + 1, y, color_on_);
-  draw_pixel(x, y + 1, color_on_);
+void GameBreakout::update_background_() {
+  // HUD (hearts, score, level)
+  if (state_.lives != drawn_lives_ || score_ticker_ != drawn_score_ || level_ != drawn_level_) {
+    redraw_region(0, 0, area_.w, HUD_H);
+    drawn_lives_ = state_.lives;
+    drawn_score_ = score_ticker_;
+    drawn_level_ = level_;
+  }
 
-  // Top-right
-  draw_pixel(x + BRICK_W - 2, y, color_on_);
-  draw_pixel(x + BRICK_W - 1, y, color_on_);
-  draw_pixel(x + BRICK_W - 1, y + 1, color_on_);
+  // Bricks: repaint the ones that changed, plus the animated ones
+  for (int i = 0; i < BRICK_COUNT; i++) {
+    const Brick &brick = bricks_[i];
+    Brick &drawn = drawn_bricks_[i];
+    const bool animated = brick.hp != 0 && (brick.type == WONKY_BRICKS || brick.type == STATIC);
+    if (!animated && brick.hp == drawn.hp && brick.type == drawn.type && brick.x == drawn.x && brick.y == drawn.y)
+      continue;
 
-  // Bottom-left
-  draw_pixel(x, y + BRICK_H - 2, color_on_);
-  draw_pixel(x, y + BRICK_H - 1, color_on_);
-  draw_pixel(x + 1, y + BRICK_H - 1, color_on_);
+    if (drawn.hp != 0 && (drawn.x != brick.x || drawn.y != brick.y)) {
+      redraw_region(drawn.x, drawn.y, BRICK_W, BRICK_H);  // Moved: clear the old spot too
+    }
+    redraw_region(brick.x, brick.y, BRICK_W, BRICK_H);
+    drawn = brick;
+  }
 
-  // Bottom-right
-  draw_pixel(x + BRICK_W - 2, y + BRICK_H - 1, color_on_);
-  draw_pixel(x + BRICK_W - 1, y + BRICK_H - 1, color_on_);
-  draw_pixel(x + BRICK_W - 1, y + BRICK_H - 2, color_on_);
-}
+  // Shield
+  if (shield_amount_ != drawn_shield_) {
+    redraw_region(0, area_.h - 1, area_.w, 1);
+    drawn_shield_ = shield_amount_;
+  }
 
-void GameBreakout::draw_unbreakable_brick_(int x, int y) {
-  fill_rect(x, y, BRICK_W, BRICK_H, color_on_);
-  // Clear out 2x2 squares in each corner and keep 1px border intact
-  fill_rect(x + 1, y + 1, 2, 2, color_off_);
-  fill_rect(x + BRICK_W - 3, y + 1, 2, 2, color_off_);
-  fill_rect(x + 1, y + BRICK_H - 3, 2, 2, color_off_);
-  fill_rect(x + BRICK_W - 3, y + BRICK_H - 3, 2, 2, color_off_);
+  // Overlay: repaint when it appears, disappears or its text changes; otherwise only the
+  // progress bar grows, and it is drawn on top of everything else in the overlay
+  char text1[32];
+  char text2[32];
+  overlay_text_(text1, text2, sizeof(text1));
+  const bool overlay = pause_frames_ > 0;
+  if (overlay != drawn_overlay_ || strcmp(text1, drawn_overlay_text1_) != 0 ||
+      strcmp(text2, drawn_overlay_text2_) != 0) {
+    const Rect r = overlay_rect_();
+    drawn_overlay_ = overlay;
+    redraw_region(r.x, r.y, r.w, r.h);
+    memcpy(drawn_overlay_text1_, text1, sizeof(text1));
+    memcpy(drawn_overlay_text2_, text2, sizeof(text2));
+  } else if (overlay) {
+    draw_progress_bar_();
+  }
 }
 
-void GameBreakout::draw_bricks_() {
-  for (int i = 0; i < BRICK_COUNT; i++) {
-    Brick &brick = bricks_[i];
-
-    if (brick.hp == 0) {
-      continue;
-    }
+void GameBreakout::update_sprites_() {
+  if (paddle_hit_) {
+    paddle_sprite_->set_solid(paddle_w_, PADDLE_H, color_on_);
+  } else {
+    paddle_sprite_->set_outline(paddle_w_, PADDLE_H, color_on_);
+  }
+  paddle_sprite_->move_to(paddle_x_, paddle_y_);
+  paddle_sprite_->visible = true;
 
-    int bx = brick.x;
-    int by = brick.y;
-
-    // Special rendering for different brick types
-    if (brick.type == EXTRA_BALL) {
-      draw_special_brick_corners_(bx, by);
-      // Draw a ball (circle) on the left side
-      draw_line(bx + 3, by + 1, bx + 5, by + 1, color_on_);
-      fill_rect(bx + 2, by + 2, 5, 3, color_on_);
-      draw_line(bx + 3, by + 5, bx + 5, by + 5, color_on_);
-      // Draw plus sign on the right side
-      int plus_cx = bx + BRICK_W - 5;
-      int plus_cy = by + BRICK_H / 2;
-      draw_line(plus_cx - 2, plus_cy, plus_cx + 2, plus_cy, color_on_);
-      draw_line(plus_cx, plus_cy - 2, plus_cx, plus_cy + 2, color_on_);
-      continue;
-    }
+  for (int b = 0; b < MAX_BALLS; b++) {
+    Sprite *sprite = ball_sprites_[b];
+    sprite->set_solid(BALL_SIZE, BALL_SIZE, color_on_);
+    sprite->move_to((int) balls_[b].x, (int) balls_[b].y);
+    sprite->visible = balls_[b].alive;
+  }
 
-    if (brick.type == SHIELD) {
-      draw_special_brick_corners_(bx, by);
-      int line_y = by + BRICK_H - 1;
-      draw_line(bx + 4, line_y, bx + BRICK_W - 5, line_y, color_on_);
-      continue;
+  for (int p = 0; p < MAX_SPRITE_PROJECTILES; p++) {
+    Sprite *sprite = projectile_sprites_[p];
+    sprite->visible = p < (int) projectiles_.size();
+    if (sprite->visible) {
+      sprite->set_solid(1, 4, color_on_);
+      sprite->move_to((int) projectiles_[p].x, (int) projectiles_[p].y);
     }
+  }
+}
 
-    if (brick.type == WIDER_PADDLE) {
-      draw_special_brick_corners_(bx, by);
-      int arrow_y = by + BRICK_H / 2;
-      // Left arrow
-      draw_line(bx + 2, arrow_y, bx + 5, arrow_y - 2, color_on_);
-      draw_line(bx + 2, arrow_y, bx + 5, arrow_y + 2, color_on_);
-      // Right arrow
-      draw_line(bx + BRICK_W - 3, arrow_y, bx + BRICK_W - 6, arrow_y - 2, color_on_);
-      draw_line(bx + BRICK_W - 3, arrow_y, bx + BRICK_W - 6, arrow_y + 2, color_on_);
-      continue;
-    }
+void GameBreakout::redraw_background(int x, int y, int w, int h) {
+  // Called with the clip set to the region; all text comes from the text cache, so
+  // everything below is clipped and only the region is touched.
+  const int x1 = x;
+  const int y1 = y;
+  const int x2 = x + w;
+  const int y2 = y + h;
+  const Rect o = overlay_rect_();
+  const bool overlay = drawn_overlay_ && x1 < o.x + o.w && x2 > o.x && y1 < o.y + o.h && y2 > o.y;
 
-    if (brick.type == EXTRA_LIFE) {
-      draw_special_brick_corners_(bx, by);
-      int heart_x = bx + (BRICK_W / 2) - 3;
-      int heart_y = by + (BRICK_H / 2) - 2;
-      draw_heart_(heart_x, heart_y);
-      continue;
-    }
+  fill_rect_fast(x1, y1, x2 - x1, y2 - y1, color_off_);
 
-    if (brick.type == WONKY_BRICKS) {
-      // Draw wonky brick with wavy pattern
-      for (int wx = 0; wx < BRICK_W; wx++) {
-        for (int wy = 0; wy < BRICK_H; wy++) {
-          if (((wx + wy + (frame_ / 2)) % 4) < 2) {
-            draw_pixel(bx + wx, by + wy, color_on_);
-          }
-        }
-      }
-      continue;
+  // Same order as a full frame: HUD, bricks, shield, overlay
+  if (y1 < HUD_H) {
+    draw_lives_left_();
+    draw_score_();
+    draw_level_();
+  }
+  for (int i = 0; i < BRICK_COUNT; i++) {
+    const Brick &brick = bricks_[i];
+    if (brick.hp != 0 && brick.x < x2 && brick.x + BRICK_W > x1 && brick.y < y2 && brick.y + BRICK_H > y1) {
+      draw_brick_(brick);
     }
+  }
+  if (y2 >= area_.h) {
+    draw_shield_();
+  }
+  if (overlay) {
+    draw_overlay_();
+  }
+}
 
-    if (brick.type == STATIC) {
-      // Draw random pixels
-      for (int p = 0; p < 35; ++p) {
-        int rx = bx + (esp_random() % BRICK_W);
-        int ry = by + (esp_random() % BRICK_H);
-        draw_pixel(rx, ry, color_on_);
-      }
-      continue;
-    }
+void GameBreakout::draw_heart_(int x, int y) {
+  blit_mono_fast(x, y, 7, 6, brick_art::HEART.bits, color_on_);
+}
 
-    if (brick.type == SHOOTER) {
-      draw_special_brick_corners_(bx, by);
-      int line_y = by + BRICK_H - 1;
-      draw_line(bx + 4, line_y, bx + BRICK_W - 5, line_y, color_on_);
-      int center_x = bx + BRICK_W / 2;
-      draw_pixel(center_x, line_y - 2, color_on_);
-      draw_pixel(center_x, line_y - 4, color_on_);
-      draw_pixel(center_x, line_y - 6, color_on_);
-      continue;
-    }
+void GameBreakout::draw_lives_left_() {
+  for (int i = 0; i < state_.lives && i < 6; i++) {
+    draw_heart_(1 + i * 8, 1);
+  }
+}
 
-    if (brick.type == POWERUP_SHUFFLE) {
-      draw_special_brick_corners_(bx, by);
-      // Draw a question mark
-      draw_line(bx + 6, by, bx + 8, by, color_on_);
-      draw_pixel(bx + 5, by + 1, color_on_);
-      draw_line(bx + 9, by + 1, bx + 9, by + 2, color_on_);
-      draw_pixel(bx + 8, by + 3, color_on_);
-      draw_pixel(bx + 7, by + 4, color_on_);
-      draw_pixel(bx + 7, by + 6, color_on_);
-      continue;
-    }
+void GameBreakout::draw_score_() {
+  char buf[16];
+  snprintf(buf, sizeof(buf), "%d", score_ticker_);
+  draw_text(area_.w - 2, 0, buf, color_on_, LV_TEXT_ALIGN_RIGHT);
+}
 
-    // Normal bricks - render based on HP
-    if (brick.hp > 4) {
-      fill_rect(bx, by, BRICK_W, BRICK_H, color_on_);
-    } else if (brick.hp == 4) {
-      draw_rect(bx, by, BRICK_W, BRICK_H, color_on_);
-      fill_rect(bx + 2, by + 2, BRICK_W - 4, BRICK_H - 4, color_on_);
-    } else if (brick.hp == 3) {
-      draw_rect(bx, by, BRICK_W, BRICK_H, color_on_);
-      fill_rect(bx + 2, by + 2, 2, BRICK_H - 4, color_on_);
-      draw_line(bx + 5, by + 2, bx + 5, by + 4, color_on_);
-      draw_line(bx + 7, by + 2, bx + 7, by + 4, color_on_);
-      draw_line(bx + 9, by + 2, bx + 9, by + 4, color_on_);
-      fill_rect(bx + 11, by + 2, 2, BRICK_H - 4, color_on_);
-    } else if (brick.hp == 2) {
-      draw_rect(bx, by, BRICK_W, BRICK_H, color_on_);
-      draw_rect(bx + 2, by + 2, BRICK_W - 4, BRICK_H - 4, color_on_);
-    } else if (brick.hp < 0) {
-      draw_unbreakable_brick_(bx, by);
-    } else {
-      draw_rect(bx, by, BRICK_W, BRICK_H, color_on_);
-    }
-  }
+void GameBreakout::draw_level_() {
+  char buf[16];
+  snprintf(buf, sizeof(buf), "L%d", level_);
+  draw_text(area_.w / 2, 0, buf, color_on_, LV_TEXT_ALIGN_CENTER);
 }
 
-void GameBreakout::draw_paddle_() {
-  if (paddle_hit_) {
-    fill_rect(paddle_x_, paddle_y_, paddle_w_, PADDLE_H, color_on_);
-  } else {
-    draw_rect(paddle_x_, paddle_y_, paddle_w_, PADDLE_H, color_on_);
+void GameBreakout::draw_brick_(const Brick &brick) {
+  // Every look is a flash bitmap drawn at compile time (brick_art.h): one blit per brick
+  static constexpr auto ATLAS = brick_art::make_brick_atlas<BRICK_W, BRICK_H>();
+  const MonoBitmap<BRICK_W, BRICK_H> *art;
+  switch (brick.type) {
+    case SHIELD:
+      art = &ATLAS.shield;
+      break;
+    case EXTRA_BALL:
+      art = &ATLAS.extra_ball;
+      break;
+    case WIDER_PADDLE:
+      art = &ATLAS.wider_paddle;
+      break;
+    case EXTRA_LIFE:
+      art = &ATLAS.extra_life;
+      break;
+    case WONKY_BRICKS:
+      art = &ATLAS.wonky[(frame_ / 2) % ATLAS.WONKY_PHASES];
+      break;
+    case SHOOTER:
+      art = &ATLAS.shooter;
+      break;
+    case STATIC:
+      // Each brick starts at its own noise frame, so neighbours don't flicker in step
+      art = &ATLAS.noise[(unsigned) (frame_ + brick.x + brick.y * 3) % ATLAS.NOISE_FRAMES];
+      break;
+    case POWERUP_SHUFFLE:
+      art = &ATLAS.shuffle;
+      break;
+    default:
+      art = brick.hp < 0 ? &ATLAS.unbreakable : &ATLAS.normal[std::min(brick.hp, 5) - 1];
+      break;
   }
+  blit_mono_fast(brick.x, brick.y, BRICK_W, BRICK_H, art->bits, color_on_);
 }
 
 void GameBreakout::draw_shield_() {
@@ -820,63 +852,39 @@ void GameBreakout::draw_shield_() {
   }
 }
 
-void GameBreakout::draw_projectiles_() {
-  for (const auto &p : projectiles_) {
-    fill_rect(p.x, p.y, 1, 4, color_on_);
-  }
-}
-
-void GameBreakout::draw_balls_() {
-  for (int b = 0; b < MAX_BALLS; b++) {
-    if (balls_[b].alive) {
-      fill_rect(balls_[b].x, balls_[b].y, BALL_SIZE, BALL_SIZE, color_on_);
-    }
-  }
-}
+void GameBreakout::draw_overlay_() {
+  const int text_overlay_y = (area_.h / 2 - OVERLAY_H / 2) - OVERLAY_Y_OFFSET;
 
-void GameBreakout::draw_overlay_text_() {
-  if (pause_frames_ > 0) {
-    int overlay_h_padding = 10;
-    int overlay_height = 30;
-    int overlay_y_offset = 4;
-    int text_overlay_y = (area_.h / 2 - overlay_height / 2) - overlay_y_offset;
+  // Draw overlay background
+  const Rect r = overlay_rect_();
+  fill_rect(r.x, r.y, r.w, r.h, color_off_);
+  draw_rect(OVERLAY_H_PADDING, text_overlay_y, area_.w - OVERLAY_H_PADDING * 2, OVERLAY_H, color_on_);
 
-    // Draw overlay background
-    fill_rect(overlay_h_padding - 2, text_overlay_y - 2, area_.w - overlay_h_padding * 2 + 4, overlay_height + 4,
-              color_off_);
-    draw_rect(overlay_h_padding, text_overlay_y, area_.w - overlay_h_padding * 2, overlay_height, color_on_);
+  // Determine text to show
+  char text1[32];
+  char text2[32];
+  overlay_text_(text1, text2, sizeof(text1));
+  int text_center_y = area_.h / 2 - OVERLAY_Y_OFFSET;
 
-    // Determine text to show
-    char text1[32] = "";
-    char text2[32] = "";
-    int text_center_x = area_.w / 2;
-    int text_center_y = area_.h / 2 - overlay_y_offset;
-
-    if (!level_started_) {
-      snprintf(text1, sizeof(text1), "LEVEL %d", level_);
-      snprintf(text2, sizeof(text2), "GET READY!");
-    } else if (state_.lives > 0) {
-      snprintf(text1, sizeof(text1), "BALLS: %d", state_.lives);
-    } else {
-      snprintf(text1, sizeof(text1), "SCORE:");
-      snprintf(text2, sizeof(text2), "%d", score_);
-    }
+  // Draw text
+  if (text2[0] != '\0') {
+    draw_text(area_.w / 2, text_center_y - 8, text1, color_on_, LV_TEXT_ALIGN_CENTER);
+    draw_text(area_.w / 2, text_center_y + 2, text2, color_on_, LV_TEXT_ALIGN_CENTER);
+  } else {
+    draw_text(area_.w / 2, text_center_y - 4, text1, color_on_, LV_TEXT_ALIGN_CENTER);
+  }
 
-    // Draw text
-    if (text2[0] != '\0') {
-      draw_text(0, text_center_y - 8, text1, color_on_, LV_TEXT_ALIGN_CENTER);
-      draw_text(0, text_center_y + 2, text2, color_on_, LV_TEXT_ALIGN_CENTER);
-    } else {
-      draw_text(0, text_center_y - 4, text1, color_on_, LV_TEXT_ALIGN_CENTER);
-    }
+  draw_progress_bar_();
+}
 
-    // Show pause progress bar
-    int progress_bar_padding = 2;
-    int progress_bar_max = (area_.w - overlay_h_padding * 2) - progress_bar_padding * 2;
-    int progress_bar_width = (progress_bar_max * (PAUSE_DURATION - pause_frames_)) / PAUSE_DURATION;
-    fill_rect(overlay_h_padding + progress_bar_padding, text_overlay_y + overlay_height - progress_bar_padding - 4,
-              progress_bar_width, 2, color_on_);
-  }
+void GameBreakout::draw_progress_bar_() {
+  // Show pause progress bar
+  const int text_overlay_y = (area_.h / 2 - OVERLAY_H / 2) - OVERLAY_Y_OFFSET;
+  int progress_bar_padding = 2;
+  int progress_bar_max = (area_.w - OVERLAY_H_PADDING * 2) - progress_bar_padding * 2;
+  int progress_bar_width = (progress_bar_max * (PAUSE_DURATION - pause_frames_)) / PAUSE_DURATION;
+  fill_rect(OVERLAY_H_PADDING + progress_bar_padding, text_overlay_y + OVERLAY_H - progress_bar_padding - 4,
+            progress_bar_width, 2, color_on_);
 }
 
 }  // namespace esphome::game_breakout
@@ -3,18 +3,24 @@
 
 #pragma once
 
+#include "esphome/components/lvgl_game_runner/entity_pool.h"
 #include "esphome/components/lvgl_game_runner/game_base.h"
 #include "esphome/components/lvgl_game_runner/game_state.h"
-#include <esp_random.h>
-#include <vector>
+#include "brick_grid.h"
 #include <cstdint>
 
 namespace esphome::game_breakout {
 
+using lvgl_game_runner::EntityPool;
 using lvgl_game_runner::GameBase;
 using lvgl_game_runner::GameState;
 using lvgl_game_runner::InputEvent;
 using lvgl_game_runner::InputType;
+using lvgl_game_runner::Scalar;
+using lvgl_game_runner::scalar_ceil;
+using lvgl_game_runner::scalar_floor;
+using lvgl_game_runner::Sprite;
+using lvgl_game_runner::SpriteLayer;
 
 /**
  * Classic Breakout/Arkanoid game.
@@ -27,9 +33,12 @@ class GameBreakout : public GameBase {
 
   void on_bind(lv_obj_t *canvas) override;
   void on_resize(const Rect &r) override;
-  void step(float dt) override;
+  void update(Scalar dt) override;
+  void render(Scalar alpha) override;
   void on_input(const InputEvent &event) override;
   void reset() override;
+  // Game over stays on screen until the game is restarted
+  uint32_t idle_hint_us() const override { return paused_ || state_.game_over ? IDLE_UNTIL_INPUT : 0; }
 
  private:
   // Configuration constants
@@ -45,15 +54,24 @@ class GameBreakout : public GameBase {
   static constexpr int PAUSE_DURATION = 100;  // frames at 30fps = ~3 seconds
   static constexpr int POINTS_PER_BRICK = 5;
   static constexpr int POINTS_PER_PADDLE_HIT = 10;
-  static constexpr float SPEED_INITIAL = 0.9f;
-  static constexpr float SPEED_MAX = 5.0f;
-  static constexpr float SPEED_INCREASE_FACTOR = 1.04f;
+  static constexpr Scalar SPEED_INITIAL = Scalar(0.9f);
+  static constexpr Scalar SPEED_MAX = Scalar(5.0f);
+  static constexpr Scalar SPEED_INCREASE_FACTOR = Scalar(1.04f);
   static constexpr int LIVES_INITIAL = 3;
   static constexpr int LIVES_MAX = 6;
   static constexpr int MAX_BALLS = 10;
   static constexpr int MAX_PROJECTILES = 8;
   static constexpr int SHOOTER_COOLDOWN_FRAMES = 15;  // ~0.5s at 30fps
   static constexpr int BRICK_COUNT = 48;              // 8 columns x 6 rows
+  static constexpr int BRICK_COLS = 8;
+  static constexpr int BRICK_ROWS = BRICK_COUNT / BRICK_COLS;
+
+  // Rendering layout
+  static constexpr int MAX_SPRITE_PROJECTILES = MAX_PROJECTILES + 1;  // A double shot can overshoot by one
+  static constexpr int HUD_H = 16;                                    // Hearts / score / level band (text height)
+  static constexpr int OVERLAY_H_PADDING = 10;
+  static constexpr int OVERLAY_H = 30;
+  static constexpr int OVERLAY_Y_OFFSET = 4;
 
   // Brick types
   enum BrickType {
@@ -70,16 +88,16 @@ class GameBreakout : public GameBase {
 
   // Game data structures
   struct Ball {
-    float x;
-    float y;
+    Scalar x;
+    Scalar y;
     int direction_x;
     int direction_y;
     bool alive;
   };
 
   struct Projectile {
-    float x;
-    float y;
+    Scalar x;
+    Scalar y;
   };
 
   struct Brick {
@@ -94,7 +112,7 @@ class GameBreakout : public GameBase {
   int frame_;
   int pause_frames_;
   int paddle_w_;
-  float speed_;
+  Scalar speed_;
   int score_;
   int score_ticker_;
   int level_;
@@ -104,15 +122,35 @@ class GameBreakout : public GameBase {
   int paddle_x_;
   int paddle_y_;
   bool paddle_hit_;
+  bool needs_full_clear_{true};  // Clear whole canvas on the next render (first frame / resize)
   Ball balls_[MAX_BALLS];
-  std::vector<Projectile> projectiles_;
+  EntityPool<Projectile, MAX_SPRITE_PROJECTILES> projectiles_;
   Brick bricks_[BRICK_COUNT];
 
+  // Broadphase over the brick lattice, rebuilt whenever brick positions change. One spare
+  // cell on each side absorbs wonky-brick drift.
+  static_assert(BRICK_COUNT <= 64, "BrickGrid masks hold 64 bricks");
+  BrickGrid<BRICK_W + 1, BRICK_H + 1, BRICK_COLS + 2, BRICK_ROWS + 2> brick_grid_;
+
+  // What is currently on screen, for incremental rendering
+  Brick drawn_bricks_[BRICK_COUNT]{};
+  int drawn_lives_{-1};
+  int drawn_score_{-1};
+  int drawn_level_{-1};
+  int drawn_shield_{-1};
+  bool drawn_overlay_{false};
+  char drawn_overlay_text1_[32]{};
+  char drawn_overlay_text2_[32]{};
+
+  // Moving objects
+  SpriteLayer<1 + MAX_BALLS + MAX_SPRITE_PROJECTILES> sprites_;
+  Sprite *paddle_sprite_;
+  Sprite *ball_sprites_[MAX_BALLS];
+  Sprite *projectile_sprites_[MAX_SPRITE_PROJECTILES];
+
   // Input state
   bool autoplay_;
-  float input_position_;  // Simulated knob position (0-50, float for smooth movement)
-  bool left_held_;        // Track if left direction is held
-  bool right_held_;       // Track if right direction is held
+  Scalar input_position_;  // Simulated knob position (0-50, fractional for smooth movement)
 
   // Colors
   lv_color_t color_on_;
@@ -133,21 +171,24 @@ class GameBreakout : public GameBase {
   bool any_balls_alive_();
   void align_brick_positions_();
   void randomise_brick_positions_();
+  void rebuild_brick_grid_();
 
   // Rendering helpers
   void render_();
+  void remember_drawn_state_();
+  void update_background_();
+  void update_sprites_();
+  void redraw_background(int x, int y, int w, int h) override;
+  Rect overlay_rect_() const;
+  void overlay_text_(char *text1, char *text2, size_t len) const;
   void draw_heart_(int x, int y);
   void draw_lives_left_();
   void draw_score_();
   void draw_level_();
-  void draw_special_brick_corners_(int x, int y);
-  void draw_unbreakable_brick_(int x, int y);
-  void draw_bricks_();
-  void draw_paddle_();
+  void draw_brick_(const Brick &brick);
   void draw_shield_();
-  void draw_projectiles_();
-  void draw_balls_();
-  void draw_overlay_text_();
+  void draw_overlay_();
+  void draw_progress_bar_();
 };
 
 }  // namespace esphome::game_breakout
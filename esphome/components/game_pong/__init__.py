@@ -3,28 +3,43 @@
 
 import esphome.codegen as cg
 import esphome.config_validation as cv
-from esphome.const import CONF_ID
 
 from esphome.components import lvgl_game_runner
 
 DEPENDENCIES = ["lvgl_game_runner"]
 
 CONF_NUM_HUMAN_PLAYERS = "num_human_players"
+CONF_AI_MODE = "ai_mode"
 
 game_pong_ns = cg.esphome_ns.namespace("game_pong")
 GamePong = game_pong_ns.class_("GamePong", lvgl_game_runner.GameBase)
+PongAI = game_pong_ns.class_("PongAI")
+
+AIMode = PongAI.enum("Mode", is_class=True)
+AI_MODES = {
+    "reactive": AIMode.REACTIVE,
+    "predictive": AIMode.PREDICTIVE,
+}
 
 CONFIG_SCHEMA = cv.Schema(
     {
-        cv.GenerateID(): cv.declare_id(GamePong),
+        cv.GenerateID(): cv.declare_id(lvgl_game_runner.GameFactory),
         cv.Optional(CONF_NUM_HUMAN_PLAYERS, default=1): cv.int_range(min=0, max=2),
+        cv.Optional(CONF_AI_MODE, default="reactive"): cv.enum(AI_MODES, lower=True),
     }
 )
 
 
 async def to_code(config):
     """Pong game initialization."""
-    var = cg.new_Pvariable(config[CONF_ID])
-
-    # Set number of human players (Pong supports max 2 players)
-    cg.add(var.set_num_human_players(config[CONF_NUM_HUMAN_PLAYERS]))
+    game = lvgl_game_runner.GAME_VAR
+    await lvgl_game_runner.register_game(
+        config,
+        "pong",
+        GamePong,
+        [
+            # Set number of human players (Pong supports max 2 players)
+            game.set_num_human_players(config[CONF_NUM_HUMAN_PLAYERS]),
+            game.set_ai_mode(config[CONF_AI_MODE]),
+        ],
+    )
@@ -2,7 +2,6 @@
 // Ported from: https://github.com/stuartparmenter/hub75-studio
 
 #include "game_pong.h"
-#include "pong_ai.h"
 #include "esphome/core/log.h"
 #include <algorithm>
 #include <cstdlib>
@@ -17,22 +16,29 @@ GamePong::GamePong()
       last_scored_right_(false),
       score_left_(0),
       score_right_(0),
-      ball_x_(0.0f),
-      ball_y_(0.0f),
-      vx_(0.0f),
-      vy_(0.0f),
-      left_y_(0.0f),
-      right_y_(0.0f),
-      left_vy_(0.0f),
-      right_vy_(0.0f),
+      ball_x_(0),
+      ball_y_(0),
+      vx_(0),
+      vy_(0),
+      left_y_(0),
+      right_y_(0),
+      left_vy_(0),
+      right_vy_(0),
       serve_idx_(0) {
   // Initialize colors
   color_fg_ = lv_color_hex(0xFFFFFF);
   color_bg_ = lv_color_hex(0x000000);
+
+  ball_sprite_ = sprites_.add(1);
+  left_paddle_sprite_ = sprites_.add();
+  right_paddle_sprite_ = sprites_.add();
+  sprites_.set_background(color_bg_);
+  set_sprite_layer(&sprites_);
 }
 
 void GamePong::on_bind(lv_obj_t *canvas) {
   GameBase::on_bind(canvas);
+  cache_text(color_fg_, color_bg_, "0123456789 -", {"PAUSED"});
   ESP_LOGI(TAG, "Pong game bound to canvas");
 }
 
@@ -68,116 +74,83 @@ void GamePong::on_resize(const Rect &r) {
     ball_speed_y_ = area_.h * BALL_SPEED_Y_RATIO;
 
     // Ensure minimum speed
-    if (ball_speed_x_ < 0.5f)
-      ball_speed_x_ = 0.5f;
-    if (ball_speed_y_ < 0.5f)
-      ball_speed_y_ = 0.5f;
+    if (ball_speed_x_ < Scalar(0.5f))
+      ball_speed_x_ = Scalar(0.5f);
+    if (ball_speed_y_ < Scalar(0.5f))
+      ball_speed_y_ = Scalar(0.5f);
 
     // Paddle speed (scales with canvas height)
     player_speed_ = area_.h * PLAYER_SPEED_RATIO;
-    if (player_speed_ < 1.0f)
-      player_speed_ = 1.0f;
+    if (player_speed_ < 1)
+      player_speed_ = 1;
 
     ESP_LOGI(TAG, "Pong scaled: paddle=%dx%d, ball=%dx%d, margin=%d, speed=%.2fx%.2f, player_speed=%.2f", paddle_w_,
-             paddle_h_, ball_w_, ball_h_, paddle_margin_x_, ball_speed_x_, ball_speed_y_, player_speed_);
+             paddle_h_, ball_w_, ball_h_, paddle_margin_x_, (float) ball_speed_x_, (float) ball_speed_y_,
+             (float) player_speed_);
 
     // Reset paddles to center
-    left_y_ = (area_.h - paddle_h_) / 2.0f;
-    right_y_ = (area_.h - paddle_h_) / 2.0f;
+    left_y_ = Scalar(area_.h - paddle_h_) / 2;
+    right_y_ = Scalar(area_.h - paddle_h_) / 2;
   }
 
   reset_ball_();
-  needs_render_ = true;
+  initial_render_ = true;  // Element sizes changed, repaint everything
 }
 
 void GamePong::reset() {
   score_left_ = 0;
   score_right_ = 0;
   scored_ = false;
+  score_delay_ = 0;
   last_scored_right_ = false;
   state_.reset();
 
   initial_render_ = true;
-  needs_render_ = true;
   last_drawn_score_left_ = 0;
   last_drawn_score_right_ = 0;
   last_paused_ = false;
-  last_ball_x_ = -1;
-  last_ball_y_ = -1;
-  last_left_y_ = -1;
-  last_right_y_ = -1;
-  last_ball_over_score_ = false;
-
-  // Reset input state for all players
-  input_p1_up_held_ = false;
-  input_p1_down_held_ = false;
-  input_p2_up_held_ = false;
-  input_p2_down_held_ = false;
+
+  // Recreated on the next update, seeded from the (re-seeded) game RNG
+  ai_player1_.reset();
+  ai_player2_.reset();
 
   reset_ball_();
 }
 
-void GamePong::on_input(const InputEvent &event) {
-  // Ignore NONE events (used by AI when no action needed)
-  if (event.type == InputType::NONE)
-    return;
-
-  // Handle START button (only on press, any player can trigger)
-  if (event.type == InputType::START && event.pressed) {
-    if (state_.game_over) {
-      // Restart game if game over
-      this->reset();
-    } else {
-      // Toggle pause/resume if game is running
-      if (paused_) {
-        this->resume();
-      } else {
-        this->pause();
-        // Clear input state when pausing to avoid stuck inputs
-        input_p1_up_held_ = false;
-        input_p1_down_held_ = false;
-        input_p2_up_held_ = false;
-        input_p2_down_held_ = false;
-      }
-      needs_render_ = true;  // Trigger render to show/hide pause text
-    }
-    return;
-  }
-
-  if (state_.game_over || paused_)
-    return;  // Ignore inputs if game over or paused
+bool GamePong::serialize_state(StateArchive &ar) {
+  ar(state_);
+  ar(scored_);
+  ar(score_delay_);
+  ar(last_scored_right_);
+  ar(score_left_);
+  ar(score_right_);
+  ar(serve_idx_);
+  ar(ball_x_);
+  ar(ball_y_);
+  ar(vx_);
+  ar(vy_);
+  ar(left_y_);
+  ar(right_y_);
+  ar(left_vy_);
+  ar(right_vy_);
+  ar(prev_ball_x_);
+  ar(prev_ball_y_);
+  ar(prev_left_y_);
+  ar(prev_right_y_);
+  return true;
+}
 
-  // Ignore inputs from external sources for AI-controlled players
-  // AI inputs are injected via update_ai_() and use the processing_ai_inputs_ flag
-  if (!processing_ai_inputs_ && !is_human_player(event.player))
+void GamePong::on_input(const InputEvent &event) {
+  // Paddles poll input_ in update(); the only event is START (any player can trigger)
+  if (event.type != InputType::START || !event.pressed)
     return;
-
-  // Route inputs based on player number
-  // Player 1 controls left paddle, Player 2 controls right paddle
-  // Note: Both human and AI inputs are processed here
-  // AI inputs are injected via update_ai_(), human inputs come from external sources
-  if (event.player == 1) {
-    switch (event.type) {
-      case InputType::UP:
-        input_p1_up_held_ = event.pressed;
-        break;
-      case InputType::DOWN:
-        input_p1_down_held_ = event.pressed;
-        break;
-      default:
-        break;
-    }
-  } else if (event.player == 2) {
-    switch (event.type) {
-      case InputType::UP:
-        input_p2_up_held_ = event.pressed;
-        break;
-      case InputType::DOWN:
-        input_p2_down_held_ = event.pressed;
-        break;
-      default:
-        break;
-    }
+  if (state_.game_over) {
+    // Restart game if game over
+    this->reset();
+  } else if (paused_) {
+    this->resume();
+  } else {
+    this->pause();
   }
 }
 
@@ -186,54 +159,57 @@ void GamePong::on_input(const InputEvent &event) {
 void GamePong::update_ai_() {
   // Create AI controllers if needed
   if (!is_human_player(1) && !ai_player1_) {
-    ai_player1_ = std::make_unique<PongAI>(1);
+    ai_player1_.emplace(1, rng_.next(), ai_mode_);
   }
   if (!is_human_player(2) && !ai_player2_) {
-    ai_player2_ = std::make_unique<PongAI>(2);
+    ai_player2_.emplace(2, rng_.next(), ai_mode_);
   }
 
-  // Destroy AI controllers if no longer needed
+  // Destroy AI controllers if no longer needed, letting go of their buttons
   if (is_human_player(1) && ai_player1_) {
     ai_player1_.reset();
+    input_.player(1) = {};
   }
   if (is_human_player(2) && ai_player2_) {
     ai_player2_.reset();
+    input_.player(2) = {};
   }
 
-  // Update AI players and inject their inputs
-  // Set flag to allow AI inputs to bypass human player check
-  processing_ai_inputs_ = true;
-
-  if (ai_player1_) {
-    auto event = ai_player1_->update(0.0f, state_, this);
-    on_input(event);
-  }
-  if (ai_player2_) {
-    auto event = ai_player2_->update(0.0f, state_, this);
-    on_input(event);
-  }
+  // AI players write their buttons straight into input_, replacing any external input
+  if (ai_player1_)
+    ai_player1_->update(0, state_, this, input_.player(1));
+  if (ai_player2_)
+    ai_player2_->update(0, state_, this, input_.player(2));
+}
 
-  processing_ai_inputs_ = false;
+Scalar GamePong::paddle_vy_(uint8_t player) const {
+  const auto &in = input_.player(player);
+  const bool up = in.is_held(InputType::UP);
+  const bool down = in.is_held(InputType::DOWN);
+  if (up == down)
+    return 0;  // Both or neither held - stop
+  return up ? -player_speed_ : player_speed_;
 }
 
 void GamePong::reset_ball_() {
   // Center the ball (only if canvas is initialized)
   if (area_.w > 0 && area_.h > 0) {
-    ball_x_ = (area_.w - ball_w_) * 0.5f;
-    ball_y_ = (area_.h - ball_h_) * 0.5f;
+    ball_x_ = Scalar(area_.w - ball_w_) / 2;
+    ball_y_ = Scalar(area_.h - ball_h_) / 2;
     serve_ball_();
   }
+  snap_interpolation_();  // Don't interpolate the jump back to the center
 }
 
 void GamePong::serve_ball_() {
   // Serve toward the player who conceded last point
-  float sx = ball_speed_x_;
-  vx_ = last_scored_right_ ? -fabsf(sx) : fabsf(sx);
+  Scalar sx = ball_speed_x_;
+  vx_ = last_scored_right_ ? -scalar_abs(sx) : scalar_abs(sx);
 
   // Vary vertical speed using a deterministic cycle
   int i = serve_idx_ % 6;
   serve_idx_ = (serve_idx_ + 1) % 6000;
-  vy_ = ball_speed_y_ * 0.6f * SERVE_ANGLES[i];
+  vy_ = ball_speed_y_ * Scalar(0.6f) * SERVE_ANGLES[i];
 
   // Reset paddle dynamics
   left_vy_ = 0;
@@ -248,32 +224,31 @@ void GamePong::serve_ball_() {
   }
 }
 
-bool GamePong::check_paddle_collision_(float ball_top, float ball_bottom, float paddle_y) {
-  float paddle_top = paddle_y;
-  float paddle_bottom = paddle_y + paddle_h_;
+bool GamePong::check_paddle_collision_(Scalar ball_top, Scalar ball_bottom, Scalar paddle_y) {
+  Scalar paddle_top = paddle_y;
+  Scalar paddle_bottom = paddle_y + paddle_h_;
   return (ball_bottom >= paddle_top) && (ball_top <= paddle_bottom);
 }
 
-void GamePong::step(float dt) {
+void GamePong::update(Scalar dt) {
   if (!canvas_)
     return;
 
-  // Check if we need to render pause/unpause text even when paused
-  if (needs_render_ && (paused_ || state_.game_over)) {
-    render_();
-    needs_render_ = false;
-    return;
-  }
+  // Positions at the start of this step, for render interpolation
+  prev_ball_x_ = ball_x_;
+  prev_ball_y_ = ball_y_;
+  prev_left_y_ = left_y_;
+  prev_right_y_ = right_y_;
 
   if (paused_ || state_.game_over)
     return;
 
-  // Update AI controllers (they inject inputs via on_input)
+  // Update AI controllers (they hold their players' buttons in input_)
   update_ai_();
 
   // Integrate ball
-  float nx = ball_x_ + vx_;
-  float ny = ball_y_ + vy_;
+  Scalar nx = ball_x_ + vx_;
+  Scalar ny = ball_y_ + vy_;
 
   // Top/bottom bounce
   if (ny <= 0) {
@@ -285,15 +260,7 @@ void GamePong::step(float dt) {
   }
 
   // Update left paddle based on input state
-  if (input_p1_up_held_ && !input_p1_down_held_) {
-    left_vy_ = -player_speed_;
-  } else if (input_p1_down_held_ && !input_p1_up_held_) {
-    left_vy_ = player_speed_;
-  } else {
-    // Both or neither held - stop
-    left_vy_ = 0.0f;
-  }
-
+  left_vy_ = paddle_vy_(1);
   left_y_ += left_vy_;
 
   // Clamp inside screen
@@ -303,15 +270,7 @@ void GamePong::step(float dt) {
     left_y_ = area_.h - paddle_h_;
 
   // Update right paddle based on input state
-  if (input_p2_up_held_ && !input_p2_down_held_) {
-    right_vy_ = -player_speed_;
-  } else if (input_p2_down_held_ && !input_p2_up_held_) {
-    right_vy_ = player_speed_;
-  } else {
-    // Both or neither held - stop
-    right_vy_ = 0.0f;
-  }
-
+  right_vy_ = paddle_vy_(2);
   right_y_ += right_vy_;
 
   // Clamp inside screen
@@ -324,17 +283,17 @@ void GamePong::step(float dt) {
   int left_x = paddle_margin_x_;
   int right_x = area_.w - paddle_margin_x_ - paddle_w_;
 
-  float ball_top = ny;
-  float ball_bottom = ny + ball_h_;
+  Scalar ball_top = ny;
+  Scalar ball_bottom = ny + ball_h_;
 
   // LEFT paddle collision
   if (nx <= (left_x + paddle_w_)) {
     if (check_paddle_collision_(ball_top, ball_bottom, left_y_)) {
       nx = left_x + paddle_w_;
-      vx_ = fabsf(ball_speed_x_);
+      vx_ = scalar_abs(ball_speed_x_);
       // Add spin from paddle movement
-      float offset = ((ny + ball_h_ / 2.0f) - (left_y_ + paddle_h_ / 2.0f)) / (paddle_h_ / 2.0f);
-      vy_ += 0.25f * offset + 0.35f * left_vy_;
+      Scalar offset = ((ny + Scalar(ball_h_) / 2) - (left_y_ + Scalar(paddle_h_) / 2)) / (Scalar(paddle_h_) / 2);
+      vy_ += Scalar(0.25f) * offset + Scalar(0.35f) * left_vy_;
     }
   }
 
@@ -342,9 +301,9 @@ void GamePong::step(float dt) {
   if ((nx + ball_w_) >= right_x) {
     if (check_paddle_collision_(ball_top, ball_bottom, right_y_)) {
       nx = right_x - ball_w_;
-      vx_ = -fabsf(ball_speed_x_);
-      float offset = ((ny + ball_h_ / 2.0f) - (right_y_ + paddle_h_ / 2.0f)) / (paddle_h_ / 2.0f);
-      vy_ += 0.25f * offset + 0.35f * right_vy_;
+      vx_ = -scalar_abs(ball_speed_x_);
+      Scalar offset = ((ny + Scalar(ball_h_) / 2) - (right_y_ + Scalar(paddle_h_) / 2)) / (Scalar(paddle_h_) / 2);
+      vy_ += Scalar(0.25f) * offset + Scalar(0.35f) * right_vy_;
     }
   }
 
@@ -364,112 +323,46 @@ void GamePong::step(float dt) {
   if (!scored_) {
     ball_x_ = nx;
     ball_y_ = ny;
-    needs_render_ = true;  // Ball or paddles moved
   } else {
     // Stop ball and prepare for next serve
     vx_ = 0;
     vy_ = 0;
 
     // Brief pause then reset (simulated with counter)
-    static int score_delay = 0;
-    score_delay++;
-    if (score_delay >= 10) {  // ~300ms at 30 FPS
-      score_delay = 0;
+    score_delay_++;
+    if (score_delay_ >= 10) {  // ~300ms at 30 FPS
+      score_delay_ = 0;
       scored_ = false;
       reset_ball_();
-      needs_render_ = true;
     }
   }
+}
 
-  // Render if needed
-  if (needs_render_) {
-    render_();
-    needs_render_ = false;
-  }
+void GamePong::render(Scalar alpha) {
+  if (!canvas_)
+    return;
+  // Rendering is incremental (score/pause text on change, sprites when they move), so it
+  // is cheap to run every frame
+  render_(alpha);
 }
 
 // ========== Rendering ==========
 
-void GamePong::render_() {
+void GamePong::render_(Scalar alpha) {
   if (!canvas_)
     return;
 
   if (initial_render_) {
-    // Clear canvas
-    lv_canvas_fill_bg(canvas_, color_bg_, LV_OPA_COVER);
+    // Clear canvas (marks the whole area damaged and wipes the sprites)
+    clear_fast(color_bg_);
 
     // Draw score
     draw_score_();
 
-    // Draw paddles
-    draw_paddle_(paddle_margin_x_, (int) left_y_);
-    draw_paddle_(area_.w - paddle_margin_x_ - paddle_w_, (int) right_y_);
-
-    // Draw ball
-    draw_ball_();
-
     initial_render_ = false;
     last_drawn_score_left_ = score_left_;
     last_drawn_score_right_ = score_right_;
-    last_ball_x_ = (int) ball_x_;
-    last_ball_y_ = (int) ball_y_;
-    last_left_y_ = (int) left_y_;
-    last_right_y_ = (int) right_y_;
-    last_ball_over_score_ = false;  // Will be updated on next frame
-
-    // Full invalidation for initial render
-    lv_obj_invalidate(canvas_);
   } else {
-    // Fast incremental update using direct buffer manipulation
-
-    // Check if ball overlaps score area (top center)
-    int ball_x_int = (int) ball_x_;
-    int ball_y_int = (int) ball_y_;
-    int score_left = area_.w / 2 - 30;
-    int score_right = area_.w / 2 + 30;
-    int score_top = 2;
-    int score_bottom = 16;
-
-    bool ball_over_score = (ball_x_int + ball_w_ >= score_left && ball_x_int <= score_right &&
-                           ball_y_int + ball_h_ >= score_top && ball_y_int <= score_bottom);
-
-    // Erase and redraw ball if it moved
-    if (ball_x_int != last_ball_x_ || ball_y_int != last_ball_y_) {
-      if (last_ball_x_ >= 0 && last_ball_y_ >= 0) {
-        erase_ball_fast_(last_ball_x_, last_ball_y_);
-      }
-      draw_ball_fast_();
-      last_ball_x_ = ball_x_int;
-      last_ball_y_ = ball_y_int;
-    }
-
-    // If ball just moved away from score area, redraw score
-    if (last_ball_over_score_ && !ball_over_score) {
-      clear_score_area_fast_();
-      draw_score_();
-    }
-    last_ball_over_score_ = ball_over_score;
-
-    // Erase and redraw left paddle if it moved
-    int left_y_int = (int) left_y_;
-    if (left_y_int != last_left_y_) {
-      if (last_left_y_ >= 0) {
-        erase_paddle_fast_(paddle_margin_x_, last_left_y_);
-      }
-      draw_paddle_fast_(paddle_margin_x_, left_y_int);
-      last_left_y_ = left_y_int;
-    }
-
-    // Erase and redraw right paddle if it moved
-    int right_y_int = (int) right_y_;
-    if (right_y_int != last_right_y_) {
-      if (last_right_y_ >= 0) {
-        erase_paddle_fast_(area_.w - paddle_margin_x_ - paddle_w_, last_right_y_);
-      }
-      draw_paddle_fast_(area_.w - paddle_margin_x_ - paddle_w_, right_y_int);
-      last_right_y_ = right_y_int;
-    }
-
     // Redraw score if it changed
     if (score_left_ != last_drawn_score_left_ || score_right_ != last_drawn_score_right_) {
       clear_score_area_fast_();
@@ -490,22 +383,46 @@ void GamePong::render_() {
       last_paused_ = paused_;
     }
   }
+
+  // Ball and paddles: the sprite layer erases and redraws whatever moved
+  update_sprites_(alpha);
 }
 
-void GamePong::draw_paddle_(int x, int y) { fill_rect(x, y, paddle_w_, paddle_h_, color_fg_); }
+void GamePong::update_sprites_(Scalar alpha) {
+  // Interpolate between the last two simulation steps (alpha is 1 without fixed-step)
+  auto lerp = [alpha](Scalar a, Scalar b) { return (int) (a + (b - a) * alpha); };
+
+  ball_sprite_->set_solid(ball_w_, ball_h_, color_fg_);
+  ball_sprite_->move_to(lerp(prev_ball_x_, ball_x_), lerp(prev_ball_y_, ball_y_));
+  ball_sprite_->visible = true;
 
-void GamePong::draw_paddle_fast_(int x, int y) { fill_rect_fast(x, y, paddle_w_, paddle_h_, color_fg_); }
+  left_paddle_sprite_->set_solid(paddle_w_, paddle_h_, color_fg_);
+  left_paddle_sprite_->move_to(paddle_margin_x_, lerp(prev_left_y_, left_y_));
+  left_paddle_sprite_->visible = true;
 
-void GamePong::erase_paddle_fast_(int x, int y) { fill_rect_fast(x, y, paddle_w_, paddle_h_, color_bg_); }
+  right_paddle_sprite_->set_solid(paddle_w_, paddle_h_, color_fg_);
+  right_paddle_sprite_->move_to(area_.w - paddle_margin_x_ - paddle_w_, lerp(prev_right_y_, right_y_));
+  right_paddle_sprite_->visible = true;
+}
 
-void GamePong::draw_ball_() {
-  // Draw ball as rounded rectangle
-  fill_rect((int) ball_x_, (int) ball_y_, ball_w_, ball_h_, color_fg_);
+void GamePong::snap_interpolation_() {
+  prev_ball_x_ = ball_x_;
+  prev_ball_y_ = ball_y_;
+  prev_left_y_ = left_y_;
+  prev_right_y_ = right_y_;
 }
 
-void GamePong::draw_ball_fast_() { fill_rect_fast((int) ball_x_, (int) ball_y_, ball_w_, ball_h_, color_fg_); }
+void GamePong::redraw_background(int x, int y, int w, int h) {
+  fill_rect_fast(x, y, w, h, color_bg_);
 
-void GamePong::erase_ball_fast_(int x, int y) { fill_rect_fast(x, y, ball_w_, ball_h_, color_bg_); }
+  // The score (and pause text) is the only background content; cached text is clipped
+  const int score_x = area_.w / 2 - 30;
+  const bool over_score = x < score_x + 60 && x + w > score_x && y < 2 + 14 && y + h > 2;
+  const int text_y = area_.h / 2 - 7 - 2;
+  const bool over_pause = paused_ && y < text_y + 16 && y + h > text_y;
+  if (over_score || over_pause)
+    draw_score_();
+}
 
 void GamePong::clear_score_area_fast_() {
   // Clear score area at top center
@@ -524,11 +441,11 @@ void GamePong::clear_center_text_area_() {
 void GamePong::draw_score_() {
   char buf[16];
   snprintf(buf, sizeof(buf), "%d - %d", score_left_, score_right_);
-  draw_text(0, 2, buf, color_fg_, LV_TEXT_ALIGN_CENTER);
+  draw_text(area_.w / 2, 2, buf, color_fg_, LV_TEXT_ALIGN_CENTER);
 
   if (paused_) {
     // Draw paused text
-    draw_text(0, area_.h / 2 - 7, "PAUSED", color_fg_, LV_TEXT_ALIGN_CENTER);
+    draw_text(area_.w / 2, area_.h / 2 - 7, "PAUSED", color_fg_, LV_TEXT_ALIGN_CENTER);
   }
 }
 
@@ -6,8 +6,9 @@
 
 #include "esphome/components/lvgl_game_runner/game_base.h"
 #include "esphome/components/lvgl_game_runner/game_state.h"
+#include "pong_ai.h"
 #include <cstdint>
-#include <memory>
+#include <optional>
 
 namespace esphome::game_pong {
 
@@ -15,6 +16,11 @@ using lvgl_game_runner::GameBase;
 using lvgl_game_runner::GameState;
 using lvgl_game_runner::InputEvent;
 using lvgl_game_runner::InputType;
+using lvgl_game_runner::Scalar;
+using lvgl_game_runner::scalar_abs;
+using lvgl_game_runner::Sprite;
+using lvgl_game_runner::SpriteLayer;
+using lvgl_game_runner::StateArchive;
 
 /**
  * Classic Pong game with sophisticated AI.
@@ -27,33 +33,43 @@ class GamePong : public GameBase {
 
   void on_bind(lv_obj_t *canvas) override;
   void on_resize(const Rect &r) override;
-  void step(float dt) override;
+  void update(Scalar dt) override;
+  void render(Scalar alpha) override;
   void on_input(const InputEvent &event) override;
   void reset() override;
+  // Everything update() touches; AI paddles aren't covered, so netplay makes both human
+  bool serialize_state(StateArchive &ar) override;
+  // Static pause and game-over screens until input
+  uint32_t idle_hint_us() const override { return paused_ || state_.game_over ? IDLE_UNTIL_INPUT : 0; }
 
   // Pong supports 2 players
   uint8_t get_max_players() const override { return 2; }
 
+  // How AI-controlled paddles pick their target (applies to AIs created after the next reset)
+  void set_ai_mode(PongAI::Mode mode) { ai_mode_ = mode; }
+
   // Accessor methods for AI
   const Rect &get_area() const { return area_; }
-  float get_ball_x() const { return ball_x_; }
-  float get_ball_y() const { return ball_y_; }
-  float get_ball_vx() const { return vx_; }
-  float get_ball_vy() const { return vy_; }
+  Scalar get_ball_x() const { return ball_x_; }
+  Scalar get_ball_y() const { return ball_y_; }
+  Scalar get_ball_vx() const { return vx_; }
+  Scalar get_ball_vy() const { return vy_; }
   int get_ball_w() const { return ball_w_; }
   int get_ball_h() const { return ball_h_; }
   int get_paddle_h() const { return paddle_h_; }
-  float get_left_paddle_y() const { return left_y_; }
-  float get_right_paddle_y() const { return right_y_; }
+  int get_paddle_w() const { return paddle_w_; }
+  int get_paddle_margin_x() const { return paddle_margin_x_; }
+  Scalar get_left_paddle_y() const { return left_y_; }
+  Scalar get_right_paddle_y() const { return right_y_; }
 
  private:
   // Configuration constants (base values, will be scaled dynamically)
   // Paddle height is the primary scaling unit: canvas height / 8
   static constexpr int PADDLE_HEIGHT_DIVISOR = 8;       // Paddle height = canvas height / this value
-  static constexpr float PADDLE_WIDTH_RATIO = 0.25f;    // Paddle width as ratio of paddle height
-  static constexpr float BALL_SIZE_RATIO = 0.33f;       // Ball size as ratio of paddle height
-  static constexpr float BALL_SPEED_X_RATIO = 0.015f;   // Ball speed as ratio of canvas width per frame
-  static constexpr float BALL_SPEED_Y_RATIO = 0.010f;   // Ball speed as ratio of canvas height per frame
+  static constexpr Scalar PADDLE_WIDTH_RATIO = Scalar(0.25f);   // Paddle width as ratio of paddle height
+  static constexpr Scalar BALL_SIZE_RATIO = Scalar(0.33f);      // Ball size as ratio of paddle height
+  static constexpr Scalar BALL_SPEED_X_RATIO = Scalar(0.015f);  // Ball speed as ratio of canvas width per frame
+  static constexpr Scalar BALL_SPEED_Y_RATIO = Scalar(0.010f);  // Ball speed as ratio of canvas height per frame
 
   // Dynamic values (calculated in on_resize)
   int paddle_w_{3};
@@ -61,12 +77,12 @@ class GamePong : public GameBase {
   int paddle_margin_x_{2};
   int ball_w_{4};
   int ball_h_{4};
-  float ball_speed_x_{1.30f};
-  float ball_speed_y_{0.90f};
-  float player_speed_{2.5f};
+  Scalar ball_speed_x_{Scalar(1.30f)};
+  Scalar ball_speed_y_{Scalar(0.90f)};
+  Scalar player_speed_{Scalar(2.5f)};
 
   // Player speed scaling
-  static constexpr float PLAYER_SPEED_RATIO = 0.030f;  // Player paddle speed as ratio of canvas height
+  static constexpr Scalar PLAYER_SPEED_RATIO = Scalar(0.030f);  // Player paddle speed as ratio of canvas height
 
   // Game state
   GameState state_;
@@ -75,46 +91,45 @@ class GamePong : public GameBase {
   int score_left_;
   int score_right_;
   bool initial_render_{true};
-  bool needs_render_{true};
   uint32_t last_drawn_score_left_{0};
   uint32_t last_drawn_score_right_{0};
   bool last_paused_{false};
 
   // Ball state
-  float ball_x_;
-  float ball_y_;
-  float vx_;
-  float vy_;
+  Scalar ball_x_;
+  Scalar ball_y_;
+  Scalar vx_;
+  Scalar vy_;
 
   // Paddle state
-  float left_y_;
-  float right_y_;
-  float left_vy_;
-  float right_vy_;
-
-  // Previous positions for incremental rendering
-  int last_ball_x_{-1};
-  int last_ball_y_{-1};
-  int last_left_y_{-1};
-  int last_right_y_{-1};
-  bool last_ball_over_score_{false};
-
-  // Player control (player 1 = left, player 2 = right)
-  bool input_p1_up_held_{false};    // Player 1 UP button state
-  bool input_p1_down_held_{false};  // Player 1 DOWN button state
-  bool input_p2_up_held_{false};    // Player 2 UP button state
-  bool input_p2_down_held_{false};  // Player 2 DOWN button state
-
-  // Flag to distinguish AI-injected inputs from external human inputs
-  bool processing_ai_inputs_{false};
-
-  // AI controllers (managed by game, created when needed)
-  std::unique_ptr<class PongAI> ai_player1_;
-  std::unique_ptr<class PongAI> ai_player2_;
+  Scalar left_y_;
+  Scalar right_y_;
+  Scalar left_vy_;
+  Scalar right_vy_;
+
+  // Positions before the latest update(), for render interpolation
+  Scalar prev_ball_x_{0};
+  Scalar prev_ball_y_{0};
+  Scalar prev_left_y_{0};
+  Scalar prev_right_y_{0};
+
+  // Ball and paddles are sprites; the runner erases/redraws them as they move
+  SpriteLayer<3> sprites_;
+  Sprite *ball_sprite_;
+  Sprite *left_paddle_sprite_;
+  Sprite *right_paddle_sprite_;
+
+  // AI controllers (managed by game, created when needed); player 1 = left, player 2 = right
+  // and both steer through input_
+  std::optional<PongAI> ai_player1_;  // Held in place, no heap
+  std::optional<PongAI> ai_player2_;
+  PongAI::Mode ai_mode_{PongAI::Mode::REACTIVE};
 
   // Serve mechanics
   int serve_idx_;
-  static constexpr float SERVE_ANGLES[6] = {-1.0f, -0.6f, -0.3f, 0.3f, 0.6f, 1.0f};
+  int score_delay_{0};  // Steps since the point was scored; the ball is served again at 10
+  static constexpr Scalar SERVE_ANGLES[6] = {Scalar(-1.0f), Scalar(-0.6f), Scalar(-0.3f),
+                                             Scalar(0.3f),  Scalar(0.6f),  Scalar(1.0f)};
 
   // Colors
   lv_color_t color_fg_;
@@ -123,17 +138,15 @@ class GamePong : public GameBase {
   // Game logic helpers
   void reset_ball_();
   void serve_ball_();
-  void update_ai_();  // Update AI controllers and inject their inputs
-  bool check_paddle_collision_(float ball_top, float ball_bottom, float paddle_y);
+  void update_ai_();  // Update AI controllers; they hold their players' buttons in input_
+  Scalar paddle_vy_(uint8_t player) const;  // From the player's UP/DOWN buttons
+  bool check_paddle_collision_(Scalar ball_top, Scalar ball_bottom, Scalar paddle_y);
 
   // Rendering helpers
-  void render_();
-  void draw_paddle_(int x, int y);
-  void draw_paddle_fast_(int x, int y);
-  void erase_paddle_fast_(int x, int y);
-  void draw_ball_();
-  void draw_ball_fast_();
-  void erase_ball_fast_(int x, int y);
+  void render_(Scalar alpha);
+  void update_sprites_(Scalar alpha);
+  void snap_interpolation_();
+  void redraw_background(int x, int y, int w, int h) override;
   void draw_score_();
   void clear_score_area_fast_();
   void clear_center_text_area_();
@@ -2,71 +2,82 @@
 // SPDX-License-Identifier: MIT
 
 #include "pong_ai.h"
+#include "game_pong.h"
 #include <cmath>
 
 namespace esphome::game_pong {
 
-PongAI::PongAI(uint8_t player_num) : AIController(player_num), rng_state_(2463534242 + player_num * 12345) { reset(); }
+PongAI::PongAI(uint8_t player_num, uint32_t seed, Mode mode) : AIController(player_num), mode_(mode), rng_(seed) {
+  reset();
+}
 
 void PongAI::reset() {
   current_input_ = InputState::NONE;
-  error_offset_ = 0.0f;
+  error_offset_ = 0;
   offset_update_counter_ = 0;
+  have_intercept_ = false;
 }
 
-InputEvent PongAI::update(float dt, const GameState &state, const GameBase *game) {
-  // Null event (no action)
-  InputEvent null_event(InputType::NONE, player_num_, false, 0);
-
+void PongAI::update(Scalar dt, const GameState &state, const GameBase *game, InputSnapshot::Player &input) {
   // Cast to GamePong to access game-specific data
   const GamePong *pong = static_cast<const GamePong *>(game);
   if (!pong)
-    return null_event;
+    return;
 
   // Get game state
   const auto &area = pong->get_area();
-  float ball_x = pong->get_ball_x();
-  float ball_y = pong->get_ball_y();
-  float ball_vx = pong->get_ball_vx();
+  Scalar ball_x = pong->get_ball_x();
+  Scalar ball_y = pong->get_ball_y();
+  Scalar ball_vx = pong->get_ball_vx();
   int ball_w = pong->get_ball_w();
   int ball_h = pong->get_ball_h();
   int paddle_h = pong->get_paddle_h();
 
   // Get our paddle position
-  float paddle_y = (player_num_ == 1) ? pong->get_left_paddle_y() : pong->get_right_paddle_y();
+  Scalar paddle_y = (player_num_ == 1) ? pong->get_left_paddle_y() : pong->get_right_paddle_y();
 
   // Determine if ball is moving toward this paddle
   bool is_left_paddle = (player_num_ == 1);
   bool ball_moving_toward_us = is_left_paddle ? (ball_vx < 0) : (ball_vx > 0);
 
   // Calculate target position
-  float target_y;
-  if (ball_moving_toward_us) {
+  Scalar target_y;
+  if (ball_moving_toward_us && mode_ == Mode::PREDICTIVE) {
+    // Only paddle hits change the ball's course, and each one flips vx, so the intercept
+    // computed when the ball turned toward us holds for the whole volley
+    if (!have_intercept_) {
+      error_offset_ = rng_.range(-paddle_h * RANDOM_ERROR, paddle_h * RANDOM_ERROR);
+      intercept_y_ = predict_intercept_y_(pong) + error_offset_;
+      have_intercept_ = true;
+    }
+    target_y = intercept_y_;
+  } else if (ball_moving_toward_us) {
     // Ball coming toward us: track the ball with some random error
     // Update random error offset occasionally (every ~20 frames)
     offset_update_counter_++;
     if (offset_update_counter_ >= 20) {
       offset_update_counter_ = 0;
       // Random error: percentage of paddle height
-      error_offset_ = rand_range_(-paddle_h * RANDOM_ERROR, paddle_h * RANDOM_ERROR);
+      error_offset_ = rng_.range(-paddle_h * RANDOM_ERROR, paddle_h * RANDOM_ERROR);
     }
 
-    float ball_center_y = ball_y + ball_h / 2.0f;
+    Scalar ball_center_y = ball_y + Scalar(ball_h) / 2;
     target_y = ball_center_y + error_offset_;
   } else {
     // Ball moving away: return to vertical center (no random error)
-    target_y = area.h / 2.0f;
+    target_y = Scalar(area.h) / 2;
     // Reset error offset for next rally
     offset_update_counter_ = 0;
-    error_offset_ = 0.0f;
+    error_offset_ = 0;
+    have_intercept_ = false;
   }
 
   // Check if target position is well-centered within paddle (not just barely touching edge)
   // We want the paddle body to hit the ball, not just the corner
   // Add margin from edges to ensure good contact
-  float paddle_top = paddle_y;
-  float paddle_bottom = paddle_y + paddle_h;
-  float safety_margin = paddle_h * 0.15f;  // 15% margin from each edge
+  Scalar paddle_top = paddle_y;
+  Scalar paddle_bottom = paddle_y + paddle_h;
+  Scalar safety_margin = paddle_h * Scalar(0.15f);  // 15% margin from each edge
 
   bool target_in_range = (target_y >= paddle_top + safety_margin) &&
                          (target_y <= paddle_bottom - safety_margin);
@@ -76,54 +87,54 @@ InputEvent PongAI::update(float dt, const GameState &state, const GameBase *game
   if (!target_in_range) {
     // Target is outside paddle range - move toward it
     // Use a small threshold to avoid oscillation when exactly at center
-    float paddle_center_y = paddle_y + paddle_h / 2.0f;
-    float diff = target_y - paddle_center_y;
-    if (diff < -0.5f) {
+    Scalar paddle_center_y = paddle_y + Scalar(paddle_h) / 2;
+    Scalar diff = target_y - paddle_center_y;
+    if (diff < Scalar(-0.5f)) {
       desired_state = InputState::UP;
-    } else if (diff > 0.5f) {
+    } else if (diff > Scalar(0.5f)) {
       desired_state = InputState::DOWN;
     }
     // else: stay at NONE if very close to center
   }
 
-  // Generate event to transition from current_input_ to desired_state
+  // Step current_input_ toward desired_state
   if (desired_state != current_input_) {
     // Priority: release old button first, then press new button in next update
-    if (current_input_ == InputState::UP) {
-      // Need to release UP
+    if (current_input_ != InputState::NONE) {
       current_input_ = InputState::NONE;
-      return InputEvent(InputType::UP, player_num_, false, 0);
-    } else if (current_input_ == InputState::DOWN) {
-      // Need to release DOWN
-      current_input_ = InputState::NONE;
-      return InputEvent(InputType::DOWN, player_num_, false, 0);
-    } else if (desired_state == InputState::UP) {
-      // Press UP
-      current_input_ = InputState::UP;
-      return InputEvent(InputType::UP, player_num_, true, 0);
-    } else if (desired_state == InputState::DOWN) {
-      // Press DOWN
-      current_input_ = InputState::DOWN;
-      return InputEvent(InputType::DOWN, player_num_, true, 0);
+    } else {
+      current_input_ = desired_state;
     }
   }
 
-  // No state change needed
-  return null_event;
+  // Hold the buttons every update, overriding any other source for this player
+  input.set_held(InputType::UP, current_input_ == InputState::UP);
+  input.set_held(InputType::DOWN, current_input_ == InputState::DOWN);
 }
 
-// ========== PRNG Helpers ==========
-
-uint32_t PongAI::rng_() {
-  // xorshift32
-  rng_state_ ^= rng_state_ << 13;
-  rng_state_ ^= rng_state_ >> 17;
-  rng_state_ ^= rng_state_ << 5;
-  return rng_state_;
+Scalar PongAI::predict_intercept_y_(const GamePong *pong) const {
+  const auto &area = pong->get_area();
+  const int ball_h = pong->get_ball_h();
+  const Scalar vx = pong->get_ball_vx();
+
+  // Ball x at which it meets our paddle's face
+  const int face = pong->get_paddle_margin_x() + pong->get_paddle_w();
+  const int plane = (player_num_ == 1) ? face : area.w - face - pong->get_ball_w();
+  Scalar steps = (plane - pong->get_ball_x()) / vx;
+  if (steps < 0)
+    steps = 0;
+
+  // Unfold the wall bounces: the ball's top edge ranges over [0, span], so its path
+  // repeats every 2 * span
+  const int span = area.h - ball_h;
+  Scalar y = pong->get_ball_y() + pong->get_ball_vy() * steps;
+  if (span > 0) {
+    const int period = 2 * span;
+    y -= period * scalar_floor(y / period);
+    if (y > span)
+      y = period - y;
+  }
+  return y + Scalar(ball_h) / 2;
 }
 
-float PongAI::rand01_() { return static_cast<float>(rng_()) / static_cast<float>(UINT32_MAX); }
-
-float PongAI::rand_range_(float min, float max) { return min + rand01_() * (max - min); }
-
 }  // namespace esphome::game_pong
@@ -4,50 +4,63 @@
 #pragma once
 
 #include "esphome/components/lvgl_game_runner/ai_controller.h"
-#include "game_pong.h"
+#include "esphome/components/lvgl_game_runner/game_base.h"
+#include "esphome/components/lvgl_game_runner/game_rng.h"
 #include <cstdint>
 
 namespace esphome::game_pong {
 
 using lvgl_game_runner::AIController;
 using lvgl_game_runner::GameBase;
+using lvgl_game_runner::GameRng;
 using lvgl_game_runner::GameState;
-using lvgl_game_runner::InputEvent;
+using lvgl_game_runner::InputSnapshot;
 using lvgl_game_runner::InputType;
+using lvgl_game_runner::Scalar;
+using lvgl_game_runner::scalar_floor;
+
+class GamePong;
 
 /**
  * Simple AI controller for Pong.
  * Tracks the ball when it's moving toward the paddle, otherwise returns to center.
  * Includes random error to make gameplay interesting.
+ *
+ * In PREDICTIVE mode it instead works out where the ball will cross its paddle (wall
+ * bounces included) once per volley and just steers toward that.
  */
 class PongAI : public AIController {
  public:
-  explicit PongAI(uint8_t player_num);
+  enum class Mode : uint8_t { REACTIVE, PREDICTIVE };
+
+  PongAI(uint8_t player_num, uint32_t seed, Mode mode = Mode::REACTIVE);
   ~PongAI() override = default;
 
-  InputEvent update(float dt, const GameState &state, const GameBase *game) override;
+  void update(Scalar dt, const GameState &state, const GameBase *game, InputSnapshot::Player &input) override;
   void reset() override;
 
  private:
   // Simple AI configuration
-  static constexpr float TRACKING_THRESHOLD = 8.0f;  // Deadband to prevent oscillation (pixels)
-  static constexpr float RANDOM_ERROR = 0.10f;        // Random error factor (0-1)
+  static constexpr Scalar TRACKING_THRESHOLD = Scalar(8.0f);  // Deadband to prevent oscillation (pixels)
+  static constexpr Scalar RANDOM_ERROR = Scalar(0.10f);       // Random error factor (0-1)
 
   // Current input state (only one can be active at a time)
   enum class InputState { NONE, UP, DOWN };
   InputState current_input_{InputState::NONE};
 
   // Random error offset (changes occasionally to simulate imperfect tracking)
-  float error_offset_{0.0f};
+  Scalar error_offset_{0};
   int offset_update_counter_{0};
 
-  // PRNG state (xorshift32)
-  uint32_t rng_state_;
+  // PREDICTIVE mode: target for the current volley, error included
+  Mode mode_;
+  bool have_intercept_{false};
+  Scalar intercept_y_{0};
+
+  Scalar predict_intercept_y_(const GamePong *pong) const;
 
-  // Helper methods
-  uint32_t rng_();
-  float rand01_();
-  float rand_range_(float min, float max);
+  // Seeded from the game's RNG, so AI play is reproducible
+  GameRng rng_;
 };
 
 }  // namespace esphome::game_pong
@@ -3,28 +3,37 @@
 
 import esphome.codegen as cg
 import esphome.config_validation as cv
-from esphome.const import CONF_ID
 
 from esphome.components import lvgl_game_runner
 
 DEPENDENCIES = ["lvgl_game_runner"]
 
 CONF_NUM_HUMAN_PLAYERS = "num_human_players"
+CONF_AUTOPLAY_BUDGET = "autoplay_budget"
 
 game_snake_ns = cg.esphome_ns.namespace("game_snake")
 GameSnake = game_snake_ns.class_("GameSnake", lvgl_game_runner.GameBase)
 
 CONFIG_SCHEMA = cv.Schema(
     {
-        cv.GenerateID(): cv.declare_id(GameSnake),
+        cv.GenerateID(): cv.declare_id(lvgl_game_runner.GameFactory),
         cv.Optional(CONF_NUM_HUMAN_PLAYERS, default=1): cv.int_range(min=0, max=1),
+        cv.Optional(CONF_AUTOPLAY_BUDGET, default=500): cv.int_range(min=16, max=20000),
     }
 )
 
 
 async def to_code(config):
     """Snake game initialization."""
-    var = cg.new_Pvariable(config[CONF_ID])
-
-    # Set number of human players (Snake supports max 1 player)
-    cg.add(var.set_num_human_players(config[CONF_NUM_HUMAN_PLAYERS]))
+    game = lvgl_game_runner.GAME_VAR
+    await lvgl_game_runner.register_game(
+        config,
+        "snake",
+        GameSnake,
+        [
+            # Set number of human players (Snake supports max 1 player)
+            game.set_num_human_players(config[CONF_NUM_HUMAN_PLAYERS]),
+            # Cells searched per update when the snake plays itself (num_human_players: 0)
+            game.set_autoplay_budget(config[CONF_AUTOPLAY_BUDGET]),
+        ],
+    )
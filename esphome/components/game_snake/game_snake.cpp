@@ -20,6 +20,7 @@ GameSnake::GameSnake() {
 
 void GameSnake::on_bind(lv_obj_t *canvas) {
   GameBase::on_bind(canvas);
+  cache_text(color_snake_, color_bg_, "0123456789", {"Score: ", "GAME OVER", "PAUSED"});
   ESP_LOGI(TAG, "Snake game bound to canvas");
 }
 
@@ -28,16 +29,19 @@ void GameSnake::on_resize(const Rect &r) {
 
   // Calculate grid dynamically based on canvas size
   if (area_.w > 0 && area_.h > 0) {
-    bool was_uninitialized = (grid_cols_ == 0 || grid_rows_ == 0);
+    const int old_cols = grid_cols_;
+    const int old_rows = grid_rows_;
 
     // Calculate cell size based on smallest dimension / MIN_GRID_CELLS
     // This ensures cells are perfectly square
     int min_dimension = (area_.w < area_.h) ? area_.w : area_.h;
     int cell_size = min_dimension / MIN_GRID_CELLS;
 
-    // Ensure at least 1 pixel per cell
+    // Ensure at least 1 pixel per cell, and few enough cells for the board
     if (cell_size < 1)
       cell_size = 1;
+    while ((size_t) (area_.w / cell_size) * (area_.h / cell_size) > SnakeBoard::MAX_CELLS)
+      cell_size++;
 
     // Both width and height are the same (square cells)
     cell_width_ = cell_size;
@@ -54,8 +58,10 @@ void GameSnake::on_resize(const Rect &r) {
     ESP_LOGI(TAG, "Snake grid: %dx%d cells, cell size: %dx%d px, offset: (%d,%d)", grid_cols_, grid_rows_,
              cell_width_, cell_height_, grid_offset_x_, grid_offset_y_);
 
-    // If this is the first time grid is configured, reset to position snake properly
-    if (was_uninitialized) {
+    // A new grid invalidates the body; (re)size the board and restart on it
+    if (grid_cols_ != old_cols || grid_rows_ != old_rows) {
+      board_.resize(grid_cols_, grid_rows_);
+      planner_.resize(board_.num_cells());
       reset();
     }
   }
@@ -64,16 +70,15 @@ void GameSnake::on_resize(const Rect &r) {
 void GameSnake::reset() {
   ESP_LOGI(TAG, "Resetting Snake game");
 
-  // Initialize snake in the center (only if grid is configured)
-  snake_.clear();
-  if (grid_cols_ > 0 && grid_rows_ > 0) {
-    snake_.push_back({grid_cols_ / 2, grid_rows_ / 2});
-    snake_.push_back({grid_cols_ / 2 - 1, grid_rows_ / 2});
-    snake_.push_back({grid_cols_ / 2 - 2, grid_rows_ / 2});
-  } else {
-    // Grid not configured yet, will be initialized in on_resize
-    snake_.push_back({0, 0});
+  // Initialize snake in the center, tail first (only if grid is configured)
+  board_.clear();
+  if (board_.num_cells() >= 3 && grid_cols_ >= 3) {
+    for (int i = 2; i >= 0; i--)
+      board_.push_head(board_.cell(grid_cols_ / 2 - i, grid_rows_ / 2));
   }
+  // Otherwise the grid isn't configured yet; on_resize() resets again
+  planner_.reset();
+  planner_.set_wrap(!walls_enabled_);
 
   direction_ = Direction::RIGHT;
   next_direction_ = Direction::RIGHT;
@@ -82,7 +87,7 @@ void GameSnake::reset() {
   last_pickup_ = NULL_POSITION;
 
   state_.reset();
-  update_timer_ = 0.0f;
+  update_timer_ = 0;
 
   initial_render_ = true;
   needs_render_ = true;
@@ -181,19 +186,13 @@ void GameSnake::on_input(const InputEvent &event) {
   next_direction_ = new_dir;
 }
 
-void GameSnake::step(float dt) {
-  // Check if we need to render pause/unpause text even when paused
-  if (needs_render_ && (paused_ || state_.game_over)) {
-    render_();
-    needs_render_ = false;
-    return;
-  }
-
+void GameSnake::update(Scalar dt) {
   if (paused_ || state_.game_over)
     return;
 
   // Update timer
   update_timer_ += dt;
+  const bool autoplay = is_autoplay_();
 
   // Move snake at fixed intervals
   if (update_timer_ >= update_interval_) {
@@ -203,27 +202,51 @@ void GameSnake::step(float dt) {
     direction_ = next_direction_;
 
     // Autoplay mode
-    if (autoplay_) {
+    if (autoplay) {
       direction_ = get_autoplay_direction_();
     }
 
     // Move snake (this will set needs_render_ flag)
     move_snake_();
 
-    // Render all changes in one call
+    // Render right after each move: the incremental renderer only knows the latest head
+    // and tail, so moves batched by fixed-step catch-up must not share one render
     if (needs_render_) {
       render_();
       needs_render_ = false;
     }
+  } else if (autoplay) {
+    // Plan ahead during the updates between moves
+    planner_.think(board_, pickup_cell_(), autoplay_budget_nodes_);
+  }
+}
+
+void GameSnake::render(Scalar alpha) {
+  (void) alpha;
+  // Pending pause/unpause text, game over screen, or the first frame after reset
+  if (needs_render_) {
+    render_();
+    needs_render_ = false;
   }
 }
 
+uint32_t GameSnake::idle_hint_us() const {
+  if (paused_ || state_.game_over)
+    return IDLE_UNTIL_INPUT;
+  // Autoplay plans during the updates between moves, so it wants them all
+  if (is_autoplay_() || needs_render_)
+    return 0;
+  // Nothing changes on screen until the next move
+  const int remaining_ms = (int) ((update_interval_ - update_timer_) * 1000);
+  return remaining_ms > 0 ? (uint32_t) remaining_ms * 1000 : 0;
+}
+
 void GameSnake::move_snake_() {
-  if (snake_.empty())
+  if (board_.length() == 0)
     return;
 
   // Calculate new head position
-  Position new_head = snake_.front();
+  Position new_head = position_of_(board_.head());
 
   switch (direction_) {
     case Direction::UP:
@@ -269,7 +292,7 @@ void GameSnake::move_snake_() {
   }
 
   // Add new head
-  snake_.insert(snake_.begin(), new_head);
+  board_.push_head(board_.cell(new_head.x, new_head.y));
 
   // Check if pickup collected
   if (new_head == pickup_) {
@@ -283,13 +306,12 @@ void GameSnake::move_snake_() {
     snake_tail_ = NULL_POSITION;
 
     // Speed up slightly
-    if (update_interval_ > 0.05f) {
-      update_interval_ *= 0.95f;
+    if (update_interval_ > Scalar(0.05f)) {
+      update_interval_ *= Scalar(0.95f);
     }
   } else {
     // Remove tail if no pickup
-    snake_tail_ = snake_.back();
-    snake_.pop_back();
+    snake_tail_ = position_of_(board_.pop_tail());
   }
 
   // Mark that we need to render the snake movement
@@ -297,68 +319,13 @@ void GameSnake::move_snake_() {
 }
 
 void GameSnake::spawn_pickup_() {
-  // Optimized: use modulo to limit attempts based on grid fill ratio
-  const int total_cells = grid_cols_ * grid_rows_;
-  const int empty_cells = total_cells - static_cast<int>(snake_.size());
-
-  // If grid is nearly full, fall back to first empty cell search
-  if (empty_cells < 10) {
-    for (int y = 0; y < grid_rows_; y++) {
-      for (int x = 0; x < grid_cols_; x++) {
-        Position pos = {x, y};
-        bool occupied = false;
-        for (const auto &part : snake_) {
-          if (part == pos) {
-            occupied = true;
-            break;
-          }
-        }
-        if (!occupied) {
-          pickup_ = pos;
-          return;
-        }
-      }
-    }
+  // Uniform over the free cells, O(1)
+  const SnakeBoard::Cell c = board_.random_free(rng_);
+  if (c == SnakeBoard::NO_CELL) {
     pickup_ = {0, 0};  // Grid full
     return;
   }
-
-  // Random placement with limited attempts
-  const int max_attempts = 20;  // Reduced from 100
-  for (int i = 0; i < max_attempts; i++) {
-    pickup_.x = rand() % grid_cols_;
-    pickup_.y = rand() % grid_rows_;
-
-    // Quick check if position is occupied
-    bool occupied = false;
-    for (const auto &part : snake_) {
-      if (part == pickup_) {
-        occupied = true;
-        break;
-      }
-    }
-
-    if (!occupied)
-      return;
-  }
-
-  // Fallback: find first empty cell
-  for (int y = 0; y < grid_rows_; y++) {
-    for (int x = 0; x < grid_cols_; x++) {
-      Position pos = {x, y};
-      bool occupied = false;
-      for (const auto &part : snake_) {
-        if (part == pos) {
-          occupied = true;
-          break;
-        }
-      }
-      if (!occupied) {
-        pickup_ = pos;
-        return;
-      }
-    }
-  }
+  pickup_ = position_of_(c);
 }
 
 bool GameSnake::check_collision_(const Position &pos) {
@@ -370,37 +337,55 @@ bool GameSnake::check_collision_(const Position &pos) {
 }
 
 bool GameSnake::check_self_collision_(const Position &pos) {
-  for (const auto &part : snake_) {
-    if (part == pos)
-      return true;
-  }
-  return false;
+  if (pos.x < 0 || pos.x >= board_.cols() || pos.y < 0 || pos.y >= board_.rows())
+    return false;
+  return board_.occupied(board_.cell(pos.x, pos.y));
+}
+
+SnakeBoard::Cell GameSnake::pickup_cell_() const {
+  if (board_.free_count() == 0)
+    return SnakeBoard::NO_CELL;
+  return board_.cell(pickup_.x, pickup_.y);
 }
 
 GameSnake::Direction GameSnake::get_autoplay_direction_() {
+  if (board_.length() == 0)
+    return direction_;
+
+  const SnakeBoard::Cell next = planner_.next_move(board_, pickup_cell_(), autoplay_budget_nodes_);
+  if (next == SnakeBoard::NO_CELL)
+    return get_greedy_direction_();  // No plan ready (or none exists)
+
+  // Plan cells are neighbors of the head, possibly across a wrapped edge
+  const Position head = position_of_(board_.head());
+  const Position to = position_of_(next);
+  if (to.x == head.x)
+    return (to.y == head.y + 1 || (head.y == grid_rows_ - 1 && to.y == 0)) ? Direction::DOWN : Direction::UP;
+  return (to.x == head.x + 1 || (head.x == grid_cols_ - 1 && to.x == 0)) ? Direction::RIGHT : Direction::LEFT;
+}
+
+GameSnake::Direction GameSnake::get_greedy_direction_() {
   // Simple AI: move toward pickup while avoiding collisions
-  if (snake_.empty())
+  if (board_.length() == 0)
     return direction_;
 
-  const Position &head = snake_.front();
+  const Position head = position_of_(board_.head());
   int dx = pickup_.x - head.x;
   int dy = pickup_.y - head.y;
 
   // Try to move in the direction of the pickup
-  std::vector<Direction> priorities;
+  Direction priorities[3];
 
   if (abs(dx) > abs(dy)) {
     // Horizontal movement priority
-    if (dx > 0)
-      priorities = {Direction::RIGHT, dy > 0 ? Direction::DOWN : Direction::UP, Direction::LEFT};
-    else
-      priorities = {Direction::LEFT, dy > 0 ? Direction::DOWN : Direction::UP, Direction::RIGHT};
+    priorities[0] = dx > 0 ? Direction::RIGHT : Direction::LEFT;
+    priorities[1] = dy > 0 ? Direction::DOWN : Direction::UP;
+    priorities[2] = dx > 0 ? Direction::LEFT : Direction::RIGHT;
   } else {
     // Vertical movement priority
-    if (dy > 0)
-      priorities = {Direction::DOWN, dx > 0 ? Direction::RIGHT : Direction::LEFT, Direction::UP};
-    else
-      priorities = {Direction::UP, dx > 0 ? Direction::RIGHT : Direction::LEFT, Direction::DOWN};
+    priorities[0] = dy > 0 ? Direction::DOWN : Direction::UP;
+    priorities[1] = dx > 0 ? Direction::RIGHT : Direction::LEFT;
+    priorities[2] = dy > 0 ? Direction::UP : Direction::DOWN;
   }
 
   // Test each direction
@@ -454,20 +439,21 @@ void GameSnake::render_() {
     return;
 
   if (initial_render_) {
-    // Clear canvas
-    lv_canvas_fill_bg(canvas_, color_bg_, LV_OPA_COVER);
+    // Clear canvas (marks the whole area damaged)
+    clear_fast(color_bg_);
 
     // Draw border if walls enabled
     if (walls_enabled_) {
       draw_border_();
     }
 
-    // Draw pickup (use slow path for initial render, it's fine)
-    draw_cell_(pickup_.x, pickup_.y, color_pickup_);
+    // Draw pickup
+    draw_cell_fast_(pickup_.x, pickup_.y, color_pickup_);
 
     // Draw snake
-    for (const auto &part : snake_) {
-      draw_cell_(part.x, part.y, color_snake_);
+    for (size_t i = 0; i < board_.length(); i++) {
+      const SnakeBoard::Cell c = board_.at(i);
+      draw_cell_fast_(board_.x_of(c), board_.y_of(c), color_snake_);
     }
 
     // Draw initial score
@@ -476,16 +462,13 @@ void GameSnake::render_() {
     initial_render_ = false;
     last_drawn_score_ = state_.score;
     last_pickup_ = pickup_;
-
-    // Full invalidation for initial render
-    lv_obj_invalidate(canvas_);
   } else {
     // Fast incremental update using direct buffer manipulation
 
     // Draw new snake head
-    if (!snake_.empty()) {
-      const Position &head = snake_.front();
-      draw_cell_fast_(head.x, head.y, color_snake_);
+    if (board_.length() > 0) {
+      const SnakeBoard::Cell head = board_.head();
+      draw_cell_fast_(board_.x_of(head), board_.y_of(head), color_snake_);
     }
 
     // Erase tail if it was removed
@@ -501,8 +484,8 @@ void GameSnake::render_() {
 
     // Redraw score if it changed or game over
     if (state_.score != last_drawn_score_ || state_.game_over) {
-      clear_score_area_fast_();  // Clears and invalidates
-      draw_score_();              // Draws text on top (already invalidated)
+      clear_score_area_fast_();  // Clears and records damage
+      draw_score_();              // Draws text on top
       last_drawn_score_ = state_.score;
     }
 
@@ -520,23 +503,10 @@ void GameSnake::render_() {
   }
 }
 
-void GameSnake::draw_cell_(int gx, int gy, lv_color_t color) {
-  const int px = grid_offset_x_ + gx * cell_width_;
-  const int py = grid_offset_y_ + gy * cell_height_;
-
-  lv_draw_rect_dsc_t rect_dsc;
-  lv_draw_rect_dsc_init(&rect_dsc);
-  rect_dsc.bg_color = color;
-  rect_dsc.bg_opa = LV_OPA_COVER;
-  rect_dsc.border_width = 0;
-
-  lv_canvas_draw_rect(canvas_, px, py, cell_width_, cell_height_, &rect_dsc);
-}
-
 void GameSnake::draw_cell_fast_(int gx, int gy, lv_color_t color) {
   const int px = grid_offset_x_ + gx * cell_width_;
   const int py = grid_offset_y_ + gy * cell_height_;
-  fill_rect_fast(px, py, cell_width_, cell_height_, color);  // Also invalidates
+  fill_rect_fast(px, py, cell_width_, cell_height_, color);  // Also records damage
 }
 
 void GameSnake::clear_score_area_fast_() {
@@ -556,18 +526,10 @@ void GameSnake::clear_center_text_area_() {
 }
 
 void GameSnake::draw_border_() {
-  lv_draw_rect_dsc_t rect_dsc;
-  lv_draw_rect_dsc_init(&rect_dsc);
-  rect_dsc.bg_opa = LV_OPA_TRANSP;
-  rect_dsc.border_color = color_border_;
-  rect_dsc.border_width = 1;
-  rect_dsc.border_opa = LV_OPA_COVER;
-
   // Draw border 1 pixel outside the actual game grid
   const int grid_pixel_width = grid_cols_ * cell_width_;
   const int grid_pixel_height = grid_rows_ * cell_height_;
-  lv_canvas_draw_rect(canvas_, grid_offset_x_ - 1, grid_offset_y_ - 1, grid_pixel_width + 2, grid_pixel_height + 2,
-                      &rect_dsc);
+  draw_rect(grid_offset_x_ - 1, grid_offset_y_ - 1, grid_pixel_width + 2, grid_pixel_height + 2, color_border_);
 }
 
 void GameSnake::draw_score_() {
@@ -577,12 +539,12 @@ void GameSnake::draw_score_() {
 
   if (state_.game_over) {
     // Draw game over text
-    draw_text(0, area_.h / 2 - 10, "GAME OVER", color_snake_, LV_TEXT_ALIGN_CENTER);
+    draw_text(area_.w / 2, area_.h / 2 - 10, "GAME OVER", color_snake_, LV_TEXT_ALIGN_CENTER);
     snprintf(buf, sizeof(buf), "Score: %d", state_.score);
-    draw_text(0, area_.h / 2 + 4, buf, color_snake_, LV_TEXT_ALIGN_CENTER);
+    draw_text(area_.w / 2, area_.h / 2 + 4, buf, color_snake_, LV_TEXT_ALIGN_CENTER);
   } else if (paused_) {
     // Draw paused text
-    draw_text(0, area_.h / 2 - 7, "PAUSED", color_snake_, LV_TEXT_ALIGN_CENTER);
+    draw_text(area_.w / 2, area_.h / 2 - 7, "PAUSED", color_snake_, LV_TEXT_ALIGN_CENTER);
   }
 }
 
@@ -4,9 +4,10 @@
 #pragma once
 
 #include <cstdint>
-#include <vector>
 #include "esphome/components/lvgl_game_runner/game_base.h"
 #include "esphome/components/lvgl_game_runner/game_state.h"
+#include "snake_board.h"
+#include "snake_planner.h"
 
 namespace esphome::game_snake {
 
@@ -14,6 +15,7 @@ using lvgl_game_runner::GameBase;
 using lvgl_game_runner::GameState;
 using lvgl_game_runner::InputEvent;
 using lvgl_game_runner::InputType;
+using lvgl_game_runner::Scalar;
 
 /**
  * Classic Snake game.
@@ -26,13 +28,20 @@ class GameSnake : public GameBase {
 
   void on_bind(lv_obj_t *canvas) override;
   void on_resize(const Rect &r) override;
-  void step(float dt) override;
+  void update(Scalar dt) override;
+  void render(Scalar alpha) override;
   void on_input(const InputEvent &event) override;
   void reset() override;
+  uint32_t idle_hint_us() const override;
 
   // Snake is single-player only
   uint8_t get_max_players() const override { return 1; }
 
+  /**
+   * Grid cells autoplay may search per update() call.
+   */
+  void set_autoplay_budget(uint32_t budget_nodes) { autoplay_budget_nodes_ = budget_nodes; }
+
  private:
   // Grid configuration (dynamically calculated in on_resize)
   static constexpr int MIN_GRID_CELLS = 12;  // Ideal size for smallest dimension
@@ -52,7 +61,8 @@ class GameSnake : public GameBase {
 
   enum class Direction { UP, DOWN, LEFT, RIGHT };
 
-  std::vector<Position> snake_;
+  SnakeBoard board_;  // Body and occupancy, sized in on_resize
+  SnakePlanner planner_;
   Position snake_tail_{NULL_POSITION};
   Position pickup_;
   Position last_pickup_{NULL_POSITION};
@@ -66,12 +76,13 @@ class GameSnake : public GameBase {
   bool last_paused_{false};
 
   // Timing
-  float update_timer_{0.0f};
-  float update_interval_{0.15f};  // seconds per move
+  Scalar update_timer_{0};
+  Scalar update_interval_{Scalar(0.15f)};  // seconds per move
 
   // Config
   bool walls_enabled_{true};
   bool autoplay_{false};
+  uint32_t autoplay_budget_nodes_{500};
 
   // Rendering
   int cell_width_{1};
@@ -86,11 +97,14 @@ class GameSnake : public GameBase {
   void spawn_pickup_();
   bool check_collision_(const Position &pos);
   bool check_self_collision_(const Position &pos);
+  Position position_of_(SnakeBoard::Cell c) const { return {board_.x_of(c), board_.y_of(c)}; }
+  bool is_autoplay_() const { return autoplay_ || get_num_human_players() == 0; }
+  SnakeBoard::Cell pickup_cell_() const;
   Direction get_autoplay_direction_();
+  Direction get_greedy_direction_();
 
   // Rendering
   void render_();
-  void draw_cell_(int gx, int gy, lv_color_t color);
   void draw_cell_fast_(int gx, int gy, lv_color_t color);
   void clear_score_area_fast_();
   void clear_center_text_area_();
@@ -0,0 +1,70 @@
+// © Copyright 2025 Stuart Parmenter
+// SPDX-License-Identifier: MIT
+
+#include "snake_board.h"
+
+#include <algorithm>
+
+namespace esphome::game_snake {
+
+void SnakeBoard::resize(int cols, int rows) {
+  this->cols_ = std::max(cols, 0);
+  this->rows_ = std::max(rows, 0);
+  if (this->num_cells() > MAX_CELLS)
+    this->rows_ = (int) (MAX_CELLS / std::max(this->cols_, 1));
+
+  const size_t n = this->num_cells();
+  this->bits_.assign((n + 31) / 32, 0);
+  this->body_.assign(std::max<size_t>(n, 1), 0);
+  this->free_.resize(n);
+  this->free_index_.resize(n);
+  this->clear();
+}
+
+void SnakeBoard::clear() {
+  std::fill(this->bits_.begin(), this->bits_.end(), 0);
+  for (size_t i = 0; i < this->free_.size(); i++) {
+    this->free_[i] = (Cell) i;
+    this->free_index_[i] = (Cell) i;
+  }
+  this->free_count_ = this->free_.size();
+  this->head_ = 0;
+  this->length_ = 0;
+}
+
+void SnakeBoard::occupy_(Cell c) {
+  this->bits_[c >> 5] |= 1u << (c & 31);
+
+  // Swap-remove from the free list
+  const Cell idx = this->free_index_[c];
+  const Cell last = this->free_[--this->free_count_];
+  this->free_[idx] = last;
+  this->free_index_[last] = idx;
+}
+
+void SnakeBoard::release_(Cell c) {
+  this->bits_[c >> 5] &= ~(1u << (c & 31));
+  this->free_[this->free_count_] = c;
+  this->free_index_[c] = (Cell) this->free_count_++;
+}
+
+void SnakeBoard::push_head(Cell c) {
+  if (this->occupied(c) || this->length_ == this->body_.size())
+    return;
+  if (this->length_ > 0)
+    this->head_ = (this->head_ + 1) % this->body_.size();
+  this->body_[this->head_] = c;
+  this->length_++;
+  this->occupy_(c);
+}
+
+SnakeBoard::Cell SnakeBoard::pop_tail() {
+  if (this->length_ == 0)
+    return NO_CELL;
+  const Cell c = this->tail();
+  this->length_--;
+  this->release_(c);
+  return c;
+}
+
+}  // namespace esphome::game_snake
@@ -0,0 +1,92 @@
+// © Copyright 2025 Stuart Parmenter
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "esphome/components/lvgl_game_runner/game_rng.h"
+
+namespace esphome::game_snake {
+
+using lvgl_game_runner::GameRng;
+
+/**
+ * Snake playfield: which cells the body occupies, and the body itself.
+ *
+ * Cells are numbered y * cols + x. A packed bit-per-cell grid answers "is this cell taken"
+ * in O(1), the body is a circular buffer of cells (head added, tail removed in O(1)), and a
+ * free-cell list with a reverse index gives a uniformly random empty cell in O(1).
+ * All storage is sized in resize(); nothing is allocated while playing.
+ */
+class SnakeBoard {
+ public:
+  using Cell = uint16_t;
+  static constexpr size_t MAX_CELLS = 65535;
+  static constexpr Cell NO_CELL = 0xFFFF;
+
+  /**
+   * Size the board for cols x rows cells (at most MAX_CELLS) and clear it.
+   */
+  void resize(int cols, int rows);
+
+  /**
+   * Remove the whole body; every cell becomes free.
+   */
+  void clear();
+
+  int cols() const { return this->cols_; }
+  int rows() const { return this->rows_; }
+  size_t num_cells() const { return (size_t) this->cols_ * this->rows_; }
+
+  Cell cell(int x, int y) const { return (Cell) (y * this->cols_ + x); }
+  int x_of(Cell c) const { return c % this->cols_; }
+  int y_of(Cell c) const { return c / this->cols_; }
+
+  bool occupied(Cell c) const { return (this->bits_[c >> 5] >> (c & 31)) & 1; }
+
+  // Body, index 0 = head
+  size_t length() const { return this->length_; }
+  Cell head() const { return this->body_[this->head_]; }
+  Cell tail() const { return this->at(this->length_ - 1); }
+  Cell at(size_t i) const {
+    const size_t n = this->body_.size();
+    return this->body_[(this->head_ + n - i) % n];
+  }
+
+  /**
+   * Grow the body by a new head at free cell `c`.
+   */
+  void push_head(Cell c);
+
+  /**
+   * Remove the tail and return its cell (which becomes free).
+   */
+  Cell pop_tail();
+
+  size_t free_count() const { return this->free_count_; }
+
+  /**
+   * A uniformly chosen free cell, or NO_CELL if the board is full.
+   */
+  Cell random_free(GameRng &rng) const {
+    return this->free_count_ ? this->free_[rng.below(this->free_count_)] : NO_CELL;
+  }
+
+ private:
+  void occupy_(Cell c);
+  void release_(Cell c);
+
+  int cols_{0};
+  int rows_{0};
+  std::vector<uint32_t> bits_;      // Occupancy, 1 bit per cell
+  std::vector<Cell> body_;          // Circular, capacity num_cells()
+  size_t head_{0};                  // Index of the head in body_
+  size_t length_{0};
+  std::vector<Cell> free_;          // Free cells, first free_count_ entries valid
+  std::vector<Cell> free_index_;    // Position of each free cell in free_
+  size_t free_count_{0};
+};
+
+}  // namespace esphome::game_snake
@@ -0,0 +1,273 @@
+// © Copyright 2025 Stuart Parmenter
+// SPDX-License-Identifier: MIT
+
+#include "snake_planner.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace esphome::game_snake {
+
+void SnakePlanner::resize(size_t num_cells) {
+  this->seen_.assign(num_cells, 0);
+  this->mark_.assign(num_cells, 0);
+  this->free_at_.assign(num_cells, 0);
+  this->depth_.assign(num_cells, 0);
+  this->parent_.assign(num_cells, SnakeBoard::NO_CELL);
+  this->queue_.assign(num_cells, SnakeBoard::NO_CELL);
+  this->candidate_.assign(num_cells, SnakeBoard::NO_CELL);
+  this->path_.assign(num_cells, SnakeBoard::NO_CELL);
+  this->gen_ = 0;
+  this->reset();
+}
+
+void SnakePlanner::reset() {
+  this->phase_ = Phase::IDLE;
+  this->key_head_ = SnakeBoard::NO_CELL;
+  this->key_tail_ = SnakeBoard::NO_CELL;
+  this->key_target_ = SnakeBoard::NO_CELL;
+  this->have_pickup_candidate_ = false;
+  this->path_len_ = 0;
+  this->path_pos_ = 0;
+  this->path_target_ = SnakeBoard::NO_CELL;
+  this->path_to_pickup_ = false;
+}
+
+void SnakePlanner::think(const SnakeBoard &board, Cell target, uint32_t budget_nodes) {
+  if (target == SnakeBoard::NO_CELL || board.length() == 0 || this->seen_.size() != board.num_cells())
+    return;
+
+  // A safe path to the current pickup needs no more work
+  if (this->path_to_pickup_ && this->path_target_ == target && this->path_valid_(board))
+    return;
+
+  if (this->is_stale_(board, target))
+    this->begin_(board, target);
+
+  uint32_t budget = budget_nodes;
+  while (this->phase_ != Phase::DONE) {
+    const Search result = this->bfs_(board, budget);
+    if (result == Search::OUT_OF_BUDGET)
+      return;  // Resume on the next call
+
+    switch (this->phase_) {
+      case Phase::PICKUP:
+        if (result == Search::FOUND) {
+          // Check that the snake could still reach its tail after eating
+          this->extract_();
+          this->have_pickup_candidate_ = true;
+          const size_t len = board.length();
+          const size_t p = this->candidate_len_;
+          const Cell virtual_tail = p - 1 < len ? board.at(len - p) : this->candidate_[p - 1 - len];
+          this->phase_ = Phase::SAFETY;
+          this->begin_bfs_(target, virtual_tail);
+          this->mark_virtual_body_(board);
+        } else {
+          this->begin_tail_(board, target);
+        }
+        break;
+
+      case Phase::SAFETY:
+        if (result == Search::FOUND) {
+          this->accept_(true);
+          this->phase_ = Phase::DONE;
+        } else {
+          this->begin_tail_(board, target);
+        }
+        break;
+
+      case Phase::TAIL:
+        if (result == Search::FOUND && this->depth_[this->goal_] > this->tail_best_depth_) {
+          this->tail_best_ = this->tail_start_;
+          this->tail_best_depth_ = this->depth_[this->goal_];
+        }
+        if (this->next_tail_start_(board, target))
+          break;
+        if (this->tail_best_ != SnakeBoard::NO_CELL) {
+          this->candidate_[0] = this->tail_best_;
+          this->candidate_len_ = 1;
+          this->accept_(false);
+        } else if (this->have_pickup_candidate_) {
+          this->accept_(true);  // Unsafe, but better than nothing; candidate_ still holds it
+        }
+        this->phase_ = Phase::DONE;
+        break;
+
+      default:
+        this->phase_ = Phase::DONE;
+        break;
+    }
+  }
+}
+
+SnakePlanner::Cell SnakePlanner::next_move(const SnakeBoard &board, Cell target, uint32_t budget_nodes) {
+  this->think(board, target, budget_nodes);
+  if (!this->path_valid_(board))
+    return SnakeBoard::NO_CELL;
+  return this->path_[this->path_pos_++];
+}
+
+SnakePlanner::Cell SnakePlanner::neighbor_(const SnakeBoard &board, Cell c, int dir) const {
+  const int cols = board.cols();
+  const int rows = board.rows();
+  int x = board.x_of(c);
+  int y = board.y_of(c);
+  switch (dir) {
+    case 0:
+      y--;
+      break;
+    case 1:
+      y++;
+      break;
+    case 2:
+      x--;
+      break;
+    default:
+      x++;
+      break;
+  }
+  if (x < 0 || x >= cols || y < 0 || y >= rows) {
+    if (!this->wrap_)
+      return SnakeBoard::NO_CELL;
+    x = (x + cols) % cols;
+    y = (y + rows) % rows;
+  }
+  return board.cell(x, y);
+}
+
+bool SnakePlanner::is_stale_(const SnakeBoard &board, Cell target) const {
+  return this->phase_ == Phase::IDLE || this->key_head_ != board.head() || this->key_tail_ != board.tail() ||
+         this->key_target_ != target;
+}
+
+bool SnakePlanner::path_valid_(const SnakeBoard &board) const {
+  if (this->path_pos_ >= this->path_len_)
+    return false;
+  const Cell next = this->path_[this->path_pos_];
+  if (board.occupied(next))
+    return false;
+  for (int dir = 0; dir < 4; dir++) {
+    if (this->neighbor_(board, board.head(), dir) == next)
+      return true;
+  }
+  return false;  // Snake left the path (e.g. a wrap setting change)
+}
+
+void SnakePlanner::begin_(const SnakeBoard &board, Cell target) {
+  this->key_head_ = board.head();
+  this->key_tail_ = board.tail();
+  this->key_target_ = target;
+  this->have_pickup_candidate_ = false;
+  this->phase_ = Phase::PICKUP;
+  this->begin_bfs_(board.head(), target);
+  this->mark_body_(board);
+}
+
+void SnakePlanner::begin_tail_(const SnakeBoard &board, Cell target) {
+  this->phase_ = Phase::TAIL;
+  this->tail_dir_ = 0;
+  this->tail_best_ = SnakeBoard::NO_CELL;
+  this->tail_best_depth_ = 0;
+  this->next_tail_start_(board, target);
+}
+
+bool SnakePlanner::next_tail_start_(const SnakeBoard &board, Cell target) {
+  // Try each free first step; the one with the longest way back to the tail keeps the body
+  // spread out instead of coiling, which is what eventually opens a safe route to the pickup
+  while (this->tail_dir_ < 4) {
+    const Cell start = this->neighbor_(board, board.head(), this->tail_dir_++);
+    if (start == SnakeBoard::NO_CELL || start == target || board.occupied(start))
+      continue;
+    this->tail_start_ = start;
+    this->begin_bfs_(start, board.tail(), 1);
+    this->mark_body_(board);
+    // Stay off the pickup: growing on the way would put the tail a step behind the plan
+    this->block_(target, UINT16_MAX);
+    return true;
+  }
+  this->queue_head_ = this->queue_tail_ = 0;
+  return false;
+}
+
+void SnakePlanner::begin_bfs_(Cell start, Cell goal, uint16_t depth) {
+  // New generation invalidates every seen_/mark_ entry at once
+  if (++this->gen_ == 0) {
+    std::fill(this->seen_.begin(), this->seen_.end(), 0);
+    std::fill(this->mark_.begin(), this->mark_.end(), 0);
+    this->gen_ = 1;
+  }
+  this->goal_ = goal;
+  this->seen_[start] = this->gen_;
+  this->depth_[start] = depth;
+  this->queue_[0] = start;
+  this->queue_head_ = 0;
+  this->queue_tail_ = 1;
+}
+
+void SnakePlanner::block_(Cell c, uint32_t free_at) {
+  this->mark_[c] = this->gen_;
+  this->free_at_[c] = (uint16_t) std::min<uint32_t>(free_at, UINT16_MAX);
+}
+
+void SnakePlanner::mark_body_(const SnakeBoard &board) {
+  // Segment i (0 = head) is still there for the next len - i moves
+  const size_t len = board.length();
+  for (size_t i = 0; i < len; i++)
+    this->block_(board.at(i), len - i + 1);
+}
+
+void SnakePlanner::mark_virtual_body_(const SnakeBoard &board) {
+  // The snake after following candidate_ and growing by one: the last len + 1 cells of
+  // (body from tail to head, then the path). Element k of that sequence frees up at k - p + 3.
+  const size_t len = board.length();
+  const size_t p = this->candidate_len_;
+  for (size_t k = p - 1; k <= len + p - 1; k++) {
+    const Cell c = k < len ? board.at(len - 1 - k) : this->candidate_[k - len];
+    this->block_(c, k - p + 3);
+  }
+}
+
+SnakePlanner::Search SnakePlanner::bfs_(const SnakeBoard &board, uint32_t &budget) {
+  while (this->queue_head_ < this->queue_tail_) {
+    if (budget == 0)
+      return Search::OUT_OF_BUDGET;
+    budget--;
+
+    const Cell c = this->queue_[this->queue_head_++];
+    const uint16_t d = this->depth_[c] + 1;
+    for (int dir = 0; dir < 4; dir++) {
+      const Cell n = this->neighbor_(board, c, dir);
+      if (n == SnakeBoard::NO_CELL || this->seen_[n] == this->gen_)
+        continue;
+      if (this->mark_[n] == this->gen_ && d < this->free_at_[n])
+        continue;  // Body still there when we'd arrive; may be reachable later via a longer route
+      this->seen_[n] = this->gen_;
+      this->depth_[n] = d;
+      this->parent_[n] = c;
+      if (n == this->goal_)
+        return Search::FOUND;
+      this->queue_[this->queue_tail_++] = n;
+    }
+  }
+  return Search::EXHAUSTED;
+}
+
+void SnakePlanner::extract_() {
+  const size_t len = this->depth_[this->goal_];
+  Cell c = this->goal_;
+  for (size_t i = len; i > 0; i--) {
+    this->candidate_[i - 1] = c;
+    c = this->parent_[c];
+  }
+  this->candidate_len_ = len;
+}
+
+void SnakePlanner::accept_(bool to_pickup) {
+  std::swap(this->path_, this->candidate_);
+  this->path_len_ = this->candidate_len_;
+  this->path_pos_ = 0;
+  this->path_target_ = this->key_target_;
+  this->path_to_pickup_ = to_pickup;
+}
+
+}  // namespace esphome::game_snake
@@ -0,0 +1,118 @@
+// © Copyright 2025 Stuart Parmenter
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "snake_board.h"
+
+namespace esphome::game_snake {
+
+/**
+ * Autoplay path planner for Snake.
+ *
+ * Breadth-first search over the SnakeBoard grid that knows the body moves: a body segment
+ * counts as free once the tail will have passed it by the time the head arrives. A path to
+ * the pickup is only taken if, after eating, the head can still reach its own tail (so the
+ * snake doesn't box itself in); otherwise the planner chases its tail until the pickup is
+ * safely reachable.
+ *
+ * The resulting path is cached and only replanned when the pickup moves, the path is used
+ * up or blocked, or (while tail chasing) after every move. Searches are resumable and
+ * expand at most `budget_nodes` cells per call, so a big board spreads its planning over
+ * several frames. The budget is a node count rather than a time so that a replay plans
+ * exactly the same moves. All storage is sized in resize(); nothing is allocated while
+ * playing.
+ */
+class SnakePlanner {
+ public:
+  using Cell = SnakeBoard::Cell;
+
+  /**
+   * Size the node storage for a board of `num_cells` cells and drop any plan.
+   */
+  void resize(size_t num_cells);
+
+  /**
+   * Drop the cached path and any search in progress.
+   */
+  void reset();
+
+  /**
+   * Whether moving off an edge wraps around (walls disabled).
+   */
+  void set_wrap(bool wrap) { this->wrap_ = wrap; }
+
+  /**
+   * Advance planning toward `target`, expanding up to `budget_nodes` cells. Cheap when a
+   * valid path is cached.
+   */
+  void think(const SnakeBoard &board, Cell target, uint32_t budget_nodes);
+
+  /**
+   * Cell the head should move into next, or SnakeBoard::NO_CELL if no plan is ready.
+   */
+  Cell next_move(const SnakeBoard &board, Cell target, uint32_t budget_nodes);
+
+ private:
+  enum class Phase : uint8_t { IDLE, PICKUP, SAFETY, TAIL, DONE };
+  enum class Search : uint8_t { FOUND, EXHAUSTED, OUT_OF_BUDGET };
+
+  Cell neighbor_(const SnakeBoard &board, Cell c, int dir) const;
+  bool is_stale_(const SnakeBoard &board, Cell target) const;
+  bool path_valid_(const SnakeBoard &board) const;
+
+  void begin_(const SnakeBoard &board, Cell target);
+  void begin_tail_(const SnakeBoard &board, Cell target);
+  bool next_tail_start_(const SnakeBoard &board, Cell target);
+  void begin_bfs_(Cell start, Cell goal, uint16_t depth = 0);
+  void block_(Cell c, uint32_t free_at);
+  void mark_body_(const SnakeBoard &board);
+  void mark_virtual_body_(const SnakeBoard &board);
+  Search bfs_(const SnakeBoard &board, uint32_t &budget);
+  void extract_();
+  void accept_(bool to_pickup);
+
+  bool wrap_{false};
+  Phase phase_{Phase::IDLE};
+
+  // Board the current search was started for
+  Cell key_head_{SnakeBoard::NO_CELL};
+  Cell key_tail_{SnakeBoard::NO_CELL};
+  Cell key_target_{SnakeBoard::NO_CELL};
+
+  // BFS nodes, one entry per cell. seen_/mark_ entries are valid when equal to gen_, so a
+  // new search doesn't have to clear them.
+  uint16_t gen_{0};
+  std::vector<uint16_t> seen_;
+  std::vector<uint16_t> mark_;
+  std::vector<uint16_t> free_at_;  // Depth at which a marked body cell can be entered
+  std::vector<uint16_t> depth_;
+  std::vector<Cell> parent_;
+  std::vector<Cell> queue_;
+  size_t queue_head_{0};
+  size_t queue_tail_{0};
+  Cell goal_{SnakeBoard::NO_CELL};
+
+  // Candidate from the last successful BFS
+  std::vector<Cell> candidate_;
+  size_t candidate_len_{0};
+  bool have_pickup_candidate_{false};
+
+  // Tail chasing: first steps tried so far and the best one
+  int tail_dir_{0};
+  Cell tail_start_{SnakeBoard::NO_CELL};
+  Cell tail_best_{SnakeBoard::NO_CELL};
+  uint16_t tail_best_depth_{0};
+
+  // Cached path being followed
+  std::vector<Cell> path_;
+  size_t path_len_{0};
+  size_t path_pos_{0};
+  Cell path_target_{SnakeBoard::NO_CELL};
+  bool path_to_pickup_{false};
+};
+
+}  // namespace esphome::game_snake
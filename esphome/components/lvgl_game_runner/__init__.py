@@ -7,17 +7,22 @@ import esphome.config_validation as cv
 from esphome.const import (
     CONF_ID,
     CONF_INPUT,
+    STATE_CLASS_MEASUREMENT,
+    UNIT_MILLISECOND,
 )
 
 from esphome import automation
-from esphome.components import lvgl
+from esphome.core import CORE, EsphomeError, Lambda
+from esphome.components import lvgl, sensor, text_sensor
 
 DEPENDENCIES = ["lvgl"]
+AUTO_LOAD = ["sensor", "text_sensor"]
 
 ns = cg.esphome_ns.namespace("lvgl_game_runner")
 
 LvglGameRunner = ns.class_("LvglGameRunner", cg.Component)
 GameBase = ns.class_("GameBase")
+GameFactory = ns.class_("GameFactory")
 StartAction = ns.class_(
     "StartAction", automation.Action, cg.Parented.template(LvglGameRunner)
 )
@@ -30,6 +35,18 @@ ResumeAction = ns.class_(
 ToggleAction = ns.class_(
     "ToggleAction", automation.Action, cg.Parented.template(LvglGameRunner)
 )
+StartRecordingAction = ns.class_(
+    "StartRecordingAction", automation.Action, cg.Parented.template(LvglGameRunner)
+)
+StopRecordingAction = ns.class_(
+    "StopRecordingAction", automation.Action, cg.Parented.template(LvglGameRunner)
+)
+ReplayAction = ns.class_(
+    "ReplayAction", automation.Action, cg.Parented.template(LvglGameRunner)
+)
+StopReplayAction = ns.class_(
+    "StopReplayAction", automation.Action, cg.Parented.template(LvglGameRunner)
+)
 SetFpsAction = ns.class_(
     "SetFpsAction", automation.Action, cg.Parented.template(LvglGameRunner)
 )
@@ -50,6 +67,70 @@ CONF_START_PAUSED = "start_paused"
 CONF_PRESSED = "pressed"
 CONF_PLAYER = "player"
 CONF_NUM_HUMAN_PLAYERS = "num_human_players"
+CONF_MULTI_PRODUCER_INPUT = "multi_producer_input"
+CONF_SIMULATION_RATE = "simulation_rate"
+CONF_MAX_CATCHUP_STEPS = "max_catchup_steps"
+CONF_TASK = "task"
+CONF_CORE = "core"
+CONF_TASK_PRIORITY = "priority"
+CONF_STACK_SIZE = "stack_size"
+CONF_DOUBLE_BUFFER = "double_buffer"
+CONF_CANVAS_FORMAT = "canvas_format"
+CONF_PIXEL_SCALE = "pixel_scale"
+CONF_PROFILER = "profiler"
+CONF_EFFECTIVE_FPS = "effective_fps"
+CONF_FRAME_TIME_P50 = "frame_time_p50"
+CONF_FRAME_TIME_P95 = "frame_time_p95"
+CONF_FRAME_TIME_P99 = "frame_time_p99"
+CONF_LVGL_LATENCY_P95 = "lvgl_latency_p95"
+CONF_INPUT_LATENCY_P95 = "input_latency_p95"
+CONF_PHASES = "phases"
+CONF_SEED = "seed"
+CONF_KEEP_PREVIOUS_GAME = "keep_previous_game"
+CONF_IDLE_SLEEP = "idle_sleep"
+CONF_CPU_FREQUENCY_LOCK = "cpu_frequency_lock"
+
+# The instance inside a game's create function; game components call their setters on it
+GAME_VAR = cg.MockObj("game", "->")
+
+# Size of GameRegistry's table (LVGL_GAME_RUNNER_MAX_GAMES in game_registry.h)
+MAX_GAMES = 8
+
+
+async def register_game(config, key, game_class, setters=()):
+    """Declare a game that is only constructed when a runner switches to it.
+
+    config[CONF_ID] must be declared as a GameFactory. `setters` are calls on GAME_VAR
+    (e.g. GAME_VAR.set_num_human_players(2)) applied every time the game is constructed.
+    """
+    games = CORE.data.setdefault("lvgl_game_runner", {}).setdefault("games", [])
+    if key in games:
+        raise EsphomeError(f"Game '{key}' is configured more than once")
+    games.append(key)
+    if len(games) > MAX_GAMES:
+        raise EsphomeError(f"At most {MAX_GAMES} games can be configured, got {len(games)}")
+
+    body = "".join(f" {setter};" for setter in setters)
+    create = cg.RawExpression(
+        f"[]() -> {GameBase} * {{ auto *game = new (std::nothrow) {game_class}();"
+        f" if (game != nullptr) {{{body} }} return game; }}"
+    )
+    return cg.new_Pvariable(config[CONF_ID], key, create)
+
+BufferMode = LvglGameRunner.enum("BufferMode", is_class=True)
+BUFFER_MODES = {
+    "none": BufferMode.SINGLE,
+    "psram": BufferMode.PSRAM,
+    "internal": BufferMode.INTERNAL,
+}
+
+CanvasFormat = LvglGameRunner.enum("CanvasFormat", is_class=True)
+CANVAS_FORMATS = {
+    "native": CanvasFormat.NATIVE,
+    "indexed_1bit": CanvasFormat.INDEXED_1BIT,
+    "indexed_2bit": CanvasFormat.INDEXED_2BIT,
+    "indexed_4bit": CanvasFormat.INDEXED_4BIT,
+}
 
 # Input type enum matching C++ InputType
 InputTypeEnum = ns.enum("InputType", is_class=True)
@@ -69,14 +150,66 @@ INPUT_TYPES = {
     "TOUCH": InputTypeEnum.TOUCH,
 }
 
+TASK_SCHEMA = cv.Schema(
+    {
+        cv.Optional(CONF_CORE, default=1): cv.Any(
+            cv.one_of("any", lower=True), cv.int_range(min=0, max=1)
+        ),
+        cv.Optional(CONF_TASK_PRIORITY, default=5): cv.int_range(min=1, max=24),
+        cv.Optional(CONF_STACK_SIZE, default=8192): cv.int_range(min=2048, max=65536),
+    }
+)
+
+_FRAME_TIME_SCHEMA = sensor.sensor_schema(
+    unit_of_measurement=UNIT_MILLISECOND,
+    icon="mdi:timer-outline",
+    accuracy_decimals=2,
+    state_class=STATE_CLASS_MEASUREMENT,
+)
+
+# Frame profiler entities, published every metrics window (5s)
+PROFILER_SCHEMA = cv.Schema(
+    {
+        cv.Optional(CONF_EFFECTIVE_FPS): sensor.sensor_schema(
+            unit_of_measurement="fps",
+            icon="mdi:speedometer",
+            accuracy_decimals=1,
+            state_class=STATE_CLASS_MEASUREMENT,
+        ),
+        cv.Optional(CONF_FRAME_TIME_P50): _FRAME_TIME_SCHEMA,
+        cv.Optional(CONF_FRAME_TIME_P95): _FRAME_TIME_SCHEMA,
+        cv.Optional(CONF_FRAME_TIME_P99): _FRAME_TIME_SCHEMA,
+        cv.Optional(CONF_LVGL_LATENCY_P95): _FRAME_TIME_SCHEMA,
+        cv.Optional(CONF_INPUT_LATENCY_P95): _FRAME_TIME_SCHEMA,
+        cv.Optional(CONF_PHASES): text_sensor.text_sensor_schema(
+            icon="mdi:chart-timeline"
+        ),
+    }
+)
 
 CONFIG_SCHEMA = cv.Schema(
     {
         cv.GenerateID(): cv.declare_id(LvglGameRunner),
         cv.Required(CONF_CANVAS): cv.use_id(lvgl.Widget),
-        cv.Optional(CONF_INITIAL_GAME): cv.use_id(GameBase),
+        cv.Optional(CONF_INITIAL_GAME): cv.use_id(GameFactory),
+        cv.Optional(CONF_KEEP_PREVIOUS_GAME, default=False): cv.boolean,
         cv.Optional(CONF_FPS, default=30.0): cv.float_range(min=1.0, max=240.0),
         cv.Optional(CONF_START_PAUSED, default=False): cv.boolean,
+        cv.Optional(CONF_MULTI_PRODUCER_INPUT, default=True): cv.boolean,
+        cv.Optional(CONF_SIMULATION_RATE): cv.float_range(min=1.0, max=1000.0),
+        cv.Optional(CONF_MAX_CATCHUP_STEPS, default=4): cv.int_range(min=1, max=16),
+        cv.Optional(CONF_TASK): TASK_SCHEMA,
+        cv.Optional(CONF_DOUBLE_BUFFER, default="none"): cv.enum(
+            BUFFER_MODES, lower=True
+        ),
+        cv.Optional(CONF_CANVAS_FORMAT, default="native"): cv.enum(
+            CANVAS_FORMATS, lower=True
+        ),
+        cv.Optional(CONF_PIXEL_SCALE, default=1): cv.int_range(min=1, max=4),
+        cv.Optional(CONF_PROFILER): PROFILER_SCHEMA,
+        cv.Optional(CONF_SEED): cv.uint32_t,
+        cv.Optional(CONF_IDLE_SLEEP, default=True): cv.boolean,
+        cv.Optional(CONF_CPU_FREQUENCY_LOCK, default=False): cv.boolean,
     }
 ).extend(cv.COMPONENT_SCHEMA)
 
@@ -85,9 +218,66 @@ async def to_code(config):
     var = cg.new_Pvariable(config[CONF_ID])
     await cg.register_component(var, config)
 
+    # Input from several contexts (GPIO ISR + BLE task + API) needs the MPSC queue, so it's
+    # the default; the SPSC queue is only used when every runner opts out. This is a
+    # build-wide switch: if any runner asks for MPSC, all runners get it.
+    if config[CONF_MULTI_PRODUCER_INPUT]:
+        cg.add_build_flag("-DLVGL_GAME_RUNNER_INPUT_MPSC=1")
+
     period_ms = int(round(1000.0 / config[CONF_FPS]))
     cg.add(var.set_initial_period(period_ms))
 
+    # Fixed-step simulation decouples game speed from the render rate
+    if CONF_SIMULATION_RATE in config:
+        cg.add(var.set_simulation_rate(config[CONF_SIMULATION_RATE]))
+    cg.add(var.set_max_catchup_steps(config[CONF_MAX_CATCHUP_STEPS]))
+
+    # Dedicated FreeRTOS task for frames, away from WiFi/API/sensor work on the main loop
+    if task := config.get(CONF_TASK):
+        core = -1 if task[CONF_CORE] == "any" else task[CONF_CORE]
+        cg.add(
+            var.set_task_config(
+                core, task[CONF_TASK_PRIORITY], task[CONF_STACK_SIZE]
+            )
+        )
+
+    # Fixed seed: every game start (and recording) plays out the same way
+    if CONF_SEED in config:
+        cg.add(var.set_seed(config[CONF_SEED]))
+
+    # Sleep through static screens instead of ticking at the full rate; with the lock, DFS
+    # (CONFIG_PM_ENABLE) can clock the CPU down whenever the game is idle or paused
+    cg.add(var.set_idle_sleep(config[CONF_IDLE_SLEEP]))
+    cg.add(var.set_cpu_frequency_lock(config[CONF_CPU_FREQUENCY_LOCK]))
+
+    # Games are destroyed when switched away from; optionally keep the last one for switching back
+    cg.add(var.set_keep_previous_game(config[CONF_KEEP_PREVIOUS_GAME]))
+
+    # Draw into a back buffer so the next frame overlaps LVGL's refresh of this one
+    cg.add(var.set_buffer_mode(config[CONF_DOUBLE_BUFFER]))
+
+    # Packed palette canvas: 2-16 colors in 1/16 to 1/4 of the memory
+    cg.add(var.set_canvas_format(config[CONF_CANVAS_FORMAT]))
+
+    # Chunky pixels: the game renders at 1/N resolution, upscaled into the canvas on flush
+    cg.add(var.set_pixel_scale(config[CONF_PIXEL_SCALE]))
+
+    if profiler := config.get(CONF_PROFILER):
+        for key, setter in (
+            (CONF_EFFECTIVE_FPS, var.set_fps_sensor),
+            (CONF_FRAME_TIME_P50, var.set_frame_time_p50_sensor),
+            (CONF_FRAME_TIME_P95, var.set_frame_time_p95_sensor),
+            (CONF_FRAME_TIME_P99, var.set_frame_time_p99_sensor),
+            (CONF_LVGL_LATENCY_P95, var.set_lvgl_latency_p95_sensor),
+            (CONF_INPUT_LATENCY_P95, var.set_input_latency_p95_sensor),
+        ):
+            if key in profiler:
+                sens = await sensor.new_sensor(profiler[key])
+                cg.add(setter(sens))
+        if CONF_PHASES in profiler:
+            sens = await text_sensor.new_text_sensor(profiler[CONF_PHASES])
+            cg.add(var.set_profile_text_sensor(sens))
+
     canvas_widget = await cg.get_variable(config[CONF_CANVAS])
 
     if initial_game := config.get(CONF_INITIAL_GAME):
@@ -122,6 +312,26 @@ async def to_code(config):
     ToggleAction,
     cv.Schema({cv.GenerateID(): cv.use_id(LvglGameRunner)}),
 )
+@automation.register_action(
+    "lvgl_game_runner.start_recording",
+    StartRecordingAction,
+    cv.Schema({cv.GenerateID(): cv.use_id(LvglGameRunner)}),
+)
+@automation.register_action(
+    "lvgl_game_runner.stop_recording",
+    StopRecordingAction,
+    cv.Schema({cv.GenerateID(): cv.use_id(LvglGameRunner)}),
+)
+@automation.register_action(
+    "lvgl_game_runner.replay",
+    ReplayAction,
+    cv.Schema({cv.GenerateID(): cv.use_id(LvglGameRunner)}),
+)
+@automation.register_action(
+    "lvgl_game_runner.stop_replay",
+    StopReplayAction,
+    cv.Schema({cv.GenerateID(): cv.use_id(LvglGameRunner)}),
+)
 async def toggle_to_code(config, action_id, template_arg, args):
     var = cg.new_Pvariable(action_id)
     await cg.register_parented(var, config[CONF_ID])
@@ -152,7 +362,10 @@ async def setfps_to_code(config, action_id, template_arg, args):
     cv.maybe_simple_value(
         {
             cv.GenerateID(): cv.use_id(LvglGameRunner),
-            cv.Required(CONF_GAME): cv.use_id(GameBase),
+            # A game's id, or a lambda returning its registry key ("snake", "pong", ...)
+            cv.Required(CONF_GAME): cv.Any(
+                cv.returning_lambda, cv.use_id(GameFactory)
+            ),
         },
         key=CONF_GAME,
     ),
@@ -160,8 +373,12 @@ async def setfps_to_code(config, action_id, template_arg, args):
 async def setgame_to_code(config, action_id, template_arg, args):
     var = cg.new_Pvariable(action_id, template_arg)
     await cg.register_parented(var, config[CONF_ID])
-    game_var = await cg.get_variable(config[CONF_GAME])
-    cg.add(var.set_game(game_var))
+    if isinstance(config[CONF_GAME], Lambda):
+        key = await cg.templatable(config[CONF_GAME], args, cg.std_string)
+        cg.add(var.set_game_key(key))
+    else:
+        game_var = await cg.get_variable(config[CONF_GAME])
+        cg.add(var.set_game(game_var))
     return var
 
 
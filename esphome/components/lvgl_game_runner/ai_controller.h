@@ -3,7 +3,8 @@
 
 #pragma once
 
-#include "input_types.h"
+#include "input_snapshot.h"
+#include "game_scalar.h"
 #include "game_state.h"
 
 namespace esphome::lvgl_game_runner {
@@ -14,8 +15,8 @@ class GameBase;
  * Base class for AI controllers.
  * Each game implements its own AI by subclassing this.
  *
- * AI controllers receive game state updates and can inject input events
- * to control their assigned player(s).
+ * AI controllers receive game state updates and drive their assigned player by
+ * writing into that player's slot of the game's InputSnapshot.
  */
 class AIController {
  public:
@@ -23,15 +24,15 @@ class AIController {
   virtual ~AIController() = default;
 
   /**
-   * Called each frame to update AI logic.
-   * AI can examine game state and return an input event.
+   * Called each update to run the AI logic.
+   * AI can examine game state and sets the buttons it holds with input.set_held().
    *
    * @param dt Delta time since last update (seconds)
    * @param state Current game state
    * @param game Pointer to game instance for AI to read game-specific data
-   * @return Input event to inject this frame, or InputEvent with type NONE to do nothing
+   * @param input This AI's player in the game's input snapshot
    */
-  virtual InputEvent update(float dt, const GameState &state, const GameBase *game) = 0;
+  virtual void update(Scalar dt, const GameState &state, const GameBase *game, InputSnapshot::Player &input) = 0;
 
   /**
    * Called when game resets.
@@ -0,0 +1,126 @@
+// © Copyright 2025 Stuart Parmenter
+// SPDX-License-Identifier: MIT
+
+#include "damage_tracker.h"
+
+#include <algorithm>
+
+namespace esphome::lvgl_game_runner {
+
+void DamageTracker::set_bounds(int w, int h) {
+  this->w_ = w;
+  this->h_ = h;
+  this->clear();
+}
+
+void DamageTracker::add_full() {
+  this->count_ = 0;
+  this->full_ = true;
+}
+
+void DamageTracker::merge(const DamageTracker &other) {
+  if (other.full_) {
+    this->add_full();
+    return;
+  }
+  for (size_t i = 0; i < other.count_ && !this->full_; i++) {
+    const lv_area_t &a = other.rects_[i];
+    this->add(a.x1, a.y1, a.x2 - a.x1 + 1, a.y2 - a.y1 + 1);
+  }
+}
+
+void DamageTracker::join_(lv_area_t &dst, const lv_area_t &src) {
+  dst.x1 = std::min(dst.x1, src.x1);
+  dst.y1 = std::min(dst.y1, src.y1);
+  dst.x2 = std::max(dst.x2, src.x2);
+  dst.y2 = std::max(dst.y2, src.y2);
+}
+
+void DamageTracker::remove_(size_t i) {
+  // Order doesn't matter, so swap-remove
+  this->rects_[i] = this->rects_[this->count_ - 1];
+  this->count_--;
+}
+
+void DamageTracker::add(int x, int y, int w, int h) {
+  if (this->full_ || w <= 0 || h <= 0 || this->w_ <= 0 || this->h_ <= 0)
+    return;
+
+  // Clip to the game area
+  const int x1 = std::max(x, 0);
+  const int y1 = std::max(y, 0);
+  const int x2 = std::min(x + w - 1, this->w_ - 1);
+  const int y2 = std::min(y + h - 1, this->h_ - 1);
+  if (x1 > x2 || y1 > y2)
+    return;
+
+  lv_area_t r{(lv_coord_t) x1, (lv_coord_t) y1, (lv_coord_t) x2, (lv_coord_t) y2};
+
+  for (;;) {
+    // Absorb every rectangle that overlaps or touches the new one. Merged rectangles
+    // never touch each other, so one pass per absorbed rectangle is enough.
+    bool merged = true;
+    while (merged) {
+      merged = false;
+      for (size_t i = 0; i < this->count_; i++) {
+        if (touches_(this->rects_[i], r)) {
+          join_(r, this->rects_[i]);
+          this->remove_(i);
+          merged = true;
+          break;
+        }
+      }
+    }
+
+    if (this->count_ < MAX_RECTS) {
+      this->rects_[this->count_++] = r;
+      break;
+    }
+
+    // List is full: fold into the rectangle whose area grows the least, then re-check
+    // the grown rectangle against the rest.
+    size_t best = 0;
+    int32_t best_growth = INT32_MAX;
+    for (size_t i = 0; i < this->count_; i++) {
+      lv_area_t u = this->rects_[i];
+      join_(u, r);
+      const int32_t growth = area_of_(u) - area_of_(this->rects_[i]);
+      if (growth < best_growth) {
+        best_growth = growth;
+        best = i;
+      }
+    }
+    join_(r, this->rects_[best]);
+    this->remove_(best);
+  }
+
+  this->check_coverage_();
+}
+
+bool DamageTracker::intersects(int x, int y, int w, int h) const {
+  if (w <= 0 || h <= 0)
+    return false;
+  if (this->full_)
+    return true;
+  const int x2 = x + w - 1;
+  const int y2 = y + h - 1;
+  for (size_t i = 0; i < this->count_; i++) {
+    const lv_area_t &a = this->rects_[i];
+    if (a.x1 <= x2 && x <= a.x2 && a.y1 <= y2 && y <= a.y2)
+      return true;
+  }
+  return false;
+}
+
+void DamageTracker::check_coverage_() {
+  // Rectangles in the list never overlap, so their areas can simply be summed
+  int32_t covered = 0;
+  for (size_t i = 0; i < this->count_; i++)
+    covered += area_of_(this->rects_[i]);
+
+  // Past ~75% coverage a single full invalidation is cheaper for LVGL
+  if (covered * 4 >= (int32_t) this->w_ * this->h_ * 3)
+    this->add_full();
+}
+
+}  // namespace esphome::lvgl_game_runner
@@ -0,0 +1,78 @@
+// © Copyright 2025 Stuart Parmenter
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <lvgl.h>
+#include <cstddef>
+#include <cstdint>
+
+namespace esphome::lvgl_game_runner {
+
+/**
+ * Collects the areas a game touched during one frame.
+ *
+ * Rectangles are clipped to the game area and merged with any overlapping or adjacent
+ * rectangle as they are added, so the list stays small. When the list is full, the new
+ * rectangle is folded into whichever existing rectangle grows the least. Once the damage
+ * covers most of the area the tracker collapses to a single "full" flag.
+ *
+ * Coordinates are relative to the game area; areas are inclusive (LVGL convention).
+ */
+class DamageTracker {
+ public:
+  static constexpr size_t MAX_RECTS = 8;
+
+  /**
+   * Set the clip bounds (game area size). Clears any pending damage.
+   */
+  void set_bounds(int w, int h);
+
+  /**
+   * Record a damaged rectangle (x, y, w, h).
+   */
+  void add(int x, int y, int w, int h);
+
+  /**
+   * Mark the whole area as damaged.
+   */
+  void add_full();
+
+  /**
+   * Add all of `other`'s damage (same bounds) to this tracker.
+   */
+  void merge(const DamageTracker &other);
+
+  void clear() {
+    this->count_ = 0;
+    this->full_ = false;
+  }
+
+  bool empty() const { return this->count_ == 0 && !this->full_; }
+  bool is_full() const { return this->full_; }
+  size_t size() const { return this->count_; }
+  const lv_area_t &operator[](size_t i) const { return this->rects_[i]; }
+
+  /**
+   * True if any damaged pixel lies inside the rectangle (x, y, w, h).
+   */
+  bool intersects(int x, int y, int w, int h) const;
+
+ private:
+  static int32_t area_of_(const lv_area_t &a) { return (int32_t) (a.x2 - a.x1 + 1) * (int32_t) (a.y2 - a.y1 + 1); }
+  static bool touches_(const lv_area_t &a, const lv_area_t &b) {
+    return a.x1 <= b.x2 + 1 && b.x1 <= a.x2 + 1 && a.y1 <= b.y2 + 1 && b.y1 <= a.y2 + 1;
+  }
+  static void join_(lv_area_t &dst, const lv_area_t &src);
+
+  void remove_(size_t i);
+  void check_coverage_();
+
+  lv_area_t rects_[MAX_RECTS]{};
+  size_t count_{0};
+  bool full_{false};
+  int w_{0};
+  int h_{0};
+};
+
+}  // namespace esphome::lvgl_game_runner
@@ -0,0 +1,117 @@
+// © Copyright 2025 Stuart Parmenter
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace esphome::lvgl_game_runner {
+
+/**
+ * Handle to an EntityPool entry. Stays valid while the entry lives, and reliably stops
+ * resolving once it's removed, even if the slot is reused.
+ */
+struct EntityHandle {
+  uint16_t slot{UINT16_MAX};
+  uint16_t generation{0};
+
+  bool valid() const { return this->slot != UINT16_MAX; }
+};
+
+/**
+ * Fixed-capacity object pool for game entities (projectiles, particles, pickups...).
+ *
+ * Live entries are kept dense in indices [0, size()), so iterating them is a plain array
+ * walk; removal swaps the last entry into the hole (order is not preserved). Entries that
+ * need to be referred to across frames can be tracked with an EntityHandle instead of an
+ * index. Storage is inline and nothing is ever allocated.
+ */
+template<typename T, size_t N> class EntityPool {
+  static_assert(N > 0 && N < UINT16_MAX, "EntityPool capacity must be 1..65534");
+
+ public:
+  EntityPool() {
+    for (size_t i = 0; i < N; i++) {
+      this->dense_slot_[i] = (uint16_t) i;
+      this->slot_dense_[i] = (uint16_t) i;
+    }
+  }
+
+  /**
+   * Add a copy of `item`. Returns an invalid handle (and adds nothing) if the pool is full.
+   */
+  EntityHandle add(const T &item) {
+    if (this->size_ >= N)
+      return {};
+    const size_t index = this->size_++;
+    this->items_[index] = item;
+    const uint16_t slot = this->dense_slot_[index];
+    return {slot, this->generation_[slot]};
+  }
+
+  /**
+   * Remove the entry at dense index `index`; the last entry moves into its place.
+   */
+  void remove_at(size_t index) {
+    if (index >= this->size_)
+      return;
+    const size_t last = --this->size_;
+    const uint16_t slot = this->dense_slot_[index];
+    this->generation_[slot]++;  // Outstanding handles to it stop resolving
+    if (index != last) {
+      const uint16_t moved = this->dense_slot_[last];
+      this->items_[index] = this->items_[last];
+      this->dense_slot_[index] = moved;
+      this->slot_dense_[moved] = (uint16_t) index;
+      // The freed slot parks past the live range, ready for the next add()
+      this->dense_slot_[last] = slot;
+      this->slot_dense_[slot] = (uint16_t) last;
+    }
+  }
+
+  bool remove(EntityHandle handle) {
+    const T *item = this->get(handle);
+    if (!item)
+      return false;
+    this->remove_at(this->slot_dense_[handle.slot]);
+    return true;
+  }
+
+  /**
+   * The entry `handle` refers to, or nullptr if it has been removed.
+   */
+  T *get(EntityHandle handle) {
+    if (handle.slot >= N || this->generation_[handle.slot] != handle.generation)
+      return nullptr;
+    const uint16_t index = this->slot_dense_[handle.slot];
+    return index < this->size_ ? &this->items_[index] : nullptr;
+  }
+
+  void clear() {
+    while (this->size_ > 0)
+      this->remove_at(this->size_ - 1);
+  }
+
+  size_t size() const { return this->size_; }
+  bool empty() const { return this->size_ == 0; }
+  bool full() const { return this->size_ >= N; }
+  static constexpr size_t capacity() { return N; }
+
+  T &operator[](size_t index) { return this->items_[index]; }
+  const T &operator[](size_t index) const { return this->items_[index]; }
+
+  T *begin() { return this->items_; }
+  T *end() { return this->items_ + this->size_; }
+  const T *begin() const { return this->items_; }
+  const T *end() const { return this->items_ + this->size_; }
+
+ private:
+  T items_[N]{};
+  uint16_t dense_slot_[N];      // Slot of the entry at each dense index
+  uint16_t slot_dense_[N];      // Dense index of each slot
+  uint16_t generation_[N]{};
+  size_t size_{0};
+};
+
+}  // namespace esphome::lvgl_game_runner
@@ -0,0 +1,65 @@
+// © Copyright 2025 Stuart Parmenter
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+
+namespace esphome::lvgl_game_runner {
+
+/**
+ * Bump allocator for scratch memory that only lives for one frame.
+ *
+ * The buffer is allocated once by reserve() (GameBase does this in on_bind()); alloc() just
+ * bumps an offset and GameBase::finish_frame() rewinds it, so per-frame temporaries never
+ * touch the heap. Objects are not destroyed on reset, so only use it for trivially
+ * destructible types. When the arena is exhausted alloc() returns nullptr.
+ */
+class FrameArena {
+ public:
+  /**
+   * (Re)allocate the buffer if it is smaller than `bytes`. Not for use mid-frame.
+   */
+  void reserve(size_t bytes) {
+    if (bytes <= this->capacity_)
+      return;
+    this->buffer_.reset(new (std::nothrow) uint8_t[bytes]);
+    this->capacity_ = this->buffer_ ? bytes : 0;
+    this->used_ = 0;
+  }
+
+  /**
+   * Uninitialized storage for `count` T's, or nullptr if it doesn't fit.
+   */
+  template<typename T> T *alloc(size_t count = 1) {
+    const size_t start = (this->used_ + alignof(T) - 1) & ~(alignof(T) - 1);
+    const size_t end = start + count * sizeof(T);
+    if (end > this->capacity_) {
+      this->failures_++;
+      return nullptr;
+    }
+    this->used_ = end;
+    if (end > this->high_water_)
+      this->high_water_ = end;
+    return reinterpret_cast<T *>(this->buffer_.get() + start);
+  }
+
+  void reset() { this->used_ = 0; }
+
+  size_t capacity() const { return this->capacity_; }
+  size_t used() const { return this->used_; }
+  size_t high_water() const { return this->high_water_; }  // Most ever used in one frame
+  uint32_t failures() const { return this->failures_; }
+
+ private:
+  std::unique_ptr<uint8_t[]> buffer_;
+  size_t capacity_{0};
+  size_t used_{0};
+  size_t high_water_{0};
+  uint32_t failures_{0};
+};
+
+}  // namespace esphome::lvgl_game_runner
@@ -0,0 +1,107 @@
+// © Copyright 2025 Stuart Parmenter
+// SPDX-License-Identifier: MIT
+
+#include "frame_profiler.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+namespace esphome::lvgl_game_runner {
+
+const uint32_t LatencyHistogram::EDGES_US[NUM_BUCKETS] = {
+    25,   50,   100,  150,  200,   300,   400,   500,   750,   1000,  1500,   2000,
+    3000, 4000, 5000, 7500, 10000, 15000, 20000, 30000, 50000, 75000, 100000, 200000,
+};
+
+void LatencyHistogram::record(uint32_t us) {
+  const uint32_t *edge = std::lower_bound(EDGES_US, EDGES_US + NUM_BUCKETS, us);
+  this->counts_[edge - EDGES_US]++;
+  this->count_++;
+  this->max_ = std::max(this->max_, us);
+}
+
+void LatencyHistogram::reset() {
+  memset(this->counts_, 0, sizeof(this->counts_));
+  this->count_ = 0;
+  this->max_ = 0;
+}
+
+uint32_t LatencyHistogram::percentile(uint8_t pct) const {
+  if (this->count_ == 0)
+    return 0;
+  const uint32_t target = (uint32_t) (((uint64_t) this->count_ * pct + 99) / 100);
+  uint32_t seen = 0;
+  for (size_t i = 0; i < NUM_BUCKETS; i++) {
+    seen += this->counts_[i];
+    if (seen >= target)
+      return std::min(EDGES_US[i], this->max_);
+  }
+  return this->max_;
+}
+
+ProfileScope FrameProfiler::scope(const char *name) {
+  for (size_t i = 0; i < this->num_sections_; i++) {
+    if (this->section_names_[i] == name || strcmp(this->section_names_[i], name) == 0)
+      return ProfileScope(&this->sections_[i]);
+  }
+  if (this->num_sections_ == MAX_SECTIONS)
+    return ProfileScope();
+  this->section_names_[this->num_sections_] = name;
+  return ProfileScope(&this->sections_[this->num_sections_++]);
+}
+
+void FrameProfiler::reset() {
+  for (auto &h : this->phases_)
+    h.reset();
+  for (auto &h : this->sections_)
+    h.reset();
+}
+
+const char *FrameProfiler::phase_name(Phase phase) {
+  switch (phase) {
+    case Phase::INPUT:
+      return "input";
+    case Phase::UPDATE:
+      return "update";
+    case Phase::RENDER:
+      return "render";
+    case Phase::COMPOSE:
+      return "compose";
+    case Phase::STREAM:
+      return "stream";
+    case Phase::INVALIDATE:
+      return "invalidate";
+    case Phase::LVGL:
+      return "lvgl";
+    case Phase::FRAME:
+      return "frame";
+    case Phase::LATENCY:
+      return "latency";
+    default:
+      return "?";
+  }
+}
+
+std::string FrameProfiler::summary() const {
+  std::string out;
+  char buf[48];
+  auto append = [&](const char *name, const LatencyHistogram &h) {
+    if (h.count() == 0)
+      return;
+    snprintf(buf, sizeof(buf), "%s%s %.2f/%.2f/%.2f", out.empty() ? "" : " ", name, h.percentile(50) / 1000.0f,
+             h.percentile(95) / 1000.0f, h.percentile(99) / 1000.0f);
+    out += buf;
+  };
+
+  // Whole frame first, then the phases in frame order
+  append(phase_name(Phase::FRAME), this->get(Phase::FRAME));
+  for (size_t i = 0; i < static_cast<size_t>(Phase::FRAME); i++)
+    append(phase_name(static_cast<Phase>(i)), this->phases_[i]);
+  append(phase_name(Phase::LATENCY), this->get(Phase::LATENCY));
+  for (size_t i = 0; i < this->num_sections_; i++)
+    append(this->section_names_[i], this->sections_[i]);
+  return out;
+}
+
+}  // namespace esphome::lvgl_game_runner
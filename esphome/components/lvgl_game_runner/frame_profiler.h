@@ -0,0 +1,116 @@
+// © Copyright 2025 Stuart Parmenter
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "esp_timer.h"
+
+#ifndef LVGL_GAME_RUNNER_METRICS
+#define LVGL_GAME_RUNNER_METRICS 1
+#endif
+
+namespace esphome::lvgl_game_runner {
+
+/**
+ * Latency histogram with fixed microsecond buckets (25us .. 200ms, plus overflow).
+ * Recording is a short search over a constant table; percentiles are reported as the
+ * upper edge of the bucket they fall in, capped by the largest sample seen.
+ */
+class LatencyHistogram {
+ public:
+  static constexpr size_t NUM_BUCKETS = 24;
+
+  void record(uint32_t us);
+  void reset();
+
+  /**
+   * Estimated `pct`th percentile (1-100) in microseconds; 0 if empty.
+   */
+  uint32_t percentile(uint8_t pct) const;
+
+  uint32_t count() const { return this->count_; }
+  uint32_t max() const { return this->max_; }
+
+ private:
+  static const uint32_t EDGES_US[NUM_BUCKETS];
+
+  uint32_t counts_[NUM_BUCKETS + 1]{};  // Last bucket: above the largest edge
+  uint32_t count_{0};
+  uint32_t max_{0};
+};
+
+/**
+ * Times a scope into a histogram. A scope without a histogram does nothing.
+ */
+class ProfileScope {
+ public:
+  ProfileScope() = default;
+  explicit ProfileScope(LatencyHistogram *hist) : hist_(hist), start_us_(hist ? esp_timer_get_time() : 0) {}
+  ~ProfileScope() {
+    if (this->hist_)
+      this->hist_->record(static_cast<uint32_t>(esp_timer_get_time() - this->start_us_));
+  }
+
+  ProfileScope(const ProfileScope &) = delete;
+  ProfileScope &operator=(const ProfileScope &) = delete;
+
+ private:
+  LatencyHistogram *hist_{nullptr};
+  int64_t start_us_{0};
+};
+
+/**
+ * Per-phase frame timing for the runner, plus a few named sections games can time
+ * themselves (GameBase::profile_scope()). Histograms cover one metrics window and are
+ * reset when the runner reports them.
+ */
+class FrameProfiler {
+ public:
+  enum class Phase : uint8_t {
+    INPUT,       // Draining the input queue into on_input()
+    UPDATE,      // Game simulation (all update() calls in the frame)
+    RENDER,      // Game render()
+    COMPOSE,     // Sprite composition
+    STREAM,      // Handing the frame to a FrameSink (frame_stream)
+    INVALIDATE,  // Pushing damage to LVGL (and the back-buffer copy)
+    LVGL,        // From invalidation until LVGL has drawn the canvas
+    FRAME,       // Whole frame, input through stream
+    LATENCY,     // Stamped input events: from the source seeing them until on_input()
+    NUM_PHASES,
+  };
+  static constexpr size_t NUM_PHASES = static_cast<size_t>(Phase::NUM_PHASES);
+  static constexpr size_t MAX_SECTIONS = 4;
+
+  ProfileScope scope(Phase phase) { return ProfileScope(&this->phases_[static_cast<size_t>(phase)]); }
+
+  /**
+   * Scope for a game-defined section, registered on first use. `name` must be a string
+   * literal. Once MAX_SECTIONS names are in use, further names are not timed.
+   */
+  ProfileScope scope(const char *name);
+
+  void record(Phase phase, uint32_t us) { this->phases_[static_cast<size_t>(phase)].record(us); }
+  const LatencyHistogram &get(Phase phase) const { return this->phases_[static_cast<size_t>(phase)]; }
+
+  void reset();
+
+  /**
+   * One line with p50/p95/p99 (ms) of every phase and section that has samples,
+   * e.g. "frame 2.00/3.00/5.00 update 1.00/1.50/2.00".
+   */
+  std::string summary() const;
+
+  static const char *phase_name(Phase phase);
+
+ private:
+  LatencyHistogram phases_[NUM_PHASES];
+  LatencyHistogram sections_[MAX_SECTIONS];
+  const char *section_names_[MAX_SECTIONS]{};
+  size_t num_sections_{0};
+};
+
+}  // namespace esphome::lvgl_game_runner
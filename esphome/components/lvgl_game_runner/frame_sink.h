@@ -0,0 +1,50 @@
+// © Copyright 2025 Stuart Parmenter
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include "damage_tracker.h"
+#include <lvgl.h>
+#include <cstddef>
+#include <cstdint>
+
+namespace esphome::lvgl_game_runner {
+
+/**
+ * Read-only view of a finished frame's pixels (see GameBase::get_frame_view()).
+ *
+ * Sizes and coordinates are in game pixels, before any pixel_scale upscale. Pixels are
+ * lv_color_t when `bpp` is 0, otherwise `bpp`-bit palette indices packed MSB first.
+ */
+struct FrameView {
+  const uint8_t *data{nullptr};          // First row
+  size_t stride{0};                      // Bytes per row
+  uint8_t bpp{0};                        // 1, 2 or 4 on an indexed canvas, else 0
+  int w{0};
+  int h{0};
+  const lv_color32_t *palette{nullptr};  // 1 << bpp entries on an indexed canvas
+  const DamageTracker *damage{nullptr};  // What the frame changed
+  uint32_t generation{0};                // Changes whenever the runner binds a game
+};
+
+/**
+ * Receives every frame a runner finishes, e.g. to stream it off the device (see the
+ * frame_stream component).
+ *
+ * on_frame() is called from the frame context, right after sprite composition, so it
+ * delays the next frame by however long it takes: sinks should work within a fixed budget
+ * and carry whatever they skip over to a later frame.
+ */
+class FrameSink {
+ public:
+  virtual ~FrameSink() = default;
+
+  /**
+   * A frame was finished. A different `generation` (or size) than last time means the
+   * whole picture is new: a game pointer can't tell, as a rebuilt game may reuse the same
+   * address.
+   */
+  virtual void on_frame(const FrameView &frame) = 0;
+};
+
+}  // namespace esphome::lvgl_game_runner
@@ -2,113 +2,565 @@
 // SPDX-License-Identifier: MIT
 
 #include "game_base.h"
+#include "pixel_ops.h"
 
-namespace esphome::lvgl_game_runner {
+#include "esphome/core/log.h"
 
-void GameBase::fill_rect(int x, int y, int w, int h, lv_color_t color) {
-  if (!canvas_)
-    return;
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
 
-  lv_draw_rect_dsc_t rect_dsc;
-  lv_draw_rect_dsc_init(&rect_dsc);
-  rect_dsc.bg_color = color;
-  rect_dsc.bg_opa = LV_OPA_COVER;
-  rect_dsc.border_width = 0;
+namespace esphome::lvgl_game_runner {
 
-  lv_canvas_draw_rect(canvas_, x, y, w, h, &rect_dsc);
-}
+static const char *const TAG = "game_base";
 
 void GameBase::draw_rect(int x, int y, int w, int h, lv_color_t color) {
-  if (!canvas_)
+  if (w <= 0 || h <= 0)
     return;
 
-  lv_draw_rect_dsc_t rect_dsc;
-  lv_draw_rect_dsc_init(&rect_dsc);
-  rect_dsc.bg_opa = LV_OPA_TRANSP;
-  rect_dsc.border_color = color;
-  rect_dsc.border_width = 1;
-  rect_dsc.border_opa = LV_OPA_COVER;
-
-  lv_canvas_draw_rect(canvas_, x, y, w, h, &rect_dsc);
+  // Four edges; the tracker merges them back into one damaged area
+  fill_rect_fast(x, y, w, 1, color);
+  if (h > 1)
+    fill_rect_fast(x, y + h - 1, w, 1, color);
+  if (h > 2) {
+    fill_rect_fast(x, y + 1, 1, h - 2, color);
+    if (w > 1)
+      fill_rect_fast(x + w - 1, y + 1, 1, h - 2, color);
+  }
 }
 
 void GameBase::draw_line(int x1, int y1, int x2, int y2, lv_color_t color) {
-  if (!canvas_)
+  // Axis-aligned lines are just thin rectangles
+  if (y1 == y2) {
+    const int x = std::min(x1, x2);
+    fill_rect_fast(x, y1, std::abs(x2 - x1) + 1, 1, color);
     return;
+  }
+  if (x1 == x2) {
+    const int y = std::min(y1, y2);
+    fill_rect_fast(x1, y, 1, std::abs(y2 - y1) + 1, color);
+    return;
+  }
 
-  lv_draw_line_dsc_t line_dsc;
-  lv_draw_line_dsc_init(&line_dsc);
-  line_dsc.color = color;
-  line_dsc.width = 1;
-  line_dsc.opa = LV_OPA_COVER;
+  Surface s;
+  if (!get_surface(s))
+    return;
+  lv_color_t *buf = s.pixels();
+  const uint8_t index = s.bpp ? color_index_(s, color, true) : 0;
 
-  lv_point_t points[2] = {{(lv_coord_t) x1, (lv_coord_t) y1}, {(lv_coord_t) x2, (lv_coord_t) y2}};
-  lv_canvas_draw_line(canvas_, points, 2, &line_dsc);
+  // Bresenham
+  const int dx = std::abs(x2 - x1);
+  const int dy = -std::abs(y2 - y1);
+  const int sx = x1 < x2 ? 1 : -1;
+  const int sy = y1 < y2 ? 1 : -1;
+  int err = dx + dy;
+  int x = x1;
+  int y = y1;
+  for (;;) {
+    if (x >= clip_.x && x < clip_.x + clip_.w && y >= clip_.y && y < clip_.y + clip_.h) {
+      if (s.bpp) {
+        pixel_ops::set_index(&s.data[y * s.stride], x, s.bpp, index);
+      } else {
+        buf[y * s.stride + x] = color;
+      }
+    }
+    if (x == x2 && y == y2)
+      break;
+    const int e2 = 2 * err;
+    if (e2 >= dy) {
+      err += dy;
+      x += sx;
+    }
+    if (e2 <= dx) {
+      err += dx;
+      y += sy;
+    }
+  }
+
+  invalidate_area_rect(std::min(x1, x2), std::min(y1, y2), dx + 1, -dy + 1);
 }
 
 void GameBase::draw_pixel(int x, int y, lv_color_t color) {
-  if (!canvas_)
+  // Bounds checking
+  if (x < clip_.x || x >= clip_.x + clip_.w || y < clip_.y || y >= clip_.y + clip_.h)
     return;
 
-  // Bounds checking
-  if (x < 0 || x >= area_.w || y < 0 || y >= area_.h)
+  Surface s;
+  if (!get_surface(s))
     return;
 
-  lv_canvas_set_px_color(canvas_, x, y, color);
+  if (s.bpp) {
+    pixel_ops::set_index(&s.data[y * s.stride], x, s.bpp, color_index_(s, color, true));
+  } else {
+    s.pixels()[y * s.stride + x] = color;
+  }
+  invalidate_area_rect(x, y, 1, 1);
+}
+
+void GameBase::cache_text(lv_color_t fg, lv_color_t bg, const char *charset,
+                          std::initializer_list<const char *> strings) {
+  text_cache_.build(canvas_, LV_FONT_DEFAULT, fg, bg, charset, strings.begin(), strings.size());
 }
 
 void GameBase::draw_text(int x, int y, const char *text, lv_color_t color, lv_text_align_t align) {
   if (!canvas_ || !text)
     return;
 
+  // Fast path: copy pre-rendered pieces
+  const int cached_w = text_cache_.matches(color) ? text_cache_.measure(text) : -1;
+  if (cached_w >= 0) {
+    int px = x;
+    if (align == LV_TEXT_ALIGN_CENTER) {
+      px = x - cached_w / 2;
+    } else if (align == LV_TEXT_ALIGN_RIGHT) {
+      px = x - cached_w;
+    }
+    const int h = text_cache_.height();
+    size_t pos = 0;
+    while (text[pos]) {
+      const TextCache::Piece *piece = text_cache_.next(text, pos);
+      blit_keyed_fast(px, y, piece->w, h, text_cache_.pixels(*piece), text_cache_.background());
+      px += piece->w;
+      pos += piece->text ? piece->len : 1;
+    }
+    return;
+  }
+
+  lv_img_dsc_t *img = lv_canvas_get_img(canvas_);
+  if (img && (pixel_ops::indexed_bpp(img->header.cf) || pixel_scale_ > 1)) {
+    if (!uncached_text_warned_) {
+      ESP_LOGW(TAG, "Text '%s' is not in the text cache; LVGL can't draw text into an indexed or scaled canvas", text);
+      uncached_text_warned_ = true;
+    }
+    return;
+  }
+
+  if (off_lvgl_thread_) {
+    if (!uncached_text_warned_) {
+      ESP_LOGW(TAG, "Text '%s' is not in the text cache; uncached text can't be drawn from the runner task", text);
+      uncached_text_warned_ = true;
+    }
+    return;
+  }
+
+  lv_point_t size;
+  lv_txt_get_size(&size, text, LV_FONT_DEFAULT, 0, 0, LV_COORD_MAX, LV_TEXT_FLAG_NONE);
+  int left = x;
+  if (align == LV_TEXT_ALIGN_CENTER) {
+    left = x - size.x / 2;
+  } else if (align == LV_TEXT_ALIGN_RIGHT) {
+    left = x - size.x;
+  }
+
   lv_draw_label_dsc_t label_dsc;
   lv_draw_label_dsc_init(&label_dsc);
   label_dsc.color = color;
   label_dsc.font = LV_FONT_DEFAULT;
-  label_dsc.align = align;
+  label_dsc.align = LV_TEXT_ALIGN_LEFT;
+
+  // In double-buffer mode point the canvas image at the back buffer while LVGL draws
+  const uint8_t *front = img->data;
+  if (back_buffer_)
+    img->data = reinterpret_cast<const uint8_t *>(back_buffer_);
+  lv_canvas_draw_text(canvas_, left, y, std::max<int>(size.x, area_.w - left), &label_dsc, text);
+  img->data = front;
 
-  lv_canvas_draw_text(canvas_, x, y, area_.w, &label_dsc, text);
+  // lv_canvas_draw_text() has already invalidated the whole canvas; keep the tracker in sync
+  invalidate_all();
 }
 
 void GameBase::fill_rect_fast(int x, int y, int w, int h, lv_color_t color) {
-  lv_color_t *buf = get_canvas_buffer();
-  if (!buf)
+  Surface s;
+  if (!get_surface(s))
     return;
 
-  // Coordinates are relative to game area
-  // Fill the rectangle directly in the buffer
-  for (int dy = 0; dy < h; dy++) {
-    const int py = y + dy;
-    if (py < 0 || py >= area_.h)
-      continue;
+  // Coordinates are relative to game area; clip once up front
+  const int x1 = std::max(x, clip_.x);
+  const int y1 = std::max(y, clip_.y);
+  const int x2 = std::min(x + w, clip_.x + clip_.w);
+  const int y2 = std::min(y + h, clip_.y + clip_.h);
+  if (x1 >= x2 || y1 >= y2)
+    return;
+
+  // Fill the rectangle directly in the buffer, a row (or the whole run) at a time
+  if (s.bpp) {
+    pixel_ops::fill_index_rect(&s.data[y1 * s.stride], s.stride, x1, x2 - x1, y2 - y1, s.bpp,
+                               color_index_(s, color, true));
+  } else {
+    pixel_ops::fill_rect(&s.pixels()[y1 * s.stride + x1], s.stride, x2 - x1, y2 - y1, color);
+  }
+
+  // Record the drawn area; flush_damage() invalidates it at the end of the frame
+  invalidate_area_rect(x1, y1, x2 - x1, y2 - y1);
+}
+
+void GameBase::blit_fast(int x, int y, int w, int h, const lv_color_t *pixels) {
+  Surface s;
+  if (!get_surface(s) || !pixels)
+    return;
 
-    // Calculate row offset using area width for stride
-    lv_color_t *row = &buf[py * area_.w];
+  const int x1 = std::max(x, clip_.x);
+  const int y1 = std::max(y, clip_.y);
+  const int x2 = std::min(x + w, clip_.x + clip_.w);
+  const int y2 = std::min(y + h, clip_.y + clip_.h);
+  if (x1 >= x2 || y1 >= y2)
+    return;
+
+  if (s.bpp) {
+    // Per pixel: each one is mapped to its palette entry
+    for (int py = y1; py < y2; py++) {
+      uint8_t *row = &s.data[py * s.stride];
+      const lv_color_t *src = &pixels[(py - y) * w];
+      for (int px = x1; px < x2; px++)
+        pixel_ops::set_index(row, px, s.bpp, color_index_(s, src[px - x], false));
+    }
+  } else {
+    pixel_ops::copy_rect(&s.pixels()[y1 * s.stride + x1], s.stride, &pixels[(y1 - y) * w + (x1 - x)], w, x2 - x1,
+                         y2 - y1);
+  }
+
+  invalidate_area_rect(x1, y1, x2 - x1, y2 - y1);
+}
+
+void GameBase::blit_keyed_fast(int x, int y, int w, int h, const lv_color_t *pixels, lv_color_t key) {
+  Surface s;
+  if (!get_surface(s) || !pixels)
+    return;
 
-    for (int dx = 0; dx < w; dx++) {
-      const int px = x + dx;
-      if (px >= 0 && px < area_.w) {
-        row[px] = color;
+  const int x1 = std::max(x, clip_.x);
+  const int y1 = std::max(y, clip_.y);
+  const int x2 = std::min(x + w, clip_.x + clip_.w);
+  const int y2 = std::min(y + h, clip_.y + clip_.h);
+  if (x1 >= x2 || y1 >= y2)
+    return;
+
+  for (int py = y1; py < y2; py++) {
+    const lv_color_t *src = &pixels[(py - y) * w];
+    if (s.bpp) {
+      uint8_t *row = &s.data[py * s.stride];
+      for (int px = x1; px < x2; px++) {
+        if (src[px - x].full != key.full)
+          pixel_ops::set_index(row, px, s.bpp, color_index_(s, src[px - x], false));
+      }
+    } else {
+      lv_color_t *row = &s.pixels()[py * s.stride];
+      for (int px = x1; px < x2; px++) {
+        if (src[px - x].full != key.full)
+          row[px] = src[px - x];
       }
     }
   }
 
-  // Automatically invalidate the drawn area
-  invalidate_area_rect(x, y, w, h);
+  invalidate_area_rect(x1, y1, x2 - x1, y2 - y1);
 }
 
-void GameBase::invalidate_area_rect(int x, int y, int w, int h) {
-  if (!canvas_)
+void GameBase::blit_mono_fast(int x, int y, int w, int h, const uint8_t *bits, lv_color_t color) {
+  Surface s;
+  if (!get_surface(s) || !bits)
+    return;
+
+  const int x1 = std::max(x, clip_.x);
+  const int y1 = std::max(y, clip_.y);
+  const int x2 = std::min(x + w, clip_.x + clip_.w);
+  const int y2 = std::min(y + h, clip_.y + clip_.h);
+  if (x1 >= x2 || y1 >= y2)
+    return;
+
+  const int src_stride = (w + 7) / 8;
+  if (s.bpp) {
+    const uint8_t index = color_index_(s, color, true);
+    for (int py = y1; py < y2; py++) {
+      pixel_ops::mono_index_span(&s.data[py * s.stride], x1, &bits[(py - y) * src_stride], x1 - x, x2 - x1, s.bpp,
+                                 index);
+    }
+  } else {
+    for (int py = y1; py < y2; py++) {
+      pixel_ops::mono_span(&s.pixels()[py * s.stride + x1], &bits[(py - y) * src_stride], x1 - x, x2 - x1, color);
+    }
+  }
+
+  invalidate_area_rect(x1, y1, x2 - x1, y2 - y1);
+}
+
+void GameBase::set_clip_rect(int x, int y, int w, int h) {
+  const int x1 = std::max(x, 0);
+  const int y1 = std::max(y, 0);
+  const int x2 = std::min(x + w, area_.w);
+  const int y2 = std::min(y + h, area_.h);
+  clip_ = Rect{x1, y1, std::max(x2 - x1, 0), std::max(y2 - y1, 0)};
+}
+
+void GameBase::redraw_background(int x, int y, int w, int h) {
+  const lv_color_t bg = sprite_layer_ ? sprite_layer_->get_background() : lv_color_black();
+  fill_rect_fast(x, y, w, h, bg);
+}
+
+void GameBase::redraw_region(int x, int y, int w, int h) {
+  if (w <= 0 || h <= 0)
+    return;
+  set_clip_rect(x, y, w, h);
+  redraw_background(x, y, w, h);
+  reset_clip_rect();
+}
+
+void GameBase::draw_sprite_(const Sprite &s) {
+  switch (s.kind) {
+    case Sprite::Kind::SOLID:
+      fill_rect_fast(s.x, s.y, s.w, s.h, s.color);
+      break;
+    case Sprite::Kind::OUTLINE:
+      draw_rect(s.x, s.y, s.w, s.h, s.color);
+      break;
+    case Sprite::Kind::MONO:
+      blit_mono_fast(s.x, s.y, s.w, s.h, static_cast<const uint8_t *>(s.image), s.color);
+      break;
+    case Sprite::Kind::RGB565:
+      blit_fast(s.x, s.y, s.w, s.h, static_cast<const lv_color_t *>(s.image));
+      break;
+  }
+}
+
+void GameBase::compose_sprites_() {
+  SpriteLayerBase *layer = sprite_layer_;
+  Surface surface;
+  if (!layer || layer->count_ == 0 || !get_surface(surface))
     return;
 
-  // Convert relative coordinates to absolute canvas coordinates
-  lv_area_t area;
-  area.x1 = area_.x + x;
-  area.y1 = area_.y + y;
-  area.x2 = area_.x + x + w;
-  area.y2 = area_.y + y + h;
+  // 1. Erase changed sprites where they were drawn last frame. An opaque sprite covers its
+  //    new rectangle anyway, so only the part of the old one it has moved off is repainted.
+  for (size_t i = 0; i < layer->count_; i++) {
+    const Sprite &d = layer->drawn_[i];
+    if (!d.visible || !layer->changed_(i))
+      continue;
+
+    const Sprite &s = layer->sprites_[i];
+    if (!s.visible || !s.is_opaque()) {
+      redraw_region(d.x, d.y, d.w, d.h);
+      continue;
+    }
+
+    // Old rectangle minus new: up to four bands around the overlap
+    const int ox2 = d.x + d.w;
+    const int oy2 = d.y + d.h;
+    const int ix1 = std::max(d.x, s.x);
+    const int iy1 = std::max(d.y, s.y);
+    const int ix2 = std::min(ox2, s.x + s.w);
+    const int iy2 = std::min(oy2, s.y + s.h);
+    if (ix1 >= ix2 || iy1 >= iy2) {
+      redraw_region(d.x, d.y, d.w, d.h);
+      continue;
+    }
+    redraw_region(d.x, d.y, d.w, iy1 - d.y);        // Above
+    redraw_region(d.x, iy2, d.w, oy2 - iy2);        // Below
+    redraw_region(d.x, iy1, ix1 - d.x, iy2 - iy1);  // Left
+    redraw_region(ix2, iy1, ox2 - ix2, iy2 - iy1);  // Right
+  }
+
+  // 2. Redraw bottom to top: sprites that changed, plus any sprite something else has
+  //    drawn over this frame (background repaints, erases, or a lower sprite).
+  //    On the stack rather than the frame arena: game scratch may have used the arena up,
+  //    and by now the erases above have to be drawn over.
+  uint8_t order[255];  // SpriteLayer capacity is at most 255
+  layer->sort_by_z_(order);
+  for (size_t k = 0; k < layer->count_; k++) {
+    const size_t i = order[k];
+    Sprite &s = layer->sprites_[i];
+    if (s.visible && (layer->changed_(i) || damage_.intersects(s.x, s.y, s.w, s.h)))
+      draw_sprite_(s);
+    s.dirty = false;
+    layer->drawn_[i] = s;
+  }
+}
+
+void GameBase::finish_frame() {
+  compose_sprites_();
+  unflushed_.merge(damage_);
+  palette_unflushed_ |= palette_changed_;
+  palette_changed_ = false;
+  last_damage_ = damage_;
+  damage_.clear();
+  frame_arena_.reset();
+}
+
+bool GameBase::archive_state_(StateArchive &ar) {
+  ar(rng_);
+  ar(paused_);
+  ar(input_);
+  return this->serialize_state(ar) && ar.ok();
+}
+
+size_t GameBase::state_size() {
+  auto ar = StateArchive::measure();
+  return this->archive_state_(ar) ? ar.size() : 0;
+}
 
-  lv_obj_invalidate_area(canvas_, &area);
+bool GameBase::save_state(uint8_t *buf, size_t cap) {
+  auto ar = StateArchive::save(buf, cap);
+  return this->archive_state_(ar);
+}
+
+bool GameBase::load_state(const uint8_t *buf, size_t len) {
+  auto ar = StateArchive::load(buf, len);
+  return this->archive_state_(ar);
+}
+
+uint32_t GameBase::get_frame_hash() {
+  Surface s;
+  if (!get_surface(s))
+    return 0;
+  const size_t row_bytes = s.bpp ? ((size_t) area_.w * s.bpp + 7) / 8 : (size_t) area_.w * sizeof(lv_color_t);
+  const size_t row_stride = s.bpp ? s.stride : s.stride * sizeof(lv_color_t);
+  uint32_t hash = 2166136261u;
+  for (int y = 0; y < area_.h; y++) {
+    const uint8_t *row = &s.data[y * row_stride];
+    for (size_t i = 0; i < row_bytes; i++)
+      hash = (hash ^ row[i]) * 16777619u;
+  }
+  return hash;
+}
+
+bool GameBase::get_frame_view(FrameView &view) const {
+  Surface s;
+  if (!get_surface(s))
+    return false;
+  view.data = s.data;
+  view.stride = s.bpp ? s.stride : s.stride * sizeof(lv_color_t);
+  view.bpp = s.bpp;
+  view.w = area_.w;
+  view.h = area_.h;
+  view.palette = s.bpp ? reinterpret_cast<const lv_color32_t *>(s.data - pixel_ops::palette_bytes(s.bpp)) : nullptr;
+  view.damage = &last_damage_;
+  return true;
+}
+
+bool GameBase::get_surface(Surface &s) const {
+  if (!canvas_)
+    return false;
+  const lv_img_dsc_t *img = lv_canvas_get_img(canvas_);
+  if (!img || !img->data)
+    return false;
+  if (back_buffer_) {
+    s = surface_of_(img, back_buffer_, pixel_scale_);
+  } else {
+    s = surface_of_(img, const_cast<uint8_t *>(img->data), 1);
+  }
+  return true;
+}
+
+GameBase::Surface GameBase::surface_of_(const lv_img_dsc_t *img, uint8_t *data, int scale) {
+  Surface s;
+  const int w = img->header.w / scale;
+  s.bpp = pixel_ops::indexed_bpp(img->header.cf);
+  if (s.bpp) {
+    s.data = data + pixel_ops::palette_bytes(s.bpp);
+    s.stride = (w * s.bpp + 7) / 8;
+  } else {
+    s.data = data;
+    s.stride = w;
+  }
+  return s;
+}
+
+uint8_t GameBase::color_index_(const Surface &s, lv_color_t color, bool claim) {
+  const uint32_t c32 = lv_color_to32(color);
+  if (palette_hit_ >= 0 && lv_color_to32(palette_[palette_hit_]) == c32)
+    return palette_hit_;
+
+  int best = -1;
+  uint32_t best_dist = UINT32_MAX;
+  for (int i = 0; i < palette_size_; i++) {
+    const uint32_t p32 = lv_color_to32(palette_[i]);
+    if (p32 == c32) {
+      palette_hit_ = i;
+      return i;
+    }
+    const int dr = (int) ((p32 >> 16) & 0xFF) - (int) ((c32 >> 16) & 0xFF);
+    const int dg = (int) ((p32 >> 8) & 0xFF) - (int) ((c32 >> 8) & 0xFF);
+    const int db = (int) (p32 & 0xFF) - (int) (c32 & 0xFF);
+    const uint32_t dist = dr * dr + dg * dg + db * db;
+    if (dist < best_dist) {
+      best = i;
+      best_dist = dist;
+    }
+  }
+
+  // New entry; bitmaps only take one while the palette is still empty
+  if ((claim || best < 0) && palette_size_ < (1u << s.bpp)) {
+    const uint8_t i = palette_size_++;
+    palette_[i] = color;
+    lv_color32_t entry;
+    entry.full = c32;
+    memcpy(s.data - pixel_ops::palette_bytes(s.bpp) + i * sizeof(lv_color32_t), &entry, sizeof(entry));
+    palette_changed_ = true;
+    palette_hit_ = i;
+    return i;
+  }
+  return best < 0 ? 0 : best;
+}
+
+bool GameBase::flush_damage() {
+  if (!canvas_ || unflushed_.empty()) {
+    unflushed_.clear();
+    return false;
+  }
+
+  lv_img_dsc_t *img = lv_canvas_get_img(canvas_);
+  if (back_buffer_ && img && img->data) {
+    // Hand the finished frames over to the canvas. This runs between LVGL refreshes, so the
+    // canvas is never read while being copied into.
+    uint8_t *front_data = const_cast<uint8_t *>(img->data);
+    const Surface front = surface_of_(img, front_data, 1);
+    const Surface back = surface_of_(img, back_buffer_, pixel_scale_);
+    const int n = pixel_scale_;
+    if (palette_unflushed_)
+      memcpy(front_data, back_buffer_, front.data - front_data);
+    const bool full = unflushed_.is_full();
+    for (size_t i = 0; i < (full ? 1 : unflushed_.size()); i++) {
+      const lv_area_t a = full ? lv_area_t{0, 0, (lv_coord_t) (area_.w - 1), (lv_coord_t) (area_.h - 1)} : unflushed_[i];
+      const int w = a.x2 - a.x1 + 1;
+      const int h = a.y2 - a.y1 + 1;
+      uint8_t *dst_row = &front.data[a.y1 * n * front.stride * (front.bpp ? 1 : sizeof(lv_color_t))];
+      const uint8_t *src_row = &back.data[a.y1 * back.stride * (back.bpp ? 1 : sizeof(lv_color_t))];
+      if (front.bpp && n > 1) {
+        pixel_ops::upscale_index_rect(dst_row, front.stride, a.x1 * n, src_row, back.stride, a.x1, w, h, front.bpp, n);
+      } else if (front.bpp) {
+        pixel_ops::copy_index_rect(dst_row, src_row, front.stride, a.x1, w, h, front.bpp);
+      } else if (n > 1) {
+        pixel_ops::upscale_rect(reinterpret_cast<lv_color_t *>(dst_row) + a.x1 * n, front.stride,
+                                reinterpret_cast<const lv_color_t *>(src_row) + a.x1, back.stride, w, h, n);
+      } else {
+        pixel_ops::copy_rect(reinterpret_cast<lv_color_t *>(dst_row) + a.x1, front.stride,
+                             reinterpret_cast<const lv_color_t *>(src_row) + a.x1, back.stride, w, h);
+      }
+    }
+  }
+  // The image decoder may hold a copy of an indexed canvas' palette
+  if (palette_unflushed_ && img)
+    lv_img_cache_invalidate_src(img);
+  palette_unflushed_ = false;
+
+  // Convert relative coordinates (game pixels) to absolute canvas coordinates
+  const int n = pixel_scale_;
+  if (unflushed_.is_full()) {
+    lv_area_t area;
+    area.x1 = area_.x;
+    area.y1 = area_.y;
+    area.x2 = area_.x + area_.w * n - 1;
+    area.y2 = area_.y + area_.h * n - 1;
+    lv_obj_invalidate_area(canvas_, &area);
+  } else {
+    for (size_t i = 0; i < unflushed_.size(); i++) {
+      const lv_area_t &a = unflushed_[i];
+      lv_area_t area;
+      area.x1 = area_.x + a.x1 * n;
+      area.y1 = area_.y + a.y1 * n;
+      area.x2 = area_.x + (a.x2 + 1) * n - 1;
+      area.y2 = area_.y + (a.y2 + 1) * n - 1;
+      lv_obj_invalidate_area(canvas_, &area);
+    }
+  }
+  unflushed_.clear();
+  return true;
 }
 
 }  // namespace esphome::lvgl_game_runner
@@ -5,7 +5,18 @@
 
 #include <lvgl.h>
 #include "esphome/core/component.h"
+#include "damage_tracker.h"
+#include "frame_arena.h"
+#include "frame_profiler.h"
+#include "frame_sink.h"
+#include "game_rng.h"
+#include "game_scalar.h"
+#include "input_snapshot.h"
 #include "input_types.h"
+#include "sprite_layer.h"
+#include "state_archive.h"
+#include "text_cache.h"
+#include <initializer_list>
 
 namespace esphome::lvgl_game_runner {
 
@@ -30,25 +41,58 @@ class GameBase {
   /**
    * Called once when the canvas buffer is ready.
    * Use this for one-time initialization (palettes, lookup tables, etc.).
+   * Games needing more per-frame scratch than FRAME_ARENA_BYTES reserve it here.
    */
-  virtual void on_bind(lv_obj_t *canvas) { canvas_ = canvas; }
+  virtual void on_bind(lv_obj_t *canvas) {
+    canvas_ = canvas;
+    frame_arena_.reserve(FRAME_ARENA_BYTES);
+    palette_size_ = 0;
+    palette_hit_ = -1;
+    input_.clear();
+  }
 
   /**
    * Called when canvas size changes or when sub-region is set.
    * Games should reallocate buffers and recompute parameters as needed.
+   * With a pixel scale, r.w and r.h are in game pixels (the canvas size divided by it).
    */
-  virtual void on_resize(const Rect &r) { area_ = r; }
+  virtual void on_resize(const Rect &r) {
+    area_ = r;
+    clip_ = Rect{0, 0, r.w, r.h};
+    damage_.set_bounds(r.w, r.h);
+    last_damage_.set_bounds(r.w, r.h);
+    unflushed_.set_bounds(r.w, r.h);
+    if (sprite_layer_)
+      sprite_layer_->invalidate();
+  }
 
   /**
    * Called each frame with the elapsed time since last step.
    * dt = measured elapsed time in seconds (capped at 0.1s for stability).
    * This is where game logic and rendering happens.
+   *
+   * Games that split simulation and drawing override update() and render() instead.
+   */
+  virtual void step(Scalar /*dt*/) {}
+
+  /**
+   * Advance the simulation by `dt` seconds.
+   * With a fixed simulation rate configured, dt is always the simulation period and this
+   * may run several times (or not at all) per displayed frame; otherwise it runs once per
+   * frame with the measured dt. Default: step(dt), for games that do everything in step().
+   */
+  virtual void update(Scalar dt) { step(dt); }
+
+  /**
+   * Draw the current state. Called once per displayed frame after update().
+   * `alpha` (0..1) is how far the clock has moved from the last simulation step towards
+   * the next, for interpolating moving objects; it is 1 without a fixed simulation rate.
    */
-  virtual void step(float dt) = 0;
+  virtual void render(Scalar alpha) { (void) alpha; }
 
   /**
-   * Called when input events are received.
-   * Games should update their state based on input.
+   * Called when input events are received, after the event was folded into input_.
+   * Games that only need button state can ignore this and poll input_ in update().
    */
   virtual void on_input(const InputEvent &event) {}
 
@@ -58,6 +102,32 @@ class GameBase {
    */
   virtual void reset() {}
 
+  /**
+   * Seed the game's random number generator. The runner calls this before reset(); the
+   * same seed, input and simulation rate reproduce the same game.
+   */
+  virtual void seed(uint32_t seed) { rng_.seed(seed); }
+
+  /**
+   * List the simulation state for snapshots (netplay rollback): call `ar(field)` on every
+   * field update() reads or writes, in the same order each time. State only render() uses
+   * can stay out if render() copes with the game jumping. GameBase already covers its RNG,
+   * pause flag and input_. Return false (the default) if the game can't be snapshotted.
+   */
+  virtual bool serialize_state(StateArchive &/*ar*/) { return false; }
+
+  /**
+   * Bytes a snapshot takes, or 0 if the game doesn't support snapshots.
+   */
+  size_t state_size();
+
+  /**
+   * Copy the simulation state into a buffer of state_size() bytes, or back out of one.
+   * Returns false if the game doesn't support snapshots or the buffer is too small.
+   */
+  bool save_state(uint8_t *buf, size_t cap);
+  bool load_state(const uint8_t *buf, size_t len);
+
   /**
    * Pause the game (stop updating state but preserve it).
    */
@@ -73,6 +143,16 @@ class GameBase {
    */
   bool is_paused() const { return paused_; }
 
+  /**
+   * How long the game can go without frames, asked by the runner after each one.
+   * 0 = keep the full frame rate; IDLE_UNTIL_INPUT = the screen is static until input
+   * arrives (pause and game-over screens); anything else = microseconds until the game next
+   * changes on its own (Snake's next move). Input always wakes the runner early, and the
+   * update() after a timed idle gets the whole time that passed as dt.
+   */
+  static constexpr uint32_t IDLE_UNTIL_INPUT = UINT32_MAX;
+  virtual uint32_t idle_hint_us() const { return paused_ ? IDLE_UNTIL_INPUT : 0; }
+
   /**
    * Get maximum number of players this game supports (1-4).
    * Override this in game implementations.
@@ -113,54 +193,226 @@ class GameBase {
     (void) event;
   }
 
+  /**
+   * Deliver an input event: fold it into input_, then call on_input(). Called by the runner.
+   */
+  void dispatch_input(const InputEvent &event) {
+    input_.apply(event);
+    on_input(event);
+  }
+
+  /**
+   * Clear input_'s edges and encoder steps. Called by the runner after each update().
+   */
+  void end_input_step() { input_.end_step(); }
+
+  const InputSnapshot &get_input() const { return input_; }
+
+  /**
+   * Forget all buttons in input_. Called by the runner when it binds the game or restarts it
+   * from a seed.
+   */
+  void clear_input() { input_.clear(); }
+
+  /**
+   * Finish the frame: compose sprites over whatever the game drew, then flush damage.
+   * Called by the runner after step().
+   */
+  void end_frame() {
+    finish_frame();
+    flush_damage();
+  }
+
+  /**
+   * Compose sprites and start a new frame, keeping the frame's damage for flush_damage().
+   * Touches only the canvas buffer, so it is safe outside the LVGL thread.
+   */
+  void finish_frame();
+
+  /**
+   * Push the damaged areas of all finished frames to LVGL. Must run on the LVGL thread.
+   * Games just draw and let this batch the invalidation. Returns true if anything was
+   * invalidated.
+   */
+  bool flush_damage();
+
+  /**
+   * Set by the runner when frames are produced outside the LVGL thread (runner task).
+   * draw_text() then only draws cached text, since the LVGL label renderer isn't thread-safe.
+   */
+  void set_off_lvgl_thread(bool off) { off_lvgl_thread_ = off; }
+
+  /**
+   * Set by the runner in double-buffer mode: a buffer shaped like the canvas image data that
+   * the game draws into instead. flush_damage() copies the damaged areas to the canvas.
+   * With `scale` > 1 it is a low-resolution framebuffer of (canvas size / scale) pixels,
+   * and flush_damage() upscales instead of copying (see the runner's pixel_scale).
+   */
+  void set_back_buffer(uint8_t *buf, uint8_t scale = 1) {
+    back_buffer_ = buf;
+    pixel_scale_ = buf ? scale : 1;
+  }
+
+  /**
+   * Set by the runner when metrics are enabled; see profile_scope().
+   */
+  void set_profiler(FrameProfiler *profiler) { profiler_ = profiler; }
+
+  /**
+   * FNV-1a hash of the game area's pixels, for comparing what two runs drew.
+   */
+  uint32_t get_frame_hash();
+
+  /**
+   * The pixels (the back buffer in double-buffer mode) and damage of the frame finish_frame()
+   * just completed. False if there is no canvas yet.
+   */
+  bool get_frame_view(FrameView &view) const;
+
  protected:
   lv_obj_t *canvas_{nullptr};     // LVGL canvas object
   Rect area_{};                   // Rendering area
   bool paused_{false};            // Pause state
   uint8_t num_human_players_{1};  // Number of human players (rest are AI)
+  DamageTracker damage_;          // Areas drawn this frame (flushed by the runner)
+  DamageTracker last_damage_;     // What the last finished frame changed (see get_frame_view)
+  DamageTracker unflushed_;       // Finished frames not yet pushed to LVGL
+  bool off_lvgl_thread_{false};   // See set_off_lvgl_thread()
+  uint8_t *back_buffer_{nullptr};     // See set_back_buffer()
+  uint8_t pixel_scale_{1};            // Canvas pixels per game pixel, each way
+  FrameProfiler *profiler_{nullptr};  // See set_profiler()
+  GameRng rng_;                       // All game randomness (see seed())
+  Rect clip_{};                   // Primitives only touch pixels inside this (game area coordinates)
+  InputSnapshot input_;           // Every player's buttons as of this update (AI writes its own)
+
+  // draw_text() has logged text it couldn't draw (once per game)
+  bool uncached_text_warned_{false};
+
+  // Optional retained sprites (owned by the game)
+  SpriteLayerBase *sprite_layer_{nullptr};
+
+  // Pre-rendered HUD text (see cache_text)
+  TextCache text_cache_;
+
+  // Scratch memory for the current frame, rewound by finish_frame()
+  static constexpr size_t FRAME_ARENA_BYTES = 1024;
+  FrameArena frame_arena_;
+
+  // Colors assigned to an indexed canvas' palette entries, in order of first use
+  static constexpr size_t MAX_PALETTE = 16;
+  lv_color_t palette_[MAX_PALETTE]{};
+  uint8_t palette_size_{0};
+  int8_t palette_hit_{-1};      // Entry of the last exact lookup, see color_index_()
+  bool palette_changed_{false};    // Entries added this frame
+  bool palette_unflushed_{false};  // ...in finished frames not yet pushed to LVGL
+
+  /**
+   * The pixels the drawing primitives write to (the back buffer in double-buffer mode).
+   * On a true-color canvas `data` holds lv_color_t pixels and `stride` counts pixels; on an
+   * indexed canvas (see the runner's canvas_format) rows are `bpp`-bit palette indices,
+   * packed MSB first, and `stride` counts bytes.
+   */
+  struct Surface {
+    uint8_t *data{nullptr};  // First row, after an indexed canvas' palette
+    int stride{0};
+    uint8_t bpp{0};  // 1, 2 or 4 on an indexed canvas, else 0
+    lv_color_t *pixels() const { return reinterpret_cast<lv_color_t *>(data); }
+  };
+  bool get_surface(Surface &s) const;
+
+  /**
+   * Time the rest of the enclosing block as a named profiler section (a string literal),
+   * reported with the runner's frame phases:
+   *   auto timer = profile_scope("collide");
+   * Does nothing when metrics are disabled. Up to FrameProfiler::MAX_SECTIONS names.
+   */
+  ProfileScope profile_scope(const char *name) { return profiler_ ? profiler_->scope(name) : ProfileScope(); }
+
+  /**
+   * Attach a sprite layer. The runner composes it after every step(): sprites that
+   * changed are erased (via redraw_background()) and redrawn, and unchanged sprites are
+   * redrawn only if the game drew over them this frame.
+   */
+  void set_sprite_layer(SpriteLayerBase *layer) { sprite_layer_ = layer; }
+
+  /**
+   * Repaint the background (everything except sprites) inside (x, y, w, h).
+   * Called with the clip rectangle already set to that area, so games can simply redraw
+   * their static scene; the default fills with the sprite layer's background color.
+   * Implementations may widen the clip with set_clip_rect() (e.g. to redraw whole text).
+   */
+  virtual void redraw_background(int x, int y, int w, int h);
+
+  /**
+   * Clip the drawing primitives to (x, y, w, h) within the game area.
+   * draw_text() is not clipped.
+   */
+  void set_clip_rect(int x, int y, int w, int h);
+  void reset_clip_rect() { clip_ = Rect{0, 0, area_.w, area_.h}; }
+
+  /**
+   * Repaint the background inside (x, y, w, h) via redraw_background(), clipped to that area.
+   * Sprites on top of it are redrawn automatically at the end of the frame.
+   */
+  void redraw_region(int x, int y, int w, int h);
 
   /**
-   * Helper to get canvas buffer for direct pixel manipulation.
-   * Returns nullptr if canvas is not ready.
+   * Helper to get canvas buffer for direct pixel manipulation (the back buffer in
+   * double-buffer mode). Returns nullptr if canvas is not ready or is indexed (use
+   * get_surface() there).
    */
   lv_color_t *get_canvas_buffer() {
-    if (!canvas_)
-      return nullptr;
-    const lv_img_dsc_t *img = static_cast<const lv_img_dsc_t *>(lv_canvas_get_img(canvas_));
-    if (!img || !img->data)
+    int stride;
+    return get_canvas_buffer(stride);
+  }
+
+  /**
+   * Same as above, also returning the buffer's row stride in pixels (the canvas image
+   * width, which can differ from the game area width).
+   */
+  lv_color_t *get_canvas_buffer(int &stride) {
+    Surface s;
+    if (!get_surface(s) || s.bpp)
       return nullptr;
-    return static_cast<lv_color_t *>(const_cast<void *>(static_cast<const void *>(img->data)));
+    stride = s.stride;
+    return s.pixels();
   }
 
   /**
-   * Helper to get canvas dimensions.
+   * Helper to get canvas dimensions, in game pixels.
    */
   void get_canvas_size(int &width, int &height) {
     if (!canvas_) {
       width = height = 0;
       return;
     }
-    width = lv_obj_get_width(canvas_);
-    height = lv_obj_get_height(canvas_);
+    width = lv_obj_get_width(canvas_) / pixel_scale_;
+    height = lv_obj_get_height(canvas_) / pixel_scale_;
   }
 
   /**
-   * LVGL drawing primitives - common wrappers for canvas operations.
-   * These handle descriptor initialization and provide a consistent API.
+   * Drawing primitives.
+   * Coordinates are relative to the game area. Shapes are written straight into the
+   * canvas buffer and recorded in the damage tracker; nothing is invalidated until the
+   * runner calls flush_damage() at the end of the frame.
+   *
+   * On an indexed canvas each color takes the next free palette entry the first time it is
+   * drawn. Once the palette is full, and for bitmap pixels (blit_fast(), cached text), the
+   * nearest palette color is used instead.
    */
 
   /**
    * Draw a filled rectangle on the canvas.
    */
-  void fill_rect(int x, int y, int w, int h, lv_color_t color);
+  void fill_rect(int x, int y, int w, int h, lv_color_t color) { fill_rect_fast(x, y, w, h, color); }
 
   /**
-   * Draw a rectangle outline on the canvas.
+   * Draw a 1px rectangle outline on the canvas.
    */
   void draw_rect(int x, int y, int w, int h, lv_color_t color);
 
   /**
-   * Draw a line on the canvas.
+   * Draw a 1px line on the canvas.
    */
   void draw_line(int x1, int y1, int x2, int y2, lv_color_t color);
 
@@ -172,23 +424,75 @@ class GameBase {
 
   /**
    * Draw text on the canvas with alignment.
+   * `x` is the left edge (LEFT), the horizontal center (CENTER) or the right edge (RIGHT)
+   * of the text; `y` is the top of the line.
+   * Text that can be assembled from the text cache in `color` is copied in, skipping pixels
+   * in the cache's background color so it lands on what is already there, as LVGL's own text
+   * does (clipped, only its own area damaged). Anything else goes
+   * through the LVGL label renderer, which ignores the clip and invalidates the whole canvas
+   * (and is skipped when the game runs in the runner task).
    */
   void draw_text(int x, int y, const char *text, lv_color_t color, lv_text_align_t align = LV_TEXT_ALIGN_LEFT);
 
+  /**
+   * Pre-render text for draw_text() with the default font. Call from on_bind().
+   * Caches every character in `charset` plus each string in `strings` (string literals; they
+   * are matched first and keep LVGL's exact layout). Glyphs are anti-aliased against `bg`,
+   * which should be the color the text is drawn over.
+   */
+  void cache_text(lv_color_t fg, lv_color_t bg, const char *charset, std::initializer_list<const char *> strings = {});
+
   /**
    * Fast rectangle fill using direct buffer manipulation.
    * Coordinates are relative to the game area (0,0 = top-left of game area).
-   * Much faster than fill_rect() for simple solid fills.
-   * Automatically invalidates the drawn area for LVGL redraw.
+   * Records the drawn area in the damage tracker.
    */
   void fill_rect_fast(int x, int y, int w, int h, lv_color_t color);
 
   /**
-   * Invalidate a rectangular area for LVGL redraw.
-   * Coordinates are relative to the game area - this function converts them
-   * to absolute canvas coordinates automatically.
+   * Fill the whole game area and mark it fully damaged.
+   * Sprites are wiped too and get redrawn at the end of the frame.
+   */
+  void clear_fast(lv_color_t color) {
+    fill_rect_fast(0, 0, area_.w, area_.h, color);
+    if (sprite_layer_)
+      sprite_layer_->invalidate();
+  }
+
+  /**
+   * Copy an opaque w*h RGB565 bitmap to (x, y). Clipped; records damage.
    */
-  void invalidate_area_rect(int x, int y, int w, int h);
+  void blit_fast(int x, int y, int w, int h, const lv_color_t *pixels);
+
+  /**
+   * Like blit_fast(), but pixels equal to `key` are left untouched.
+   */
+  void blit_keyed_fast(int x, int y, int w, int h, const lv_color_t *pixels, lv_color_t key);
+
+  /**
+   * Draw the set bits of a 1-bit bitmap (rows of (w + 7) / 8 bytes, MSB first) at (x, y)
+   * in `color`. Clear bits are left untouched. Clipped; records damage.
+   */
+  void blit_mono_fast(int x, int y, int w, int h, const uint8_t *bits, lv_color_t color);
+
+  /**
+   * Mark a rectangular area as needing an LVGL redraw.
+   * Coordinates are relative to the game area; the area is merged into this frame's
+   * damage list and invalidated once by flush_damage().
+   */
+  void invalidate_area_rect(int x, int y, int w, int h) { damage_.add(x, y, w, h); }
+
+  /**
+   * Mark the whole game area as needing an LVGL redraw.
+   */
+  void invalidate_all() { damage_.add_full(); }
+
+ private:
+  void compose_sprites_();
+  void draw_sprite_(const Sprite &s);
+  static Surface surface_of_(const lv_img_dsc_t *img, uint8_t *data, int scale);
+  uint8_t color_index_(const Surface &s, lv_color_t color, bool claim);
+  bool archive_state_(StateArchive &ar);  // GameBase's own state, then serialize_state()
 };
 
 }  // namespace esphome::lvgl_game_runner
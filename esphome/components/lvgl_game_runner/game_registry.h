@@ -3,99 +3,146 @@
 
 #pragma once
 
+#include "esphome/core/log.h"
 #include "game_base.h"
-#include <functional>
-#include <map>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
 #include <memory>
-#include <string>
+#include <new>
+
+// Most game components one firmware can register
+#ifndef LVGL_GAME_RUNNER_MAX_GAMES
+#define LVGL_GAME_RUNNER_MAX_GAMES 8
+#endif
 
 namespace esphome::lvgl_game_runner {
 
 /**
- * Game registry using Factory Method pattern.
- * Similar to FxRegistry in lvgl-canvas-fx.
+ * A configured game that is only constructed while a runner uses it.
  *
- * Games are registered at startup with string keys (e.g., "snake", "breakout").
- * Runtime game switching is done via make("game_name").
- *
- * Supports two registration methods:
- * 1. register_factory() - Factory functions that create instances (for future use)
- * 2. register_instance() - Pre-created instances (from Python components)
+ * Codegen creates one per game component, with a captureless create function that builds the
+ * game and applies its YAML settings. Until a runner switches to it a game costs just this
+ * object; release() destroys the instance again, with all its state and buffers.
  */
-class GameRegistry {
+class GameFactory {
  public:
-  using Factory = std::function<std::unique_ptr<GameBase>()>;
+  using CreateFn = GameBase *(*) ();  // nullptr if out of memory
+
+  GameFactory(const char *key, CreateFn create);
+
+  const char *get_key() const { return key_; }
 
   /**
-   * Register a game factory function with a string key.
+   * The game instance, constructed on first use. Returns nullptr if construction failed.
    */
-  static void register_factory(const std::string &key, Factory factory) { get_factories_()[key] = std::move(factory); }
+  GameBase *acquire() {
+    if (!instance_)
+      instance_.reset(create_());
+    if (instance_)
+      users_++;
+    return instance_.get();
+  }
 
   /**
-   * Register a pre-created game instance (e.g., from Python component).
-   * Registry does not take ownership - caller must ensure lifetime.
+   * Drop one acquire(); the last one destroys the instance.
    */
-  static void register_instance(const std::string &key, GameBase *instance) { get_instances_()[key] = instance; }
+  void release() {
+    if (users_ > 0 && --users_ == 0)
+      instance_.reset();
+  }
 
   /**
-   * Get a game instance by key.
-   * Returns nullptr if key is not found.
-   * For registered instances, returns the stored pointer.
-   * For factories, creates a new instance and caches it.
+   * The live instance, or nullptr while no runner uses the game.
    */
-  static GameBase *make(const std::string &key) {
-    // First check for pre-registered instances
-    auto &instances = get_instances_();
-    auto inst_it = instances.find(key);
-    if (inst_it != instances.end()) {
-      return inst_it->second;
-    }
+  GameBase *get() const { return instance_.get(); }
 
-    // Then check factories and create instance
-    auto &factories = get_factories_();
-    auto factory_it = factories.find(key);
-    if (factory_it != factories.end()) {
-      // Create and cache the instance
-      auto unique_instance = factory_it->second();
-      GameBase *raw_ptr = unique_instance.get();
-      get_owned_instances_()[key] = std::move(unique_instance);
-      return raw_ptr;
-    }
+ protected:
+  const char *key_;
+  CreateFn create_;
+  std::unique_ptr<GameBase> instance_;
+  uint8_t users_{0};
+};
 
-    return nullptr;
-  }
+/**
+ * Game registry: every GameFactory by key (e.g., "snake", "breakout").
+ * Similar to FxRegistry in lvgl-canvas-fx.
+ *
+ * Factories register themselves at startup. The table is a fixed array kept sorted by key,
+ * so lookups are a binary search with no heap or std::string involved.
+ */
+class GameRegistry {
+ public:
+  static constexpr size_t MAX_GAMES = LVGL_GAME_RUNNER_MAX_GAMES;
 
   /**
-   * Check if a game is registered.
+   * Add a factory. Returns false if the table is full or the key is taken.
    */
-  static bool has_game(const std::string &key) {
-    return get_instances_().find(key) != get_instances_().end() || get_factories_().find(key) != get_factories_().end();
+  static bool register_factory(GameFactory *factory) {
+    auto &t = table_();
+    const size_t pos = lower_bound_(factory->get_key());
+    if (t.count == MAX_GAMES || (pos < t.count && strcmp(t.entries[pos]->get_key(), factory->get_key()) == 0))
+      return false;
+    for (size_t i = t.count; i > pos; i--)
+      t.entries[i] = t.entries[i - 1];
+    t.entries[pos] = factory;
+    t.count++;
+    return true;
   }
 
- private:
   /**
-   * Static singleton map for factories.
+   * Find a game by key. Returns nullptr if key is not found.
    */
-  static std::map<std::string, Factory> &get_factories_() {
-    static std::map<std::string, Factory> map;
-    return map;
+  static GameFactory *find(const char *key) {
+    auto &t = table_();
+    const size_t pos = lower_bound_(key);
+    return pos < t.count && strcmp(t.entries[pos]->get_key(), key) == 0 ? t.entries[pos] : nullptr;
   }
 
   /**
-   * Static singleton map for pre-created instances.
+   * Check if a game is registered.
    */
-  static std::map<std::string, GameBase *> &get_instances_() {
-    static std::map<std::string, GameBase *> map;
-    return map;
-  }
+  static bool has_game(const char *key) { return find(key) != nullptr; }
+
+  // Registered games in key order
+  static size_t size() { return table_().count; }
+  static GameFactory *at(size_t i) { return table_().entries[i]; }
+
+ private:
+  struct Table {
+    GameFactory *entries[MAX_GAMES]{};
+    size_t count{0};
+  };
 
   /**
-   * Static singleton map for factory-created instances (owned).
+   * Static singleton table (function-local so registration order between TUs doesn't matter).
    */
-  static std::map<std::string, std::unique_ptr<GameBase>> &get_owned_instances_() {
-    static std::map<std::string, std::unique_ptr<GameBase>> map;
-    return map;
+  static Table &table_() {
+    static Table table;
+    return table;
+  }
+
+  static size_t lower_bound_(const char *key) {
+    auto &t = table_();
+    size_t lo = 0, hi = t.count;
+    while (lo < hi) {
+      const size_t mid = (lo + hi) / 2;
+      if (strcmp(t.entries[mid]->get_key(), key) < 0) {
+        lo = mid + 1;
+      } else {
+        hi = mid;
+      }
+    }
+    return lo;
   }
 };
 
+inline GameFactory::GameFactory(const char *key, CreateFn create) : key_(key), create_(create) {
+  // Codegen rejects duplicate keys and too many games, so this only trips on hand-written factories
+  if (!GameRegistry::register_factory(this)) {
+    ESP_LOGE("lvgl_game_runner", "Can't register game '%s': key already taken or more than %u games", key,
+             (unsigned) GameRegistry::MAX_GAMES);
+  }
+}
+
 }  // namespace esphome::lvgl_game_runner
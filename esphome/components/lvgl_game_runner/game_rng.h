@@ -0,0 +1,57 @@
+// © Copyright 2025 Stuart Parmenter
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <cstdint>
+#include "game_scalar.h"
+
+namespace esphome::lvgl_game_runner {
+
+/**
+ * Small seedable PRNG (xorshift32) for game logic.
+ *
+ * Every game draws its randomness from GameBase's instance, which the runner seeds before
+ * reset(): with the same seed, a fixed simulation rate and the same input, a game plays out
+ * identically (see InputRecording). Not suitable for anything security related.
+ */
+class GameRng {
+ public:
+  static constexpr uint32_t DEFAULT_SEED = 2463534242u;
+
+  explicit GameRng(uint32_t seed = DEFAULT_SEED) { this->seed(seed); }
+
+  void seed(uint32_t seed) { this->state_ = seed != 0 ? seed : DEFAULT_SEED; }  // xorshift can't leave 0
+
+  uint32_t next() {
+    this->state_ ^= this->state_ << 13;
+    this->state_ ^= this->state_ >> 17;
+    this->state_ ^= this->state_ << 5;
+    return this->state_;
+  }
+
+  /**
+   * Uniform integer in [0, n); 0 if n == 0.
+   */
+  uint32_t below(uint32_t n) { return n != 0 ? this->next() % n : 0; }
+
+  /**
+   * Uniform float in [0, 1).
+   */
+  float uniform() { return (this->next() >> 8) * (1.0f / 16777216.0f); }
+
+  /**
+   * Uniform float in [min, max).
+   */
+  float range(float min, float max) { return min + this->uniform() * (max - min); }
+
+  /**
+   * Uniform fixed-point value in [min, max), without floating point.
+   */
+  Fixed range(Fixed min, Fixed max) { return min + Fixed::from_raw((int32_t) (this->next() >> 16)) * (max - min); }
+
+ private:
+  uint32_t state_;
+};
+
+}  // namespace esphome::lvgl_game_runner
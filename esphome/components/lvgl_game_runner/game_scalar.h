@@ -0,0 +1,116 @@
+// © Copyright 2025 Stuart Parmenter
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <type_traits>
+
+// Build with -DLVGL_GAME_RUNNER_FIXED_POINT=1 on chips without an FPU (ESP32-C3/C6) to run
+// game physics and frame timing in Q16.16 integers instead of software floating point.
+#ifndef LVGL_GAME_RUNNER_FIXED_POINT
+#define LVGL_GAME_RUNNER_FIXED_POINT 0
+#endif
+
+namespace esphome::lvgl_game_runner {
+
+/**
+ * Q16.16 signed fixed-point number (range about +-32767, resolution 1/65536).
+ *
+ * Integers convert implicitly, floats only explicitly: write Fixed(0.25f) for constants
+ * (folded at compile time) so a stray float can't quietly pull in soft-float code. The
+ * integer constructor and operators only take integral types, so a float operand is a
+ * compile error rather than being truncated to an int first. Like a float-to-int cast,
+ * (int) truncates toward zero.
+ */
+class Fixed {
+  template<typename T> using if_integral = std::enable_if_t<std::is_integral<T>::value, int>;
+
+ public:
+  static constexpr int FRAC_BITS = 16;
+  static constexpr int32_t ONE = 1 << FRAC_BITS;
+
+  constexpr Fixed() = default;
+  template<typename T, if_integral<T> = 0>
+  constexpr Fixed(T v) : raw_((int32_t) v * ONE) {}  // NOLINT(google-explicit-constructor)
+  explicit constexpr Fixed(float v) : raw_((int32_t) (v * ONE + (v >= 0 ? 0.5f : -0.5f))) {}
+  explicit constexpr Fixed(double v) : raw_((int32_t) (v * ONE + (v >= 0 ? 0.5 : -0.5))) {}
+
+  static constexpr Fixed from_raw(int32_t raw) {
+    Fixed f;
+    f.raw_ = raw;
+    return f;
+  }
+  constexpr int32_t raw() const { return this->raw_; }
+
+  explicit constexpr operator int() const { return this->raw_ / ONE; }
+  explicit constexpr operator float() const { return (float) this->raw_ / ONE; }  // Logging only
+
+  constexpr Fixed operator-() const { return from_raw(-this->raw_); }
+
+  friend constexpr Fixed operator+(Fixed a, Fixed b) { return from_raw(a.raw_ + b.raw_); }
+  friend constexpr Fixed operator-(Fixed a, Fixed b) { return from_raw(a.raw_ - b.raw_); }
+  friend constexpr Fixed operator*(Fixed a, Fixed b) {
+    return from_raw((int32_t) (((int64_t) a.raw_ * b.raw_) >> FRAC_BITS));
+  }
+  friend constexpr Fixed operator/(Fixed a, Fixed b) { return from_raw((int32_t) ((int64_t) a.raw_ * ONE / b.raw_)); }
+  // Integer operands skip the 64-bit intermediate
+  template<typename T, if_integral<T> = 0> friend constexpr Fixed operator*(Fixed a, T b) {
+    return from_raw(a.raw_ * (int32_t) b);
+  }
+  template<typename T, if_integral<T> = 0> friend constexpr Fixed operator*(T a, Fixed b) {
+    return from_raw((int32_t) a * b.raw_);
+  }
+  template<typename T, if_integral<T> = 0> friend constexpr Fixed operator/(Fixed a, T b) {
+    return from_raw(a.raw_ / (int32_t) b);
+  }
+
+  Fixed &operator+=(Fixed o) { return *this = *this + o; }
+  Fixed &operator-=(Fixed o) { return *this = *this - o; }
+  Fixed &operator*=(Fixed o) { return *this = *this * o; }
+  Fixed &operator/=(Fixed o) { return *this = *this / o; }
+
+  friend constexpr bool operator==(Fixed a, Fixed b) { return a.raw_ == b.raw_; }
+  friend constexpr bool operator!=(Fixed a, Fixed b) { return a.raw_ != b.raw_; }
+  friend constexpr bool operator<(Fixed a, Fixed b) { return a.raw_ < b.raw_; }
+  friend constexpr bool operator<=(Fixed a, Fixed b) { return a.raw_ <= b.raw_; }
+  friend constexpr bool operator>(Fixed a, Fixed b) { return a.raw_ > b.raw_; }
+  friend constexpr bool operator>=(Fixed a, Fixed b) { return a.raw_ >= b.raw_; }
+
+ private:
+  int32_t raw_{0};
+};
+
+/**
+ * Number type for game physics and frame timing: Fixed or float, per build flag.
+ * Code written against Scalar and the helpers below compiles either way.
+ */
+#if LVGL_GAME_RUNNER_FIXED_POINT
+using Scalar = Fixed;
+#else
+using Scalar = float;
+#endif
+
+inline float scalar_abs(float v) { return fabsf(v); }
+inline Fixed scalar_abs(Fixed v) { return v.raw() < 0 ? -v : v; }
+
+inline int scalar_floor(float v) { return (int) floorf(v); }
+inline int scalar_floor(Fixed v) { return v.raw() >> Fixed::FRAC_BITS; }
+
+inline int scalar_ceil(float v) { return (int) ceilf(v); }
+inline int scalar_ceil(Fixed v) { return (v.raw() + Fixed::ONE - 1) >> Fixed::FRAC_BITS; }
+
+/**
+ * num / den as a Scalar, without floating point in fixed-point builds (e.g. microseconds
+ * to seconds). The result must fit the Fixed range.
+ */
+inline Scalar scalar_ratio(int64_t num, int64_t den) {
+#if LVGL_GAME_RUNNER_FIXED_POINT
+  return Fixed::from_raw((int32_t) (num * Fixed::ONE / den));
+#else
+  return (float) num / (float) den;
+#endif
+}
+
+}  // namespace esphome::lvgl_game_runner
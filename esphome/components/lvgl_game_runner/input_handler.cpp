@@ -2,81 +2,54 @@
 // SPDX-License-Identifier: MIT
 
 #include "input_handler.h"
-#include "esphome/core/log.h"
 
 namespace esphome::lvgl_game_runner {
 
-static const char *const TAG = "lvgl_game_runner.input";
-
-InputHandler::InputHandler() {
-  this->mutex_ = xSemaphoreCreateMutex();
-  if (!this->mutex_) {
-    ESP_LOGE(TAG, "Failed to create input mutex");
+// No logging in here: push_event() runs from ISRs and the BLE callback task, where
+// logging stalls the caller. Drops are reported via get_dropped_count() instead.
+
+bool InputHandler::push_event(const InputEvent &event) {
+  const bool rotate = event.type == InputType::ROTATE_CW || event.type == InputType::ROTATE_CCW;
+  if (rotate && event.player >= 1 && event.player <= MAX_PLAYERS) {
+    if (!event.pressed)
+      return true;  // Encoders only click; a release carries nothing
+    const int32_t steps = event.value > 0 ? event.value : 1;
+    this->rotation_[event.player - 1].fetch_add(event.type == InputType::ROTATE_CW ? steps : -steps,
+                                                std::memory_order_relaxed);
+  } else if (!this->queue_.push(event)) {
+    return false;
   }
+  this->wake_();
+  return true;
 }
 
-InputHandler::~InputHandler() {
-  if (this->mutex_) {
-    vSemaphoreDelete(this->mutex_);
-    this->mutex_ = nullptr;
-  }
+void InputHandler::wake_() {
+  if (this->wake_fn_ && this->wake_armed_.load(std::memory_order_relaxed) && this->wake_armed_.exchange(false))
+    this->wake_fn_(this->wake_arg_);
 }
 
-void InputHandler::push_event(const InputEvent &event) {
-  if (!this->mutex_)
-    return;
+bool InputHandler::pop_event(InputEvent &event) { return this->queue_.pop(event); }
 
-  if (xSemaphoreTake(this->mutex_, pdMS_TO_TICKS(10)) == pdTRUE) {
-    // Prevent queue overflow
-    if (this->queue_.size() < MAX_QUEUE_SIZE) {
-      this->queue_.push(event);
-    } else {
-      ESP_LOGW(TAG, "Input queue full, dropping event");
-    }
-    xSemaphoreGive(this->mutex_);
-  } else {
-    ESP_LOGW(TAG, "Failed to acquire mutex for push_event");
-  }
+int32_t InputHandler::take_rotation(uint8_t player) {
+  if (player < 1 || player > MAX_PLAYERS)
+    return 0;
+  return this->rotation_[player - 1].exchange(0, std::memory_order_relaxed);
 }
 
-bool InputHandler::pop_event(InputEvent &event) {
-  if (!this->mutex_)
-    return false;
-
-  bool has_event = false;
-  if (xSemaphoreTake(this->mutex_, 0) == pdTRUE) {
-    if (!this->queue_.empty()) {
-      event = this->queue_.front();
-      this->queue_.pop();
-      has_event = true;
-    }
-    xSemaphoreGive(this->mutex_);
+bool InputHandler::has_events() const {
+  if (!this->queue_.empty())
+    return true;
+  for (const auto &r : this->rotation_) {
+    if (r.load(std::memory_order_relaxed) != 0)
+      return true;
   }
-  return has_event;
-}
-
-bool InputHandler::has_events() {
-  if (!this->mutex_)
-    return false;
-
-  bool has = false;
-  if (xSemaphoreTake(this->mutex_, 0) == pdTRUE) {
-    has = !this->queue_.empty();
-    xSemaphoreGive(this->mutex_);
-  }
-  return has;
+  return false;
 }
 
 void InputHandler::clear() {
-  if (!this->mutex_)
-    return;
-
-  if (xSemaphoreTake(this->mutex_, pdMS_TO_TICKS(10)) == pdTRUE) {
-    while (!this->queue_.empty()) {
-      this->queue_.pop();
-    }
-    xSemaphoreGive(this->mutex_);
-  }
+  this->queue_.clear();
+  for (auto &r : this->rotation_)
+    r.store(0, std::memory_order_relaxed);
 }
 
 }  // namespace esphome::lvgl_game_runner
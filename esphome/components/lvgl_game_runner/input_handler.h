@@ -4,30 +4,41 @@
 #pragma once
 
 #include "input_types.h"
-#include "esphome/core/component.h"
-#include <queue>
-#include <freertos/FreeRTOS.h>
-#include <freertos/semphr.h>
+#include "ring_buffer.h"
+#include <atomic>
+#include <cstdint>
+
+// Select the multi-producer queue when several contexts (GPIO ISR, BLE task, API)
+// push input into the same runner. Codegen enables it unless every runner sets
+// multi_producer_input: false; single-producer is cheaper but only safe with one source.
+#ifndef LVGL_GAME_RUNNER_INPUT_MPSC
+#define LVGL_GAME_RUNNER_INPUT_MPSC 0
+#endif
 
 namespace esphome::lvgl_game_runner {
 
 /**
- * Thread-safe input event queue.
+ * Lock-free input event queue.
  * Similar to the data ingress pattern in FxAudioSpectrum.
  *
  * Input events can come from multiple sources (button ISRs, encoder callbacks, etc.)
- * and need to be safely queued for the game loop to process.
+ * and need to be safely queued for the game loop to process. Pushing never blocks or
+ * allocates; when the queue is full the event is dropped and counted.
+ *
+ * Encoder clicks (ROTATE_CW / ROTATE_CCW presses) don't use the queue: they are summed into
+ * a per-player step count that the consumer takes once per frame, so a fast-spinning
+ * encoder can't crowd out button events.
  */
 class InputHandler {
  public:
-  InputHandler();
-  ~InputHandler();
+  static constexpr size_t MAX_QUEUE_SIZE = 32;  // Must be a power of two
+  static constexpr uint8_t MAX_PLAYERS = 4;
 
   /**
    * Push an input event to the queue.
-   * Thread-safe, can be called from ISRs or other threads.
+   * Lock-free and ISR-safe. Returns false if the queue was full and the event was dropped.
    */
-  void push_event(const InputEvent &event);
+  bool push_event(const InputEvent &event);
 
   /**
    * Pop the next input event from the queue.
@@ -37,19 +48,57 @@ class InputHandler {
   bool pop_event(InputEvent &event);
 
   /**
-   * Check if there are events in the queue.
+   * Take the net encoder steps pushed for `player` (1-4) since the last call: clockwise
+   * positive. Consumer side.
+   */
+  int32_t take_rotation(uint8_t player);
+
+  /**
+   * Check if there are events in the queue or encoder steps to take.
    */
-  bool has_events();
+  bool has_events() const;
 
   /**
    * Clear all events from the queue.
+   * Must only be called from the consumer (game loop) thread.
    */
   void clear();
 
+  /**
+   * Total number of events dropped because the queue was full.
+   */
+  uint32_t get_dropped_count() const { return this->queue_.overflow_count(); }
+
+  /**
+   * Called (from the pushing context, possibly an ISR) by the first push after arm_wake().
+   * Set once, before any producer runs.
+   */
+  using WakeFn = void (*)(void *arg);
+  void set_wake_callback(WakeFn fn, void *arg) {
+    this->wake_fn_ = fn;
+    this->wake_arg_ = arg;
+  }
+
+  /**
+   * Have the next push call the wake callback (the consumer is about to sleep). Check
+   * has_events() afterwards: an event pushed just before arming doesn't wake.
+   */
+  void arm_wake() { this->wake_armed_.store(true); }
+  void disarm_wake() { this->wake_armed_.store(false, std::memory_order_relaxed); }
+
  private:
-  std::queue<InputEvent> queue_;
-  SemaphoreHandle_t mutex_{nullptr};
-  static constexpr size_t MAX_QUEUE_SIZE = 32;  // Prevent overflow
+  WakeFn wake_fn_{nullptr};
+  void *wake_arg_{nullptr};
+  std::atomic<bool> wake_armed_{false};
+  std::atomic<int32_t> rotation_[MAX_PLAYERS]{};
+
+  void wake_();
+
+#if LVGL_GAME_RUNNER_INPUT_MPSC
+  MpscRingBuffer<InputEvent, MAX_QUEUE_SIZE> queue_;
+#else
+  SpscRingBuffer<InputEvent, MAX_QUEUE_SIZE> queue_;
+#endif
 };
 
 }  // namespace esphome::lvgl_game_runner
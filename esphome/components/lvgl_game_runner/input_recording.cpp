@@ -0,0 +1,130 @@
+// © Copyright 2025 Stuart Parmenter
+// SPDX-License-Identifier: MIT
+
+#include "input_recording.h"
+
+#include <cstring>
+
+namespace esphome::lvgl_game_runner {
+
+static const uint8_t MAGIC[4] = {'G', 'R', 'E', 'C'};
+
+static uint32_t get_u32(const uint8_t *p) {
+  return (uint32_t) p[0] | ((uint32_t) p[1] << 8) | ((uint32_t) p[2] << 16) | ((uint32_t) p[3] << 24);
+}
+
+// Reads a varint at `pos`; returns false if it runs past `len` or is too long
+static bool get_varint(const uint8_t *data, size_t len, size_t &pos, uint32_t &out) {
+  out = 0;
+  for (int shift = 0; shift < 35; shift += 7) {
+    if (pos >= len)
+      return false;
+    const uint8_t b = data[pos++];
+    out |= (uint32_t) (b & 0x7F) << shift;
+    if (!(b & 0x80))
+      return true;
+  }
+  return false;
+}
+
+void InputRecording::put_varint_(uint32_t v) {
+  while (v >= 0x80) {
+    this->data_.push_back((uint8_t) (v | 0x80));
+    v >>= 7;
+  }
+  this->data_.push_back((uint8_t) v);
+}
+
+void InputRecording::put_u32_(size_t offset, uint32_t v) {
+  for (int i = 0; i < 4; i++)
+    this->data_[offset + i] = (uint8_t) (v >> (8 * i));
+}
+
+void InputRecording::begin(uint32_t seed, uint32_t sim_period_us) {
+  this->data_.reserve(MAX_BYTES);  // Allocate now rather than while the game is running
+  this->data_.assign(HEADER_SIZE, 0);
+  memcpy(this->data_.data(), MAGIC, sizeof(MAGIC));
+  this->data_[4] = VERSION;
+  this->put_u32_(8, seed);
+  this->put_u32_(12, sim_period_us);
+  this->seed_ = seed;
+  this->sim_period_us_ = sim_period_us;
+  this->steps_ = 0;
+  this->last_step_ = 0;
+}
+
+bool InputRecording::append(uint32_t step, const InputEvent &event) {
+  // Worst case: 5 + 1 + 3 bytes
+  if (this->data_.size() < HEADER_SIZE || this->data_.size() + 9 > MAX_BYTES)
+    return false;
+  this->put_varint_(step - this->last_step_);
+  this->last_step_ = step;
+  const uint8_t player = (event.player >= 1 && event.player <= 4) ? event.player - 1 : 0;
+  this->data_.push_back((uint8_t) ((uint8_t) event.type & 0x1F) | (event.pressed ? 0x20 : 0) | (player << 6));
+  const int32_t v = event.value;
+  this->put_varint_(((uint32_t) v << 1) ^ (uint32_t) (v >> 31));
+  return true;
+}
+
+void InputRecording::finish(uint32_t steps) {
+  if (this->data_.size() < HEADER_SIZE)
+    return;
+  this->steps_ = steps;
+  this->put_u32_(16, steps);
+}
+
+bool InputRecording::load(const uint8_t *data, size_t len) {
+  if (!data || len < HEADER_SIZE || len > MAX_BYTES || memcmp(data, MAGIC, sizeof(MAGIC)) != 0 ||
+      data[4] != VERSION)
+    return false;
+
+  // Validate the whole event stream up front so replays can't read garbage
+  size_t pos = HEADER_SIZE;
+  while (pos < len) {
+    uint32_t delta, value;
+    if (!get_varint(data, len, pos, delta) || pos >= len)
+      return false;
+    if ((data[pos++] & 0x1F) >= (uint8_t) InputType::NONE)
+      return false;
+    if (!get_varint(data, len, pos, value))
+      return false;
+  }
+
+  this->data_.assign(data, data + len);
+  this->seed_ = get_u32(&data[8]);
+  this->sim_period_us_ = get_u32(&data[12]);
+  this->steps_ = get_u32(&data[16]);
+  this->last_step_ = 0;
+  return true;
+}
+
+bool InputRecording::Cursor::peek_step_(uint32_t &step, size_t &after) const {
+  const std::vector<uint8_t> &d = this->rec_->data_;
+  after = this->pos_;
+  uint32_t delta;
+  if (!get_varint(d.data(), d.size(), after, delta))
+    return false;
+  step = this->step_ + delta;
+  return true;
+}
+
+bool InputRecording::Cursor::next(uint32_t step, InputEvent &event) {
+  if (!this->rec_ || this->pos_ >= this->rec_->data_.size())
+    return false;
+  uint32_t event_step;
+  size_t pos;
+  if (!this->peek_step_(event_step, pos) || event_step > step)
+    return false;
+
+  const std::vector<uint8_t> &d = this->rec_->data_;
+  const uint8_t packed = d[pos++];
+  uint32_t zz = 0;
+  get_varint(d.data(), d.size(), pos, zz);
+  event = InputEvent(static_cast<InputType>(packed & 0x1F), (uint8_t) ((packed >> 6) + 1), (packed & 0x20) != 0,
+                     (int16_t) ((zz >> 1) ^ -(int32_t) (zz & 1)));
+  this->pos_ = pos;
+  this->step_ = event_step;
+  return true;
+}
+
+}  // namespace esphome::lvgl_game_runner
@@ -0,0 +1,90 @@
+// © Copyright 2025 Stuart Parmenter
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include "input_types.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace esphome::lvgl_game_runner {
+
+/**
+ * A recorded input stream that can be replayed deterministically.
+ *
+ * Events are stamped with the index of the simulation step they were delivered before, so
+ * a replay with the same seed and simulation rate feeds the game exactly the same input
+ * between exactly the same update() calls, however the frames happen to be timed.
+ *
+ * Binary format (little endian):
+ *   header  "GREC", u8 version, 3 reserved bytes, u32 seed, u32 sim_period_us, u32 steps
+ *   events  varint step delta, u8 type | pressed << 5 | (player - 1) << 6, zigzag varint value
+ */
+class InputRecording {
+ public:
+  static constexpr uint8_t VERSION = 1;
+  static constexpr size_t HEADER_SIZE = 20;
+  static constexpr size_t MAX_BYTES = 16384;  // ~5000 events
+
+  /**
+   * Start a new recording (drops the previous one).
+   */
+  void begin(uint32_t seed, uint32_t sim_period_us);
+
+  /**
+   * Append an event delivered before simulation step `step` (non-decreasing).
+   * Returns false (and records nothing) once MAX_BYTES is reached.
+   */
+  bool append(uint32_t step, const InputEvent &event);
+
+  /**
+   * Close the recording at `steps` simulation steps; replays stop there.
+   */
+  void finish(uint32_t steps);
+
+  /**
+   * Replace the recording with `len` bytes in the format above. Returns false if invalid.
+   */
+  bool load(const uint8_t *data, size_t len);
+
+  bool empty() const { return this->data_.size() <= HEADER_SIZE; }
+  const std::vector<uint8_t> &data() const { return this->data_; }
+  size_t size() const { return this->data_.size(); }
+  uint32_t seed() const { return this->seed_; }
+  uint32_t sim_period_us() const { return this->sim_period_us_; }
+  uint32_t steps() const { return this->steps_; }
+
+  /**
+   * Sequential reader for replays.
+   */
+  class Cursor {
+   public:
+    Cursor() = default;
+    explicit Cursor(const InputRecording *rec) : rec_(rec), pos_(rec ? HEADER_SIZE : 0) {}
+
+    /**
+     * Next event due before step `step`, if any. Call repeatedly until it returns false.
+     */
+    bool next(uint32_t step, InputEvent &event);
+
+   private:
+    bool peek_step_(uint32_t &step, size_t &after) const;
+
+    const InputRecording *rec_{nullptr};
+    size_t pos_{0};
+    uint32_t step_{0};  // Step of the last event read
+  };
+
+ private:
+  void put_varint_(uint32_t v);
+  void put_u32_(size_t offset, uint32_t v);
+
+  std::vector<uint8_t> data_;
+  uint32_t seed_{0};
+  uint32_t sim_period_us_{0};
+  uint32_t steps_{0};
+  uint32_t last_step_{0};
+};
+
+}  // namespace esphome::lvgl_game_runner
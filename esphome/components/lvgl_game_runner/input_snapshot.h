@@ -0,0 +1,122 @@
+// © Copyright 2025 Stuart Parmenter
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include "input_types.h"
+#include <cstdint>
+
+namespace esphome::lvgl_game_runner {
+
+// Number of real input types (InputType::NONE excluded)
+static constexpr uint8_t INPUT_TYPE_COUNT = static_cast<uint8_t>(InputType::NONE);
+
+/**
+ * Every player's input as of the current simulation step.
+ *
+ * The runner folds each input event into it before passing the event to on_input(), so
+ * games can poll held buttons in update() instead of tracking them from edges. A button
+ * pressed and released between two updates still shows up in `pressed` and `released`,
+ * and encoder clicks add up to a signed step count. The edges and steps are cleared after
+ * every update().
+ */
+class InputSnapshot {
+ public:
+  static constexpr uint8_t MAX_PLAYERS = 4;
+
+  static constexpr uint16_t bit(InputType type) { return uint16_t(1u << static_cast<uint8_t>(type)); }
+
+  struct Player {
+    uint16_t held{0};      // bit() of each button that is down
+    uint16_t pressed{0};   // Went down since the last update
+    uint16_t released{0};  // Went up since the last update
+    int16_t rotate{0};     // Encoder steps since the last update: clockwise positive
+    int16_t value[INPUT_TYPE_COUNT]{};  // Latest event value per type (triggers, touch)
+
+    bool is_held(InputType type) const { return held & bit(type); }
+    bool was_pressed(InputType type) const { return pressed & bit(type); }
+    bool was_released(InputType type) const { return released & bit(type); }
+
+    /**
+     * Set a button's state directly (for AI controllers), recording the edge if it changed.
+     */
+    void set_held(InputType type, bool down) {
+      const uint16_t b = bit(type);
+      if (down && !(held & b))
+        pressed |= b;
+      if (!down && (held & b))
+        released |= b;
+      held = down ? uint16_t(held | b) : uint16_t(held & ~b);
+    }
+  };
+
+  /**
+   * Player 1-4. Out of range numbers map to player 1.
+   */
+  Player &player(uint8_t num) { return players_[num >= 1 && num <= MAX_PLAYERS ? num - 1 : 0]; }
+  const Player &player(uint8_t num) const { return players_[num >= 1 && num <= MAX_PLAYERS ? num - 1 : 0]; }
+
+  /**
+   * All players merged, for single-player games that take input from any source.
+   */
+  Player combined() const {
+    Player all;
+    for (const auto &p : players_) {
+      all.held |= p.held;
+      all.pressed |= p.pressed;
+      all.released |= p.released;
+      all.rotate += p.rotate;
+    }
+    return all;
+  }
+
+  /**
+   * Fold one event in. Events for players outside 1-4 are ignored.
+   */
+  void apply(const InputEvent &event) {
+    if (event.player < 1 || event.player > MAX_PLAYERS || event.type == InputType::NONE)
+      return;
+    Player &p = players_[event.player - 1];
+    if (event.type == InputType::ROTATE_CW || event.type == InputType::ROTATE_CCW) {
+      // value is the number of steps the runner coalesced into the event (0 means one)
+      if (event.pressed) {
+        const int16_t steps = event.value > 0 ? event.value : 1;
+        p.rotate += event.type == InputType::ROTATE_CW ? steps : -steps;
+      }
+      return;
+    }
+    const uint16_t b = bit(event.type);
+    if (event.pressed) {
+      p.held |= b;
+      p.pressed |= b;
+    } else {
+      p.held &= ~b;
+      p.released |= b;
+    }
+    p.value[static_cast<uint8_t>(event.type)] = event.value;
+  }
+
+  /**
+   * After an update(): edges and encoder steps have been seen.
+   */
+  void end_step() {
+    for (auto &p : players_) {
+      p.pressed = 0;
+      p.released = 0;
+      p.rotate = 0;
+    }
+  }
+
+  /**
+   * Forget everything (a new game was bound).
+   */
+  void clear() {
+    for (auto &p : players_)
+      p = Player{};
+  }
+
+ private:
+  Player players_[MAX_PLAYERS];
+};
+
+}  // namespace esphome::lvgl_game_runner
@@ -48,9 +48,13 @@ struct InputEvent {
   uint8_t player;  // Player number (1-4)
   bool pressed;    // true = press/trigger, false = release
   int16_t value;   // Optional: analog value, touch coordinates, rotation steps, etc.
+  // Optional: when the source saw the input (low 32 bits of esp_timer_get_time(), 0 = not
+  // stamped). Stamped events feed the runner's input latency metric.
+  uint32_t timestamp_us;
 
-  InputEvent() : type(InputType::NONE), player(1), pressed(false), value(0) {}
-  InputEvent(InputType t, uint8_t pl = 1, bool p = true, int16_t v = 0) : type(t), player(pl), pressed(p), value(v) {}
+  InputEvent() : type(InputType::NONE), player(1), pressed(false), value(0), timestamp_us(0) {}
+  InputEvent(InputType t, uint8_t pl = 1, bool p = true, int16_t v = 0)
+      : type(t), player(pl), pressed(p), value(v), timestamp_us(0) {}
 };
 
 }  // namespace esphome::lvgl_game_runner
@@ -2,16 +2,25 @@
 // SPDX-License-Identifier: MIT
 
 #include "lvgl_game_runner.h"
+#include "pixel_ops.h"
 
 #include <algorithm>
 #include <cmath>
+#include <cstring>
 #include <unordered_map>
+#include "esp_heap_caps.h"
+#include "esp_random.h"
 #include "esp_timer.h"
 
 namespace esphome::lvgl_game_runner {
 
 static const char *const TAG = "lvgl_game_runner";
 
+// Longest LVGL waits for the task to finish a frame before drawing the canvas anyway
+static constexpr uint32_t DRAW_LOCK_TIMEOUT_MS = 10;
+
+using Phase = FrameProfiler::Phase;
+
 void LvglGameRunner::set_fps(float fps) {
   if (fps < 1.0f)
     fps = 1.0f;
@@ -20,27 +29,63 @@ void LvglGameRunner::set_fps(float fps) {
   period_ms_ = (uint32_t) lroundf(1000.0f / fps);
 }
 
+void LvglGameRunner::set_simulation_rate(float hz) {
+  if (hz <= 0.0f) {
+    sim_period_us_ = 0;
+  } else {
+    sim_period_us_ = (uint32_t) lroundf(1e6f / std::min(hz, 1000.0f));
+  }
+  sim_accum_us_ = 0;
+}
+
+void LvglGameRunner::set_task_config(int8_t core, uint8_t priority, uint32_t stack_size) {
+  use_task_ = true;
+  task_core_ = core;
+  task_priority_ = priority;
+  task_stack_size_ = stack_size;
+}
+
 void LvglGameRunner::pause() {
+  this->lock_frame_();
   if (game_)
     game_->pause();
   running_ = false;
-  this->disable_loop();
+  this->leave_idle_();
+  this->set_cpu_lock_(false);
+  this->unlock_frame_();
+  // With a runner task, loop() disables itself once the last frame has been flushed
+  if (!task_handle_)
+    this->disable_loop();
 }
 
 void LvglGameRunner::resume() {
+  this->lock_frame_();
   if (game_)
     game_->resume();
   running_ = true;
   rebind_ = true;
   last_us_ = esp_timer_get_time();  // Resync timing
+  sim_accum_us_ = 0;
+  this->leave_idle_();
+  this->unlock_frame_();
   this->enable_loop();
+  if (task_handle_)
+    xTaskNotifyGive(task_handle_);
 }
 
 void LvglGameRunner::start() {
+  this->lock_frame_();
   if (game_)
     game_->reset();
-  if (!running_)
+  this->leave_idle_();
+  this->unlock_frame_();
+  if (!running_) {
     resume();
+  } else {
+    this->enable_loop();
+    if (task_handle_)
+      xTaskNotifyGive(task_handle_);
+  }
 }
 
 void LvglGameRunner::send_input(InputType type, uint8_t player, bool pressed, int16_t value) {
@@ -76,9 +121,9 @@ void LvglGameRunner::send_input(const char *input_str, uint8_t player, bool pres
 
 void LvglGameRunner::send_input_event(const InputEvent &event) { input_handler_.push_event(event); }
 
-void LvglGameRunner::setup_binding(lv_obj_t *canvas_obj, GameBase *initial_game, bool start_paused) {
+void LvglGameRunner::setup_binding(lv_obj_t *canvas_obj, GameFactory *initial_game, bool start_paused) {
   canvas_ = canvas_obj;
-  game_ = initial_game;
+  factory_ = initial_game;  // Constructed at the first bind
   running_ = !start_paused;
   rebind_ = running_;
 }
@@ -90,6 +135,33 @@ void LvglGameRunner::setup() {
   m_.last_tick_us = last_us_;
 #endif
 
+  // Input during an idle wait wakes the frame producer
+  input_handler_.set_wake_callback(&LvglGameRunner::input_wake_cb_, this);
+
+  if (cpu_lock_wanted_) {
+#ifdef CONFIG_PM_ENABLE
+    if (esp_pm_lock_create(ESP_PM_CPU_FREQ_MAX, 0, "game_runner", &pm_lock_) != ESP_OK) {
+      ESP_LOGW(TAG, "Failed to create CPU frequency lock");
+      pm_lock_ = nullptr;
+    }
+#else
+    ESP_LOGW(TAG, "cpu_frequency_lock needs CONFIG_PM_ENABLE; ignoring");
+#endif
+  }
+
+  if (use_task_) {
+    frame_mutex_ = xSemaphoreCreateMutex();
+    const BaseType_t core = task_core_ < 0 ? tskNO_AFFINITY : std::min<BaseType_t>(task_core_, portNUM_PROCESSORS - 1);
+    if (!frame_mutex_ || xTaskCreatePinnedToCore(&LvglGameRunner::task_entry_, "game_runner", task_stack_size_, this,
+                                                 task_priority_, &task_handle_, core) != pdPASS) {
+      ESP_LOGE(TAG, "Failed to start runner task; running frames from the main loop");
+      if (frame_mutex_)
+        vSemaphoreDelete(frame_mutex_);
+      frame_mutex_ = nullptr;
+      task_handle_ = nullptr;
+    }
+  }
+
   // If starting paused, disable loop to save power
   if (!running_) {
     this->disable_loop();
@@ -97,6 +169,11 @@ void LvglGameRunner::setup() {
 }
 
 void LvglGameRunner::loop() {
+  if (task_handle_) {
+    this->service_task_();
+    return;
+  }
+
   if (!running_)
     return;
 
@@ -104,25 +181,198 @@ void LvglGameRunner::loop() {
   const uint64_t elapsed_us = now - last_us_;
   const uint64_t target_us = (uint64_t) period_ms_ * 1000;
 
-  if (elapsed_us >= target_us) {
-    // Calculate dt from MEASURED elapsed time (for graceful degradation)
-    const float dt = std::min((float) elapsed_us / 1e6f, 0.1f);  // cap at 100ms
-
+  if (elapsed_us >= target_us && !this->idle_(now)) {
     // Update last_us_ BEFORE tick
     last_us_ = now;
 
-    // Pass measured dt to tick
-    this->tick_(dt);
+    // Pass MEASURED elapsed time to tick (for graceful degradation)
+    this->tick_(elapsed_us);
+
+#if ESPHOME_VERSION_CODE >= VERSION_CODE(2025, 7, 0)
+    // Static until input: stop looping, input_wake_cb_() turns the loop back on
+    if (idle_until_us_ == IDLE_FOREVER && !input_handler_.has_events()) {
+      this->disable_loop();
+      return;
+    }
+#endif
   }
+
+#if LVGL_GAME_RUNNER_METRICS
+  this->metrics_poll_();
+#endif
 }
 
-void LvglGameRunner::set_game(GameBase *game) {
-  if (game == game_)
+void LvglGameRunner::set_game(GameFactory *factory) {
+  if (factory == nullptr || factory == factory_)
+    return;
+  this->lock_frame_();
+  // Free the current game before the next one allocates, unless it stays as the warm spare
+  if (game_ && !keep_previous_game_) {
+    factory_->release();
+    game_ = nullptr;
+  }
+  GameBase *game = factory->acquire();
+  if (!game) {
+    ESP_LOGE(TAG, "Not enough memory to construct game '%s'", factory->get_key());
+    if (!game_ && factory_) {
+      game_ = factory_->acquire();  // Fall back to a fresh copy of the current game
+      rebind_ = true;
+    }
+    this->unlock_frame_();
     return;
+  }
+  if (keep_previous_game_ && game_) {
+    if (warm_)
+      warm_->release();  // Only one spare; if it was `factory`, the acquire above keeps it alive
+    warm_ = factory_;
+  }
+  factory_ = factory;
   game_ = game;
   rebind_ = true;          // ensure ensure_bound_() runs next update
   input_handler_.clear();  // clear any pending input
-  ESP_LOGI(TAG, "Game changed; will rebind");
+  this->leave_idle_();
+  this->unlock_frame_();
+  this->enable_loop();
+  if (task_handle_)
+    xTaskNotifyGive(task_handle_);
+  ESP_LOGI(TAG, "Game changed to '%s'; will rebind", factory->get_key());
+}
+
+void LvglGameRunner::set_game(const char *key) {
+  GameFactory *factory = GameRegistry::find(key);
+  if (!factory) {
+    ESP_LOGW(TAG, "Unknown game: %s", key);
+    return;
+  }
+  this->set_game(factory);
+}
+
+// ---- Runner task ----
+//
+// The task produces frames: input, update()/render() and sprite composition, all of which
+// only write the canvas buffer. Anything that calls into LVGL (binding, text cache, pushing
+// damage with lv_obj_invalidate_area) runs on the main loop, next to lv_timer_handler().
+// frame_mutex_ is held by the task for each frame and by LVGL while it draws the canvas
+// (DRAW_MAIN_BEGIN .. DRAW_POST_END), so LVGL never copies out a half-drawn frame. The main
+// loop only ever try-locks it, and without a back buffer the task doesn't start a frame
+// while LVGL still has one to draw, so neither side waits out a whole game frame. LVGL's
+// wait is bounded as well: a draw that couldn't get the lock may have copied out a frame in
+// progress, so the whole canvas is invalidated and drawn again once the frame is done.
+
+void LvglGameRunner::task_entry_(void *arg) { static_cast<LvglGameRunner *>(arg)->task_loop_(); }
+
+void LvglGameRunner::task_loop_() {
+  TickType_t last_wake = xTaskGetTickCount();
+  TickType_t idle_ticks = 0;  // Wait before the next frame while the game is idle
+  for (;;) {
+    if (!running_) {
+      ulTaskNotifyTake(pdTRUE, portMAX_DELAY);  // Woken by resume()
+      last_wake = xTaskGetTickCount();
+      continue;
+    }
+
+    const TickType_t period = std::max<TickType_t>(pdMS_TO_TICKS(period_ms_), 1);
+    if (idle_ticks != 0) {
+      // Input, resume() or set_game() notify the task early
+      ulTaskNotifyTake(pdTRUE, idle_ticks);
+      last_wake = xTaskGetTickCount();
+    } else {
+      vTaskDelayUntil(&last_wake, period);
+      // After a stall, restart the schedule instead of running the missed frames back to back
+      const TickType_t now_ticks = xTaskGetTickCount();
+      if (now_ticks - last_wake > period)
+        last_wake = now_ticks;
+    }
+    // Let LVGL draw the last frame first; a canvas it never redraws (hidden) costs a period
+    if (draw_pending_.load(std::memory_order_acquire)) {
+      ulTaskNotifyTake(pdTRUE, period);
+      draw_pending_.store(false, std::memory_order_relaxed);
+    }
+
+    this->lock_frame_();
+    idle_ticks = 0;
+    if (running_ && !rebind_) {
+      uint64_t now = esp_timer_get_time();
+      if (!this->idle_(now)) {
+        const uint64_t elapsed_us = now - last_us_;
+        last_us_ = now;
+        this->tick_(elapsed_us);
+        now = esp_timer_get_time();
+      }
+      if (this->idle_(now)) {
+        idle_ticks = idle_until_us_ == IDLE_FOREVER
+                         ? portMAX_DELAY
+                         : std::max<TickType_t>(pdMS_TO_TICKS((idle_until_us_ - now + 999) / 1000), 1);
+      }
+    }
+    this->unlock_frame_();
+  }
+}
+
+void LvglGameRunner::service_task_() {
+  // The task is mid-frame: don't hold up the main loop, push its frame on the next pass
+  if (!this->try_lock_frame_())
+    return;
+  if (redraw_canvas_) {
+    redraw_canvas_ = false;
+    lv_obj_invalidate(canvas_);
+    draw_pending_.store(true, std::memory_order_release);
+  }
+  if (rebind_ && running_ && this->ensure_bound_()) {
+    rebind_ = false;
+    last_us_ = esp_timer_get_time();
+  }
+  if (this->flush_frame_() && draw_lock_hooked_)
+    draw_pending_.store(true, std::memory_order_release);
+#if LVGL_GAME_RUNNER_METRICS
+  this->metrics_poll_();
+#endif
+  this->unlock_frame_();
+
+  if (!running_)
+    this->disable_loop();
+}
+
+void LvglGameRunner::lock_frame_() {
+  if (frame_mutex_)
+    xSemaphoreTake(frame_mutex_, portMAX_DELAY);
+}
+
+bool LvglGameRunner::try_lock_frame_() { return !frame_mutex_ || xSemaphoreTake(frame_mutex_, 0) == pdTRUE; }
+
+void LvglGameRunner::unlock_frame_() {
+  if (frame_mutex_)
+    xSemaphoreGive(frame_mutex_);
+}
+
+bool LvglGameRunner::flush_frame_() {
+  if (!game_)
+    return false;
+  bool flushed;
+  {
+    auto timer = this->profile_(Phase::INVALIDATE);
+    flushed = game_->flush_damage();
+  }
+#if LVGL_GAME_RUNNER_METRICS
+  if (flushed && lvgl_pending_since_us_ == 0)
+    lvgl_pending_since_us_ = esp_timer_get_time();
+#endif
+  return flushed;
+}
+
+void LvglGameRunner::draw_lock_cb_(lv_event_t *e) {
+  auto *self = static_cast<LvglGameRunner *>(lv_event_get_user_data(e));
+  if (lv_event_get_code(e) == LV_EVENT_DRAW_MAIN_BEGIN) {
+    self->draw_locked_ = xSemaphoreTake(self->frame_mutex_, pdMS_TO_TICKS(DRAW_LOCK_TIMEOUT_MS)) == pdTRUE;
+    if (!self->draw_locked_)
+      self->redraw_canvas_ = true;
+  } else {
+    if (self->draw_locked_)
+      self->unlock_frame_();
+    self->draw_locked_ = false;
+    if (self->draw_pending_.exchange(false, std::memory_order_acq_rel))
+      xTaskNotifyGive(self->task_handle_);
+  }
 }
 
 bool LvglGameRunner::read_canvas_size_(uint16_t &w, uint16_t &h) {
@@ -145,7 +395,7 @@ void LvglGameRunner::on_canvas_size_change_() {
   int cx = canvas_ ? lv_obj_get_x(canvas_) : 0;
   int cy = canvas_ ? lv_obj_get_y(canvas_) : 0;
 
-  game_->on_resize(GameBase::Rect{cx, cy, cw, ch});
+  game_->on_resize(GameBase::Rect{cx, cy, cw / pixel_scale_, ch / pixel_scale_});
 }
 
 bool LvglGameRunner::ensure_bound_() {
@@ -158,28 +408,275 @@ bool LvglGameRunner::ensure_bound_() {
     return false;
   }
 
+  if (canvas_format_ != CanvasFormat::NATIVE)
+    this->ensure_canvas_format_();
+
+  if (buffer_mode_ != BufferMode::SINGLE || pixel_scale_ > 1)
+    this->ensure_back_buffer_(img);
+
+  // Without a back buffer the task draws into the canvas itself, so LVGL must not read it meanwhile
+  if (frame_mutex_ && !back_buffer_ && !draw_lock_hooked_) {
+    lv_obj_add_event_cb(canvas_, &LvglGameRunner::draw_lock_cb_, LV_EVENT_DRAW_MAIN_BEGIN, this);
+    lv_obj_add_event_cb(canvas_, &LvglGameRunner::draw_lock_cb_, LV_EVENT_DRAW_POST_END, this);
+    draw_lock_hooked_ = true;
+  }
+
+#if LVGL_GAME_RUNNER_METRICS
+  if (!profile_hooked_) {
+    lv_obj_add_event_cb(canvas_, &LvglGameRunner::profile_draw_cb_, LV_EVENT_DRAW_POST_END, this);
+    profile_hooked_ = true;
+  }
+#endif
+
+  if (!game_ && factory_) {
+    game_ = factory_->acquire();  // Initial game
+    if (!game_) {
+      ESP_LOGE(TAG, "Not enough memory to construct game '%s'", factory_->get_key());
+      factory_ = nullptr;
+    }
+  }
+
   if (!game_) {
     // Show game menu?
   } else {
+    game_->set_off_lvgl_thread(task_handle_ != nullptr);
+    game_->set_back_buffer(back_buffer_, pixel_scale_);
+#if LVGL_GAME_RUNNER_METRICS
+    game_->set_profiler(&profiler_);
+#endif
     game_->on_bind(canvas_);
-    game_->reset();  // Initialize game state
+    bind_generation_++;
+    game_->seed(this->next_seed_());
+    game_->clear_input();  // A warm spare still holds the buttons it last saw
+    game_->reset();        // Initialize game state
+    sim_step_ = 0;
+    if (recording_active_ || replaying_) {
+      ESP_LOGW(TAG, "Game restarted; stopping input %s", recording_active_ ? "recording" : "replay");
+      if (recording_active_)
+        this->stop_recording();
+      if (replaying_)
+        this->finish_replay_(false);
+    }
   }
 
   this->on_canvas_size_change_();
   return true;
 }
 
+bool LvglGameRunner::ensure_canvas_format_() {
+  lv_img_dsc_t *img = lv_canvas_get_img(canvas_);
+  const uint8_t bpp = static_cast<uint8_t>(canvas_format_);
+  const lv_img_cf_t cf = bpp == 1 ? LV_IMG_CF_INDEXED_1BIT : bpp == 2 ? LV_IMG_CF_INDEXED_2BIT : LV_IMG_CF_INDEXED_4BIT;
+  if (img->header.cf == cf)
+    return true;
+
+  // Packed pixels are small enough for internal RAM, which is much faster to fill than PSRAM
+  const lv_coord_t w = img->header.w;
+  const lv_coord_t h = img->header.h;
+  const size_t bytes = lv_img_buf_get_img_size(w, h, cf);
+  uint8_t *buf = static_cast<uint8_t *>(heap_caps_malloc(bytes, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT));
+  if (!buf)
+    buf = static_cast<uint8_t *>(heap_caps_malloc(bytes, MALLOC_CAP_8BIT));
+  if (!buf) {
+    ESP_LOGW(TAG, "Can't allocate %u byte indexed canvas; keeping the configured format", (unsigned) bytes);
+    canvas_format_ = CanvasFormat::NATIVE;
+    return false;
+  }
+  memset(buf, 0, bytes);
+
+  // Only free a buffer of our own: the canvas widget's original one belongs to whoever set
+  // it up, and nothing says it came from an allocator we could hand it back to
+  lv_canvas_set_buffer(canvas_, buf, w, h, cf);
+  if (canvas_buffer_)
+    heap_caps_free(canvas_buffer_);
+  canvas_buffer_ = buf;
+  canvas_buffer_bytes_ = bytes;
+  ESP_LOGI(TAG, "Canvas is now %u-bit indexed (%u bytes)", (unsigned) bpp, (unsigned) bytes);
+  return true;
+}
+
+bool LvglGameRunner::ensure_back_buffer_(const lv_img_dsc_t *img) {
+  const int n = pixel_scale_;
+  const size_t bytes = lv_img_buf_get_img_size(img->header.w / n, img->header.h / n, img->header.cf);
+  if (back_buffer_ && back_buffer_bytes_ != bytes) {
+    heap_caps_free(back_buffer_);
+    back_buffer_ = nullptr;
+  }
+
+  if (!back_buffer_) {
+    const uint32_t caps =
+        buffer_mode_ == BufferMode::PSRAM ? MALLOC_CAP_SPIRAM : (MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    back_buffer_ = static_cast<uint8_t *>(heap_caps_malloc(bytes, caps));
+    if (!back_buffer_) {
+      ESP_LOGW(TAG, "Can't allocate %u byte back buffer; drawing straight into the canvas%s", (unsigned) bytes,
+               n > 1 ? " at full resolution" : "");
+      buffer_mode_ = BufferMode::SINGLE;
+      pixel_scale_ = 1;
+      return false;
+    }
+    back_buffer_bytes_ = bytes;
+  }
+
+  // Start from what the canvas shows, so areas the game never draws stay intact. A scaled
+  // framebuffer starts blank (games repaint their whole area), apart from the palette.
+  if (n == 1) {
+    memcpy(back_buffer_, img->data, bytes);
+  } else {
+    const uint8_t bpp = pixel_ops::indexed_bpp(img->header.cf);
+    const size_t palette = bpp ? pixel_ops::palette_bytes(bpp) : 0;
+    memcpy(back_buffer_, img->data, palette);
+    memset(back_buffer_ + palette, 0, bytes - palette);
+  }
+  return true;
+}
+
 void LvglGameRunner::process_input_() {
   if (!game_)
     return;
 
   InputEvent event;
   while (input_handler_.pop_event(event)) {
-    game_->on_input(event);
+    if (replaying_)
+      continue;  // Only recorded input during a replay
+#if LVGL_GAME_RUNNER_METRICS
+    if (event.timestamp_us != 0)
+      profiler_.record(Phase::LATENCY, (uint32_t) esp_timer_get_time() - event.timestamp_us);
+#endif
+    this->deliver_input_(event);
+  }
+
+  // Each player's encoder clicks since the last frame arrive as one event carrying the steps
+  for (uint8_t player = 1; player <= InputHandler::MAX_PLAYERS; player++) {
+    const int32_t steps = input_handler_.take_rotation(player);
+    if (steps == 0 || replaying_)
+      continue;
+    const int32_t n = std::min<int32_t>(steps < 0 ? -steps : steps, INT16_MAX);
+    this->deliver_input_(InputEvent(steps > 0 ? InputType::ROTATE_CW : InputType::ROTATE_CCW, player, true, n));
   }
 }
 
-void LvglGameRunner::tick_(float dt) {
+void LvglGameRunner::deliver_input_(const InputEvent &event) {
+  if (driven_) {
+    sim_driver_->on_local_input(event);
+    return;
+  }
+  if (recording_active_ && !recording_.append(sim_step_, event)) {
+    ESP_LOGW(TAG, "Input recording full (%u bytes); stopping", (unsigned) recording_.size());
+    this->stop_recording();
+  }
+  game_->dispatch_input(event);
+}
+
+void LvglGameRunner::step_sim_(Scalar dt) {
+  if (replaying_) {
+    InputEvent event;
+    while (replay_cursor_.next(sim_step_, event))
+      game_->dispatch_input(event);
+    const int64_t t0 = esp_timer_get_time();
+    game_->update(dt);
+    replay_update_us_.record(static_cast<uint32_t>(esp_timer_get_time() - t0));
+  } else {
+    game_->update(dt);
+  }
+  game_->end_input_step();
+  sim_step_++;
+}
+
+// ---- Record / replay ----
+
+uint32_t LvglGameRunner::next_seed_() { return has_seed_ ? seed_ : esp_random(); }
+
+void LvglGameRunner::restart_game_(uint32_t seed) {
+  input_handler_.clear();
+  game_->clear_input();
+  game_->seed(seed);
+  game_->reset();
+  game_->resume();
+  sim_step_ = 0;
+  sim_accum_us_ = 0;
+  last_us_ = esp_timer_get_time();
+}
+
+void LvglGameRunner::start_recording() {
+  if (sim_period_us_ == 0) {
+    ESP_LOGW(TAG, "Input recording needs a fixed simulation_rate");
+    return;
+  }
+  this->lock_frame_();
+  if (!game_ || rebind_ || !running_) {
+    this->unlock_frame_();
+    ESP_LOGW(TAG, "Input recording needs a running game");
+    return;
+  }
+  if (replaying_)
+    this->finish_replay_(false);
+  const uint32_t seed = this->next_seed_();
+  recording_.begin(seed, sim_period_us_);
+  this->restart_game_(seed);
+  recording_active_ = true;
+  this->unlock_frame_();
+  ESP_LOGI(TAG, "Recording input (seed=%u)", (unsigned) seed);
+}
+
+void LvglGameRunner::stop_recording() {
+  // Also called from tick_() with the frame lock held; the flag check keeps this re-entrant
+  if (!recording_active_)
+    return;
+  recording_active_ = false;
+  recording_.finish(sim_step_);
+  ESP_LOGI(TAG, "Recorded %u steps of input in %u bytes", (unsigned) recording_.steps(), (unsigned) recording_.size());
+}
+
+bool LvglGameRunner::load_recording(const uint8_t *data, size_t len) {
+  this->lock_frame_();
+  const bool ok = !recording_active_ && !replaying_ && recording_.load(data, len);
+  this->unlock_frame_();
+  if (!ok)
+    ESP_LOGW(TAG, "Input recording not loaded (invalid, or a recording/replay is active)");
+  return ok;
+}
+
+void LvglGameRunner::start_replay() {
+  this->lock_frame_();
+  if (!game_ || rebind_ || !running_ || recording_.steps() == 0 || recording_.sim_period_us() == 0) {
+    this->unlock_frame_();
+    ESP_LOGW(TAG, "Nothing to replay (needs a finished recording and a running game)");
+    return;
+  }
+  if (recording_active_)
+    this->stop_recording();
+  saved_sim_period_us_ = sim_period_us_;
+  sim_period_us_ = recording_.sim_period_us();
+  this->restart_game_(recording_.seed());
+  replay_cursor_ = InputRecording::Cursor(&recording_);
+  replay_update_us_.reset();
+  replaying_ = true;
+  this->unlock_frame_();
+  ESP_LOGI(TAG, "Replaying %u steps (seed=%u)", (unsigned) recording_.steps(), (unsigned) recording_.seed());
+}
+
+void LvglGameRunner::stop_replay() {
+  this->lock_frame_();
+  if (replaying_)
+    this->finish_replay_(false);
+  this->unlock_frame_();
+}
+
+void LvglGameRunner::finish_replay_(bool completed) {
+  replaying_ = false;
+  sim_period_us_ = saved_sim_period_us_;
+  sim_accum_us_ = 0;
+  if (!completed) {
+    ESP_LOGI(TAG, "Replay stopped at step %u", (unsigned) sim_step_);
+    return;
+  }
+  const LatencyHistogram &h = replay_update_us_;
+  ESP_LOGI(TAG, "Replay done: %u steps, update p50/p95/p99/max=%.3f/%.3f/%.3f/%.3f ms, frame hash=%08x",
+           (unsigned) sim_step_, h.percentile(50) / 1000.0f, h.percentile(95) / 1000.0f, h.percentile(99) / 1000.0f,
+           h.max() / 1000.0f, (unsigned) game_->get_frame_hash());
+}
+
+void LvglGameRunner::tick_(uint64_t elapsed_us) {
   if (rebind_) {
     if (!this->ensure_bound_())
       return;
@@ -189,19 +686,108 @@ void LvglGameRunner::tick_(float dt) {
   if (!game_)
     return;
 
+  // First frame after an idle wait: time the runner chose to skip counts in full, a wait for
+  // input doesn't count at all (nothing was moving)
+  uint32_t idle_credit_us = 0;
+  if (idle_until_us_ == IDLE_FOREVER) {
+    elapsed_us = std::min<uint64_t>(elapsed_us, (uint64_t) period_ms_ * 1000);
+    sim_accum_us_ = 0;
+  } else if (idle_until_us_ != 0) {
+    idle_credit_us = idle_credit_us_;
+  }
+  this->leave_idle_();
+
+#if LVGL_GAME_RUNNER_METRICS
+  const uint64_t frame_start = esp_timer_get_time();
+#endif
+
+  // A simulation driver (netplay) may take over fixed-step frames
+  driven_ = sim_driver_ && sim_period_us_ != 0 && !replaying_ && sim_driver_->begin_frame(game_);
+
   // Process input events first
-  this->process_input_();
+  {
+    auto timer = this->profile_(Phase::INPUT);
+    this->process_input_();
+  }
 
-  // Measure the game step() duration
+  // Measure the game update()/render() duration
 #if LVGL_GAME_RUNNER_METRICS
   const uint64_t t0 = esp_timer_get_time();
 #endif
 
-  game_->step(dt);
+  if (sim_period_us_ == 0) {
+    // Variable step: one update with the measured dt
+    const uint64_t max_dt_us = 100000 + idle_credit_us;  // cap at 100ms past any idle wait
+    const Scalar dt = scalar_ratio(std::min<uint64_t>(elapsed_us, max_dt_us), 1000000);
+    {
+      auto timer = this->profile_(Phase::UPDATE);
+      game_->update(dt);
+      game_->end_input_step();
+    }
+    auto timer = this->profile_(Phase::RENDER);
+    game_->render(Scalar(1));
+  } else {
+    // Fixed step: run as many simulation periods as have elapsed, up to the catch-up cap.
+    // Past the cap the backlog is dropped, so a stall slows the game instead of spiralling.
+    const Scalar sim_dt = scalar_ratio(sim_period_us_, 1000000);
+    sim_accum_us_ += elapsed_us;
+    const uint32_t max_steps = max_catchup_steps_ + idle_credit_us / sim_period_us_;
+    uint32_t steps = 0;
+    {
+      auto timer = this->profile_(Phase::UPDATE);
+      if (driven_) {
+        // The driver decides how many updates the elapsed periods turn into
+        const uint32_t due = std::min<uint64_t>(sim_accum_us_ / sim_period_us_, max_steps);
+        sim_accum_us_ -= (uint64_t) due * sim_period_us_;
+        steps = sim_driver_->advance(game_, sim_dt, due);
+        sim_step_ += steps;
+      } else {
+        while (sim_accum_us_ >= sim_period_us_ && steps < max_steps &&
+               !(replaying_ && sim_step_ >= recording_.steps())) {
+          this->step_sim_(sim_dt);
+          sim_accum_us_ -= sim_period_us_;
+          steps++;
+        }
+      }
+    }
+    if (sim_accum_us_ >= sim_period_us_) {
+      sim_accum_us_ %= sim_period_us_;
+#if LVGL_GAME_RUNNER_METRICS
+      m_.sim_capped++;
+#endif
+    }
+#if LVGL_GAME_RUNNER_METRICS
+    m_.sim_steps += steps;
+#endif
+    // The last frame of a replay is drawn exactly at its final step, so its hash is repeatable
+    const bool replay_done = replaying_ && sim_step_ >= recording_.steps();
+    auto timer = this->profile_(Phase::RENDER);
+    game_->render(replay_done ? Scalar(1) : scalar_ratio(sim_accum_us_, sim_period_us_));
+  }
+
+  // Compose sprites; the damage is pushed to LVGL in one batch per frame, by the main loop
+  // when frames come from the runner task
+  {
+    auto timer = this->profile_(Phase::COMPOSE);
+    game_->finish_frame();
+  }
+  if (frame_sink_) {
+    auto timer = this->profile_(Phase::STREAM);
+    FrameView view;
+    if (game_->get_frame_view(view)) {
+      view.generation = bind_generation_;
+      frame_sink_->on_frame(view);
+    }
+  }
+  if (replaying_ && sim_step_ >= recording_.steps())
+    this->finish_replay_(true);
+
+  this->plan_idle_(esp_timer_get_time());
 
 #if LVGL_GAME_RUNNER_METRICS
   const uint64_t t1 = esp_timer_get_time();
   const uint32_t step_us = static_cast<uint32_t>(t1 - t0);
+  profiler_.record(Phase::FRAME, static_cast<uint32_t>(t1 - frame_start));
 
   // Loop interval (tick-to-tick), using end-of-previous update
   const uint32_t loop_us = static_cast<uint32_t>(t1 - m_.last_tick_us);
@@ -213,21 +799,134 @@ void LvglGameRunner::tick_(float dt) {
   m_.loop_us_sum += loop_us;
   m_.step_us_max = std::max(m_.step_us_max, step_us);
   m_.loop_us_max = std::max(m_.loop_us_max, loop_us);
-  if (step_us / 1000.0f > static_cast<float>(period_ms_))
+  if (step_us > period_ms_ * 1000)
     m_.overruns++;
+#endif
+
+  if (!task_handle_)
+    this->flush_frame_();
+}
+
+// ---- Idle frame skipping ----
+//
+// After each frame the game says how long it will stay static. Rather than ticking at the
+// full rate for nothing, the producer then sleeps: the runner task blocks on its
+// notification with a timeout, the main loop skips frames (or, until input, disables
+// itself). The first push into the input queue wakes it early.
+
+void LvglGameRunner::plan_idle_(uint64_t now_us) {
+  // A driven simulation (netplay) has to keep talking to its peer
+  const uint32_t hint = idle_sleep_ && !replaying_ && !driven_ ? game_->idle_hint_us() : 0;
+  // Anything up to a frame period isn't worth a separate wake-up
+  if (hint <= period_ms_ * 1000) {
+    this->set_cpu_lock_(true);
+    return;
+  }
+  this->set_cpu_lock_(false);
+  if (hint == GameBase::IDLE_UNTIL_INPUT) {
+    idle_until_us_ = IDLE_FOREVER;
+    idle_credit_us_ = 0;
+  } else {
+    idle_until_us_ = now_us + hint;
+    idle_credit_us_ = hint;
+  }
+  // The main loop polls the queue itself during a timed idle
+  if (task_handle_ || idle_until_us_ == IDLE_FOREVER)
+    input_handler_.arm_wake();
+#if LVGL_GAME_RUNNER_METRICS
+  m_.idle_waits++;
+#endif
+}
+
+void LvglGameRunner::leave_idle_() {
+  idle_until_us_ = 0;
+  idle_credit_us_ = 0;
+  input_handler_.disarm_wake();
+}
+
+void LvglGameRunner::wake() {
+  this->lock_frame_();
+  this->leave_idle_();
+  this->unlock_frame_();
+  if (!running_)
+    return;
+  this->enable_loop();
+  if (task_handle_)
+    xTaskNotifyGive(task_handle_);
+}
+
+void LvglGameRunner::input_wake_cb_(void *arg) {
+  auto *self = static_cast<LvglGameRunner *>(arg);
+  if (self->task_handle_) {
+    if (xPortInIsrContext()) {
+      BaseType_t woken = pdFALSE;
+      vTaskNotifyGiveFromISR(self->task_handle_, &woken);
+      portYIELD_FROM_ISR(woken);
+    } else {
+      xTaskNotifyGive(self->task_handle_);
+    }
+  } else {
+#if ESPHOME_VERSION_CODE >= VERSION_CODE(2025, 7, 0)
+    self->enable_loop_soon_any_context();
+#endif
+  }
+}
 
-  // Periodic log/roll
-  if (t1 - m_.window_start_us >= (uint64_t) METRICS_PERIOD_MS * 1000ULL) {
-    metrics_log_and_roll_(t1);
+void LvglGameRunner::set_cpu_lock_(bool held) {
+#ifdef CONFIG_PM_ENABLE
+  if (!pm_lock_ || held == cpu_lock_held_)
+    return;
+  if (held) {
+    esp_pm_lock_acquire(pm_lock_);
+  } else {
+    esp_pm_lock_release(pm_lock_);
   }
 #endif
+  cpu_lock_held_ = held;
 }
 
 void LvglGameRunner::dump_config() {
   uint16_t cw = 0, ch = 0;
   read_canvas_size_(cw, ch);
-  ESP_LOGCONFIG(TAG, "LvglGameRunner(%p): game='%s' canvas=%ux%u period=%ums running=%s", this, game_key_.c_str(), cw,
-                ch, period_ms_, running_ ? "true" : "false");
+  ESP_LOGCONFIG(TAG, "LvglGameRunner(%p): game='%s' canvas=%ux%u period=%ums running=%s", this,
+                factory_ ? factory_->get_key() : "", cw, ch, period_ms_, running_ ? "true" : "false");
+  ESP_LOGCONFIG(TAG, "Games: %u registered, keep previous: %s%s%s", (unsigned) GameRegistry::size(),
+                keep_previous_game_ ? "yes" : "no", warm_ ? ", warm: " : "", warm_ ? warm_->get_key() : "");
+  if (sim_period_us_ > 0) {
+    ESP_LOGCONFIG(TAG, "Simulation: fixed %.1f Hz, max %u catch-up steps", 1e6f / sim_period_us_,
+                  (unsigned) max_catchup_steps_);
+  } else {
+    ESP_LOGCONFIG(TAG, "Simulation: variable step (one update per frame)");
+  }
+  if (task_handle_) {
+    ESP_LOGCONFIG(TAG, "Runner task: core=%d priority=%u stack=%u", (int) task_core_, (unsigned) task_priority_,
+                  (unsigned) task_stack_size_);
+  } else {
+    ESP_LOGCONFIG(TAG, "Runner task: none (frames run from the main loop)");
+  }
+  if (pixel_scale_ > 1) {
+    ESP_LOGCONFIG(TAG, "Pixel scale: %ux (game area %ux%u)", (unsigned) pixel_scale_, (unsigned) (cw / pixel_scale_),
+                  (unsigned) (ch / pixel_scale_));
+  }
+  if (canvas_format_ != CanvasFormat::NATIVE) {
+    ESP_LOGCONFIG(TAG, "Canvas format: %u-bit indexed%s", (unsigned) canvas_format_,
+                  canvas_buffer_ ? "" : " (pending, not bound yet)");
+  }
+  if (back_buffer_) {
+    ESP_LOGCONFIG(TAG, "Double buffer: %s, %u bytes", buffer_mode_ == BufferMode::PSRAM ? "PSRAM" : "internal",
+                  (unsigned) back_buffer_bytes_);
+  } else {
+    ESP_LOGCONFIG(TAG, "Double buffer: %s", buffer_mode_ == BufferMode::SINGLE ? "off" : "pending (not bound yet)");
+  }
+#ifdef CONFIG_PM_ENABLE
+  const bool cpu_lock = pm_lock_ != nullptr;
+#else
+  const bool cpu_lock = false;
+#endif
+  ESP_LOGCONFIG(TAG, "Idle sleep: %s, CPU frequency lock: %s", idle_sleep_ ? "on" : "off", cpu_lock ? "on" : "off");
+  ESP_LOGCONFIG(TAG, "Input queue: %s, capacity=%u, dropped=%u",
+                LVGL_GAME_RUNNER_INPUT_MPSC ? "multi-producer" : "single-producer",
+                (unsigned) InputHandler::MAX_QUEUE_SIZE, input_handler_.get_dropped_count());
 #if LVGL_GAME_RUNNER_METRICS
   ESP_LOGCONFIG(TAG, "Metrics: enabled (period=%ums)", METRICS_PERIOD_MS);
 #else
@@ -236,9 +935,24 @@ void LvglGameRunner::dump_config() {
 }
 
 #if LVGL_GAME_RUNNER_METRICS
+void LvglGameRunner::profile_draw_cb_(lv_event_t *e) {
+  auto *self = static_cast<LvglGameRunner *>(lv_event_get_user_data(e));
+  if (self->lvgl_pending_since_us_ == 0)
+    return;
+  self->profiler_.record(Phase::LVGL, static_cast<uint32_t>(esp_timer_get_time() - self->lvgl_pending_since_us_));
+  self->lvgl_pending_since_us_ = 0;
+}
+
+void LvglGameRunner::metrics_poll_() {
+  const uint64_t now = esp_timer_get_time();
+  if (now - m_.window_start_us >= (uint64_t) METRICS_PERIOD_MS * 1000ULL)
+    this->metrics_log_and_roll_(now);
+}
+
 void LvglGameRunner::metrics_log_and_roll_(uint64_t now_us) {
   if (m_.frames == 0) {
     m_.window_start_us = now_us;
+    profiler_.reset();
     return;
   }
   const double win_s = (now_us - m_.window_start_us) / 1e6;
@@ -247,11 +961,39 @@ void LvglGameRunner::metrics_log_and_roll_(uint64_t now_us) {
   const double avg_step_ms = (m_.step_us_sum / 1000.0) / m_.frames;
   const double avg_loop_ms = (m_.loop_us_sum / 1000.0) / m_.frames;
 
+  const uint32_t input_dropped = input_handler_.get_dropped_count();
+
   ESP_LOGD(TAG,
            "[metrics] eff=%.2ffps tgt=%.2ffps frames=%u "
-           "step(avg/max)=%.3f/%.3f ms loop(avg/max)=%.3f/%.3f ms overruns=%u",
+           "step(avg/max)=%.3f/%.3f ms loop(avg/max)=%.3f/%.3f ms overruns=%u input_dropped=%u "
+           "sim_steps=%u sim_capped=%u idle_waits=%u",
            effective_fps, target_fps, m_.frames, avg_step_ms, m_.step_us_max / 1000.0, avg_loop_ms,
-           m_.loop_us_max / 1000.0, m_.overruns);
+           m_.loop_us_max / 1000.0, m_.overruns, input_dropped - m_.input_dropped_base, m_.sim_steps,
+           m_.sim_capped, m_.idle_waits);
+
+  // Where the time went: p50/p95/p99 per phase
+  const std::string profile = profiler_.summary();
+  ESP_LOGD(TAG, "[profile] %s ms", profile.c_str());
+
+#ifdef USE_SENSOR
+  const LatencyHistogram &frame = profiler_.get(Phase::FRAME);
+  if (fps_sensor_)
+    fps_sensor_->publish_state(effective_fps);
+  if (frame_p50_sensor_)
+    frame_p50_sensor_->publish_state(frame.percentile(50) / 1000.0f);
+  if (frame_p95_sensor_)
+    frame_p95_sensor_->publish_state(frame.percentile(95) / 1000.0f);
+  if (frame_p99_sensor_)
+    frame_p99_sensor_->publish_state(frame.percentile(99) / 1000.0f);
+  if (lvgl_p95_sensor_ && profiler_.get(Phase::LVGL).count() > 0)
+    lvgl_p95_sensor_->publish_state(profiler_.get(Phase::LVGL).percentile(95) / 1000.0f);
+  if (input_latency_p95_sensor_ && profiler_.get(Phase::LATENCY).count() > 0)
+    input_latency_p95_sensor_->publish_state(profiler_.get(Phase::LATENCY).percentile(95) / 1000.0f);
+#endif
+#ifdef USE_TEXT_SENSOR
+  if (profile_text_sensor_)
+    profile_text_sensor_->publish_state(profile);
+#endif
 
   // Roll the window
   m_.window_start_us = now_us;
@@ -261,6 +1003,11 @@ void LvglGameRunner::metrics_log_and_roll_(uint64_t now_us) {
   m_.loop_us_sum = 0;
   m_.loop_us_max = 0;
   m_.overruns = 0;
+  m_.sim_steps = 0;
+  m_.sim_capped = 0;
+  m_.idle_waits = 0;
+  m_.input_dropped_base = input_dropped;
+  profiler_.reset();
 }
 #endif
 
@@ -9,25 +9,46 @@
 #include "esphome/core/log.h"
 #include "esphome/core/version.h"
 
+#include <atomic>
 #include <memory>
 #include <string>
 
+#include "frame_profiler.h"
+#include "frame_sink.h"
 #include "game_base.h"
 #include "game_registry.h"
 #include "input_handler.h"
+#include "input_recording.h"
+#include "sim_driver.h"
+
+#ifdef USE_SENSOR
+#include "esphome/components/sensor/sensor.h"
+#endif
+#ifdef USE_TEXT_SENSOR
+#include "esphome/components/text_sensor/text_sensor.h"
+#endif
+
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include <freertos/task.h>
+#include "esp_pm.h"
 
 extern "C" {
 #include <lvgl.h>
 }
 
-#ifndef LVGL_GAME_RUNNER_METRICS
-#define LVGL_GAME_RUNNER_METRICS 1
-#endif
-
 namespace esphome::lvgl_game_runner {
 
 class LvglGameRunner : public Component {
  public:
+  // Where the game draws: straight into the canvas, or into a back buffer whose damaged
+  // areas are copied to the canvas each frame
+  enum class BufferMode : uint8_t { SINGLE, PSRAM, INTERNAL };
+
+  // Canvas pixel format: as configured, or replaced at bind by an indexed buffer with this
+  // many bits per pixel (LV_IMG_CF_INDEXED_1/2/4BIT) for games with few colors
+  enum class CanvasFormat : uint8_t { NATIVE = 0, INDEXED_1BIT = 1, INDEXED_2BIT = 2, INDEXED_4BIT = 4 };
+
   // Lifecycle
   void setup() override;
   void loop() override;
@@ -35,7 +56,7 @@ class LvglGameRunner : public Component {
   float get_setup_priority() const override { return setup_priority::BEFORE_CONNECTION; }
 
   // Codegen wiring
-  void setup_binding(lv_obj_t *canvas_obj, GameBase *initial_game, bool start_paused);
+  void setup_binding(lv_obj_t *canvas_obj, GameFactory *initial_game, bool start_paused);
 
   // Runtime control
   void start();  // Start/restart current game
@@ -52,7 +73,84 @@ class LvglGameRunner : public Component {
   // Per-instance timing
   void set_initial_period(uint32_t ms) { period_ms_ = ms; }
   void set_fps(float fps);
-  void set_game(GameBase *game);
+  // Switch games. The new game is constructed now and the previous one destroyed, unless
+  // keep_previous_game holds it as a warm spare (one at a time) for switching back.
+  void set_game(GameFactory *factory);
+  void set_game(const char *key);  // Registry lookup
+  void set_keep_previous_game(bool keep) { keep_previous_game_ = keep; }
+
+  // Fixed-step simulation: update() runs at `hz` regardless of the frame rate (0 = one
+  // variable-length update per frame). At most `steps` updates run per frame to catch up.
+  void set_simulation_rate(float hz);
+  void set_max_catchup_steps(uint8_t steps) { max_catchup_steps_ = steps > 0 ? steps : 1; }
+
+  uint32_t get_simulation_period_us() const { return sim_period_us_; }
+
+  // Let `driver` run the fixed-step simulation on the frames it asks for (see SimDriver)
+  void set_sim_driver(SimDriver *driver) { sim_driver_ = driver; }
+
+  // Hand every finished frame to `sink` (see FrameSink)
+  void set_frame_sink(FrameSink *sink) { frame_sink_ = sink; }
+
+  // Restart the current game with `seed`, as a replay start does. Frame context only (a
+  // SimDriver's begin_frame()).
+  void restart_game(uint32_t seed) { this->restart_game_(seed); }
+
+  GameBase *get_game() const { return game_; }
+  const char *get_game_key() const { return factory_ ? factory_->get_key() : ""; }
+
+  // Run the next frame on schedule even if the game is idle (main loop only)
+  void wake();
+
+  // Run frames in a dedicated FreeRTOS task instead of loop() (core < 0 = no affinity).
+  // LVGL work (binding, invalidation) stays on the main loop; see task_loop_().
+  void set_task_config(int8_t core, uint8_t priority, uint32_t stack_size);
+
+  void set_buffer_mode(BufferMode mode) { buffer_mode_ = mode; }
+  void set_canvas_format(CanvasFormat format) { canvas_format_ = format; }
+
+  // Game pixels are scale x scale canvas pixels: the game draws into a (canvas / scale)
+  // framebuffer whose damaged areas are upscaled into the canvas (this uses the back buffer)
+  void set_pixel_scale(uint8_t scale) { pixel_scale_ = scale > 0 ? scale : 1; }
+
+  // Skip frames while the game reports nothing will change (see GameBase::idle_hint_us()):
+  // sleep until its next scheduled change, or until input for a static screen
+  void set_idle_sleep(bool enable) { idle_sleep_ = enable; }
+
+  // Hold an esp_pm CPU_FREQ_MAX lock while frames run at the full rate, releasing it when
+  // idle or paused so dynamic frequency scaling can clock down (needs CONFIG_PM_ENABLE)
+  void set_cpu_frequency_lock(bool enable) { cpu_lock_wanted_ = enable; }
+
+  // Game RNG seed used at every (re)start; random per start unless set
+  void set_seed(uint32_t seed) {
+    seed_ = seed;
+    has_seed_ = true;
+  }
+
+  // Input record/replay (needs a fixed simulation rate). Starting either one restarts the game
+  // with a known seed; a replay then feeds the recorded input into the same simulation steps,
+  // ignores live input, and logs per-step update times and a hash of the final frame.
+  void start_recording();
+  void stop_recording();
+  void start_replay();
+  void stop_replay();
+  bool is_recording() const { return recording_active_; }
+  bool is_replaying() const { return replaying_; }
+  const InputRecording &get_recording() const { return recording_; }
+  bool load_recording(const uint8_t *data, size_t len);
+
+  // Profiler entities, published every metrics window (needs LVGL_GAME_RUNNER_METRICS)
+#ifdef USE_SENSOR
+  void set_fps_sensor(sensor::Sensor *s) { fps_sensor_ = s; }
+  void set_frame_time_p50_sensor(sensor::Sensor *s) { frame_p50_sensor_ = s; }
+  void set_frame_time_p95_sensor(sensor::Sensor *s) { frame_p95_sensor_ = s; }
+  void set_frame_time_p99_sensor(sensor::Sensor *s) { frame_p99_sensor_ = s; }
+  void set_lvgl_latency_p95_sensor(sensor::Sensor *s) { lvgl_p95_sensor_ = s; }
+  void set_input_latency_p95_sensor(sensor::Sensor *s) { input_latency_p95_sensor_ = s; }
+#endif
+#ifdef USE_TEXT_SENSOR
+  void set_profile_text_sensor(text_sensor::TextSensor *s) { profile_text_sensor_ = s; }
+#endif
 
  protected:
   struct Area {
@@ -60,25 +158,126 @@ class LvglGameRunner : public Component {
   };
 
   bool ensure_bound_();
+  bool ensure_back_buffer_(const lv_img_dsc_t *img);
+  bool ensure_canvas_format_();
   bool read_canvas_size_(uint16_t &w, uint16_t &h);
   void on_canvas_size_change_();
-  void tick_(float dt);   // Execute one frame update
+  void tick_(uint64_t elapsed_us);  // Execute one frame update
   void process_input_();  // Process queued input events
+  void deliver_input_(const InputEvent &event);  // Record (if recording) and hand to the game
+  void step_sim_(Scalar dt);  // One update(), with replayed input
+  void restart_game_(uint32_t seed);
+  void finish_replay_(bool completed);
+  uint32_t next_seed_();
+
+  // Idle frame skipping
+  static constexpr uint64_t IDLE_FOREVER = UINT64_MAX;  // idle_until_us_: until input
+  void plan_idle_(uint64_t now_us);  // After a frame: ask the game how long it stays static
+  bool idle_(uint64_t now_us) const {
+    return idle_until_us_ != 0 && now_us < idle_until_us_ && !input_handler_.has_events();
+  }
+  void leave_idle_();  // Frame lock held; the next frame runs whenever it normally would
+  static void input_wake_cb_(void *arg);
+  void set_cpu_lock_(bool held);
+
+  // Runner task
+  static void task_entry_(void *arg);
+  void task_loop_();
+  void service_task_();  // Main loop side: bind and push finished frames to LVGL
+  void lock_frame_();
+  bool try_lock_frame_();  // Without waiting; false if the task is mid-frame
+  void unlock_frame_();
+  static void draw_lock_cb_(lv_event_t *e);
+
+  bool flush_frame_();  // Push finished frames to LVGL (LVGL thread)
 
   // Bound canvas & game
   lv_obj_t *canvas_{nullptr};
-  std::string game_key_;
-  GameBase *game_{nullptr};  // Raw pointer - game lifetime managed by components
+  GameFactory *factory_{nullptr};  // Current game; its instance is game_ once bound
+  GameBase *game_{nullptr};        // Owned by factory_ (acquired from it)
+  GameFactory *warm_{nullptr};     // Previous game, still acquired (keep_previous_game)
+  bool keep_previous_game_{false};
   InputHandler input_handler_;
 
   // State
-  bool running_{true};
+  std::atomic<bool> running_{true};  // Also read by the runner task outside frame_mutex_
   bool rebind_{false};
 
   // Timing
   uint32_t period_ms_{33};  // ~30 FPS default
   uint64_t last_us_{0};
 
+  // Fixed-step simulation (sim_period_us_ == 0 means variable step)
+  uint32_t sim_period_us_{0};
+  uint8_t max_catchup_steps_{4};
+  uint64_t sim_accum_us_{0};
+  uint32_t sim_step_{0};  // Fixed-step updates since the last restart (record/replay clock)
+
+  // Seeding and record/replay
+  uint32_t seed_{0};
+  bool has_seed_{false};
+  InputRecording recording_;
+  InputRecording::Cursor replay_cursor_;
+  bool recording_active_{false};
+  bool replaying_{false};
+  uint32_t saved_sim_period_us_{0};  // Restored after a replay
+  LatencyHistogram replay_update_us_;
+
+  // External simulation driver (netplay); driven_ while it runs the current frame
+  SimDriver *sim_driver_{nullptr};
+  bool driven_{false};
+
+  // External frame consumer (frame_stream)
+  FrameSink *frame_sink_{nullptr};
+  uint32_t bind_generation_{0};  // Bumped by every game bind (see FrameView::generation)
+
+  // Runner task (task_handle_ == nullptr means frames run from loop())
+  bool use_task_{false};
+  int8_t task_core_{1};
+  uint8_t task_priority_{5};
+  uint32_t task_stack_size_{8192};
+  TaskHandle_t task_handle_{nullptr};
+  SemaphoreHandle_t frame_mutex_{nullptr};  // Held while a frame is produced or LVGL draws the canvas
+  bool draw_lock_hooked_{false};
+  bool draw_locked_{false};    // LVGL holds frame_mutex_ for the draw in progress
+  bool redraw_canvas_{false};  // LVGL drew without the lock; draw the canvas again
+  // A frame was pushed to LVGL but not drawn yet; the task waits (up to a period) before
+  // drawing over it, so LVGL's draw lock never has to wait for a whole frame
+  std::atomic<bool> draw_pending_{false};
+
+  // Idle frame skipping (touched by the frame producer only, or under the frame lock)
+  bool idle_sleep_{true};
+  uint64_t idle_until_us_{0};   // No frames before this unless input arrives (0 = not idle)
+  uint32_t idle_credit_us_{0};  // Length of a timed idle; the next update may catch it all up
+  bool cpu_lock_wanted_{false};
+  bool cpu_lock_held_{false};
+#ifdef CONFIG_PM_ENABLE
+  esp_pm_lock_handle_t pm_lock_{nullptr};
+#endif
+
+  // Double buffering
+  BufferMode buffer_mode_{BufferMode::SINGLE};
+  uint8_t *back_buffer_{nullptr};
+  size_t back_buffer_bytes_{0};
+  uint8_t pixel_scale_{1};  // See set_pixel_scale()
+
+  // Indexed canvas buffer (see set_canvas_format)
+  CanvasFormat canvas_format_{CanvasFormat::NATIVE};
+  uint8_t *canvas_buffer_{nullptr};
+  size_t canvas_buffer_bytes_{0};
+
+#ifdef USE_SENSOR
+  sensor::Sensor *fps_sensor_{nullptr};
+  sensor::Sensor *frame_p50_sensor_{nullptr};
+  sensor::Sensor *frame_p95_sensor_{nullptr};
+  sensor::Sensor *frame_p99_sensor_{nullptr};
+  sensor::Sensor *lvgl_p95_sensor_{nullptr};
+  sensor::Sensor *input_latency_p95_sensor_{nullptr};
+#endif
+#ifdef USE_TEXT_SENSOR
+  text_sensor::TextSensor *profile_text_sensor_{nullptr};
+#endif
+
 #if LVGL_GAME_RUNNER_METRICS
   // ---- Metrics window (printed every ~5s) ----
   struct {
@@ -90,10 +289,24 @@ class LvglGameRunner : public Component {
     uint64_t loop_us_sum{0};
     uint32_t loop_us_max{0};
     uint32_t overruns{0};
+    uint32_t sim_steps{0};           // Fixed-step updates run
+    uint32_t sim_capped{0};          // Frames that hit max_catchup_steps and dropped time
+    uint32_t idle_waits{0};          // Frames after which the runner slept (idle game)
+    uint32_t input_dropped_base{0};  // InputHandler drop count at window start
   } m_{};
 
   static constexpr uint32_t METRICS_PERIOD_MS = 5000;
+  void metrics_poll_();  // Log/publish and roll once the window is over (main loop)
   void metrics_log_and_roll_(uint64_t now_us);
+
+  // Per-phase histograms; LVGL latency runs from invalidation to the canvas' DRAW_POST_END
+  FrameProfiler profiler_;
+  uint64_t lvgl_pending_since_us_{0};
+  bool profile_hooked_{false};
+  static void profile_draw_cb_(lv_event_t *e);
+  ProfileScope profile_(FrameProfiler::Phase phase) { return profiler_.scope(phase); }
+#else
+  ProfileScope profile_(FrameProfiler::Phase /*phase*/) { return ProfileScope(); }
 #endif
 };
 
@@ -119,6 +332,26 @@ class ToggleAction : public Action<>, public Parented<LvglGameRunner> {
   void play() override { this->parent_->toggle(); }
 };
 
+class StartRecordingAction : public Action<>, public Parented<LvglGameRunner> {
+ public:
+  void play() override { this->parent_->start_recording(); }
+};
+
+class StopRecordingAction : public Action<>, public Parented<LvglGameRunner> {
+ public:
+  void play() override { this->parent_->stop_recording(); }
+};
+
+class ReplayAction : public Action<>, public Parented<LvglGameRunner> {
+ public:
+  void play() override { this->parent_->start_replay(); }
+};
+
+class StopReplayAction : public Action<>, public Parented<LvglGameRunner> {
+ public:
+  void play() override { this->parent_->stop_replay(); }
+};
+
 template<typename... Ts> class SetFpsAction : public Action<Ts...>, public Parented<LvglGameRunner> {
  public:
   TEMPLATABLE_VALUE(float, fps);
@@ -127,14 +360,19 @@ template<typename... Ts> class SetFpsAction : public Action<Ts...>, public Paren
 
 template<typename... Ts> class SetGameAction : public Action<Ts...>, public Parented<LvglGameRunner> {
  public:
-  TEMPLATABLE_VALUE(GameBase *, game);
+  TEMPLATABLE_VALUE(GameFactory *, game);
+  TEMPLATABLE_VALUE(std::string, game_key);  // Registry key instead, e.g. from a lambda
 
 #if ESPHOME_VERSION_CODE >= VERSION_CODE(2025, 11, 0)
   void play(const Ts &...x) override {
 #else
   void play(Ts... x) override {
 #endif
-    GameBase *game = this->game_.value(x...);
+    if (this->game_key_.has_value()) {
+      this->parent_->set_game(this->game_key_.value(x...).c_str());
+      return;
+    }
+    GameFactory *game = this->game_.value(x...);
     if (game != nullptr)
       this->parent_->set_game(game);
   }
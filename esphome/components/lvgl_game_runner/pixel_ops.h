@@ -0,0 +1,300 @@
+// © Copyright 2025 Stuart Parmenter
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <lvgl.h>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+namespace esphome::lvgl_game_runner {
+
+/**
+ * Span kernels for the canvas buffer.
+ *
+ * These are the inner loops behind GameBase's fill/blit helpers: callers clip first, so
+ * the kernels never bounds-check. With 16-bit color two pixels are written per 32-bit
+ * store (unrolled), and colors whose two bytes are equal (black, white, ...) go through
+ * memset / memcpy, which the IDF provides as optimized ROM routines.
+ */
+namespace pixel_ops {
+
+// Word stores into an lv_color_t buffer; may_alias keeps them legal under strict aliasing
+typedef uint32_t __attribute__((__may_alias__)) word_alias_t;
+typedef uint16_t __attribute__((__may_alias__)) half_alias_t;
+
+/**
+ * Fill n pixels starting at dst with color.
+ */
+inline void fill_span(lv_color_t *dst, size_t n, lv_color_t color) {
+#if LV_COLOR_DEPTH == 16
+  const uint16_t c = color.full;
+  if ((c >> 8) == (c & 0xFF)) {
+    memset(dst, c & 0xFF, n * sizeof(lv_color_t));
+    return;
+  }
+
+  half_alias_t *p = reinterpret_cast<half_alias_t *>(dst);
+  if (n > 0 && (reinterpret_cast<uintptr_t>(p) & 2)) {
+    *p++ = c;  // Align to a word boundary
+    n--;
+  }
+
+  word_alias_t *w = reinterpret_cast<word_alias_t *>(p);
+  const uint32_t c2 = ((uint32_t) c << 16) | c;
+  size_t words = n >> 1;
+  for (; words >= 4; words -= 4) {
+    w[0] = c2;
+    w[1] = c2;
+    w[2] = c2;
+    w[3] = c2;
+    w += 4;
+  }
+  while (words--)
+    *w++ = c2;
+
+  if (n & 1)
+    *reinterpret_cast<half_alias_t *>(w) = c;
+#else
+  std::fill_n(dst, n, color);
+#endif
+}
+
+/**
+ * Fill a w x h rectangle whose first pixel is dst, in a buffer `stride` pixels wide.
+ * Rows that span the full stride are filled as one contiguous run.
+ */
+inline void fill_rect(lv_color_t *dst, int stride, int w, int h, lv_color_t color) {
+  if (w == stride) {
+    fill_span(dst, (size_t) w * h, color);
+    return;
+  }
+  for (int y = 0; y < h; y++, dst += stride)
+    fill_span(dst, w, color);
+}
+
+/**
+ * Copy a w x h rectangle between buffers with the given strides (in pixels).
+ */
+inline void copy_rect(lv_color_t *dst, int dst_stride, const lv_color_t *src, int src_stride, int w, int h) {
+  if (w == dst_stride && w == src_stride) {
+    memcpy(dst, src, (size_t) w * h * sizeof(lv_color_t));
+    return;
+  }
+  for (int y = 0; y < h; y++, dst += dst_stride, src += src_stride)
+    memcpy(dst, src, (size_t) w * sizeof(lv_color_t));
+}
+
+/**
+ * Write each of the w source pixels n times.
+ */
+inline void upscale_row(lv_color_t *dst, const lv_color_t *src, int w, int n) {
+#if LV_COLOR_DEPTH == 16
+  if (n == 2 && (reinterpret_cast<uintptr_t>(dst) & 2) == 0) {
+    word_alias_t *p = reinterpret_cast<word_alias_t *>(dst);
+    for (int x = 0; x < w; x++) {
+      const uint32_t c = src[x].full;
+      p[x] = (c << 16) | c;
+    }
+    return;
+  }
+#endif
+  for (int x = 0; x < w; x++) {
+    const lv_color_t c = src[x];
+    for (int k = 0; k < n; k++)
+      *dst++ = c;
+  }
+}
+
+/**
+ * Nearest-neighbour upscale by n: each pixel of the w x h source rectangle becomes an n x n
+ * block at dst. Each block row is built once and copied to the n - 1 rows below it.
+ */
+inline void upscale_rect(lv_color_t *dst, int dst_stride, const lv_color_t *src, int src_stride, int w, int h, int n) {
+  for (int y = 0; y < h; y++, src += src_stride) {
+    const lv_color_t *row = dst;
+    upscale_row(dst, src, w, n);
+    dst += dst_stride;
+    for (int k = 1; k < n; k++, dst += dst_stride)
+      memcpy(dst, row, (size_t) w * n * sizeof(lv_color_t));
+  }
+}
+
+/**
+ * Draw the set bits of one 1-bit row (MSB first) into dst.
+ * `bit` is the index of the first source bit; `n` pixels are written. All-clear bytes are
+ * skipped and all-set bytes filled without testing each bit.
+ */
+inline void mono_span(lv_color_t *dst, const uint8_t *bits, int bit, int n, lv_color_t color) {
+  int i = 0;
+  while (i < n) {
+    const int b = bit + i;
+    const uint8_t byte = bits[b >> 3];
+    if ((b & 7) == 0 && n - i >= 8) {
+      if (byte == 0xFF) {
+        fill_span(&dst[i], 8, color);
+      } else if (byte != 0) {
+        for (int k = 0; k < 8; k++) {
+          if (byte & (0x80 >> k))
+            dst[i + k] = color;
+        }
+      }
+      i += 8;
+      continue;
+    }
+    if (byte & (0x80 >> (b & 7)))
+      dst[i] = color;
+    i++;
+  }
+}
+
+/*
+ * Indexed canvases (LV_IMG_CF_INDEXED_1/2/4BIT): a palette of (1 << bpp) lv_color32_t
+ * entries, then rows of `bpp`-bit palette indices packed MSB first. The kernels below take
+ * a row's first byte and x in pixels; the longest runs go through memset.
+ */
+
+/**
+ * Bits per pixel of an indexed format the kernels handle (1, 2 or 4), or 0 for any other format.
+ */
+inline uint8_t indexed_bpp(uint8_t cf) {
+  switch (cf) {
+    case LV_IMG_CF_INDEXED_1BIT:
+      return 1;
+    case LV_IMG_CF_INDEXED_2BIT:
+      return 2;
+    case LV_IMG_CF_INDEXED_4BIT:
+      return 4;
+    default:
+      return 0;
+  }
+}
+
+inline size_t palette_bytes(int bpp) { return ((size_t) 1 << bpp) * sizeof(lv_color32_t); }
+
+// `index` repeated across a whole byte
+inline uint8_t index_pattern(uint8_t index, int bpp) {
+  index &= (1 << bpp) - 1;
+  return bpp == 1 ? (index ? 0xFF : 0x00) : bpp == 2 ? index * 0x55 : index * 0x11;
+}
+
+inline void set_index(uint8_t *row, int x, int bpp, uint8_t index) {
+  const int bit = x * bpp;
+  const int shift = 8 - bpp - (bit & 7);
+  const uint8_t mask = (uint8_t) (((1 << bpp) - 1) << shift);
+  uint8_t &b = row[bit >> 3];
+  b = (uint8_t) ((b & ~mask) | ((index << shift) & mask));
+}
+
+inline uint8_t get_index(const uint8_t *row, int x, int bpp) {
+  const int bit = x * bpp;
+  return (row[bit >> 3] >> (8 - bpp - (bit & 7))) & ((1 << bpp) - 1);
+}
+
+/**
+ * Set n pixels of a row, starting at pixel x, to `index`.
+ */
+inline void fill_index_span(uint8_t *row, int x, int n, int bpp, uint8_t index) {
+  const uint8_t pattern = index_pattern(index, bpp);
+  int bit = x * bpp;
+  const int end = (x + n) * bpp;
+  if (bit & 7) {
+    // Leading partial byte
+    const int base = bit & ~7;
+    const int stop = std::min(end, base + 8);
+    const uint8_t mask = (uint8_t) ((0xFF >> (bit - base)) & ~(0xFF >> (stop - base)));
+    uint8_t &b = row[bit >> 3];
+    b = (uint8_t) ((b & ~mask) | (pattern & mask));
+    bit = stop;
+  }
+  const int full = (end - bit) >> 3;
+  if (full > 0) {
+    memset(&row[bit >> 3], pattern, full);
+    bit += full * 8;
+  }
+  if (bit < end) {
+    const uint8_t mask = (uint8_t) ~(0xFF >> (end - bit));
+    uint8_t &b = row[bit >> 3];
+    b = (uint8_t) ((b & ~mask) | (pattern & mask));
+  }
+}
+
+/**
+ * Fill a w x h rectangle at pixel x of `row` and the rows below it, `stride` bytes apart.
+ * Rectangles covering whole rows are filled as one run.
+ */
+inline void fill_index_rect(uint8_t *row, int stride, int x, int w, int h, int bpp, uint8_t index) {
+  if (x == 0 && w * bpp == stride * 8) {
+    memset(row, index_pattern(index, bpp), (size_t) stride * h);
+    return;
+  }
+  for (int y = 0; y < h; y++, row += stride)
+    fill_index_span(row, x, w, bpp, index);
+}
+
+/**
+ * Copy a w x h rectangle between two indexed buffers of the same layout. Whole bytes are
+ * copied, so pixels sharing the rectangle's edge bytes come along.
+ */
+inline void copy_index_rect(uint8_t *dst, const uint8_t *src, int stride, int x, int w, int h, int bpp) {
+  const int first = (x * bpp) >> 3;
+  const int last = ((x + w) * bpp + 7) >> 3;
+  if (first == 0 && last == stride) {
+    memcpy(dst, src, (size_t) stride * h);
+    return;
+  }
+  for (int y = 0; y < h; y++, dst += stride, src += stride)
+    memcpy(&dst[first], &src[first], last - first);
+}
+
+/**
+ * upscale_rect() for indexed buffers: the w x h rectangle at pixel src_x of `src` (and the
+ * rows below, src_stride bytes apart) becomes n x n blocks from pixel dst_x of `dst`.
+ * Block rows are copied as whole bytes; neighbours sharing the edge bytes are unchanged,
+ * since all n rows of an upscaled block row are identical.
+ */
+inline void upscale_index_rect(uint8_t *dst, int dst_stride, int dst_x, const uint8_t *src, int src_stride, int src_x,
+                               int w, int h, int bpp, int n) {
+  const int first = (dst_x * bpp) >> 3;
+  const int last = ((dst_x + w * n) * bpp + 7) >> 3;
+  for (int y = 0; y < h; y++, src += src_stride) {
+    const uint8_t *row = dst;
+    for (int x = 0; x < w; x++)
+      fill_index_span(dst, dst_x + x * n, n, bpp, get_index(src, src_x + x, bpp));
+    dst += dst_stride;
+    for (int k = 1; k < n; k++, dst += dst_stride)
+      memcpy(&dst[first], &row[first], last - first);
+  }
+}
+
+/**
+ * mono_span() for indexed rows: set pixels x.. of `row` to `index` where the 1-bit source
+ * row has bits set.
+ */
+inline void mono_index_span(uint8_t *row, int x, const uint8_t *bits, int bit, int n, int bpp, uint8_t index) {
+  int i = 0;
+  while (i < n) {
+    const int b = bit + i;
+    const uint8_t byte = bits[b >> 3];
+    if ((b & 7) == 0 && n - i >= 8) {
+      if (byte == 0xFF) {
+        fill_index_span(row, x + i, 8, bpp, index);
+      } else if (byte != 0) {
+        for (int k = 0; k < 8; k++) {
+          if (byte & (0x80 >> k))
+            set_index(row, x + i + k, bpp, index);
+        }
+      }
+      i += 8;
+      continue;
+    }
+    if (byte & (0x80 >> (b & 7)))
+      set_index(row, x + i, bpp, index);
+    i++;
+  }
+}
+
+}  // namespace pixel_ops
+
+}  // namespace esphome::lvgl_game_runner
@@ -0,0 +1,184 @@
+// © Copyright 2025 Stuart Parmenter
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace esphome::lvgl_game_runner {
+
+/**
+ * Fixed-capacity, allocation-free ring buffers for handing data to the game loop.
+ *
+ * Both variants never block and never allocate, so they are safe to use from ISRs,
+ * the BLE callback task and the main loop. A full buffer drops the new item and
+ * bumps an overflow counter instead of logging.
+ *
+ * Capacity must be a power of two.
+ */
+
+/**
+ * Lock-free single-producer / single-consumer ring buffer.
+ * Exactly one context may push and exactly one context may pop.
+ */
+template<typename T, size_t N> class SpscRingBuffer {
+  static_assert(N > 0 && (N & (N - 1)) == 0, "SpscRingBuffer capacity must be a power of two");
+
+ public:
+  /**
+   * Push an item. Returns false (and counts an overflow) if the buffer is full.
+   */
+  bool push(const T &item) {
+    const uint32_t head = this->head_.load(std::memory_order_relaxed);
+    const uint32_t tail = this->tail_.load(std::memory_order_acquire);
+    if (head - tail >= N) {
+      this->overflows_.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    }
+    this->slots_[head & MASK] = item;
+    this->head_.store(head + 1, std::memory_order_release);
+    return true;
+  }
+
+  /**
+   * Pop the oldest item. Returns false if the buffer is empty. Consumer only.
+   */
+  bool pop(T &item) {
+    const uint32_t tail = this->tail_.load(std::memory_order_relaxed);
+    const uint32_t head = this->head_.load(std::memory_order_acquire);
+    if (tail == head)
+      return false;
+    item = this->slots_[tail & MASK];
+    this->tail_.store(tail + 1, std::memory_order_release);
+    return true;
+  }
+
+  bool empty() const {
+    return this->head_.load(std::memory_order_acquire) == this->tail_.load(std::memory_order_acquire);
+  }
+
+  size_t size() const {
+    return this->head_.load(std::memory_order_acquire) - this->tail_.load(std::memory_order_acquire);
+  }
+
+  /**
+   * Discard all queued items. Consumer only.
+   */
+  void clear() { this->tail_.store(this->head_.load(std::memory_order_acquire), std::memory_order_release); }
+
+  /**
+   * Total number of items dropped because the buffer was full.
+   */
+  uint32_t overflow_count() const { return this->overflows_.load(std::memory_order_relaxed); }
+
+  static constexpr size_t capacity() { return N; }
+
+ private:
+  static constexpr uint32_t MASK = N - 1;
+
+  T slots_[N]{};
+  std::atomic<uint32_t> head_{0};  // Next slot to write (producer)
+  std::atomic<uint32_t> tail_{0};  // Next slot to read (consumer)
+  std::atomic<uint32_t> overflows_{0};
+};
+
+/**
+ * Lock-free multi-producer / single-consumer ring buffer.
+ * Bounded queue with per-slot sequence numbers (Vyukov style): producers claim a slot
+ * with a CAS on the head index, then publish it by advancing the slot sequence.
+ *
+ * A producer preempted between claiming and publishing only delays the consumer
+ * (pop() returns false until the slot is published); it never blocks other producers.
+ */
+template<typename T, size_t N> class MpscRingBuffer {
+  static_assert(N > 0 && (N & (N - 1)) == 0, "MpscRingBuffer capacity must be a power of two");
+
+ public:
+  MpscRingBuffer() {
+    for (uint32_t i = 0; i < N; i++)
+      this->cells_[i].seq.store(i, std::memory_order_relaxed);
+  }
+
+  /**
+   * Push an item from any context. Returns false (and counts an overflow) if the buffer is full.
+   */
+  bool push(const T &item) {
+    uint32_t pos = this->head_.load(std::memory_order_relaxed);
+    Cell *cell;
+    for (;;) {
+      cell = &this->cells_[pos & MASK];
+      const uint32_t seq = cell->seq.load(std::memory_order_acquire);
+      const int32_t diff = static_cast<int32_t>(seq - pos);
+      if (diff == 0) {
+        if (this->head_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+          break;
+      } else if (diff < 0) {
+        this->overflows_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+      } else {
+        pos = this->head_.load(std::memory_order_relaxed);
+      }
+    }
+    cell->data = item;
+    cell->seq.store(pos + 1, std::memory_order_release);
+    return true;
+  }
+
+  /**
+   * Pop the oldest published item. Returns false if none is ready. Consumer only.
+   */
+  bool pop(T &item) {
+    const uint32_t pos = this->tail_.load(std::memory_order_relaxed);
+    Cell *cell = &this->cells_[pos & MASK];
+    const uint32_t seq = cell->seq.load(std::memory_order_acquire);
+    if (static_cast<int32_t>(seq - (pos + 1)) < 0)
+      return false;
+    item = cell->data;
+    cell->seq.store(pos + N, std::memory_order_release);
+    this->tail_.store(pos + 1, std::memory_order_relaxed);
+    return true;
+  }
+
+  bool empty() const {
+    const uint32_t pos = this->tail_.load(std::memory_order_relaxed);
+    const uint32_t seq = this->cells_[pos & MASK].seq.load(std::memory_order_acquire);
+    return static_cast<int32_t>(seq - (pos + 1)) < 0;
+  }
+
+  size_t size() const {
+    return this->head_.load(std::memory_order_acquire) - this->tail_.load(std::memory_order_relaxed);
+  }
+
+  /**
+   * Discard all published items. Consumer only.
+   */
+  void clear() {
+    T discard;
+    while (this->pop(discard)) {
+    }
+  }
+
+  /**
+   * Total number of items dropped because the buffer was full.
+   */
+  uint32_t overflow_count() const { return this->overflows_.load(std::memory_order_relaxed); }
+
+  static constexpr size_t capacity() { return N; }
+
+ private:
+  static constexpr uint32_t MASK = N - 1;
+
+  struct Cell {
+    std::atomic<uint32_t> seq;
+    T data;
+  };
+
+  Cell cells_[N];
+  std::atomic<uint32_t> head_{0};  // Next slot to claim (producers)
+  std::atomic<uint32_t> tail_{0};  // Next slot to read (consumer)
+  std::atomic<uint32_t> overflows_{0};
+};
+
+}  // namespace esphome::lvgl_game_runner
@@ -0,0 +1,46 @@
+// © Copyright 2025 Stuart Parmenter
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include "game_scalar.h"
+#include "input_types.h"
+#include <cstdint>
+
+namespace esphome::lvgl_game_runner {
+
+class GameBase;
+
+/**
+ * Takes over a runner's fixed-step simulation, e.g. to keep it in lockstep with another
+ * device (see the netplay component).
+ *
+ * Every frame the runner asks begin_frame() whether the driver wants it. If so, the frame's
+ * local input events go to on_local_input() instead of the game, and advance() runs the
+ * game's updates in place of the runner's own catch-up loop. All calls come from the frame
+ * context (the main loop, or the runner task), with the frame lock held.
+ */
+class SimDriver {
+ public:
+  virtual ~SimDriver() = default;
+
+  /**
+   * Start of a frame with `game` bound. Return true to drive this frame.
+   */
+  virtual bool begin_frame(GameBase *game) = 0;
+
+  /**
+   * A local input event (from any input source and for any player) while driving.
+   */
+  virtual void on_local_input(const InputEvent &event) = 0;
+
+  /**
+   * `due` simulation periods of `dt` seconds have passed on the local clock. Run the
+   * game's updates for them, each as GameBase::dispatch_input() calls, update() and
+   * end_input_step(); a driver may run more (resimulating) or fewer (waiting). Returns the
+   * number of new steps run.
+   */
+  virtual uint32_t advance(GameBase *game, Scalar dt, uint32_t due) = 0;
+};
+
+}  // namespace esphome::lvgl_game_runner
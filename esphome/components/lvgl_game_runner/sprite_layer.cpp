@@ -0,0 +1,47 @@
+// © Copyright 2025 Stuart Parmenter
+// SPDX-License-Identifier: MIT
+
+#include "sprite_layer.h"
+
+namespace esphome::lvgl_game_runner {
+
+Sprite *SpriteLayerBase::add(int8_t z) {
+  if (this->count_ >= this->capacity_)
+    return nullptr;
+  Sprite *s = &this->sprites_[this->count_];
+  *s = Sprite{};
+  s->z = z;
+  this->drawn_[this->count_] = Sprite{};
+  this->count_++;
+  return s;
+}
+
+void SpriteLayerBase::invalidate() {
+  for (size_t i = 0; i < this->count_; i++)
+    this->drawn_[i].visible = false;
+}
+
+bool SpriteLayerBase::changed_(size_t i) const {
+  const Sprite &s = this->sprites_[i];
+  const Sprite &d = this->drawn_[i];
+  if (s.visible != d.visible)
+    return true;
+  if (!s.visible)
+    return false;
+  return s.dirty || s.x != d.x || s.y != d.y || s.w != d.w || s.h != d.h || s.z != d.z || s.kind != d.kind ||
+         s.image != d.image || (s.kind != Sprite::Kind::RGB565 && lv_color_to32(s.color) != lv_color_to32(d.color));
+}
+
+void SpriteLayerBase::sort_by_z_(uint8_t *order) const {
+  // Insertion sort: a handful of sprites, almost always already in order
+  for (size_t i = 0; i < this->count_; i++) {
+    size_t j = i;
+    while (j > 0 && this->sprites_[order[j - 1]].z > this->sprites_[i].z) {
+      order[j] = order[j - 1];
+      j--;
+    }
+    order[j] = (uint8_t) i;
+  }
+}
+
+}  // namespace esphome::lvgl_game_runner
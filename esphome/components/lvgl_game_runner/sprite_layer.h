@@ -0,0 +1,125 @@
+// © Copyright 2025 Stuart Parmenter
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <lvgl.h>
+#include <cstddef>
+#include <cstdint>
+
+namespace esphome::lvgl_game_runner {
+
+/**
+ * A retained-mode sprite: a rectangle drawn on top of the game's background.
+ *
+ * Games update the fields (position, size, look, visibility) whenever they like; the runner
+ * compares each sprite against what it drew last frame and only erases / redraws the sprites
+ * that changed (or that something else drew over). Coordinates are relative to the game area.
+ */
+struct Sprite {
+  enum class Kind : uint8_t {
+    SOLID,    // Filled rectangle in `color`
+    OUTLINE,  // 1px rectangle outline in `color` (interior is transparent)
+    MONO,     // 1-bit bitmap, set bits drawn in `color`, clear bits transparent
+    RGB565,   // Opaque w*h lv_color_t bitmap
+  };
+
+  int x{0};
+  int y{0};
+  int w{0};
+  int h{0};
+  int8_t z{0};  // Higher z is drawn on top
+  bool visible{false};
+  Kind kind{Kind::SOLID};
+  lv_color_t color{};
+  // MONO: rows of (w + 7) / 8 bytes, MSB first. RGB565: w * h pixels. Must outlive the sprite.
+  const void *image{nullptr};
+  bool dirty{false};  // Set when the image contents changed in place (same pointer)
+
+  void move_to(int nx, int ny) {
+    this->x = nx;
+    this->y = ny;
+  }
+  void set_solid(int nw, int nh, lv_color_t c) { this->set_(Kind::SOLID, nw, nh, c, nullptr); }
+  void set_outline(int nw, int nh, lv_color_t c) { this->set_(Kind::OUTLINE, nw, nh, c, nullptr); }
+  void set_mono(const uint8_t *bits, int nw, int nh, lv_color_t c) { this->set_(Kind::MONO, nw, nh, c, bits); }
+  void set_rgb565(const lv_color_t *pixels, int nw, int nh) { this->set_(Kind::RGB565, nw, nh, this->color, pixels); }
+
+  /**
+   * True if every pixel of the sprite's rectangle is covered when drawn.
+   */
+  bool is_opaque() const { return this->kind == Kind::SOLID || this->kind == Kind::RGB565; }
+
+ private:
+  void set_(Kind k, int nw, int nh, lv_color_t c, const void *img) {
+    this->kind = k;
+    this->w = nw;
+    this->h = nh;
+    this->color = c;
+    this->image = img;
+  }
+};
+
+/**
+ * Fixed set of sprites plus what was drawn for each of them last frame.
+ * Use SpriteLayer<N> to declare one; GameBase only sees this base class.
+ */
+class SpriteLayerBase {
+ public:
+  /**
+   * Add a sprite (hidden until made visible). Returns nullptr if the layer is full.
+   * Pointers stay valid for the lifetime of the layer.
+   */
+  Sprite *add(int8_t z = 0);
+
+  /**
+   * Forget what was drawn last frame, e.g. after the whole canvas was cleared.
+   * Every visible sprite is redrawn on the next compose and nothing is erased.
+   */
+  void invalidate();
+
+  /**
+   * Color used to erase sprites when the game doesn't override GameBase::redraw_background().
+   */
+  void set_background(lv_color_t color) { this->background_ = color; }
+  lv_color_t get_background() const { return this->background_; }
+
+  size_t size() const { return this->count_; }
+
+ protected:
+  friend class GameBase;
+
+  SpriteLayerBase(Sprite *sprites, Sprite *drawn, size_t capacity)
+      : sprites_(sprites), drawn_(drawn), capacity_(capacity) {}
+  SpriteLayerBase(const SpriteLayerBase &) = delete;
+  SpriteLayerBase &operator=(const SpriteLayerBase &) = delete;
+
+  /**
+   * True if sprite i looks different from what was drawn for it last frame.
+   */
+  bool changed_(size_t i) const;
+
+  /**
+   * Fill `order` with the indices of all sprites sorted by z (stable).
+   */
+  void sort_by_z_(uint8_t *order) const;
+
+  Sprite *sprites_;
+  Sprite *drawn_;  // State drawn last frame; a hidden entry means nothing is on screen
+  size_t capacity_;
+  size_t count_{0};
+  lv_color_t background_{};
+};
+
+template<size_t N> class SpriteLayer : public SpriteLayerBase {
+  static_assert(N > 0 && N <= 255, "SpriteLayer capacity must be 1..255");
+
+ public:
+  SpriteLayer() : SpriteLayerBase(storage_, drawn_storage_, N) {}
+
+ private:
+  Sprite storage_[N]{};
+  Sprite drawn_storage_[N]{};
+};
+
+}  // namespace esphome::lvgl_game_runner
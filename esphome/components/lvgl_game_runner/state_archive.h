@@ -0,0 +1,60 @@
+// © Copyright 2025 Stuart Parmenter
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+namespace esphome::lvgl_game_runner {
+
+/**
+ * Reads or writes a game's simulation state as raw bytes (see GameBase::serialize_state()).
+ *
+ * A game lists its fields once, as `ar(field)` calls, and the same list then measures the
+ * state, saves it into a caller-owned buffer or loads it back. No allocation, no format:
+ * snapshots only ever go back into the same build of the same game.
+ */
+class StateArchive {
+ public:
+  enum class Mode : uint8_t { MEASURE, SAVE, LOAD };
+
+  static StateArchive measure() { return StateArchive(Mode::MEASURE, nullptr, 0); }
+  static StateArchive save(uint8_t *buf, size_t cap) { return StateArchive(Mode::SAVE, buf, cap); }
+  static StateArchive load(const uint8_t *buf, size_t len) {
+    return StateArchive(Mode::LOAD, const_cast<uint8_t *>(buf), len);  // Only ever read from
+  }
+
+  template<typename T> void operator()(T &value) {
+    static_assert(std::is_trivially_copyable_v<T>, "StateArchive copies fields as raw bytes");
+    if (this->mode_ != Mode::MEASURE) {
+      if (this->pos_ + sizeof(T) > this->cap_) {
+        this->ok_ = false;
+        return;
+      }
+      if (this->mode_ == Mode::SAVE) {
+        memcpy(this->buf_ + this->pos_, &value, sizeof(T));
+      } else {
+        memcpy(&value, this->buf_ + this->pos_, sizeof(T));
+      }
+    }
+    this->pos_ += sizeof(T);
+  }
+
+  Mode mode() const { return this->mode_; }
+  size_t size() const { return this->pos_; }  // Bytes measured, saved or loaded so far
+  bool ok() const { return this->ok_; }       // false if the buffer was too small
+
+ private:
+  StateArchive(Mode mode, uint8_t *buf, size_t cap) : mode_(mode), buf_(buf), cap_(cap) {}
+
+  Mode mode_;
+  uint8_t *buf_;
+  size_t cap_;
+  size_t pos_{0};
+  bool ok_{true};
+};
+
+}  // namespace esphome::lvgl_game_runner
@@ -0,0 +1,144 @@
+// © Copyright 2025 Stuart Parmenter
+// SPDX-License-Identifier: MIT
+
+#include "text_cache.h"
+#include "pixel_ops.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace esphome::lvgl_game_runner {
+
+void TextCache::clear() {
+  this->pixels_.clear();
+  this->pixels_.shrink_to_fit();
+  for (auto &g : this->glyphs_)
+    g = Piece{};
+  this->num_strings_ = 0;
+  this->height_ = 0;
+}
+
+bool TextCache::render_(lv_obj_t *canvas, lv_color_t *buf, int stride, int canvas_w, const lv_font_t *font,
+                        const char *text, Piece &piece) {
+  lv_point_t size;
+  lv_txt_get_size(&size, text, font, 0, 0, LV_COORD_MAX, LV_TEXT_FLAG_NONE);
+  if (size.x <= 0 || size.x > canvas_w)
+    return false;
+
+  // Render over the background in the canvas corner, then keep a copy of the pixels
+  pixel_ops::fill_rect(buf, stride, size.x, this->height_, this->bg_);
+
+  lv_draw_label_dsc_t label_dsc;
+  lv_draw_label_dsc_init(&label_dsc);
+  label_dsc.color = this->fg_;
+  label_dsc.font = font;
+  label_dsc.align = LV_TEXT_ALIGN_LEFT;
+  lv_canvas_draw_text(canvas, 0, 0, size.x, &label_dsc, text);
+
+  piece.offset = this->pixels_.size();
+  piece.w = size.x;
+  this->pixels_.resize(this->pixels_.size() + (size_t) size.x * this->height_);
+  pixel_ops::copy_rect(&this->pixels_[piece.offset], size.x, buf, stride, size.x, this->height_);
+  return true;
+}
+
+bool TextCache::build(lv_obj_t *canvas, const lv_font_t *font, lv_color_t fg, lv_color_t bg, const char *charset,
+                      const char *const *strings, size_t num_strings) {
+  this->clear();
+  if (!canvas || !font)
+    return false;
+  lv_img_dsc_t *img = lv_canvas_get_img(canvas);
+  if (!img || !img->data)
+    return false;
+
+  lv_color_t *buf = static_cast<lv_color_t *>(const_cast<void *>(static_cast<const void *>(img->data)));
+  const int stride = img->header.w;
+  const int height = lv_font_get_line_height(font);
+  if (height <= 0 || height > (int) img->header.h)
+    return false;
+
+  this->height_ = height;
+  this->fg_ = fg;
+  this->bg_ = bg;
+
+  // Render into a true-color strip instead of an indexed canvas, restored below
+  const lv_img_dsc_t saved = *img;
+  std::vector<lv_color_t> scratch;
+  if (pixel_ops::indexed_bpp(img->header.cf)) {
+    scratch.resize((size_t) stride * height);
+    buf = scratch.data();
+    img->header.cf = LV_IMG_CF_TRUE_COLOR;
+    img->header.h = height;
+    img->data = reinterpret_cast<const uint8_t *>(buf);
+    img->data_size = scratch.size() * sizeof(lv_color_t);
+  }
+
+  char single[2] = {0, 0};
+  for (const char *c = charset; c && *c; c++) {
+    const uint8_t code = static_cast<uint8_t>(*c);
+    if (code >= 128 || this->glyphs_[code].w)
+      continue;
+    single[0] = *c;
+    this->render_(canvas, buf, stride, stride, font, single, this->glyphs_[code]);
+  }
+
+  for (size_t i = 0; i < num_strings && this->num_strings_ < MAX_STRINGS; i++) {
+    const size_t len = strings[i] ? strlen(strings[i]) : 0;
+    if (len == 0 || len > 255)
+      continue;
+    Piece &piece = this->strings_[this->num_strings_];
+    if (this->render_(canvas, buf, stride, stride, font, strings[i], piece)) {
+      piece.text = strings[i];
+      piece.len = (uint8_t) len;
+      this->num_strings_++;
+    }
+  }
+
+  if (!scratch.empty()) {
+    *img = saved;
+    return true;
+  }
+
+  // Leave the scratch area blank; the game repaints the canvas before showing anything
+  int used_w = 0;
+  for (const auto &g : this->glyphs_)
+    used_w = std::max(used_w, (int) g.w);
+  for (size_t i = 0; i < this->num_strings_; i++)
+    used_w = std::max(used_w, (int) this->strings_[i].w);
+  pixel_ops::fill_rect(buf, stride, used_w, this->height_, bg);
+  return true;
+}
+
+const TextCache::Piece *TextCache::next(const char *text, size_t pos) const {
+  // Longest cached string first, so "LEVEL" wins over "L"
+  const Piece *best = nullptr;
+  for (size_t i = 0; i < this->num_strings_; i++) {
+    const Piece &s = this->strings_[i];
+    if ((!best || s.len > best->len) && strncmp(&text[pos], s.text, s.len) == 0)
+      best = &s;
+  }
+  if (best)
+    return best;
+
+  const uint8_t code = static_cast<uint8_t>(text[pos]);
+  if (code < 128 && this->glyphs_[code].w)
+    return &this->glyphs_[code];
+  return nullptr;
+}
+
+int TextCache::measure(const char *text) const {
+  if (this->height_ <= 0 || !text)
+    return -1;
+  int w = 0;
+  size_t pos = 0;
+  while (text[pos]) {
+    const Piece *p = this->next(text, pos);
+    if (!p)
+      return -1;
+    w += p->w;
+    pos += p->text ? p->len : 1;
+  }
+  return w;
+}
+
+}  // namespace esphome::lvgl_game_runner
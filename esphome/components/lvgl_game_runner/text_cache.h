@@ -0,0 +1,79 @@
+// © Copyright 2025 Stuart Parmenter
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <lvgl.h>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace esphome::lvgl_game_runner {
+
+/**
+ * Pre-rendered text for HUDs and overlays.
+ *
+ * build() renders single characters and whole strings once through the LVGL label renderer
+ * (using the canvas' own buffer as scratch space, or a temporary strip if the canvas is
+ * indexed, which LVGL can't draw text into) and keeps the pixels as RGB565 strips,
+ * anti-aliased against the background color. Text made only of cached pieces can then
+ * be drawn by copying every pixel that isn't the background color: cached strings are
+ * matched first (exact LVGL layout, kerning included), anything else is assembled from
+ * the cached characters.
+ */
+class TextCache {
+ public:
+  static constexpr size_t MAX_STRINGS = 16;
+
+  struct Piece {
+    uint32_t offset{0};  // Into pixels_
+    uint16_t w{0};
+    const char *text{nullptr};  // nullptr for single characters
+    uint8_t len{0};
+  };
+
+  /**
+   * Render `charset` (ASCII) and `strings` with `font` in `fg` over `bg`.
+   * Strings are not copied and must outlive the cache (use string literals).
+   * Overwrites the top-left corner of a true-color canvas; the caller redraws afterwards.
+   * Returns false if the canvas isn't ready.
+   */
+  bool build(lv_obj_t *canvas, const lv_font_t *font, lv_color_t fg, lv_color_t bg, const char *charset,
+             const char *const *strings, size_t num_strings);
+
+  void clear();
+
+  /**
+   * True if text in `fg` can be drawn from the cache.
+   */
+  bool matches(lv_color_t fg) const { return this->height_ > 0 && lv_color_to32(fg) == lv_color_to32(this->fg_); }
+
+  /**
+   * Width of `text` when drawn from the cache, or -1 if some character isn't cached.
+   */
+  int measure(const char *text) const;
+
+  /**
+   * Next piece of `text` starting at `pos` (a cached string, or else a single character).
+   * Returns nullptr if nothing cached matches.
+   */
+  const Piece *next(const char *text, size_t pos) const;
+
+  const lv_color_t *pixels(const Piece &p) const { return &this->pixels_[p.offset]; }
+  int height() const { return this->height_; }
+  lv_color_t background() const { return this->bg_; }
+
+ private:
+  bool render_(lv_obj_t *canvas, lv_color_t *buf, int stride, int canvas_w, const lv_font_t *font, const char *text,
+               Piece &piece);
+
+  std::vector<lv_color_t> pixels_;
+  Piece glyphs_[128]{};  // Indexed by ASCII code; w == 0 means not cached
+  Piece strings_[MAX_STRINGS]{};
+  size_t num_strings_{0};
+  int height_{0};
+  lv_color_t fg_{};
+  lv_color_t bg_{};
+};
+
+}  // namespace esphome::lvgl_game_runner
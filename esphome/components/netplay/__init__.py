@@ -0,0 +1,81 @@
+# © Copyright 2025 Stuart Parmenter
+# SPDX-License-Identifier: MIT
+
+"""
+Netplay component for ESPHome.
+
+Links the game runners on two devices over ESP-NOW for two-player games, with
+input delay and rollback.
+"""
+
+import esphome.codegen as cg
+import esphome.config_validation as cv
+from esphome.const import CONF_CHANNEL, CONF_ID
+from esphome.components import lvgl_game_runner
+import esphome.final_validate as fv
+
+# Only works with ESP-IDF framework
+DEPENDENCIES = ["esp32", "lvgl_game_runner"]
+CODEBASE_COMPONENTS = ["esp32"]
+
+# Component namespace
+netplay_ns = cg.esphome_ns.namespace("netplay")
+
+Netplay = netplay_ns.class_("Netplay", cg.Component)
+
+# Config keys
+CONF_RUNNER = "runner"
+CONF_PEER = "peer"
+CONF_PLAYER = "player"
+CONF_INPUT_DELAY = "input_delay"
+CONF_MAX_ROLLBACK = "max_rollback"
+CONF_TIMEOUT = "timeout"
+
+CONFIG_SCHEMA = cv.Schema(
+    {
+        cv.GenerateID(): cv.declare_id(Netplay),
+        cv.Required(CONF_RUNNER): cv.use_id(lvgl_game_runner.LvglGameRunner),
+        cv.Required(CONF_PEER): cv.mac_address,
+        cv.Required(CONF_PLAYER): cv.int_range(min=1, max=2),
+        cv.Optional(CONF_CHANNEL, default=1): cv.int_range(min=1, max=14),
+        cv.Optional(CONF_INPUT_DELAY, default=2): cv.int_range(min=0, max=8),
+        cv.Optional(CONF_MAX_ROLLBACK, default=8): cv.int_range(min=1, max=15),
+        cv.Optional(CONF_TIMEOUT, default="3s"): cv.All(
+            cv.positive_time_period_milliseconds,
+            cv.Range(min=cv.TimePeriod(milliseconds=500)),
+        ),
+    }
+).extend(cv.COMPONENT_SCHEMA)
+
+
+def _validate_simulation_rate(config):
+    """Both devices must step the game at the same fixed rate to stay in lockstep."""
+    runner = fv.full_config.get().get("lvgl_game_runner", {})
+    if lvgl_game_runner.CONF_SIMULATION_RATE not in runner:
+        raise cv.Invalid(
+            "netplay requires a fixed simulation step: set lvgl_game_runner "
+            f"{lvgl_game_runner.CONF_SIMULATION_RATE} (the same on both devices)"
+        )
+    return config
+
+
+FINAL_VALIDATE_SCHEMA = _validate_simulation_rate
+
+
+async def to_code(config):
+    """Generate C++ code for netplay component."""
+    var = cg.new_Pvariable(config[CONF_ID])
+    await cg.register_component(var, config)
+
+    runner = await cg.get_variable(config[CONF_RUNNER])
+    cg.add(var.set_runner(runner))
+    cg.add(var.set_peer(config[CONF_PEER].as_hex))
+    cg.add(var.set_player(config[CONF_PLAYER]))
+
+    # Without the wifi component, netplay brings Wi-Fi up itself on this channel
+    cg.add(var.set_channel(config[CONF_CHANNEL]))
+
+    # Steps between sampling local input and running it: each one hides one step of latency
+    cg.add(var.set_input_delay(config[CONF_INPUT_DELAY]))
+    cg.add(var.set_max_rollback(config[CONF_MAX_ROLLBACK]))
+    cg.add(var.set_peer_timeout(config[CONF_TIMEOUT].total_milliseconds))
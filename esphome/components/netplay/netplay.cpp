@@ -0,0 +1,518 @@
+// © Copyright 2025 Stuart Parmenter
+// SPDX-License-Identifier: MIT
+
+#include "netplay.h"
+
+#include "esphome/core/hal.h"
+#include "esphome/core/log.h"
+
+#include <algorithm>
+#include <new>
+
+#include "esp_event.h"
+#include "esp_netif.h"
+#include "esp_random.h"
+#include "esp_wifi.h"
+
+namespace esphome::netplay {
+
+static const char *const TAG = "netplay";
+
+using lvgl_game_runner::INPUT_TYPE_COUNT;
+using lvgl_game_runner::InputSnapshot;
+using lvgl_game_runner::InputType;
+
+namespace {
+
+constexpr uint16_t MAGIC = 0x4E50;  // "NP"
+constexpr uint8_t VERSION = 1;
+
+enum PacketType : uint8_t {
+  HELLO = 1,      // Host: join session `session`
+  HELLO_ACK = 2,  // Guest: joined
+  INPUTS = 3,     // Either side: its latest inputs
+};
+
+struct __attribute__((packed)) Header {
+  uint16_t magic;
+  uint8_t version;
+  uint8_t type;
+  uint32_t session;
+};
+
+// HELLO / HELLO_ACK: the two sides must simulate the same game the same way
+struct __attribute__((packed)) Hello {
+  Header h;
+  uint8_t player;  // The sender's local player
+  uint8_t input_delay;
+  uint32_t sim_period_us;
+  uint32_t game_hash;  // FNV-1a of the game key
+  uint32_t state_size;
+};
+
+// INPUTS, followed by `count` WireInputs for steps first, first + 1, ...
+struct __attribute__((packed)) Inputs {
+  Header h;
+  uint32_t frame;     // The sender's next step
+  uint32_t ack;       // Steps of the receiver's input the sender has
+  int8_t advantage;   // How many steps the sender thinks it is ahead
+  uint32_t first;
+  uint8_t count;
+};
+
+struct __attribute__((packed)) WireInput {
+  uint16_t held;
+  int8_t rotate;
+};
+
+static_assert(sizeof(Inputs) + 64 * sizeof(WireInput) <= ESP_NOW_MAX_DATA_LEN, "INPUTS must fit one frame");
+
+uint32_t fnv1a(const char *s) {
+  uint32_t h = 2166136261u;
+  for (; *s; s++)
+    h = (h ^ (uint8_t) *s) * 16777619u;
+  return h;
+}
+
+}  // namespace
+
+Netplay *Netplay::instance_ = nullptr;
+
+// ---- Radio ----
+
+void Netplay::setup() {
+  if (runner_->get_simulation_period_us() == 0) {
+    ESP_LOGE(TAG, "Netplay needs a fixed simulation_rate on the runner");
+    this->mark_failed();
+    return;
+  }
+  instance_ = this;
+  if (!this->start_radio_()) {
+    this->mark_failed();
+    return;
+  }
+  radio_ok_ = true;
+  runner_->set_sim_driver(this);
+}
+
+bool Netplay::start_radio_() {
+  // ESP-NOW rides on the Wi-Fi driver; without a wifi: component, start a bare station here
+  wifi_mode_t mode;
+  if (esp_wifi_get_mode(&mode) == ESP_ERR_WIFI_NOT_INIT) {
+    esp_netif_init();
+    esp_event_loop_create_default();  // ESP_ERR_INVALID_STATE if it already exists
+    wifi_init_config_t cfg = WIFI_INIT_CONFIG_DEFAULT();
+    esp_err_t err = esp_wifi_init(&cfg);
+    if (err == ESP_OK) {
+      esp_wifi_set_storage(WIFI_STORAGE_RAM);
+      esp_wifi_set_mode(WIFI_MODE_STA);
+      err = esp_wifi_start();
+    }
+    if (err != ESP_OK) {
+      ESP_LOGE(TAG, "Wi-Fi start failed: %s", esp_err_to_name(err));
+      return false;
+    }
+    esp_wifi_set_ps(WIFI_PS_NONE);  // Modem sleep would delay every packet
+    esp_wifi_set_channel(channel_, WIFI_SECOND_CHAN_NONE);
+    own_wifi_ = true;
+  }
+
+  esp_err_t err = esp_now_init();
+  if (err != ESP_OK) {
+    ESP_LOGE(TAG, "ESP-NOW init failed: %s", esp_err_to_name(err));
+    return false;
+  }
+  esp_now_register_recv_cb(&Netplay::recv_cb_);
+
+  esp_now_peer_info_t peer{};
+  memcpy(peer.peer_addr, peer_mac_, sizeof(peer_mac_));
+  peer.channel = 0;  // Whatever channel the station is on
+  peer.ifidx = WIFI_IF_STA;
+  peer.encrypt = false;
+  err = esp_now_add_peer(&peer);
+  if (err != ESP_OK) {
+    ESP_LOGE(TAG, "Adding ESP-NOW peer failed: %s", esp_err_to_name(err));
+    return false;
+  }
+  return true;
+}
+
+// Runs in the Wi-Fi task: copy the packet out for the frame context
+#if ESP_IDF_VERSION >= ESP_IDF_VERSION_VAL(5, 0, 0)
+void Netplay::recv_cb_(const esp_now_recv_info_t *info, const uint8_t *data, int len) {
+  const uint8_t *mac = info->src_addr;
+#else
+void Netplay::recv_cb_(const uint8_t *mac, const uint8_t *data, int len) {
+#endif
+  Netplay *self = instance_;
+  if (!self || len <= 0 || len > (int) MAX_PACKET || memcmp(mac, self->peer_mac_, sizeof(self->peer_mac_)) != 0)
+    return;
+  RxPacket p;
+  p.len = (uint8_t) len;
+  memcpy(p.data, data, len);
+  if (!self->rx_.push(p))
+    self->rx_dropped_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void Netplay::send_(const void *data, size_t len) {
+  const esp_err_t err = esp_now_send(peer_mac_, static_cast<const uint8_t *>(data), len);
+  if (err != ESP_OK)
+    ESP_LOGV(TAG, "Send failed: %s", esp_err_to_name(err));
+}
+
+void Netplay::loop() {
+  if (!radio_ok_ || active_.load(std::memory_order_relaxed))
+    return;
+  // Handshakes run in the runner's frames, which an idle game (pause screen) skips
+  const uint32_t now = millis();
+  if (now - last_wake_ms_ >= (rx_.empty() ? HELLO_INTERVAL_MS : 20)) {
+    last_wake_ms_ = now;
+    runner_->wake();
+  }
+}
+
+void Netplay::dump_config() {
+  ESP_LOGCONFIG(TAG, "Netplay:");
+  ESP_LOGCONFIG(TAG, "  Peer: %02X:%02X:%02X:%02X:%02X:%02X", peer_mac_[0], peer_mac_[1], peer_mac_[2],
+                peer_mac_[3], peer_mac_[4], peer_mac_[5]);
+  ESP_LOGCONFIG(TAG, "  Local player: %u (%s)", local_player_, local_player_ == 1 ? "host" : "guest");
+  ESP_LOGCONFIG(TAG, "  Input delay: %u steps, rollback up to %u steps", input_delay_, max_rollback_);
+  ESP_LOGCONFIG(TAG, "  Timeout: %u ms", (unsigned) timeout_ms_);
+  if (own_wifi_)
+    ESP_LOGCONFIG(TAG, "  Channel: %u (Wi-Fi started by netplay)", channel_);
+  if (this->is_failed())
+    ESP_LOGCONFIG(TAG, "  Setup failed");
+}
+
+// ---- Session ----
+
+bool Netplay::begin_frame(GameBase *game) {
+  if (!radio_ok_)
+    return false;
+  if (game != game_) {
+    game_ = nullptr;  // The old game is gone; nothing to release
+    if (active_)
+      this->end_session_("game changed");
+    game_ = game;
+    mismatch_logged_ = false;
+  }
+
+  RxPacket p;
+  while (rx_.pop(p))
+    this->handle_packet_(game, p.data, p.len);
+
+  const uint32_t now = millis();
+  if (active_) {
+    if (now - last_rx_ms_ <= timeout_ms_)
+      return true;
+    this->end_session_("peer timed out");
+    return false;
+  }
+  if (local_player_ == 1 && now - last_hello_ms_ >= HELLO_INTERVAL_MS) {
+    if (session_ == 0)
+      session_ = esp_random() | 1;
+    this->send_hello_(game, HELLO);
+    last_hello_ms_ = now;
+  }
+  return false;
+}
+
+void Netplay::handle_packet_(GameBase *game, const uint8_t *data, size_t len) {
+  Header h;
+  if (len < sizeof(h))
+    return;
+  memcpy(&h, data, sizeof(h));
+  if (h.magic != MAGIC || h.version != VERSION)
+    return;
+
+  switch (h.type) {
+    case HELLO:
+      if (local_player_ == 1 || !this->hello_matches_(game, data, len))
+        return;
+      if (!active_ || h.session != session_) {
+        if (active_)
+          this->end_session_("host restarted");
+        if (!this->start_session_(game, h.session))
+          return;
+      }
+      this->send_hello_(game, HELLO_ACK);  // Also repeats an ACK that got lost
+      last_rx_ms_ = millis();
+      break;
+    case HELLO_ACK:
+      if (local_player_ != 1 || active_ || h.session != session_ || !this->hello_matches_(game, data, len))
+        return;
+      this->start_session_(game, session_);
+      break;
+    case INPUTS:
+      if (!active_ || h.session != session_)
+        return;
+      last_rx_ms_ = millis();
+      this->handle_inputs_(data, len);
+      break;
+    default:
+      break;
+  }
+}
+
+bool Netplay::hello_matches_(GameBase *game, const uint8_t *data, size_t len) {
+  Hello hello;
+  if (len < sizeof(hello))
+    return false;
+  memcpy(&hello, data, sizeof(hello));
+  const char *problem = nullptr;
+  if (hello.player != this->remote_player_()) {
+    problem = "both sides are the same player";
+  } else if (hello.sim_period_us != runner_->get_simulation_period_us()) {
+    problem = "simulation_rate differs";
+  } else if (hello.input_delay != input_delay_) {
+    problem = "input_delay differs";
+  } else if (hello.game_hash != fnv1a(runner_->get_game_key())) {
+    problem = "different game";
+  } else if (hello.state_size != game->state_size() || hello.state_size == 0) {
+    problem = "game state differs or can't be snapshotted";
+  }
+  if (problem && !mismatch_logged_) {
+    ESP_LOGW(TAG, "Peer can't join: %s", problem);
+    mismatch_logged_ = true;
+  }
+  return problem == nullptr;
+}
+
+void Netplay::send_hello_(GameBase *game, uint8_t type) {
+  Hello hello{};
+  hello.h = Header{MAGIC, VERSION, type, session_};
+  hello.player = local_player_;
+  hello.input_delay = input_delay_;
+  hello.sim_period_us = runner_->get_simulation_period_us();
+  hello.game_hash = fnv1a(runner_->get_game_key());
+  hello.state_size = game->state_size();
+  this->send_(&hello, sizeof(hello));
+}
+
+bool Netplay::start_session_(GameBase *game, uint32_t seed) {
+  const size_t size = game->state_size();
+  if (size == 0) {
+    ESP_LOGW(TAG, "Game '%s' can't be snapshotted (no serialize_state())", runner_->get_game_key());
+    return false;
+  }
+  const uint32_t slots = max_rollback_ + 1u;
+  if (!snapshots_ || size != state_size_ || slots != snapshot_slots_) {
+    snapshots_.reset(new (std::nothrow) uint8_t[size * slots]);
+    state_size_ = snapshots_ ? size : 0;
+    snapshot_slots_ = snapshots_ ? slots : 0;
+    if (!snapshots_) {
+      ESP_LOGE(TAG, "Not enough memory for %u snapshots of %u bytes", (unsigned) slots, (unsigned) size);
+      return false;
+    }
+  }
+
+  // AI players aren't part of the snapshots, and each device supplies one human
+  local_humans_ = game->get_num_human_players();
+  game->set_num_human_players(2);
+  runner_->restart_game(seed);
+
+  // Nobody has input for the first input_delay_ steps
+  session_ = seed;
+  frame_ = 0;
+  local_count_ = input_delay_;
+  remote_count_ = input_delay_;
+  peer_ack_ = 0;
+  peer_frame_ = 0;
+  peer_advantage_ = 0;
+  sync_wait_ = 0;
+  next_sync_ = SYNC_INTERVAL;
+  rollback_from_ = NO_ROLLBACK;
+  std::fill(std::begin(local_), std::end(local_), StepInput{});
+  std::fill(std::begin(remote_), std::end(remote_), StepInput{});
+  std::fill(std::begin(predicted_), std::end(predicted_), StepInput{});
+  local_held_ = 0;
+  local_rotate_ = 0;
+  rollbacks_ = 0;
+  resimulated_ = 0;
+  stalls_ = 0;
+  last_rx_ms_ = millis();
+  active_ = true;
+  ESP_LOGI(TAG, "Session %08X started as player %u (%u byte snapshots)", (unsigned) seed, local_player_,
+           (unsigned) size);
+  return true;
+}
+
+void Netplay::end_session_(const char *reason) {
+  ESP_LOGW(TAG, "Session ended (%s) after %u steps: %u rollbacks, %u steps run again, %u stalls", reason,
+           (unsigned) frame_, (unsigned) rollbacks_, (unsigned) resimulated_, (unsigned) stalls_);
+  active_ = false;
+  if (local_player_ == 1)
+    session_ = 0;  // Offer a new one
+  // Local play carries on from here, with its AI players back and without buttons stuck down
+  if (game_) {
+    game_->set_num_human_players(local_humans_);
+    this->apply_input_(game_, 1, StepInput{});
+    this->apply_input_(game_, 2, StepInput{});
+  }
+}
+
+// ---- Simulation ----
+
+void Netplay::on_local_input(const InputEvent &event) {
+  // This device's controls are all the local player, whichever player they are mapped to
+  if (event.type == InputType::ROTATE_CW || event.type == InputType::ROTATE_CCW) {
+    if (event.pressed) {
+      const int32_t steps = event.value > 0 ? event.value : 1;
+      local_rotate_ += event.type == InputType::ROTATE_CW ? steps : -steps;
+    }
+  } else if (event.type != InputType::NONE) {
+    const uint16_t b = InputSnapshot::bit(event.type);
+    local_held_ = event.pressed ? uint16_t(local_held_ | b) : uint16_t(local_held_ & ~b);
+  }
+}
+
+uint32_t Netplay::advance(GameBase *game, Scalar dt, uint32_t due) {
+  if (!active_)
+    return 0;
+  if (rollback_from_ != NO_ROLLBACK && !this->rollback_(game, dt)) {
+    this->end_session_("snapshot restore failed");
+    return 0;
+  }
+
+  // Each side measures how far it is ahead of what it last heard from the other; the
+  // difference of the two is the real lead (latency cancels out), and the leader waits
+  // half of it
+  if (frame_ >= next_sync_) {
+    const int32_t lead = ((int32_t) (frame_ - peer_frame_) - peer_advantage_) / 2;
+    sync_wait_ = lead > 0 ? lead : 0;
+    next_sync_ = frame_ + SYNC_INTERVAL;
+  }
+
+  uint32_t run = 0;
+  for (uint32_t i = 0; i < due; i++) {
+    if (sync_wait_ > 0) {
+      sync_wait_--;
+      continue;
+    }
+    // Past this, a late remote input could need a snapshot we no longer have
+    if ((int32_t) (frame_ - remote_count_) >= (int32_t) max_rollback_) {
+      stalls_++;
+      break;
+    }
+    StepInput in;
+    in.held = local_held_;
+    in.rotate = (int8_t) std::clamp<int32_t>(local_rotate_, -127, 127);
+    local_rotate_ -= in.rotate;
+    local_[(frame_ + input_delay_) % INPUT_RING] = in;
+    local_count_ = frame_ + input_delay_ + 1;
+
+    if (!game->save_state(this->snapshot_(frame_), state_size_)) {
+      this->end_session_("snapshot failed");
+      return run;
+    }
+    this->simulate_(game, dt, frame_);
+    frame_++;
+    run++;
+  }
+
+  this->send_inputs_();
+  return run;
+}
+
+void Netplay::simulate_(GameBase *game, Scalar dt, uint32_t frame) {
+  StepInput remote;
+  if (frame < remote_count_) {
+    remote = remote_[frame % INPUT_RING];
+  } else if (remote_count_ > 0) {
+    // Predict: the buttons stay as they were, the encoder doesn't move
+    remote.held = remote_[(remote_count_ - 1) % INPUT_RING].held;
+  }
+  predicted_[frame % INPUT_RING] = remote;
+
+  // Players in the same order on both devices, so on_input() sees the same sequence
+  for (uint8_t player = 1; player <= 2; player++)
+    this->apply_input_(game, player, player == local_player_ ? local_[frame % INPUT_RING] : remote);
+  game->update(dt);
+  game->end_input_step();
+}
+
+void Netplay::apply_input_(GameBase *game, uint8_t player, const StepInput &in) {
+  // Turn the step's buttons into the events that lead there from the game's current state
+  const uint16_t held = game->get_input().player(player).held;
+  const uint16_t changed = held ^ in.held;
+  for (uint8_t t = 0; t < INPUT_TYPE_COUNT; t++) {
+    const InputType type = static_cast<InputType>(t);
+    if (changed & InputSnapshot::bit(type))
+      game->dispatch_input(InputEvent(type, player, (in.held & InputSnapshot::bit(type)) != 0));
+  }
+  if (in.rotate != 0) {
+    const InputType type = in.rotate > 0 ? InputType::ROTATE_CW : InputType::ROTATE_CCW;
+    game->dispatch_input(InputEvent(type, player, true, (int16_t) (in.rotate > 0 ? in.rotate : -in.rotate)));
+  }
+}
+
+bool Netplay::rollback_(GameBase *game, Scalar dt) {
+  const uint32_t from = rollback_from_;
+  rollback_from_ = NO_ROLLBACK;
+  if (from >= frame_)
+    return true;
+  if (frame_ - from > max_rollback_ || !game->load_state(this->snapshot_(from), state_size_))
+    return false;
+  for (uint32_t f = from; f < frame_; f++) {
+    if (f != from && !game->save_state(this->snapshot_(f), state_size_))
+      return false;
+    this->simulate_(game, dt, f);
+  }
+  rollbacks_++;
+  resimulated_ += frame_ - from;
+  return true;
+}
+
+void Netplay::handle_inputs_(const uint8_t *data, size_t len) {
+  Inputs p;
+  if (len < sizeof(p))
+    return;
+  memcpy(&p, data, sizeof(p));
+  if (len < sizeof(p) + p.count * sizeof(WireInput))
+    return;
+  peer_frame_ = p.frame;
+  peer_advantage_ = p.advantage;
+  if (p.ack > peer_ack_ && p.ack <= local_count_)
+    peer_ack_ = p.ack;
+
+  const uint8_t *wire = data + sizeof(p);
+  for (uint8_t i = 0; i < p.count; i++) {
+    const uint32_t g = p.first + i;
+    if (g < remote_count_)
+      continue;
+    if (g > remote_count_)
+      break;  // A gap; the peer resends from our ack
+    WireInput w;
+    memcpy(&w, wire + i * sizeof(w), sizeof(w));
+    const StepInput in{w.held, w.rotate};
+    remote_[g % INPUT_RING] = in;
+    // Already run on a wrong guess: go back to it before the next step
+    if (g < frame_ && in != predicted_[g % INPUT_RING])
+      rollback_from_ = std::min(rollback_from_, g);
+    remote_count_++;
+  }
+}
+
+void Netplay::send_inputs_() {
+  // Everything the peer hasn't confirmed, within what a packet (and the ring) holds
+  const uint32_t oldest = local_count_ > MAX_INPUTS_PER_PACKET ? local_count_ - MAX_INPUTS_PER_PACKET : 0;
+  const uint32_t first = std::max(peer_ack_, oldest);
+
+  uint8_t buf[MAX_PACKET];
+  Inputs p{};
+  p.h = Header{MAGIC, VERSION, INPUTS, session_};
+  p.frame = frame_;
+  p.ack = remote_count_;
+  p.advantage = (int8_t) std::clamp<int32_t>((int32_t) (frame_ - peer_frame_), -127, 127);
+  p.first = first;
+  p.count = (uint8_t) (local_count_ - first);
+  memcpy(buf, &p, sizeof(p));
+  for (uint8_t i = 0; i < p.count; i++) {
+    const StepInput &in = local_[(first + i) % INPUT_RING];
+    const WireInput w{in.held, in.rotate};
+    memcpy(buf + sizeof(p) + i * sizeof(w), &w, sizeof(w));
+  }
+  this->send_(buf, sizeof(p) + p.count * sizeof(WireInput));
+}
+
+}  // namespace esphome::netplay
@@ -0,0 +1,166 @@
+// © Copyright 2025 Stuart Parmenter
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include "esphome/core/component.h"
+#include "esphome/components/lvgl_game_runner/lvgl_game_runner.h"
+#include "esphome/components/lvgl_game_runner/ring_buffer.h"
+#include "esphome/components/lvgl_game_runner/sim_driver.h"
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+
+#include "esp_idf_version.h"
+#include "esp_now.h"
+
+namespace esphome::netplay {
+
+using lvgl_game_runner::GameBase;
+using lvgl_game_runner::InputEvent;
+using lvgl_game_runner::LvglGameRunner;
+using lvgl_game_runner::Scalar;
+
+/**
+ * Two-player netplay between two devices over ESP-NOW, with input delay and rollback.
+ *
+ * Both devices run the same deterministic fixed-step simulation. Each samples its local
+ * buttons once per step and schedules them `input_delay` steps ahead, sending every input
+ * the peer hasn't acknowledged yet in each packet (so a lost packet costs nothing). Steps
+ * whose remote input hasn't arrived run with a prediction (the peer's last buttons); when
+ * the real input differs, the game's state is restored from the snapshot taken before
+ * that step and the steps since are run again. A device stops advancing rather than
+ * predict more than `max_rollback` steps ahead, and the one that runs ahead of its peer
+ * skips a step now and then so both stay level.
+ *
+ * Player 1 hosts: it offers a session (a seed) until the peer accepts, then both restart
+ * the current game with that seed. Until then, and after the peer goes quiet for
+ * `timeout`, the runner plays locally as usual.
+ */
+class Netplay : public Component, public lvgl_game_runner::SimDriver {
+ public:
+  void setup() override;
+  void loop() override;
+  void dump_config() override;
+  float get_setup_priority() const override { return setup_priority::AFTER_WIFI; }
+
+  void set_runner(LvglGameRunner *runner) { runner_ = runner; }
+  void set_peer(uint64_t mac) {
+    for (int i = 0; i < 6; i++)
+      peer_mac_[i] = uint8_t(mac >> (8 * (5 - i)));
+  }
+  void set_player(uint8_t player) { local_player_ = player; }
+  void set_channel(uint8_t channel) { channel_ = channel; }
+  void set_input_delay(uint8_t frames) { input_delay_ = frames; }
+  void set_max_rollback(uint8_t frames) { max_rollback_ = frames; }
+  void set_peer_timeout(uint32_t ms) { timeout_ms_ = ms; }
+
+  bool is_connected() const { return active_.load(std::memory_order_relaxed); }
+
+  // SimDriver (frame context)
+  bool begin_frame(GameBase *game) override;
+  void on_local_input(const InputEvent &event) override;
+  uint32_t advance(GameBase *game, Scalar dt, uint32_t due) override;
+
+ protected:
+  static constexpr size_t MAX_PACKET = ESP_NOW_MAX_DATA_LEN;
+  static constexpr uint32_t INPUT_RING = 128;  // Steps of input kept; must be a power of two
+  static constexpr uint8_t MAX_INPUTS_PER_PACKET = 64;
+  static constexpr uint32_t HELLO_INTERVAL_MS = 250;
+  static constexpr uint32_t SYNC_INTERVAL = 16;  // Steps between frame advantage checks
+  static constexpr uint32_t NO_ROLLBACK = UINT32_MAX;
+
+  // One step of a player's input, as sent
+  struct StepInput {
+    uint16_t held{0};   // InputSnapshot::bit() per button down
+    int8_t rotate{0};   // Encoder steps
+    bool operator==(const StepInput &o) const { return held == o.held && rotate == o.rotate; }
+    bool operator!=(const StepInput &o) const { return !(*this == o); }
+  };
+
+  struct RxPacket {
+    uint8_t len;
+    uint8_t data[MAX_PACKET];
+  };
+
+  // Radio
+  bool start_radio_();
+  void send_(const void *data, size_t len);
+#if ESP_IDF_VERSION >= ESP_IDF_VERSION_VAL(5, 0, 0)
+  static void recv_cb_(const esp_now_recv_info_t *info, const uint8_t *data, int len);
+#else
+  static void recv_cb_(const uint8_t *mac, const uint8_t *data, int len);
+#endif
+  static Netplay *instance_;
+
+  // Session
+  void handle_packet_(GameBase *game, const uint8_t *data, size_t len);
+  void handle_inputs_(const uint8_t *data, size_t len);
+  bool hello_matches_(GameBase *game, const uint8_t *data, size_t len);
+  void send_hello_(GameBase *game, uint8_t type);
+  void send_inputs_();
+  bool start_session_(GameBase *game, uint32_t seed);
+  void end_session_(const char *reason);
+
+  // Simulation
+  void simulate_(GameBase *game, Scalar dt, uint32_t frame);
+  void apply_input_(GameBase *game, uint8_t player, const StepInput &in);
+  bool rollback_(GameBase *game, Scalar dt);
+  uint8_t *snapshot_(uint32_t frame) { return snapshots_.get() + (frame % snapshot_slots_) * state_size_; }
+  uint8_t remote_player_() const { return local_player_ == 1 ? 2 : 1; }
+
+  // Configuration
+  LvglGameRunner *runner_{nullptr};
+  uint8_t peer_mac_[6]{};
+  uint8_t local_player_{1};
+  uint8_t channel_{1};
+  uint8_t input_delay_{2};
+  uint8_t max_rollback_{8};
+  uint32_t timeout_ms_{3000};
+
+  bool radio_ok_{false};
+  bool own_wifi_{false};  // Wi-Fi was started here, not by the wifi component
+  lvgl_game_runner::SpscRingBuffer<RxPacket, 8> rx_;
+  std::atomic<uint32_t> rx_dropped_{0};
+  std::atomic<bool> active_{false};
+
+  // Session state (frame context)
+  GameBase *game_{nullptr};
+  uint32_t session_{0};  // The host's seed; 0 = none offered yet
+  uint32_t last_rx_ms_{0};
+  uint32_t last_hello_ms_{0};
+  uint32_t last_wake_ms_{0};
+  bool mismatch_logged_{false};
+  uint8_t local_humans_{1};  // The game's human player count before the session
+
+  // Lockstep: frame_ is the next step to simulate. Inputs for steps below local_count_ /
+  // remote_count_ are known; later remote steps are predicted.
+  uint32_t frame_{0};
+  uint32_t local_count_{0};
+  uint32_t remote_count_{0};
+  uint32_t peer_ack_{0};    // Steps of our input the peer has
+  uint32_t peer_frame_{0};  // The peer's frame_ when it last sent
+  int8_t peer_advantage_{0};
+  uint32_t sync_wait_{0};   // Steps still to skip for the peer to catch up
+  uint32_t next_sync_{0};   // Frame of the next advantage check
+  uint32_t rollback_from_{NO_ROLLBACK};
+  StepInput local_[INPUT_RING];
+  StepInput remote_[INPUT_RING];
+  StepInput predicted_[INPUT_RING];  // Remote input each step was last run with
+  uint16_t local_held_{0};
+  int32_t local_rotate_{0};
+
+  // Snapshots of the state before each of the last snapshot_slots_ steps
+  std::unique_ptr<uint8_t[]> snapshots_;
+  size_t state_size_{0};
+  uint32_t snapshot_slots_{0};
+
+  // Per session, logged when it ends
+  uint32_t rollbacks_{0};
+  uint32_t resimulated_{0};
+  uint32_t stalls_{0};
+};
+
+}  // namespace esphome::netplay
@@ -0,0 +1,422 @@
+// © Copyright 2025 Stuart Parmenter
+// SPDX-License-Identifier: MIT
+
+// Headless benchmark for the game components. Replays an input recording (or runs with no
+// or random input) through GameBase the way LvglGameRunner's fixed-step loop does, into an
+// offscreen canvas, and reports update/render/compose/flush times, how much of the area
+// each frame damaged, and the final frame hash. See "Host Benchmark" in the README.
+
+#include "esphome/core/log.h"
+#include "esphome/components/lvgl_game_runner/game_registry.h"
+#include "esphome/components/lvgl_game_runner/input_recording.h"
+#include "esphome/components/game_breakout/game_breakout.h"
+#include "esphome/components/game_pong/game_pong.h"
+#include "esphome/components/game_snake/game_snake.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <vector>
+
+namespace esphome::game_bench {
+
+using lvgl_game_runner::FrameView;
+using lvgl_game_runner::GameBase;
+using lvgl_game_runner::GameFactory;
+using lvgl_game_runner::GameRegistry;
+using lvgl_game_runner::GameRng;
+using lvgl_game_runner::InputEvent;
+using lvgl_game_runner::InputRecording;
+using lvgl_game_runner::InputType;
+using lvgl_game_runner::Scalar;
+
+// Registered as codegen would, with each game's YAML defaults
+static GameFactory breakout_factory("breakout",
+                                    []() -> GameBase * { return new (std::nothrow) game_breakout::GameBreakout(); });
+static GameFactory pong_factory("pong", []() -> GameBase * { return new (std::nothrow) game_pong::GamePong(); });
+static GameFactory snake_factory("snake", []() -> GameBase * { return new (std::nothrow) game_snake::GameSnake(); });
+
+static constexpr uint32_t MAX_CATCHUP_STEPS = 4;  // The runner's default
+
+struct Options {
+  const char *game{nullptr};
+  const char *recording{nullptr};
+  const char *record{nullptr};
+  const char *csv{nullptr};
+  uint32_t steps{3600};
+  uint32_t seed{1};
+  float rate{60.0f};
+  float fps{30.0f};
+  int width{320};
+  int height{240};
+  uint8_t bpp{0};  // 0 = RGB565, else indexed
+  uint8_t scale{1};
+  bool double_buffer{false};
+  int humans{-1};  // -1 = the game's default
+  bool random_input{false};
+  bool has_expect_hash{false};
+  uint32_t expect_hash{0};
+  float max_update_p95_us{0};
+};
+
+/**
+ * Raw durations, for percentiles finer than LatencyHistogram's 25us buckets.
+ */
+class Samples {
+ public:
+  void add(std::chrono::steady_clock::duration d) {
+    this->ns_.push_back((uint64_t) std::chrono::duration_cast<std::chrono::nanoseconds>(d).count());
+    this->sorted_ = false;
+  }
+  size_t count() const { return this->ns_.size(); }
+
+  // `pct`th percentile (0-100) in microseconds; 0 if empty
+  double percentile_us(double pct) {
+    if (this->ns_.empty())
+      return 0;
+    if (!this->sorted_) {
+      std::sort(this->ns_.begin(), this->ns_.end());
+      this->sorted_ = true;
+    }
+    const size_t i = std::min(this->ns_.size() - 1, (size_t) std::ceil(pct / 100.0 * this->ns_.size()) - (pct > 0));
+    return this->ns_[i] / 1000.0;
+  }
+
+  void print(const char *name) {
+    printf("%-8s p50/p95/p99/max = %.2f/%.2f/%.2f/%.2f us (%zu)\n", name, this->percentile_us(50),
+           this->percentile_us(95), this->percentile_us(99), this->percentile_us(100), this->count());
+  }
+
+ private:
+  std::vector<uint64_t> ns_;
+  bool sorted_{true};
+};
+
+static void usage() {
+  fprintf(stderr,
+          "usage: game_bench <game> [options]\n"
+          "  --recording FILE      replay a recording (get_recording() bytes); sets seed, rate and steps\n"
+          "  --steps N             steps to run without a recording (default 3600)\n"
+          "  --seed N              game seed without a recording (default 1)\n"
+          "  --rate HZ             simulation rate without a recording (default 60)\n"
+          "  --random-input        press and release random buttons (seeded) instead of none\n"
+          "  --record FILE         save the input that was fed as a recording\n"
+          "  --fps F               frames drawn per second of game time (default 30)\n"
+          "  --size WxH            canvas size (default 320x240)\n"
+          "  --format F            native, indexed_1bit, indexed_2bit or indexed_4bit\n"
+          "  --pixel-scale N       draw at 1/N resolution and upscale on flush (1-4)\n"
+          "  --double-buffer       draw into a back buffer, copied on flush\n"
+          "  --humans N            human players (rest are AI)\n"
+          "  --csv FILE            per-frame timings and damage\n"
+          "  --expect-hash HEX     fail unless the final frame hash matches\n"
+          "  --max-update-p95 US   fail if the update p95 is slower\n"
+          "  --verbose             show the games' info logs\n"
+          "games:");
+  for (size_t i = 0; i < GameRegistry::size(); i++)
+    fprintf(stderr, " %s", GameRegistry::at(i)->get_key());
+  fprintf(stderr, "\n");
+}
+
+static bool parse_args(int argc, char **argv, Options &o) {
+  for (int i = 1; i < argc; i++) {
+    const char *a = argv[i];
+    const bool has_value = i + 1 < argc;
+    auto value = [&]() { return argv[++i]; };
+    if (a[0] != '-' && !o.game) {
+      o.game = a;
+    } else if (!strcmp(a, "--random-input")) {
+      o.random_input = true;
+    } else if (!strcmp(a, "--double-buffer")) {
+      o.double_buffer = true;
+    } else if (!strcmp(a, "--verbose")) {
+      host_log_verbose = true;
+    } else if (!has_value) {
+      return false;
+    } else if (!strcmp(a, "--recording")) {
+      o.recording = value();
+    } else if (!strcmp(a, "--record")) {
+      o.record = value();
+    } else if (!strcmp(a, "--csv")) {
+      o.csv = value();
+    } else if (!strcmp(a, "--steps")) {
+      o.steps = strtoul(value(), nullptr, 0);
+    } else if (!strcmp(a, "--seed")) {
+      o.seed = strtoul(value(), nullptr, 0);
+    } else if (!strcmp(a, "--rate")) {
+      o.rate = strtof(value(), nullptr);
+    } else if (!strcmp(a, "--fps")) {
+      o.fps = strtof(value(), nullptr);
+    } else if (!strcmp(a, "--size")) {
+      if (sscanf(value(), "%dx%d", &o.width, &o.height) != 2)
+        return false;
+    } else if (!strcmp(a, "--format")) {
+      const char *f = value();
+      if (!strcmp(f, "native")) {
+        o.bpp = 0;
+      } else if (!strncmp(f, "indexed_", 8) && strchr("124", f[8]) && !strcmp(f + 9, "bit")) {
+        o.bpp = f[8] - '0';
+      } else {
+        return false;
+      }
+    } else if (!strcmp(a, "--pixel-scale")) {
+      o.scale = (uint8_t) strtoul(value(), nullptr, 0);
+    } else if (!strcmp(a, "--humans")) {
+      o.humans = atoi(value());
+    } else if (!strcmp(a, "--expect-hash")) {
+      o.expect_hash = strtoul(value(), nullptr, 16);
+      o.has_expect_hash = true;
+    } else if (!strcmp(a, "--max-update-p95")) {
+      o.max_update_p95_us = strtof(value(), nullptr);
+    } else {
+      return false;
+    }
+  }
+  return o.game && o.fps > 0 && o.rate > 0 && o.rate <= 1000 && o.scale >= 1 && o.scale <= 4 && o.width > 0 &&
+         o.height > 0 && o.width % o.scale == 0 && o.height % o.scale == 0;
+}
+
+static bool read_file(const char *path, std::vector<uint8_t> &out) {
+  FILE *f = fopen(path, "rb");
+  if (!f)
+    return false;
+  uint8_t buf[4096];
+  size_t n;
+  while ((n = fread(buf, 1, sizeof(buf), f)) > 0)
+    out.insert(out.end(), buf, buf + n);
+  const bool ok = !ferror(f);
+  fclose(f);
+  return ok;
+}
+
+static bool write_file(const char *path, const std::vector<uint8_t> &data) {
+  FILE *f = fopen(path, "wb");
+  if (!f)
+    return false;
+  const bool ok = fwrite(data.data(), 1, data.size(), f) == data.size();
+  return fclose(f) == 0 && ok;
+}
+
+// Pixels the frame's damage covers (overlapping rectangles count twice)
+static uint32_t damaged_pixels(const FrameView &view) {
+  if (view.damage->is_full())
+    return (uint32_t) view.w * view.h;
+  uint32_t px = 0;
+  for (size_t i = 0; i < view.damage->size(); i++) {
+    const lv_area_t &a = (*view.damage)[i];
+    px += (uint32_t) (a.x2 - a.x1 + 1) * (a.y2 - a.y1 + 1);
+  }
+  return px;
+}
+
+static int run(const Options &o) {
+  GameFactory *factory = GameRegistry::find(o.game);
+  if (!factory) {
+    fprintf(stderr, "Unknown game '%s'\n", o.game);
+    return 2;
+  }
+
+  InputRecording recording;
+  if (o.recording) {
+    std::vector<uint8_t> data;
+    if (!read_file(o.recording, data) || !recording.load(data.data(), data.size()) || recording.steps() == 0 ||
+        recording.sim_period_us() == 0) {
+      fprintf(stderr, "Can't load recording '%s'\n", o.recording);
+      return 2;
+    }
+  }
+  const uint32_t seed = o.recording ? recording.seed() : o.seed;
+  const uint32_t period_us = o.recording ? recording.sim_period_us() : (uint32_t) lroundf(1e6f / o.rate);
+  const uint32_t total_steps = o.recording ? recording.steps() : o.steps;
+  const uint64_t frame_us = (uint64_t) llroundf(1e6f / o.fps);
+
+  // Offscreen canvas, plus the back buffer the runner would allocate
+  const lv_img_cf_t cf = o.bpp == 1   ? LV_IMG_CF_INDEXED_1BIT
+                         : o.bpp == 2 ? LV_IMG_CF_INDEXED_2BIT
+                         : o.bpp == 4 ? LV_IMG_CF_INDEXED_4BIT
+                                      : LV_IMG_CF_TRUE_COLOR;
+  std::vector<uint8_t> canvas_buf(lv_img_buf_get_img_size(o.width, o.height, cf));
+  lv_obj_t canvas{};
+  lv_canvas_set_buffer(&canvas, canvas_buf.data(), o.width, o.height, cf);
+  std::vector<uint8_t> back_buf;
+  if (o.double_buffer || o.scale > 1)
+    back_buf.resize(lv_img_buf_get_img_size(o.width / o.scale, o.height / o.scale, cf));
+
+  GameBase *game = factory->acquire();
+  if (!game) {
+    fprintf(stderr, "Can't construct '%s'\n", o.game);
+    return 2;
+  }
+  if (o.humans >= 0)
+    game->set_num_human_players((uint8_t) o.humans);
+
+  // Bind as ensure_bound_() does, then restart from the seed as a replay start does
+  game->set_off_lvgl_thread(false);
+  game->set_back_buffer(back_buf.empty() ? nullptr : back_buf.data(), o.scale);
+  game->on_bind(&canvas);
+  game->seed(seed);
+  game->clear_input();
+  game->reset();
+  game->on_resize(GameBase::Rect{0, 0, o.width / o.scale, o.height / o.scale});
+  game->clear_input();
+  game->seed(seed);
+  game->reset();
+  game->resume();
+
+  InputRecording record;
+  if (o.record)
+    record.begin(seed, period_us);
+  InputRecording::Cursor cursor(o.recording ? &recording : nullptr);
+  GameRng input_rng;
+  input_rng.seed(seed ^ 0x9E3779B9u);
+  static constexpr InputType RANDOM_BUTTONS[] = {InputType::UP, InputType::DOWN, InputType::LEFT, InputType::RIGHT,
+                                                 InputType::A};
+  uint16_t held = 0;  // Random input: bit per RANDOM_BUTTONS entry
+
+  FILE *csv = nullptr;
+  if (o.csv) {
+    csv = fopen(o.csv, "w");
+    if (!csv) {
+      fprintf(stderr, "Can't write '%s'\n", o.csv);
+      return 2;
+    }
+    fprintf(csv, "frame,steps,update_us,render_us,compose_us,flush_us,rects,damaged_px\n");
+  }
+
+  using Clock = std::chrono::steady_clock;
+  auto us = [](Clock::duration d) { return std::chrono::duration_cast<std::chrono::nanoseconds>(d).count() / 1000.0; };
+  Samples update_t, render_t, compose_t, flush_t;
+  std::vector<uint32_t> damage_px;
+  uint32_t full_frames = 0;
+  uint64_t rects = 0;
+  const Scalar dt = lvgl_game_runner::scalar_ratio(period_us, 1000000);
+  uint32_t step = 0;
+  uint64_t accum_us = 0;
+
+  while (step < total_steps) {
+    // The runner's fixed-step loop, with every frame exactly on time
+    accum_us += frame_us;
+    uint32_t steps = 0;
+    Clock::duration frame_update{};
+    while (accum_us >= period_us && steps < MAX_CATCHUP_STEPS && step < total_steps) {
+      InputEvent event;
+      while (cursor.next(step, event)) {
+        game->dispatch_input(event);
+        if (o.record)
+          record.append(step, event);
+      }
+      if (o.random_input && input_rng.next() % 8 == 0) {
+        const size_t b = input_rng.next() % (sizeof(RANDOM_BUTTONS) / sizeof(RANDOM_BUTTONS[0]));
+        const bool pressed = !(held & (1u << b));
+        held ^= 1u << b;
+        event = InputEvent(RANDOM_BUTTONS[b], 1, pressed);
+        game->dispatch_input(event);
+        if (o.record)
+          record.append(step, event);
+      }
+      const auto t0 = Clock::now();
+      game->update(dt);
+      const auto d = Clock::now() - t0;
+      update_t.add(d);
+      frame_update += d;
+      game->end_input_step();
+      step++;
+      steps++;
+      accum_us -= period_us;
+    }
+    if (accum_us >= period_us)
+      accum_us %= period_us;
+
+    const bool done = step >= total_steps;
+    const auto t0 = Clock::now();
+    game->render(done ? Scalar(1) : lvgl_game_runner::scalar_ratio(accum_us, period_us));
+    const auto t1 = Clock::now();
+    game->finish_frame();
+    const auto t2 = Clock::now();
+    FrameView view;
+    const bool have_view = game->get_frame_view(view);
+    const auto t3 = Clock::now();
+    game->flush_damage();
+    const auto t4 = Clock::now();
+    render_t.add(t1 - t0);
+    compose_t.add(t2 - t1);
+    flush_t.add(t4 - t3);
+
+    const uint32_t px = have_view ? damaged_pixels(view) : 0;
+    const size_t n = have_view && !view.damage->is_full() ? view.damage->size() : 1;
+    damage_px.push_back(px);
+    rects += n;
+    full_frames += have_view && view.damage->is_full();
+    if (csv) {
+      fprintf(csv, "%zu,%u,%.2f,%.2f,%.2f,%.2f,%zu,%u\n", damage_px.size() - 1, (unsigned) steps, us(frame_update),
+              us(t1 - t0), us(t2 - t1), us(t4 - t3), n, (unsigned) px);
+    }
+  }
+  if (csv)
+    fclose(csv);
+
+  const uint32_t hash = game->get_frame_hash();
+  static const char *const FORMATS[] = {"native", "indexed_1bit", "indexed_2bit", "", "indexed_4bit"};
+  printf("%s %dx%d %s x%u%s, seed %u, %u steps at %.1f Hz, %zu frames at %.1f fps%s\n", o.game, o.width, o.height,
+         FORMATS[o.bpp], (unsigned) o.scale, back_buf.empty() ? "" : " (back buffer)", (unsigned) seed,
+         (unsigned) step, 1e6 / period_us, damage_px.size(), o.fps,
+#if LVGL_GAME_RUNNER_FIXED_POINT
+         ", fixed point"
+#else
+         ""
+#endif
+  );
+  update_t.print("update");
+  render_t.print("render");
+  compose_t.print("compose");
+  flush_t.print("flush");
+
+  // Render deltas: how much of the game area each frame changed
+  const double area = (double) (o.width / o.scale) * (o.height / o.scale);
+  std::vector<uint32_t> sorted = damage_px;
+  std::sort(sorted.begin(), sorted.end());
+  double sum = 0;
+  for (uint32_t px : damage_px)
+    sum += px;
+  const size_t frames = std::max<size_t>(damage_px.size(), 1);
+  const uint32_t p95 = sorted.empty() ? 0 : sorted[std::min(sorted.size() - 1, sorted.size() * 95 / 100)];
+  printf("damage   avg %.1f%% of the area per frame (p95 %.1f%%), %.1f rects per frame, %u full frames\n",
+         100.0 * sum / frames / area, 100.0 * p95 / area, (double) rects / frames, (unsigned) full_frames);
+  printf("frame hash %08x\n", (unsigned) hash);
+
+  int rc = 0;
+  if (o.record) {
+    record.finish(step);
+    if (!write_file(o.record, record.data())) {
+      fprintf(stderr, "Can't write '%s'\n", o.record);
+      rc = 2;
+    } else {
+      printf("recorded %u steps of input in %zu bytes to %s\n", (unsigned) step, record.size(), o.record);
+    }
+  }
+  if (o.has_expect_hash && hash != o.expect_hash) {
+    printf("FAIL: frame hash %08x, expected %08x\n", (unsigned) hash, (unsigned) o.expect_hash);
+    rc = 1;
+  }
+  const double update_p95 = update_t.percentile_us(95);
+  if (o.max_update_p95_us > 0 && update_p95 > o.max_update_p95_us) {
+    printf("FAIL: update p95 %.2f us, limit %.2f us\n", update_p95, o.max_update_p95_us);
+    rc = 1;
+  }
+  factory->release();
+  return rc;
+}
+
+}  // namespace esphome::game_bench
+
+int main(int argc, char **argv) {
+  esphome::game_bench::Options options;
+  if (!esphome::game_bench::parse_args(argc, argv, options)) {
+    esphome::game_bench::usage();
+    return 2;
+  }
+  return esphome::game_bench::run(options);
+}
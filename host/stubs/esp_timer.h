@@ -0,0 +1,14 @@
+// © Copyright 2025 Stuart Parmenter
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+// ESP-IDF's microsecond clock, for host builds
+
+#include <chrono>
+#include <cstdint>
+
+static inline int64_t esp_timer_get_time() {
+  return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
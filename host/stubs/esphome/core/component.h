@@ -0,0 +1,9 @@
+// © Copyright 2025 Stuart Parmenter
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+// Host builds compile games without ESPHome's component framework; GameBase includes this
+// header but uses nothing from it.
+
+namespace esphome {}  // namespace esphome
@@ -0,0 +1,27 @@
+// © Copyright 2025 Stuart Parmenter
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+// ESPHome's logging macros for host builds: warnings and errors go to stderr, the rest
+// only once esphome::host_log_verbose is set (game_bench --verbose).
+
+#include <cstdio>
+
+namespace esphome {
+inline bool host_log_verbose = false;
+}  // namespace esphome
+
+#define ESP_HOST_LOG_(enabled, level, tag, format, ...) \
+  do { \
+    if (enabled) \
+      fprintf(stderr, "[" level "][%s] " format "\n", tag, ##__VA_ARGS__); \
+  } while (0)
+
+#define ESP_LOGE(tag, format, ...) ESP_HOST_LOG_(true, "E", tag, format, ##__VA_ARGS__)
+#define ESP_LOGW(tag, format, ...) ESP_HOST_LOG_(true, "W", tag, format, ##__VA_ARGS__)
+#define ESP_LOGI(tag, format, ...) ESP_HOST_LOG_(esphome::host_log_verbose, "I", tag, format, ##__VA_ARGS__)
+#define ESP_LOGCONFIG(tag, format, ...) ESP_HOST_LOG_(esphome::host_log_verbose, "C", tag, format, ##__VA_ARGS__)
+#define ESP_LOGD(tag, format, ...) ESP_HOST_LOG_(esphome::host_log_verbose, "D", tag, format, ##__VA_ARGS__)
+#define ESP_LOGV(tag, format, ...) ESP_HOST_LOG_(esphome::host_log_verbose, "V", tag, format, ##__VA_ARGS__)
+#define ESP_LOGVV(tag, format, ...) ESP_HOST_LOG_(false, "VV", tag, format, ##__VA_ARGS__)
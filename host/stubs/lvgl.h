@@ -0,0 +1,172 @@
+// © Copyright 2025 Stuart Parmenter
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+// The slice of the LVGL 8 API that GameBase and the games use, for host builds. Types and
+// color formats match an RGB565 device build, so frame hashes compare with a device; text
+// is measured (6 px per character) but never drawn.
+
+#include <cstdint>
+#include <cstring>
+
+#define LV_COLOR_DEPTH 16
+#define LV_COLOR_16_SWAP 0
+
+typedef int16_t lv_coord_t;
+#define LV_COORD_MAX ((lv_coord_t) ((1 << 13) - 1))
+
+typedef struct {
+  lv_coord_t x1;
+  lv_coord_t y1;
+  lv_coord_t x2;
+  lv_coord_t y2;
+} lv_area_t;
+
+typedef struct {
+  lv_coord_t x;
+  lv_coord_t y;
+} lv_point_t;
+
+// ---- Color ----
+
+typedef union {
+  struct {
+    uint16_t blue : 5;
+    uint16_t green : 6;
+    uint16_t red : 5;
+  } ch;
+  uint16_t full;
+} lv_color_t;
+
+typedef union {
+  struct {
+    uint8_t blue;
+    uint8_t green;
+    uint8_t red;
+    uint8_t alpha;
+  } ch;
+  uint32_t full;
+} lv_color32_t;
+
+static inline lv_color_t lv_color_make(uint8_t r, uint8_t g, uint8_t b) {
+  lv_color_t c;
+  c.full = (uint16_t) (((r >> 3) << 11) | ((g >> 2) << 5) | (b >> 3));
+  return c;
+}
+
+static inline lv_color_t lv_color_hex(uint32_t c) {
+  return lv_color_make((uint8_t) (c >> 16), (uint8_t) (c >> 8), (uint8_t) c);
+}
+
+static inline lv_color_t lv_color_black() { return lv_color_hex(0x000000); }
+
+// Same rounding as LVGL's lv_color_to32() for 16-bit color
+static inline uint32_t lv_color_to32(lv_color_t c) {
+  lv_color32_t r;
+  r.ch.red = (uint8_t) ((c.ch.red * 263 + 7) >> 5);
+  r.ch.green = (uint8_t) ((c.ch.green * 259 + 3) >> 6);
+  r.ch.blue = (uint8_t) ((c.ch.blue * 263 + 7) >> 5);
+  r.ch.alpha = 0xFF;
+  return r.full;
+}
+
+// ---- Images and canvas ----
+
+typedef uint8_t lv_img_cf_t;
+enum {
+  LV_IMG_CF_TRUE_COLOR = 4,
+  LV_IMG_CF_INDEXED_1BIT = 7,
+  LV_IMG_CF_INDEXED_2BIT = 8,
+  LV_IMG_CF_INDEXED_4BIT = 9,
+};
+
+typedef struct {
+  uint32_t cf : 5;
+  uint32_t always_zero : 3;
+  uint32_t reserved : 2;
+  uint32_t w : 11;
+  uint32_t h : 11;
+} lv_img_header_t;
+
+typedef struct {
+  lv_img_header_t header;
+  uint32_t data_size;
+  const uint8_t *data;
+} lv_img_dsc_t;
+
+// A canvas is just its image here
+typedef struct _lv_obj_t {
+  lv_img_dsc_t img;
+} lv_obj_t;
+
+typedef struct _lv_event_t lv_event_t;
+
+static inline uint32_t lv_img_buf_get_img_size(lv_coord_t w, lv_coord_t h, lv_img_cf_t cf) {
+  switch (cf) {
+    case LV_IMG_CF_INDEXED_1BIT:
+      return 4 * 2 + ((w + 7) / 8) * h;
+    case LV_IMG_CF_INDEXED_2BIT:
+      return 4 * 4 + ((w + 3) / 4) * h;
+    case LV_IMG_CF_INDEXED_4BIT:
+      return 4 * 16 + ((w + 1) / 2) * h;
+    default:
+      return (uint32_t) w * h * sizeof(lv_color_t);
+  }
+}
+
+static inline void lv_canvas_set_buffer(lv_obj_t *canvas, void *buf, lv_coord_t w, lv_coord_t h, lv_img_cf_t cf) {
+  canvas->img.header.cf = cf;
+  canvas->img.header.w = w;
+  canvas->img.header.h = h;
+  canvas->img.data_size = lv_img_buf_get_img_size(w, h, cf);
+  canvas->img.data = static_cast<const uint8_t *>(buf);
+}
+
+static inline lv_img_dsc_t *lv_canvas_get_img(lv_obj_t *canvas) { return &canvas->img; }
+static inline lv_coord_t lv_obj_get_width(const lv_obj_t *obj) { return obj->img.header.w; }
+static inline lv_coord_t lv_obj_get_height(const lv_obj_t *obj) { return obj->img.header.h; }
+
+static inline void lv_obj_invalidate_area(const lv_obj_t *, const lv_area_t *) {}
+static inline void lv_img_cache_invalidate_src(const void *) {}
+
+// ---- Text ----
+
+typedef struct {
+  lv_coord_t line_height;
+} lv_font_t;
+
+inline const lv_font_t lv_font_host_default{10};
+#define LV_FONT_DEFAULT (&lv_font_host_default)
+
+typedef uint8_t lv_text_align_t;
+enum {
+  LV_TEXT_ALIGN_AUTO,
+  LV_TEXT_ALIGN_LEFT,
+  LV_TEXT_ALIGN_CENTER,
+  LV_TEXT_ALIGN_RIGHT,
+};
+
+typedef uint8_t lv_text_flag_t;
+enum {
+  LV_TEXT_FLAG_NONE = 0,
+};
+
+typedef struct {
+  const lv_font_t *font;
+  lv_color_t color;
+  lv_text_align_t align;
+} lv_draw_label_dsc_t;
+
+static inline lv_coord_t lv_font_get_line_height(const lv_font_t *font) { return font->line_height; }
+
+static inline void lv_txt_get_size(lv_point_t *size, const char *text, const lv_font_t *font, lv_coord_t, lv_coord_t,
+                                   lv_coord_t, lv_text_flag_t) {
+  size->x = (lv_coord_t) (strlen(text) * 6);
+  size->y = font->line_height;
+}
+
+static inline void lv_draw_label_dsc_init(lv_draw_label_dsc_t *dsc) { memset(dsc, 0, sizeof(*dsc)); }
+
+static inline void lv_canvas_draw_text(lv_obj_t *, lv_coord_t, lv_coord_t, lv_coord_t, const lv_draw_label_dsc_t *,
+                                       const char *) {}